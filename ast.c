@@ -0,0 +1,210 @@
+/**
+ * @file ast.c
+ * @brief Arena and constructors of the abstract syntax tree.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <string.h>
+#include "ast.h"
+#include "compiler.h"
+
+#define AST_CHUNK_SIZE (64 * 1024) // nodes are allocated from chunks of this size
+#define AST_ALIGN sizeof(void *)
+
+/**
+ * @brief - Chunk of memory the nodes are allocated from
+ */
+typedef struct Ast_chunk
+{
+    struct Ast_chunk *next;
+    size_t used;
+    size_t size;
+    char data[];
+} Ast_chunk;
+
+void *ast_alloc(size_t size)
+{
+    Ast_arena *arena = &compiler->ast;
+    size = (size + AST_ALIGN - 1) & ~(AST_ALIGN - 1);
+    if (arena->chunks == NULL || arena->chunks->size - arena->chunks->used < size)
+    {
+        size_t chunk_size = size > AST_CHUNK_SIZE ? size : AST_CHUNK_SIZE;
+        Ast_chunk *chunk = malloc(sizeof(Ast_chunk) + chunk_size);
+        if (chunk == NULL)
+        {
+            throw_error(INTERNAL_ERR, -1, "Memory allocation for syntax tree failed.");
+        }
+        chunk->next = arena->chunks;
+        chunk->used = 0;
+        chunk->size = chunk_size;
+        arena->chunks = chunk;
+    }
+    void *node = arena->chunks->data + arena->chunks->used;
+    arena->chunks->used += size;
+    memset(node, 0, size);
+    return node;
+}
+
+void ast_free()
+{
+    Ast_arena *arena = &compiler->ast;
+    while (arena->chunks != NULL)
+    {
+        Ast_chunk *next = arena->chunks->next;
+        free(arena->chunks);
+        arena->chunks = next;
+    }
+    arena->program = NULL;
+    arena->current = NULL;
+}
+
+/// EXPRESSIONS
+
+Ast_var ast_resolve_var(char *id)
+{
+    symtable_item *found = symtable_find_in_stack(id, compiler->sym_st, false);
+    if (found == NULL)
+    {
+        // unknown symbols are presumed to be temporary
+        return (Ast_var){.id = id, .scope = -1, .has_suffix = false};
+    }
+    if (found->type != VARIABLE || found->data.var_data->type == TYPE_INVALID)
+    {
+        throw_error(INTERNAL_ERR, -1, "Variable '%s' is invalid\n", id);
+    }
+    return (Ast_var){.id = found->id, .scope = found->scope, .has_suffix = true};
+}
+
+Ast_var ast_scope_var(char *id)
+{
+    return (Ast_var){.id = id, .scope = (int)compiler->sym_st->size - 1, .has_suffix = true};
+}
+
+static Ast_expr *ast_expr_new(Ast_expr_kind kind, Expression_type type)
+{
+    Ast_expr *expr = ast_alloc(sizeof(Ast_expr));
+    expr->kind = kind;
+    expr->type = type;
+    return expr;
+}
+
+Ast_expr *ast_operand(Token token, Expression_type type)
+{
+    if (token.type == TOKEN_IDENTIFICATOR)
+    {
+        Ast_expr *expr = ast_expr_new(AST_VARIABLE, type);
+        expr->data.variable = ast_resolve_var(token.token_value);
+        return expr;
+    }
+
+    Ast_expr *expr = ast_expr_new(AST_LITERAL, type);
+    expr->data.literal.token_type = token.type;
+    expr->data.literal.value = token.token_value;
+    expr->data.literal.literal = token.literal;
+    return expr;
+}
+
+Ast_expr *ast_call(char *name, Expression_type type, Ast_expr **args, int arg_count)
+{
+    Ast_expr *expr = ast_expr_new(AST_CALL, type);
+    expr->data.call.name = name;
+    expr->data.call.arg_count = arg_count;
+    if (arg_count > 0)
+    {
+        expr->data.call.args = ast_alloc(sizeof(Ast_expr *) * arg_count);
+        memcpy(expr->data.call.args, args, sizeof(Ast_expr *) * arg_count);
+    }
+    return expr;
+}
+
+Ast_expr *ast_binary(Token_type op, Expression_type type, Ast_expr *left, Ast_expr *right, Ast_conversion conversion)
+{
+    Ast_expr *expr = ast_expr_new(AST_BINARY, type);
+    expr->data.binary.op = op;
+    expr->data.binary.conversion = conversion;
+    expr->data.binary.left = left;
+    expr->data.binary.right = right;
+    return expr;
+}
+
+Ast_expr *ast_unary(Ast_expr_kind kind, Expression_type type, Ast_expr *operand)
+{
+    Ast_expr *expr = ast_expr_new(kind, type);
+    expr->data.operand = operand;
+    return expr;
+}
+
+/// STATEMENTS
+
+void ast_program_begin()
+{
+    Ast_arena *arena = &compiler->ast;
+    arena->program = ast_alloc(sizeof(Ast_block));
+    arena->current = arena->program;
+}
+
+Ast_block *ast_program_end()
+{
+    Ast_arena *arena = &compiler->ast;
+    arena->current = NULL;
+    return arena->program;
+}
+
+Ast_stmt *ast_stmt_append(Ast_stmt_kind kind, int line_num)
+{
+    Ast_arena *arena = &compiler->ast;
+    Ast_stmt *stmt = ast_alloc(sizeof(Ast_stmt));
+    stmt->kind = kind;
+    stmt->line_num = line_num;
+    if (arena->current->last == NULL)
+    {
+        arena->current->first = stmt;
+    }
+    else
+    {
+        arena->current->last->next = stmt;
+    }
+    arena->current->last = stmt;
+    return stmt;
+}
+
+Ast_stmt *ast_last_stmt()
+{
+    Ast_arena *arena = &compiler->ast;
+    return arena->current->last;
+}
+
+void ast_block_open(Ast_block *block)
+{
+    Ast_arena *arena = &compiler->ast;
+    block->parent = arena->current;
+    block->scope = (int)compiler->sym_st->size - 1;
+    arena->current = block;
+}
+
+void ast_block_close()
+{
+    Ast_arena *arena = &compiler->ast;
+    arena->current = arena->current->parent;
+}
+
+void ast_if_branch(Ast_stmt *if_stmt, Ast_expr *cond)
+{
+    Ast_branch *branch = ast_alloc(sizeof(Ast_branch));
+    branch->cond = cond;
+    if (if_stmt->data.if_stmt.last == NULL)
+    {
+        if_stmt->data.if_stmt.first = branch;
+    }
+    else
+    {
+        if_stmt->data.if_stmt.last->next = branch;
+    }
+    if_stmt->data.if_stmt.last = branch;
+    ast_block_open(&branch->body);
+}
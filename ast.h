@@ -0,0 +1,321 @@
+/**
+ * @file ast.h
+ * @brief Abstract syntax tree built by the parser and the PSA, lowered to IFJcode23 by lower.c.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#ifndef AST_H
+#define AST_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "symtable.h"
+
+/**
+ * @brief - Resolved reference to a variable, formatted by variable() when lowered
+ * @param id - interned name of the variable
+ * @param scope - depth of the scope the variable was found in (0 global, -1 temporary frame)
+ * @param has_suffix - the scope number is appended to the name
+ */
+typedef struct
+{
+    char *id;
+    int scope;
+    bool has_suffix;
+} Ast_var;
+
+typedef enum
+{
+    AST_LITERAL,     // literal from the source
+    AST_VARIABLE,    // variable read
+    AST_CALL,        // function call
+    AST_BINARY,      // binary operation including ??
+    AST_NOT,         // prefix !
+    AST_UNWRAP,      // postfix ! (forced unwrapping)
+    AST_INT2DOUBLE,  // implicit conversion of the operand
+    AST_IS_NOT_NIL,  // condition of 'if let'
+} Ast_expr_kind;
+
+/**
+ * @brief Implicit Int to Double conversion of a binary operation operand.
+ */
+typedef enum
+{
+    AST_CONVERT_NONE,
+    AST_CONVERT_LEFT,
+    AST_CONVERT_RIGHT,
+} Ast_conversion;
+
+/**
+ * @brief - Typed expression node
+ * @param kind - kind of the node
+ * @param type - type of the expression computed by the PSA
+ * @param data - kind specific data
+ */
+typedef struct Ast_expr
+{
+    Ast_expr_kind kind;
+    Expression_type type;
+    union
+    {
+        struct
+        {
+            Token_type token_type;
+            char *value;
+            Literal *literal;
+        } literal;
+        Ast_var variable;
+        struct
+        {
+            char *name;
+            int arg_count;
+            struct Ast_expr **args;
+        } call;
+        struct
+        {
+            Token_type op;
+            Ast_conversion conversion;
+            struct Ast_expr *left;
+            struct Ast_expr *right;
+        } binary;
+        struct Ast_expr *operand; // AST_NOT, AST_UNWRAP, AST_INT2DOUBLE, AST_IS_NOT_NIL
+    } data;
+} Ast_expr;
+
+typedef enum
+{
+    AST_VAR_DECL, // var/let with optional initialization
+    AST_ASSIGN,   // id = expression
+    AST_EXPR,     // function call statement
+    AST_RETURN,   // return with optional expression
+    AST_IF,       // if with else if branches and optional else
+    AST_WHILE,    // while loop
+    AST_FUNC,     // function definition
+} Ast_stmt_kind;
+
+struct Ast_stmt;
+
+/**
+ * @brief - Scope node, list of the statements of one block
+ * @param first - first statement
+ * @param last - last statement
+ * @param parent - enclosing block while the tree is being built
+ * @param scope - depth of the symtable scope of the block
+ */
+typedef struct Ast_block
+{
+    struct Ast_stmt *first;
+    struct Ast_stmt *last;
+    struct Ast_block *parent;
+    int scope;
+} Ast_block;
+
+/**
+ * @brief - Syntax tree of one compilation
+ * @param chunks - memory the nodes are allocated from
+ * @param program - global block of the program
+ * @param current - block the statements are appended to
+ */
+typedef struct
+{
+    struct Ast_chunk *chunks;
+    Ast_block *program;
+    Ast_block *current;
+} Ast_arena;
+
+/**
+ * @brief - Branch of the if statement
+ * @param cond - condition of the branch
+ * @param body - statements executed if the condition holds
+ * @param next - next else if branch
+ */
+typedef struct Ast_branch
+{
+    Ast_expr *cond;
+    Ast_block body;
+    struct Ast_branch *next;
+} Ast_branch;
+
+/**
+ * @brief - Statement node
+ * @param kind - kind of the statement
+ * @param line_num - line the statement starts on
+ * @param next - next statement of the block
+ * @param data - kind specific data
+ */
+typedef struct Ast_stmt
+{
+    Ast_stmt_kind kind;
+    int line_num;
+    struct Ast_stmt *next;
+    union
+    {
+        struct
+        {
+            Ast_var var;      // defined variable
+            Ast_var target;   // variable the initial value is stored to
+            bool has_init;    // = expression was present
+            bool nil_init;    // implicit initialization to nil
+            Ast_expr *init;   // NULL for an empty expression
+        } var_decl;
+        struct
+        {
+            Ast_var target;
+            Ast_expr *value;
+        } assign;
+        Ast_expr *expr;       // AST_EXPR and AST_RETURN (NULL if nothing is returned)
+        struct
+        {
+            Ast_branch *first;
+            Ast_branch *last;
+            Ast_block *else_body; // NULL without else
+        } if_stmt;
+        struct
+        {
+            Ast_expr *cond;
+            Ast_block body;
+        } while_stmt;
+        struct
+        {
+            char *name;
+            int param_count;
+            Ast_var *params;
+            Ast_block body;
+            struct Func_cache *cache; // entry of the function code cache, NULL if the cache is not used
+            struct Func_unit *unit;   // body parsed by the function pool, NULL if it is parsed with the program
+            bool unreachable;         // lazy compilation does not generate the function
+        } func;
+    } data;
+} Ast_stmt;
+
+// ARENA
+
+/**
+ * @brief Allocates zeroed memory from the tree arena, it is released all at once by ast_free.
+ *
+ * @param size size of the allocation
+ * @return void* - pointer aligned for any node
+ */
+void *ast_alloc(size_t size);
+
+/**
+ * @brief Releases all the nodes.
+ */
+void ast_free();
+
+// EXPRESSIONS
+
+/**
+ * @brief Resolves the variable in the current symtable stack the same way symb_resolve does.
+ *
+ * @param id name of the variable
+ * @return Ast_var
+ */
+Ast_var ast_resolve_var(char *id);
+
+/**
+ * @brief Variable defined in the current (top) scope.
+ *
+ * @param id name of the variable
+ * @return Ast_var
+ */
+Ast_var ast_scope_var(char *id);
+
+/**
+ * @brief Creates an operand node from a literal or an identifier token.
+ *
+ * @param token literal or identifier
+ * @param type type of the operand
+ * @return Ast_expr*
+ */
+Ast_expr *ast_operand(Token token, Expression_type type);
+
+/**
+ * @brief Creates a function call node, the arguments are copied to the arena.
+ *
+ * @param name interned function name
+ * @param type return type
+ * @param args argument expressions
+ * @param arg_count number of the arguments
+ * @return Ast_expr*
+ */
+Ast_expr *ast_call(char *name, Expression_type type, Ast_expr **args, int arg_count);
+
+/**
+ * @brief Creates a binary operation node.
+ *
+ * @param op operator token type
+ * @param type result type
+ * @param left left operand
+ * @param right right operand
+ * @param conversion operand converted from Int to Double
+ * @return Ast_expr*
+ */
+Ast_expr *ast_binary(Token_type op, Expression_type type, Ast_expr *left, Ast_expr *right, Ast_conversion conversion);
+
+/**
+ * @brief Creates a node with one operand (!, unwrapping, conversion, if let test).
+ *
+ * @param kind kind of the node
+ * @param type result type
+ * @param operand the operand
+ * @return Ast_expr*
+ */
+Ast_expr *ast_unary(Ast_expr_kind kind, Expression_type type, Ast_expr *operand);
+
+// STATEMENTS
+
+/**
+ * @brief Starts a new program, the statements are added to its global block.
+ */
+void ast_program_begin();
+
+/**
+ * @brief Finishes the program.
+ *
+ * @return Ast_block* - global block of the program
+ */
+Ast_block *ast_program_end();
+
+/**
+ * @brief Appends a new statement to the current block.
+ *
+ * @param kind kind of the statement
+ * @param line_num line of the statement
+ * @return Ast_stmt* - the statement, its data are zeroed
+ */
+Ast_stmt *ast_stmt_append(Ast_stmt_kind kind, int line_num);
+
+/**
+ * @brief Returns the last statement of the current block.
+ *
+ * @return Ast_stmt* - NULL if the block is empty
+ */
+Ast_stmt *ast_last_stmt();
+
+/**
+ * @brief Makes the block current, the statements are added to it until it is closed.
+ *
+ * @param block block to open
+ */
+void ast_block_open(Ast_block *block);
+
+/**
+ * @brief Closes the current block, its parent becomes current.
+ */
+void ast_block_close();
+
+/**
+ * @brief Adds a branch to the if statement and opens its body.
+ *
+ * @param if_stmt the if statement
+ * @param cond condition of the branch
+ */
+void ast_if_branch(Ast_stmt *if_stmt, Ast_expr *cond);
+
+#endif // AST_H
@@ -0,0 +1,459 @@
+/**
+ * @file compiler.c
+ * @brief Runs the stages of one compilation and compiles batches of files on several threads.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include "compiler.h"
+#include "parser.h"
+#include "generator.h"
+#include "lower.h"
+#include "psa.h"
+#include "func_cache.h"
+#include "func_pool.h"
+
+__thread Compiler *compiler = NULL;
+
+void compiler_init(Compiler *ctx, FILE *diagnostics)
+{
+    memset(ctx, 0, sizeof(Compiler));
+    pthread_mutex_init(&ctx->intern.lock, NULL);
+    pthread_mutex_init(&ctx->helper_lock, NULL);
+    ctx->diagnostics = diagnostics;
+    ctx->thread = pthread_self();
+    compiler = ctx;
+}
+
+void compiler_reset(Compiler *ctx)
+{
+    compiler = ctx;
+    func_pool_free(); // the workers read the tokens of the compilation
+    psa_release_stacks();
+    free_scanner_stack();
+    scanner_close();
+    ast_free();
+    if (ctx->sym_st != NULL)
+    {
+        symtable_stack_free_all(ctx->sym_st);
+        ctx->sym_st = NULL;
+    }
+    // the tables of symbols and the source files have been allocated from the syntax tree arena
+    ctx->files = NULL;
+    ctx->file_count = 0;
+    ctx->func_index = NULL;
+    ctx->func_index_complete = false;
+    ctx->gen_id_idx_cnt = 0;
+    if (ctx->else_label_st != NULL)
+    {
+        int_stack_free(ctx->else_label_st);
+        ctx->else_label_st = NULL;
+    }
+    if (ctx->while_label_st != NULL)
+    {
+        int_stack_free(ctx->while_label_st);
+        ctx->while_label_st = NULL;
+    }
+    // an error inside of a loop leaves the file of the loop body open
+    if (ctx->is_in_loop && ctx->while_def_out_code_file != NULL &&
+        ctx->while_def_out_code_file != ctx->out_code_file)
+    {
+        fclose(ctx->out_code_file);
+        ctx->out_code_file = ctx->while_def_out_code_file;
+    }
+    ctx->while_def_out_code_file = NULL;
+    ctx->is_in_loop = false;
+    ctx->loop_depth = 0;
+    ctx->if_counter = 0;
+    ctx->while_counter = 0;
+    ctx->tmp_counter = 0;
+    ctx->label_counter = 0;
+    ctx->label_prefix = NULL;
+    func_cache_free();
+    ctx->lazy_funcs = NULL;
+    ctx->lazy_func_count = 0;
+    ctx->poisoned = NULL; // allocated from the syntax tree arena
+    ctx->poisoned_count = 0;
+    ctx->poisoned_cap = 0;
+    ctx->is_cascade = false;
+    // the output file is kept for the next compilation
+    if (ctx->out_code_file != NULL)
+    {
+        fflush(ctx->out_code_file);
+        if (ftruncate(fileno(ctx->out_code_file), 0) != 0)
+        {
+            fclose(ctx->out_code_file);
+            ctx->out_code_file = NULL;
+        }
+        else
+        {
+            rewind(ctx->out_code_file);
+        }
+    }
+    if (ctx->error_st != NULL)
+    {
+        // the errors of a run compiled again have not been printed
+        while (!Error_stack_empty(ctx->error_st))
+        {
+            free(Error_stack_pop(ctx->error_st).message);
+        }
+        Error_stack_free(ctx->error_st);
+        ctx->error_st = NULL;
+    }
+}
+
+void compiler_free(Compiler *ctx)
+{
+    compiler_reset(ctx);
+    psa_free_stacks();
+    if (ctx->out_code_file != NULL)
+    {
+        fclose(ctx->out_code_file);
+        ctx->out_code_file = NULL;
+    }
+    pthread_mutex_destroy(&ctx->intern.lock);
+    pthread_mutex_destroy(&ctx->helper_lock);
+}
+
+/**
+ * @brief Runs the stages up to the code generation, the source is taken from kept if its data is not NULL, then from
+ * data if it is not NULL, otherwise it is read from the files at the paths.
+ */
+static void compile_stages(Compiler *ctx, const char *const *paths, int path_count, char *data, size_t len,
+                           Compiler_options options, Scanner_source kept)
+{
+    if (ctx->cache_dir != NULL)
+    {
+        func_cache_load(); // the entries of the functions compiled before
+    }
+    if (kept.data != NULL)
+    {
+        scanner_open_source(kept); // compiled again, the bodies left out are read now
+    }
+    else if (data != NULL)
+    {
+        scanner_open_buffer(data, len); // the source has been loaded by the caller
+    }
+    else if (path_count > 1)
+    {
+        link_open(paths, path_count, options.lex_threads); // read the files and put their tokens together
+    }
+    else
+    {
+        scanner_open(paths[0]); // load the source code, stdin is used if no file is given
+    }
+    if (path_count <= 1)
+    {
+        func_cache_skim(); // leave out the bodies of the functions whose code is in the cache
+    }
+
+    if (ctx->out_code_file == NULL)
+    {
+        ctx->out_code_file = tmpfile();
+        if (ctx->out_code_file == NULL)
+        {
+            throw_error(INTERNAL_ERR, -1, "Cannot create temporary file for the output code.");
+        }
+    }
+
+    scanner_init(); // initialize the scanner
+    if ((options.pretokenize || options.lazy) && !ctx->token_buffer.is_active)
+    {
+        scanner_pretokenize(options.lex_threads); // tokenize the whole input at once
+    }
+    if (options.lazy)
+    {
+        lazy_skim(); // find the functions the program can call
+    }
+
+    ctx->sym_st = symtable_stack_init(); // initialize the symbol table stack
+
+    Ast_block *program = run_parser(); // run the parser, it continues after the syntax and semantic errors
+    func_pool_join();                   // the errors of the function bodies parsed by the pool join them
+    bool failed = ctx->error_st != NULL && !Error_stack_empty(ctx->error_st);
+    if (!failed && !ctx->cache_retry)
+    {
+        lower_program(program); // generate the code from the syntax tree
+    }
+}
+
+/**
+ * @brief Runs all the stages, the source is taken from data if it is not NULL, otherwise it is read from the files at
+ * the paths.
+ */
+static Error_code compile(Compiler *ctx, const char *const *paths, int path_count, char *data, size_t len,
+                          Compiler_options options, FILE *out)
+{
+    compiler = ctx;
+    ctx->thread = pthread_self();
+    ctx->cache_dir = options.cache_dir;
+    ctx->func_threads = options.func_threads;
+    ctx->lazy = options.lazy;
+    ctx->lazy_check = options.lazy_check;
+
+    ctx->cache_reuse = options.cache_dir != NULL;
+
+    // throw_error jumps back here, the errors are printed below
+    jmp_buf on_error;
+    Scanner_source kept = {.data = NULL, .len = 0, .pos = 0, .is_mapped = false};
+    while (true)
+    {
+        ctx->on_error = &on_error;
+        if (setjmp(on_error) == 0)
+        {
+            compile_stages(ctx, paths, path_count, data, len, options, kept);
+        }
+        ctx->on_error = NULL;
+        func_pool_join(); // an error of the parser leaves the pool running
+
+        // a body left out of the source is needed after all, the code of the run is not used
+        bool failed = ctx->error_st != NULL && !Error_stack_empty(ctx->error_st);
+        if (!func_cache_again(failed))
+        {
+            break;
+        }
+        kept = func_cache_take_source();
+        compiler_reset(ctx);
+        ctx->cache_reuse = false;
+    }
+
+    // if there were any errors, print them, the code is printed only if there were none
+    Error_code error_code = print_errors();
+    if (error_code == NO_ERR)
+    {
+        if (ctx->cache_dir != NULL)
+        {
+            func_cache_store(); // only the code of a successful compilation is reused
+        }
+        print_out_code(out);
+    }
+    return error_code;
+}
+
+Error_code compiler_run(Compiler *ctx, const char *source_path, Compiler_options options, FILE *out)
+{
+    return compile(ctx, &source_path, 1, NULL, 0, options, out);
+}
+
+Error_code compiler_run_buffer(Compiler *ctx, char *data, size_t len, Compiler_options options, FILE *out)
+{
+    return compile(ctx, NULL, 0, data, len, options, out);
+}
+
+Error_code compiler_run_files(Compiler *ctx, const char *const *paths, int count, Compiler_options options, FILE *out)
+{
+    return compile(ctx, paths, count, NULL, 0, options, out);
+}
+
+/// BATCH
+
+/**
+ * @brief - Files of a batch, the threads take the next file to compile under the lock
+ * @param dir - directory with the source files
+ * @param out_dir - directory for the results
+ * @param options - how each file is compiled
+ * @param names - names of the source files, sorted
+ * @param codes - exit codes of the compilations
+ * @param count - count of the files
+ * @param next - index of the next file to compile
+ * @param lock - lock of next
+ */
+typedef struct
+{
+    const char *dir;
+    const char *out_dir;
+    Compiler_options options;
+    char **names;
+    Error_code *codes;
+    size_t count;
+    size_t next;
+    pthread_mutex_t lock;
+} Batch;
+
+static char *batch_path(const char *dir, const char *name, size_t name_len, const char *suffix)
+{
+    size_t len = strlen(dir) + 1 + name_len + strlen(suffix) + 1;
+    char *path = malloc(len);
+    if (path != NULL)
+    {
+        snprintf(path, len, "%s/%.*s%s", dir, (int)name_len, name, suffix);
+    }
+    return path;
+}
+
+static Error_code batch_compile_file(Batch *batch, Compiler *ctx, const char *name)
+{
+    size_t stem_len = strlen(name) - strlen(".swift");
+    char *source_path = batch_path(batch->dir, name, strlen(name), "");
+    char *code_path = batch_path(batch->out_dir, name, stem_len, ".ifjcode");
+    char *err_path = batch_path(batch->out_dir, name, stem_len, ".err");
+    FILE *code_file = code_path != NULL ? fopen(code_path, "w") : NULL;
+    FILE *err_file = err_path != NULL ? fopen(err_path, "w") : NULL;
+
+    Error_code code = INTERNAL_ERR;
+    if (source_path != NULL && code_file != NULL && err_file != NULL)
+    {
+        ctx->diagnostics = err_file;
+        code = compiler_run(ctx, source_path, batch->options, code_file);
+        compiler_reset(ctx);
+    }
+
+    if (code_file != NULL)
+    {
+        fclose(code_file);
+    }
+    if (err_file != NULL)
+    {
+        fclose(err_file);
+    }
+    free(source_path);
+    free(code_path);
+    free(err_path);
+    return code;
+}
+
+static void *batch_worker(void *arg)
+{
+    Batch *batch = arg;
+    Compiler *ctx = malloc(sizeof(Compiler));
+    if (ctx == NULL)
+    {
+        return NULL;
+    }
+    compiler_init(ctx, stderr);
+    while (1)
+    {
+        pthread_mutex_lock(&batch->lock);
+        size_t i = batch->next++;
+        pthread_mutex_unlock(&batch->lock);
+        if (i >= batch->count)
+        {
+            break;
+        }
+        batch->codes[i] = batch_compile_file(batch, ctx, batch->names[i]);
+    }
+    compiler_free(ctx);
+    free(ctx);
+    return NULL;
+}
+
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/**
+ * @brief Lists the .swift files of the directory sorted by name, returns false if the directory cannot be read.
+ */
+static bool batch_list(Batch *batch)
+{
+    DIR *dir = opendir(batch->dir);
+    if (dir == NULL)
+    {
+        return false;
+    }
+    size_t cap = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        size_t len = strlen(entry->d_name);
+        if (len <= strlen(".swift") || strcmp(entry->d_name + len - strlen(".swift"), ".swift") != 0)
+        {
+            continue;
+        }
+        if (batch->count == cap)
+        {
+            cap = cap == 0 ? 64 : cap * 2;
+            char **names = realloc(batch->names, sizeof(char *) * cap);
+            if (names == NULL)
+            {
+                closedir(dir);
+                return false;
+            }
+            batch->names = names;
+        }
+        char *name = strdup(entry->d_name);
+        if (name == NULL)
+        {
+            closedir(dir);
+            return false;
+        }
+        batch->names[batch->count++] = name;
+    }
+    closedir(dir);
+    if (batch->count > 0)
+    {
+        qsort(batch->names, batch->count, sizeof(char *), compare_names);
+    }
+    return true;
+}
+
+int compile_batch(const char *dir, const char *out_dir, int threads, Compiler_options options)
+{
+    Batch batch = {.dir = dir, .out_dir = out_dir != NULL ? out_dir : dir, .options = options, .names = NULL, .codes = NULL, .count = 0, .next = 0};
+    bool listed = batch_list(&batch);
+    batch.codes = listed ? malloc(sizeof(Error_code) * (batch.count > 0 ? batch.count : 1)) : NULL;
+    if (batch.codes == NULL)
+    {
+        fprintf(stderr, "Cannot read directory %s.\n", dir);
+        for (size_t i = 0; i < batch.count; i++)
+        {
+            free(batch.names[i]);
+        }
+        free(batch.names);
+        return 1;
+    }
+    // a file no worker has compiled, because none could be started, is an internal error
+    for (size_t i = 0; i < batch.count; i++)
+    {
+        batch.codes[i] = INTERNAL_ERR;
+    }
+    pthread_mutex_init(&batch.lock, NULL);
+
+    if (threads <= 0)
+    {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = processors > 1 ? (int)processors : 1;
+    }
+    if ((size_t)threads > batch.count)
+    {
+        threads = batch.count > 0 ? (int)batch.count : 1;
+    }
+
+    // the calling thread is one of the workers
+    pthread_t *workers = malloc(sizeof(pthread_t) * (size_t)threads);
+    int started = 1;
+    for (; workers != NULL && started < threads; started++)
+    {
+        if (pthread_create(&workers[started], NULL, batch_worker, &batch) != 0)
+        {
+            break;
+        }
+    }
+    batch_worker(&batch);
+    for (int i = 1; workers != NULL && i < started; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    pthread_mutex_destroy(&batch.lock);
+
+    for (size_t i = 0; i < batch.count; i++)
+    {
+        printf("%s %d\n", batch.names[i], batch.codes[i]);
+        free(batch.names[i]);
+    }
+    free(batch.names);
+    free(batch.codes);
+    return 0;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file compiler.h
+ * @brief State of one compilation, several compilations may run at once on different threads.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include "scanner.h"
+#include "intern.h"
+#include "symtable.h"
+#include "ast.h"
+#include "error.h"
+#include "stack.h"
+#include "lazy.h"
+#include "link.h"
+#include "func_cache.h"
+
+/**
+ * @brief - Everything a compilation changes, the stages reach it through the compiler pointer of their thread
+ *
+ * Scanner:
+ * @param source - source code buffer
+ * @param main_lexer - lexer reading the source for the parser
+ * @param token_buffer - pre-tokenized input
+ * @param token_ring - tokens read ahead and kept for return_token
+ * @param intern - identifiers and literals
+ * @param files - source files of a program of several files in the order of the command line, NULL for one input
+ * @param file_count - count of files
+ *
+ * Parser and semantic analysis:
+ * @param sym_st - stack of the scopes
+ * @param func_index - signatures of all the functions of the program
+ * @param func_index_complete - the whole program has been indexed
+ * @param gen_id_idx_cnt - counter of the generated identifier suffixes
+ * @param ast - syntax tree arena
+ * @param expr_stacks - stacks of the expressions, the first expr_stacks_count are being parsed, the rest are reused
+ * @param expr_stacks_count - count of the stacks being used
+ * @param expr_stacks_made - count of the stacks allocated
+ * @param expr_stacks_cap - capacity of expr_stacks
+ *
+ * Code generation:
+ * @param out_code_file - file the code is generated to
+ * @param while_def_out_code_file - file of the code outside of the outermost loop
+ * @param is_in_loop - the code of a loop is being generated, variables are defined before it
+ * @param loop_depth - count of the nested loops being generated
+ * @param if_counter - counter of the if statement labels
+ * @param while_counter - counter of the while loop labels
+ * @param tmp_counter - counter of the temporary variables
+ * @param label_counter - counter of the other labels
+ * @param else_label_st - labels of the if statements being generated
+ * @param while_label_st - labels of the loops being generated
+ * @param label_prefix - prefix of the labels of the function being generated, NULL outside of functions ($main$ is used)
+ * @param outer_counters - if, while, tmp and label counters of the code around the function being generated
+ *
+ * Function cache:
+ * @param cache_dir - directory of the cached function code, NULL if the cache is not used
+ * @param cache_reuse - the bodies of the cached functions are left out of the source, false when compiling again
+ * @param cache_retry - a body left out is needed, the compilation is to be run again with all of the bodies
+ * @param cache_pack - entries read from the cache directory, NULL if there are none
+ * @param cache_funcs - functions of the global block found by the skim of the source
+ * @param cache_source - source read before the bodies were left out, its data is NULL if none has been
+ * @param cache_stores - functions generated by this compilation, they are stored once it succeeds
+ *
+ * Function pool:
+ * @param parent - compilation whose function body this one parses, its identifiers are interned to the parent
+ * @param func_threads - count of threads parsing the function bodies, 0 parses them with the rest of the program
+ * @param func_pool - threads parsing the function bodies of this compilation, NULL until the first body is handed over
+ *
+ * Lazy compilation:
+ * @param lazy - only the functions reachable from the code outside of the functions are compiled
+ * @param lazy_check - the unreachable functions are parsed and checked, only their code is not generated
+ * @param lazy_funcs - functions of the global block sorted by the name, NULL if all of them are compiled
+ * @param lazy_func_count - count of lazy_funcs
+ *
+ * Errors:
+ * @param error_st - reported errors
+ * @param diagnostics - errors are printed to this stream
+ * @param on_error - throw_error jumps here after the error is reported, exits the process if it is NULL
+ * @param thread - thread running the compilation, the other threads exit on error unless they are helpers
+ * @param helper_error - first error of the helper threads lexing the chunks, its code is NO_ERR if there is none
+ * @param helper_lock - lock of helper_error
+ * @param poisoned - names declared by the statements with syntax or semantic errors, NULL until there is any
+ * @param poisoned_count - count of poisoned
+ * @param poisoned_cap - capacity of poisoned
+ * @param is_cascade - the statement being parsed has used a poisoned name, its error only repeats an earlier one
+ */
+typedef struct Compiler
+{
+    Scanner_source source;
+    Lexer main_lexer;
+    Token_buffer token_buffer;
+    Token_ring token_ring;
+    Intern_table intern;
+    Source_file *files;
+    size_t file_count;
+
+    symtable_stack *sym_st;
+    symtable func_index;
+    bool func_index_complete;
+    unsigned long gen_id_idx_cnt;
+    Ast_arena ast;
+    void **expr_stacks;
+    size_t expr_stacks_count;
+    size_t expr_stacks_made;
+    size_t expr_stacks_cap;
+
+    FILE *out_code_file;
+    FILE *while_def_out_code_file;
+    bool is_in_loop;
+    int loop_depth;
+    int if_counter;
+    int while_counter;
+    int tmp_counter;
+    int label_counter;
+    int_stack *else_label_st;
+    int_stack *while_label_st;
+    char *label_prefix;
+    int outer_counters[4];
+
+    const char *cache_dir;
+    bool cache_reuse;
+    bool cache_retry;
+    struct Func_cache_pack *cache_pack;
+    Func_cache_list cache_funcs;
+    Scanner_source cache_source;
+    Func_cache *cache_stores;
+
+    struct Compiler *parent;
+    int func_threads;
+    struct Func_pool *func_pool;
+
+    bool lazy;
+    bool lazy_check;
+    Lazy_func *lazy_funcs;
+    size_t lazy_func_count;
+
+    Error_stack *error_st;
+    FILE *diagnostics;
+    jmp_buf *on_error;
+    pthread_t thread;
+    Error helper_error;
+    pthread_mutex_t helper_lock;
+    char **poisoned;
+    size_t poisoned_count;
+    size_t poisoned_cap;
+    bool is_cascade;
+} Compiler;
+
+/**
+ * @brief - How the source is read and compiled
+ * @param pretokenize - tokenize the whole input before parsing
+ * @param lex_threads - count of threads to lex with, 0 chooses it by the input size
+ * @param cache_dir - directory of the function code cache, NULL compiles everything
+ * @param func_threads - count of threads parsing and generating the function bodies, 0 does it on the parser thread
+ * @param lazy - compile only the functions the program can call, the whole input is tokenized at once
+ * @param lazy_check - with lazy, parse and check the functions that are not compiled
+ */
+typedef struct
+{
+    bool pretokenize;
+    int lex_threads;
+    const char *cache_dir;
+    int func_threads;
+    bool lazy;
+    bool lazy_check;
+} Compiler_options;
+
+/**
+ * Compilation run by the current thread
+ */
+extern __thread Compiler *compiler;
+
+/**
+ * @brief Prepares a new compilation and makes it current for the calling thread.
+ *
+ * @param ctx the compilation
+ * @param diagnostics stream the errors are printed to
+ */
+void compiler_init(Compiler *ctx, FILE *diagnostics);
+
+/**
+ * @brief Releases everything the compilation has allocated.
+ *
+ * @param ctx the compilation
+ */
+void compiler_free(Compiler *ctx);
+
+/**
+ * @brief Releases the state of the last run so the compilation can be run again, the output file is kept.
+ *
+ * @param ctx the compilation
+ */
+void compiler_reset(Compiler *ctx);
+
+/**
+ * @brief Compiles the source file, the errors are reported to the diagnostics stream of the compilation.
+ *
+ * @param ctx compilation prepared by compiler_init
+ * @param source_path path of the source file, stdin is read if it is NULL
+ * @param options how the source is read
+ * @param out the code is written here if the compilation succeeds
+ * @return Error_code - code of the first error, NO_ERR on success
+ */
+Error_code compiler_run(Compiler *ctx, const char *source_path, Compiler_options options, FILE *out);
+
+/**
+ * @brief Compiles the source loaded in memory, like compiler_run.
+ *
+ * @param ctx compilation prepared by compiler_init
+ * @param data characters of the source allocated by malloc, the compilation frees them
+ * @param len count of the characters
+ * @param options how the source is read
+ * @param out the code is written here if the compilation succeeds
+ * @return Error_code - code of the first error, NO_ERR on success
+ */
+Error_code compiler_run_buffer(Compiler *ctx, char *data, size_t len, Compiler_options options, FILE *out);
+
+/**
+ * @brief Compiles the program of several source files, like compiler_run. The files are read on lex_threads threads
+ * (0 chooses the count by the processors) and linked in the order of the paths.
+ *
+ * @param ctx compilation prepared by compiler_init
+ * @param paths paths of the source files
+ * @param count count of paths
+ * @param options how the sources are read
+ * @param out the code is written here if the compilation succeeds
+ * @return Error_code - code of the first error, NO_ERR on success
+ */
+Error_code compiler_run_files(Compiler *ctx, const char *const *paths, int count, Compiler_options options, FILE *out);
+
+/**
+ * @brief Compiles all the .swift files of the directory on several threads. For every file name.swift, the code
+ * is written to name.ifjcode and the errors to name.err in the output directory, and a line with the name and the
+ * exit code is printed to stdout.
+ *
+ * @param dir directory with the source files
+ * @param out_dir directory for the results, dir is used if it is NULL
+ * @param threads count of threads, 0 uses one thread per processor
+ * @param options how each file is compiled
+ * @return int - 0 if all the files have been compiled (successfully or not), 1 if the directory cannot be read
+ */
+int compile_batch(const char *dir, const char *out_dir, int threads, Compiler_options options);
+
+#endif // COMPILER_H
@@ -11,62 +11,136 @@
  */
 
 #include "error.h"
+#include "compiler.h"
 
 DEFINE_STACK_FUNCTIONS(Error)
 
-static Error_stack *error_st = NULL;
+__thread jmp_buf *helper_on_error = NULL;
 
 void throw_error_base(Error_code code, char *message, int line_num)
 {
-    if (error_st == NULL)
+    // a helper thread shares the compilation, it keeps the first error for the thread running it and stops
+    if (helper_on_error != NULL)
     {
+        pthread_mutex_lock(&compiler->helper_lock);
+        if (compiler->helper_error.code == NO_ERR)
+        {
+            compiler->helper_error = (Error){.code = code, .line_num = line_num, .message = message};
+            message = NULL;
+        }
+        pthread_mutex_unlock(&compiler->helper_lock);
+        free(message);
+        longjmp(*helper_on_error, 1);
+    }
 
-        error_st = Error_stack_init();
-        if (error_st == NULL)
+    if (compiler->error_st == NULL)
+    {
+
+        compiler->error_st = Error_stack_init();
+        if (compiler->error_st == NULL)
         {
             return;
         }
     }
-    Error_stack_push(error_st, (Error){
-                                   .code = code,
-                                   .line_num = line_num,
-                                   .message = message});
+    Error_stack_push(compiler->error_st, (Error){
+                                             .code = code,
+                                             .line_num = line_num,
+                                             .message = message});
 
+    // the compilation is abandoned, only the thread running it can jump back to compiler_run
+    if (compiler->on_error != NULL && pthread_equal(pthread_self(), compiler->thread))
+    {
+        longjmp(*compiler->on_error, 1);
+    }
     exit(print_errors());
 }
 
+void throw_helper_error()
+{
+    Error error = compiler->helper_error;
+    if (error.code != NO_ERR)
+    {
+        compiler->helper_error = (Error){.code = NO_ERR, .line_num = 0, .message = NULL};
+        throw_error_base(error.code, error.message, (int)error.line_num);
+    }
+}
+
 Error_code print_errors()
 {
-    if (error_st == NULL || Error_stack_empty(error_st))
+    if (compiler->error_st == NULL || Error_stack_empty(compiler->error_st))
     {
         // fprintf_green(stderr, "✅ The compiler found no errors.\n");
         return NO_ERR;
     }
 
-    int first_error_code = NO_ERR;
-
-    fprintf(stderr, "\nCOMPILER FOUND ");
-    fprintf_red(stderr, "%d ERRORS:\n\n", error_st->size);
+    fprintf(compiler->diagnostics, "\nCOMPILER FOUND ");
+    fprintf_red(compiler->diagnostics, "%d ERRORS:\n\n", compiler->error_st->size);
 
-    while (!Error_stack_empty(error_st))
+    // the errors are printed in the order they have been reported, the first one gives the code
+    Error_node *reversed = NULL;
+    while (compiler->error_st->top != NULL)
     {
-        first_error_code = Error_stack_top(error_st).code;
-        printError(Error_stack_pop(error_st));
+        Error_node *node = compiler->error_st->top;
+        compiler->error_st->top = node->next;
+        node->next = reversed;
+        reversed = node;
+    }
+    compiler->error_st->size = 0;
+    Error_code first_error_code = reversed->data.code;
+    while (reversed != NULL)
+    {
+        Error_node *node = reversed;
+        reversed = node->next;
+        printError(node->data);
+        free(node->data.message);
+        free(node);
     }
 
-    Error_stack_free(error_st);
+    Error_stack_free(compiler->error_st);
+    compiler->error_st = NULL;
 
     return first_error_code;
 }
 
+void add_error_by_line(Error error)
+{
+    if (compiler->error_st == NULL)
+    {
+        compiler->error_st = Error_stack_init();
+    }
+    Error_stack_push(compiler->error_st, error);
+
+    // the error sinks below the errors of its line and the later lines, a function body comes before the rest of the
+    // line of its closing brace
+    Error_node **link = &compiler->error_st->top;
+    Error_node *node = *link;
+    *link = node->next;
+    while (*link != NULL && (int)(*link)->data.line_num >= (int)error.line_num)
+    {
+        link = &(*link)->next;
+    }
+    node->next = *link;
+    *link = node;
+}
+
 void printError(Error error)
 {
-    fprintf(stderr, "code:");
-    fprintf_red(stderr, "%d", error.line_num);
-    fprintf(stderr, ": ");
-    fprintf_red(stderr, "error: ");
+    // the lines of a program of several files are printed as the lines of the file
+    const Source_file *file = link_file_of_line((int)error.line_num);
+    if (file != NULL)
+    {
+        fprintf(compiler->diagnostics, "%s:", file->path);
+        fprintf_red(compiler->diagnostics, "%d", (int)error.line_num - file->first_line + 1);
+    }
+    else
+    {
+        fprintf(compiler->diagnostics, "code:");
+        fprintf_red(compiler->diagnostics, "%d", error.line_num);
+    }
+    fprintf(compiler->diagnostics, ": ");
+    fprintf_red(compiler->diagnostics, "error: ");
     printErrorCode(error.code);
-    fprintf_red(stderr, "%s\n\n", error.message);
+    fprintf_red(compiler->diagnostics, "%s\n\n", error.message);
 }
 
 void printErrorCode(Error_code code)
@@ -74,38 +148,38 @@ void printErrorCode(Error_code code)
     switch (code)
     {
     case LEXICAL_ERR:
-        fprintf_red(stderr, "LEXICAL_ERR");
+        fprintf_red(compiler->diagnostics, "LEXICAL_ERR");
         break;
     case SYNTACTIC_ERR:
-        fprintf_red(stderr, "SYNTACTIC_ERR");
+        fprintf_red(compiler->diagnostics, "SYNTACTIC_ERR");
         break;
     case FUNCTIONS_ERR:
-        fprintf_red(stderr, "FUNCTIONS_ERR");
+        fprintf_red(compiler->diagnostics, "FUNCTIONS_ERR");
         break;
     case PARAM_TYPE_ERR:
-        fprintf_red(stderr, "PARAM_TYPE_ERR");
+        fprintf_red(compiler->diagnostics, "PARAM_TYPE_ERR");
         break;
     case VARIABLES_ERR:
-        fprintf_red(stderr, "VARIABLES_ERR");
+        fprintf_red(compiler->diagnostics, "VARIABLES_ERR");
         break;
     case RETURN_ERR:
-        fprintf_red(stderr, "RETURN_ERR");
+        fprintf_red(compiler->diagnostics, "RETURN_ERR");
         break;
     case COMPATIBILITY_ERR:
-        fprintf_red(stderr, "COMPATIBILITY_ERR");
+        fprintf_red(compiler->diagnostics, "COMPATIBILITY_ERR");
         break;
     case TYPE_ERR:
-        fprintf_red(stderr, "TYPE_ERR");
+        fprintf_red(compiler->diagnostics, "TYPE_ERR");
         break;
     case SEMANTICS_ERR:
-        fprintf_red(stderr, "SEMANTICS_ERR");
+        fprintf_red(compiler->diagnostics, "SEMANTICS_ERR");
         break;
     case INTERNAL_ERR:
-        fprintf_red(stderr, "INTERNAL_ERR");
+        fprintf_red(compiler->diagnostics, "INTERNAL_ERR");
         break;
     default:
-        fprintf_red(stderr, "UNKNOWN_ERR");
+        fprintf_red(compiler->diagnostics, "UNKNOWN_ERR");
         break;
     }
-    fprintf_red(stderr, "\n");
+    fprintf_red(compiler->diagnostics, "\n");
 }
\ No newline at end of file
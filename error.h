@@ -10,6 +10,7 @@
 #define IFJ23_ERROR_H
 
 #include <stdlib.h>
+#include <setjmp.h>
 #include "colorful_printf.h"
 #include "scanner.h"
 
@@ -63,14 +64,30 @@ DECLARE_STACK_FUNCTIONS(Error)
  * @param line_num the line number where the error situates
  * @param message message to go along with the error
  */
+// jump target of a thread lexing a chunk of the compilation, throw_error records the error in the compilation and
+// jumps here, NULL on the other threads
+extern __thread jmp_buf *helper_on_error;
+
 void throw_error_base(Error_code code, char *message, int line_num);
 
+// throws the error recorded by the helper threads on the thread running the compilation, once they have finished
+void throw_helper_error();
+
 /**
- * @brief Sorts and prints all the errors in the stack ordered by the line number.
+ * @brief Prints all the errors in the stack in the order they have been reported and empties the stack.
  *
+ * @return Error_code - code of the first error reported, NO_ERR if there is none
  */
 Error_code print_errors();
 
+/**
+ * @brief Adds an error found apart from the parser, it is put before the errors reported on its line and the later
+ * lines. The errors of one line added this way come out in the reverse order of adding.
+ *
+ * @param error error to add, the stack takes its message
+ */
+void add_error_by_line(Error error);
+
 /**
  * @brief Prints the error structure in a human readable format.
  *
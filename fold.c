@@ -0,0 +1,401 @@
+/**
+ * @file fold.c
+ * @brief Folding of the expressions of literals into literals while the PSA reduces them.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include "fold.h"
+#include "compiler.h"
+
+/**
+ * @brief - Value of a literal
+ * @param type - type of the literal
+ * @param int_value - value of TYPE_INT
+ * @param double_value - value of TYPE_DOUBLE
+ * @param bool_value - value of TYPE_BOOL
+ * @param string_value - value of TYPE_STRING
+ */
+typedef struct
+{
+    Expression_type type;
+    int64_t int_value;
+    double double_value;
+    bool bool_value;
+    const char *string_value;
+} Fold_value;
+
+static bool is_literal(Ast_expr *expr)
+{
+    return expr != NULL && expr->kind == AST_LITERAL;
+}
+
+/**
+ * @brief Reads the value of the literal, false if the value is not known exactly.
+ */
+static bool fold_read(Ast_expr *expr, Fold_value *value)
+{
+    const char *text = expr->data.literal.value;
+    value->type = expr->type;
+    switch (expr->type)
+    {
+    case TYPE_INT:
+        if (expr->data.literal.literal != NULL)
+        {
+            // the scanner decodes a literal out of the range as INT64_MAX
+            value->int_value = expr->data.literal.literal->value.int_value;
+            return value->int_value != INT64_MAX;
+        }
+        errno = 0;
+        value->int_value = strtoll(text, NULL, 10);
+        return errno == 0;
+    case TYPE_DOUBLE:
+        value->double_value = expr->data.literal.literal != NULL ? expr->data.literal.literal->value.double_value
+                                                                 : strtod(text, NULL);
+        return isfinite(value->double_value);
+    case TYPE_STRING:
+        value->string_value = text;
+        return true;
+    case TYPE_BOOL:
+        value->bool_value = strcmp(text, "true") == 0;
+        return true;
+    case TYPE_NIL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Allocates the text of the literal and its IFJcode23 operand, the prefix is followed by the encoded text.
+ */
+static Token fold_token(Token_type type, const char *text, const char *prefix)
+{
+    size_t text_len = strlen(text);
+    char *value = ast_alloc(text_len + 1);
+    memcpy(value, text, text_len + 1);
+
+    size_t prefix_len = strlen(prefix);
+    size_t operand_len = prefix_len + (type == TOKEN_STRING ? string_operand_encode(text, NULL) : text_len);
+    Literal *literal = ast_alloc(sizeof(Literal) + operand_len + 1);
+    literal->operand_len = operand_len;
+    memcpy(literal->operand, prefix, prefix_len);
+    if (type == TOKEN_STRING)
+    {
+        string_operand_encode(text, literal->operand + prefix_len);
+    }
+    else
+    {
+        memcpy(literal->operand + prefix_len, text, text_len + 1);
+    }
+    return (Token){.type = type, .token_value = value, .preceded_by_nl = false, .line_num = 0, .literal = literal};
+}
+
+static Ast_expr *fold_literal(Fold_value value)
+{
+    char text[64];
+    Token token;
+    switch (value.type)
+    {
+    case TYPE_INT:
+        snprintf(text, sizeof(text), "%lld", (long long)value.int_value);
+        token = fold_token(TOKEN_INT, text, "int@");
+        token.literal->value.int_value = value.int_value;
+        break;
+    case TYPE_DOUBLE:
+        snprintf(text, sizeof(text), "%a", value.double_value);
+        token = fold_token(TOKEN_DOUBLE, text, "float@");
+        token.literal->value.double_value = value.double_value;
+        break;
+    case TYPE_STRING:
+        token = fold_token(TOKEN_STRING, value.string_value, "string@");
+        token.literal->value.int_value = 0;
+        break;
+    default:
+        // bool@ operands are formatted from the text
+        token = (Token){.type = TOKEN_BOOL, .token_value = value.bool_value ? "true" : "false", .literal = NULL};
+        break;
+    }
+    return ast_operand(token, value.type);
+}
+
+/// ARITHMETIC
+
+static bool add_overflows(int64_t l, int64_t r)
+{
+    return (r > 0 && l > INT64_MAX - r) || (r < 0 && l < INT64_MIN - r);
+}
+
+static bool sub_overflows(int64_t l, int64_t r)
+{
+    return (r < 0 && l > INT64_MAX + r) || (r > 0 && l < INT64_MIN + r);
+}
+
+static bool mul_overflows(int64_t l, int64_t r)
+{
+    if (l > 0)
+    {
+        return r > 0 ? l > INT64_MAX / r : r < INT64_MIN / l;
+    }
+    return r > 0 ? l < INT64_MIN / r : l != 0 && r < INT64_MAX / l;
+}
+
+/**
+ * @brief Computes the arithmetic operation, false if it is left to the runtime.
+ */
+static bool fold_arithmetic(Token_type op, Fold_value l, Fold_value r, Fold_value *result)
+{
+    if (l.type == TYPE_STRING)
+    {
+        // only + is defined for strings, the other operations fail at runtime
+        if (op != TOKEN_PLUS)
+        {
+            return false;
+        }
+        size_t l_len = strlen(l.string_value), r_len = strlen(r.string_value);
+        char *concat = ast_alloc(l_len + r_len + 1);
+        memcpy(concat, l.string_value, l_len);
+        memcpy(concat + l_len, r.string_value, r_len + 1);
+        result->string_value = concat;
+        return true;
+    }
+
+    if (l.type == TYPE_DOUBLE)
+    {
+        switch (op)
+        {
+        case TOKEN_PLUS:
+            result->double_value = l.double_value + r.double_value;
+            break;
+        case TOKEN_MINUS:
+            result->double_value = l.double_value - r.double_value;
+            break;
+        case TOKEN_MUL:
+            result->double_value = l.double_value * r.double_value;
+            break;
+        default:
+            if (r.double_value == 0.0)
+            {
+                return false;
+            }
+            result->double_value = l.double_value / r.double_value;
+            break;
+        }
+        return isfinite(result->double_value);
+    }
+
+    int64_t a = l.int_value, b = r.int_value;
+    switch (op)
+    {
+    case TOKEN_PLUS:
+        if (add_overflows(a, b))
+        {
+            return false;
+        }
+        result->int_value = a + b;
+        return true;
+    case TOKEN_MINUS:
+        if (sub_overflows(a, b))
+        {
+            return false;
+        }
+        result->int_value = a - b;
+        return true;
+    case TOKEN_MUL:
+        if (mul_overflows(a, b))
+        {
+            return false;
+        }
+        result->int_value = a * b;
+        return true;
+    default:
+        if (b == 0 || (a == INT64_MIN && b == -1))
+        {
+            return false;
+        }
+        // IDIV rounds towards minus infinity
+        result->int_value = a / b - (a % b != 0 && (a < 0) != (b < 0));
+        return true;
+    }
+}
+
+/**
+ * @brief Compares the values of the same type.
+ *
+ * @return int - negative, zero or positive as l is less than, equal to or greater than r
+ */
+static int fold_compare(Fold_value l, Fold_value r)
+{
+    switch (l.type)
+    {
+    case TYPE_INT:
+        return (l.int_value > r.int_value) - (l.int_value < r.int_value);
+    case TYPE_DOUBLE:
+        return (l.double_value > r.double_value) - (l.double_value < r.double_value);
+    case TYPE_STRING:
+        return strcmp(l.string_value, r.string_value);
+    case TYPE_BOOL:
+        return (int)l.bool_value - (int)r.bool_value;
+    default:
+        return 0; // nil
+    }
+}
+
+/// NODES
+
+/**
+ * @brief Converts the Int literal to a Double literal, NULL if it is not an Int literal.
+ */
+static Ast_expr *fold_int2double(Ast_expr *operand)
+{
+    Fold_value value;
+    if (!is_literal(operand) || !fold_read(operand, &value) || value.type != TYPE_INT)
+    {
+        return NULL;
+    }
+    value.type = TYPE_DOUBLE;
+    value.double_value = (double)value.int_value;
+    return fold_literal(value);
+}
+
+static Ast_expr *fold_binary(Ast_expr *expr)
+{
+    // the converted literal replaces the conversion
+    Ast_expr *converted = NULL;
+    switch (expr->data.binary.conversion)
+    {
+    case AST_CONVERT_LEFT:
+        if ((converted = fold_int2double(expr->data.binary.left)) != NULL)
+        {
+            expr->data.binary.left = converted;
+        }
+        break;
+    case AST_CONVERT_RIGHT:
+        if ((converted = fold_int2double(expr->data.binary.right)) != NULL)
+        {
+            expr->data.binary.right = converted;
+        }
+        break;
+    default:
+        break;
+    }
+    if (converted != NULL)
+    {
+        expr->data.binary.conversion = AST_CONVERT_NONE;
+    }
+
+    Fold_value l, r;
+    if (!is_literal(expr->data.binary.left) || !is_literal(expr->data.binary.right) ||
+        !fold_read(expr->data.binary.left, &l) || !fold_read(expr->data.binary.right, &r) || l.type != r.type)
+    {
+        return expr;
+    }
+
+    Fold_value result = {.type = expr->type};
+    Token_type op = expr->data.binary.op;
+    switch (op)
+    {
+    case TOKEN_PLUS:
+    case TOKEN_MINUS:
+    case TOKEN_MUL:
+    case TOKEN_DIV:
+        if (!fold_arithmetic(op, l, r, &result))
+        {
+            return expr;
+        }
+        break;
+    case TOKEN_EQ:
+        result.bool_value = fold_compare(l, r) == 0;
+        break;
+    case TOKEN_NEQ:
+        result.bool_value = fold_compare(l, r) != 0;
+        break;
+    case TOKEN_LESS:
+        result.bool_value = fold_compare(l, r) < 0;
+        break;
+    case TOKEN_MORE:
+        result.bool_value = fold_compare(l, r) > 0;
+        break;
+    case TOKEN_LESS_EQ:
+        result.bool_value = fold_compare(l, r) <= 0;
+        break;
+    case TOKEN_MORE_EQ:
+        result.bool_value = fold_compare(l, r) >= 0;
+        break;
+    case TOKEN_AND:
+        result.bool_value = l.bool_value && r.bool_value;
+        break;
+    case TOKEN_OR:
+        result.bool_value = l.bool_value || r.bool_value;
+        break;
+    default:
+        // the left operand of ?? is never a literal, the type check allows only the optional types
+        return expr;
+    }
+    return fold_literal(result);
+}
+
+/**
+ * @brief Folds the calls of the conversion functions.
+ */
+static Ast_expr *fold_call(Ast_expr *expr)
+{
+    Fold_value value;
+    if (expr->data.call.arg_count != 1 || !is_literal(expr->data.call.args[0]) ||
+        !fold_read(expr->data.call.args[0], &value))
+    {
+        return expr;
+    }
+
+    if (strcmp(expr->data.call.name, "Int2Double") == 0 && value.type == TYPE_INT)
+    {
+        return fold_int2double(expr->data.call.args[0]);
+    }
+    // FLOAT2INT truncates, the doubles out of the range of Int are left to the runtime
+    if (strcmp(expr->data.call.name, "Double2Int") == 0 && value.type == TYPE_DOUBLE &&
+        value.double_value >= -9223372036854775808.0 && value.double_value < 9223372036854775808.0)
+    {
+        value.type = TYPE_INT;
+        value.int_value = (int64_t)value.double_value;
+        return fold_literal(value);
+    }
+    return expr;
+}
+
+Ast_expr *fold_expr(Ast_expr *expr)
+{
+    switch (expr->kind)
+    {
+    case AST_BINARY:
+        return fold_binary(expr);
+    case AST_NOT:
+    {
+        Fold_value value;
+        if (is_literal(expr->data.operand) && fold_read(expr->data.operand, &value) && value.type == TYPE_BOOL)
+        {
+            value.bool_value = !value.bool_value;
+            return fold_literal(value);
+        }
+        return expr;
+    }
+    case AST_INT2DOUBLE:
+    {
+        Ast_expr *converted = fold_int2double(expr->data.operand);
+        return converted != NULL ? converted : expr;
+    }
+    case AST_CALL:
+        return fold_call(expr);
+    default:
+        return expr;
+    }
+}
@@ -0,0 +1,31 @@
+/**
+ * @file fold.h
+ * @brief Folding of the expressions of literals into literals while the PSA reduces them.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ * The values are computed as the interpreter of IFJcode23 computes them: the division of integers rounds towards minus
+ * infinity, Double2Int truncates and the doubles are written with %a. An operation whose result the interpreter would
+ * not compute the same way (division by zero, integer overflow, a result that is not a finite double) is left to run
+ * at runtime, so its errors are reported as before. The folded literals are not literals of the source, the implicit
+ * conversion of Int to Double is not allowed for them.
+ */
+
+#ifndef FOLD_H
+#define FOLD_H
+
+#include "ast.h"
+
+/**
+ * @brief Folds the node if its operands are literals. Binary operations, '!', the implicit conversion and the calls of
+ * Int2Double and Double2Int are folded, the Int literal operand of a Double operation is converted.
+ *
+ * @param expr node whose operands have been folded already
+ * @return Ast_expr* - the literal of the value, expr if it cannot be folded
+ */
+Ast_expr *fold_expr(Ast_expr *expr);
+
+#endif // FOLD_H
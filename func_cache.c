@@ -0,0 +1,891 @@
+/**
+ * @file func_cache.c
+ * @brief Cache of the generated code of the functions.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "func_cache.h"
+#include "semantic.h"
+#include "compiler.h"
+
+// changing the generated code or the layout of the file must change the format so the old entries are not used
+#define FUNC_CACHE_FORMAT "IFJC4"
+// the Makefile passes a checksum of the compiler sources, so a rebuilt compiler does not use the entries of
+// another build even when the format has not been changed by hand
+#ifndef FUNC_CACHE_BUILD
+#define FUNC_CACHE_BUILD "unversioned"
+#endif
+#define FUNC_CACHE_FILE "functions.ifjc"
+#define FUNC_CACHE_PATH_MAX 4096
+// the entries not used by the last compilations are dropped beyond this count
+#define FUNC_CACHE_MAX_ENTRIES 65536
+
+/**
+ * @brief - Entry of the cache file, the names and the code point into the contents of the file
+ * @param key - hash of the name and the characters of the body
+ * @param deps - hash of what the names of the body stood for
+ * @param names - names of the body, as in Func_cache
+ * @param names_len - length of names
+ * @param code - code of the function
+ * @param code_len - length of code
+ */
+typedef struct Func_cache_entry
+{
+    uint64_t key[2];
+    uint64_t deps[2];
+    const char *names;
+    size_t names_len;
+    const char *code;
+    size_t code_len;
+} Func_cache_entry;
+
+/**
+ * @brief - Entries read from the cache file
+ * @param data - contents of the file
+ * @param entries - the entries in the order of the file
+ * @param count - count of entries
+ * @param slots - open addressing table of the keys, index of the entry + 1, 0 is an empty slot
+ * @param mask - size of slots - 1, the size is a power of two
+ */
+typedef struct Func_cache_pack
+{
+    char *data;
+    Func_cache_entry *entries;
+    size_t count;
+    size_t *slots;
+    size_t mask;
+} Func_cache_pack;
+
+/// KEY
+
+/**
+ * @brief Adds the bytes to both halves of the key, FNV-1a and a multiply-rotate hash with another constant.
+ */
+static void key_add(uint64_t key[2], const void *data, size_t len)
+{
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < len; i++)
+    {
+        key[0] = (key[0] ^ bytes[i]) * 0x100000001b3ULL;
+        key[1] = (key[1] ^ bytes[i]) * 0x9e3779b97f4a7c15ULL;
+        key[1] = (key[1] << 29) | (key[1] >> 35);
+    }
+}
+
+/**
+ * @brief Adds the characters of a body to the key, eight at a time, the rest of them one by one.
+ */
+static void key_add_text(uint64_t key[2], const char *text, size_t len)
+{
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, text + i, sizeof(word));
+        key[0] = (key[0] ^ word) * 0xff51afd7ed558ccdULL;
+        key[0] ^= key[0] >> 33;
+        key[1] = (key[1] ^ word) * 0x9e3779b97f4a7c15ULL;
+        key[1] = (key[1] << 29) | (key[1] >> 35);
+    }
+    key_add(key, text + i, len - i);
+}
+
+static void key_add_int(uint64_t key[2], int64_t value)
+{
+    key_add(key, &value, sizeof(value));
+}
+
+static void key_add_str(uint64_t key[2], const char *str)
+{
+    // the length keeps the neighbouring strings apart
+    size_t len = str != NULL ? strlen(str) : 0;
+    key_add_int(key, str != NULL ? (int64_t)len : -1);
+    key_add(key, str, len);
+}
+
+static void key_init(uint64_t key[2])
+{
+    key[0] = 0xcbf29ce484222325ULL;
+    key[1] = 0x84222325cbf29ce4ULL;
+}
+
+static void key_add_signature(uint64_t key[2], symtable_item *func)
+{
+    if (func == NULL)
+    {
+        key_add_int(key, -1);
+        return;
+    }
+    FunctionData *data = func->data.func_data;
+    key_add_str(key, func->id);
+    key_add_int(key, data->return_type);
+    key_add_int(key, data->params_count);
+    for (int i = 0; i < data->params_count; i++)
+    {
+        key_add_str(key, data->params[i].name);
+        key_add_str(key, data->params[i].id);
+        key_add_int(key, data->params[i].type);
+    }
+}
+
+/**
+ * @brief Adds the name and what it stands for outside of the function, a function of the program or a global variable.
+ *
+ * @return false if the index of the functions is not complete
+ */
+static bool key_add_name(uint64_t key[2], char kind, char *name)
+{
+    key_add_int(key, kind);
+    key_add_str(key, name);
+
+    // the functions defined before are in the scopes, the index has the ones that follow, as for a call
+    bool complete = true;
+    bool is_cascade = compiler->is_cascade; // a name not found is not a use of it
+    symtable_item *func = symtable_find_in_stack(name, compiler->sym_st, true);
+    if (func == NULL || func->type != FUNCTION)
+    {
+        func = find_indexed_func(name, &complete);
+    }
+    key_add_signature(key, func);
+
+    symtable_item *var = symtable_find_in_stack(name, compiler->sym_st, false);
+    compiler->is_cascade = is_cascade;
+    if (var == NULL || var->type != VARIABLE)
+    {
+        key_add_int(key, -1);
+    }
+    else
+    {
+        key_add_int(key, var->scope);
+        key_add_int(key, var->data.var_data->type);
+        key_add_int(key, var->data.var_data->is_const);
+        key_add_int(key, var->data.var_data->is_initialized);
+    }
+    return complete;
+}
+
+/**
+ * @brief Starts the hash of what the names of the body of the function stand for with its header and scope.
+ */
+static void deps_init(uint64_t deps[2], symtable_item *func)
+{
+    key_init(deps);
+    key_add_signature(deps, func);
+    key_add_int(deps, compiler->sym_st->size);
+}
+
+/// FILE
+
+static void cache_path(char *path)
+{
+    snprintf(path, FUNC_CACHE_PATH_MAX, "%s/" FUNC_CACHE_FILE, compiler->cache_dir);
+}
+
+static Func_cache_entry *pack_find(Func_cache_pack *pack, const uint64_t key[2])
+{
+    if (pack == NULL)
+    {
+        return NULL;
+    }
+    for (size_t slot = key[0] & pack->mask; pack->slots[slot] != 0; slot = (slot + 1) & pack->mask)
+    {
+        Func_cache_entry *entry = &pack->entries[pack->slots[slot] - 1];
+        if (entry->key[0] == key[0] && entry->key[1] == key[1])
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void pack_free(Func_cache_pack *pack)
+{
+    if (pack != NULL)
+    {
+        free(pack->data);
+        free(pack->entries);
+        free(pack->slots);
+        free(pack);
+    }
+}
+
+/**
+ * @brief Reads the cache file, the entries follow the line with the format and the build. Each entry is made of the
+ * key, the hash of the names, the lengths of the names and the code, and then the names and the code themselves.
+ *
+ * @return Func_cache_pack* - the entries, NULL if the file cannot be read or belongs to another build
+ */
+static Func_cache_pack *pack_read(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    Func_cache_pack *pack = calloc(1, sizeof(Func_cache_pack));
+    long size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+    bool ok = pack != NULL && size > 0 && fseek(file, 0, SEEK_SET) == 0;
+    if (ok)
+    {
+        pack->data = malloc((size_t)size);
+        ok = pack->data != NULL && fread(pack->data, 1, (size_t)size, file) == (size_t)size;
+    }
+    fclose(file);
+
+    const char *header = FUNC_CACHE_FORMAT " " FUNC_CACHE_BUILD "\n";
+    size_t pos = strlen(header);
+    if (!ok || (size_t)size < pos || memcmp(pack->data, header, pos) != 0)
+    {
+        pack_free(pack);
+        return NULL;
+    }
+
+    // a cut entry ends the file, the entries before it are used
+    size_t len = (size_t)size, cap = 0;
+    uint64_t fields[6];
+    while (pos + sizeof(fields) <= len)
+    {
+        memcpy(fields, pack->data + pos, sizeof(fields));
+        pos += sizeof(fields);
+        if (fields[4] > len - pos || fields[5] > len - pos - fields[4])
+        {
+            break;
+        }
+        if (pack->count == cap)
+        {
+            cap = cap == 0 ? 256 : cap * 2;
+            Func_cache_entry *entries = realloc(pack->entries, sizeof(Func_cache_entry) * cap);
+            if (entries == NULL)
+            {
+                break;
+            }
+            pack->entries = entries;
+        }
+        pack->entries[pack->count++] = (Func_cache_entry){
+            .key = {fields[0], fields[1]},
+            .deps = {fields[2], fields[3]},
+            .names = pack->data + pos,
+            .names_len = fields[4],
+            .code = pack->data + pos + fields[4],
+            .code_len = fields[5],
+        };
+        pos += fields[4] + fields[5];
+    }
+
+    size_t slot_count = 16;
+    while (slot_count < pack->count * 2)
+    {
+        slot_count *= 2;
+    }
+    pack->slots = calloc(slot_count, sizeof(size_t));
+    if (pack->slots == NULL)
+    {
+        pack_free(pack);
+        return NULL;
+    }
+    pack->mask = slot_count - 1;
+    for (size_t i = 0; i < pack->count; i++)
+    {
+        if (pack_find(pack, pack->entries[i].key) == NULL)
+        {
+            size_t slot = pack->entries[i].key[0] & pack->mask;
+            while (pack->slots[slot] != 0)
+            {
+                slot = (slot + 1) & pack->mask;
+            }
+            pack->slots[slot] = i + 1;
+        }
+    }
+    return pack;
+}
+
+static bool entry_write(FILE *file, const uint64_t key[2], const uint64_t deps[2], const char *names,
+                        size_t names_len, const char *code, size_t code_len)
+{
+    uint64_t fields[6] = {key[0], key[1], deps[0], deps[1], names_len, code_len};
+    return fwrite(fields, sizeof(fields), 1, file) == 1 && fwrite(names, 1, names_len, file) == names_len &&
+           fwrite(code, 1, code_len, file) == code_len;
+}
+
+void func_cache_load()
+{
+    char path[FUNC_CACHE_PATH_MAX];
+    cache_path(path);
+    compiler->cache_pack = pack_read(path);
+}
+
+/// SKIM
+
+// the names are interned, so they are ordered by their addresses
+static int compare_funcs(const void *a, const void *b)
+{
+    uintptr_t name_a = (uintptr_t)((const Func_cache *)a)->name, name_b = (uintptr_t)((const Func_cache *)b)->name;
+    return (name_a > name_b) - (name_a < name_b);
+}
+
+static int compare_bodies(const void *a, const void *b)
+{
+    size_t start_a = (*(Func_cache *const *)a)->body_start, start_b = (*(Func_cache *const *)b)->body_start;
+    return (start_a > start_b) - (start_a < start_b);
+}
+
+static Func_cache *find_func(char *name)
+{
+    Func_cache key = {.name = name};
+    Func_cache_list *list = &compiler->cache_funcs;
+    return list->count > 0 ? bsearch(&key, list->funcs, list->count, sizeof(Func_cache), compare_funcs) : NULL;
+}
+
+/**
+ * @brief Sorts the functions by the name, only the functions defined once are cached.
+ */
+static void list_sort(Func_cache_list *list)
+{
+    if (list->count == 0)
+    {
+        return;
+    }
+    qsort(list->funcs, list->count, sizeof(Func_cache), compare_funcs);
+    for (size_t i = 0; i < list->count; i++)
+    {
+        bool same_before = i > 0 && list->funcs[i - 1].name == list->funcs[i].name;
+        bool same_after = i + 1 < list->count && list->funcs[i + 1].name == list->funcs[i].name;
+        list->funcs[i].is_unique = !same_before && !same_after;
+        list->funcs[i].hit = list->funcs[i].hit && list->funcs[i].is_unique;
+    }
+}
+
+static void list_append(Func_cache_list *list, const Func_cache *func)
+{
+    if (list->count == list->cap)
+    {
+        size_t cap = list->cap == 0 ? 64 : list->cap * 2;
+        Func_cache *funcs = realloc(list->funcs, sizeof(Func_cache) * cap);
+        if (funcs == NULL)
+        {
+            throw_error(INTERNAL_ERR, -1, "Memory allocation failed.");
+        }
+        list->funcs = funcs;
+        list->cap = cap;
+    }
+    list->funcs[list->count++] = *func;
+}
+
+static bool is_name_char(char c)
+{
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+/**
+ * @brief Reads the name of the function after the keyword func at the position.
+ *
+ * @return char* - the interned name, NULL if the keyword is not followed by a name
+ */
+static char *skim_header(const char *data, size_t pos, size_t len)
+{
+    if ((pos > 0 && is_name_char(data[pos - 1])) || pos + 4 > len || memcmp(data + pos, "func", 4) != 0 ||
+        (pos + 4 < len && is_name_char(data[pos + 4])))
+    {
+        return NULL;
+    }
+    pos += 4;
+    while (pos < len && isspace((unsigned char)data[pos]))
+    {
+        pos++;
+    }
+    size_t start = pos;
+    while (pos < len && is_name_char(data[pos]))
+    {
+        pos++;
+    }
+    bool is_name = pos > start && !isdigit((unsigned char)data[start]) && !(pos - start == 1 && data[start] == '_');
+    return is_name ? intern(data + start, pos - start) : NULL;
+}
+
+void func_cache_skim()
+{
+    // the files of a program are skimmed by the threads reading them, the cache belongs to the program
+    Compiler *owner = compiler->parent != NULL ? compiler->parent : compiler;
+    if (owner->cache_dir == NULL)
+    {
+        return;
+    }
+    const char *data = compiler->source.data;
+    size_t len = compiler->source.len;
+    Func_cache_list *list = &compiler->cache_funcs;
+
+    // the bodies are told apart by matching the braces outside of the strings and the commentaries
+    int depth = 0, line = 1;
+    size_t pos = 0, counted = 0, body = 0;
+    char *header = NULL, *current = NULL;
+    while (pos < len)
+    {
+        pos = depth == 0 ? scan_find_any(data, pos, len, "\"/{}f", 5) : scan_find_any(data, pos, len, "\"/{}", 4);
+        if (pos >= len)
+        {
+            break;
+        }
+        switch (data[pos])
+        {
+        case 'f':
+        {
+            char *name = skim_header(data, pos, len);
+            header = name != NULL ? name : header;
+            pos += name != NULL ? 4 : 1;
+            break;
+        }
+        case '{':
+            if (depth++ == 0 && header != NULL)
+            {
+                current = header;
+                header = NULL;
+                body = pos + 1;
+            }
+            pos++;
+            break;
+        case '}':
+            if (depth > 0 && --depth == 0 && current != NULL)
+            {
+                line += (int)scan_count(data, counted, pos, '\n', '\n');
+                counted = pos;
+                Func_cache func = {.name = current, .close_line = line, .body_start = body, .body_end = pos};
+                key_init(func.key);
+                key_add_str(func.key, current);
+                key_add_int(func.key, (int64_t)(pos - body));
+                key_add_text(func.key, data + body, pos - body);
+                list_append(list, &func);
+                current = NULL;
+            }
+            pos++;
+            break;
+        default:
+            pos = scan_skip_literal(data, pos, len);
+            break;
+        }
+    }
+    list_sort(list);
+    if (!owner->cache_reuse || owner->cache_pack == NULL)
+    {
+        return;
+    }
+
+    // the bodies in the cache are left out, only their newlines are kept so the lines do not change
+    Func_cache **hits = malloc(sizeof(Func_cache *) * list->count);
+    if (hits == NULL)
+    {
+        throw_error(INTERNAL_ERR, -1, "Memory allocation failed.");
+    }
+    size_t hit_count = 0;
+    for (size_t i = 0; i < list->count; i++)
+    {
+        Func_cache *func = &list->funcs[i];
+        func->entry = func->is_unique ? pack_find(owner->cache_pack, func->key) : NULL;
+        func->hit = func->entry != NULL;
+        if (func->hit)
+        {
+            hits[hit_count++] = func;
+        }
+    }
+    char *left = hit_count > 0 ? malloc(len) : NULL;
+    if (left == NULL)
+    {
+        free(hits);
+        if (hit_count > 0)
+        {
+            throw_error(INTERNAL_ERR, -1, "Memory allocation failed.");
+        }
+        return;
+    }
+    qsort(hits, hit_count, sizeof(Func_cache *), compare_bodies);
+    size_t left_len = 0, copied = 0;
+    for (size_t i = 0; i < hit_count; i++)
+    {
+        memcpy(left + left_len, data + copied, hits[i]->body_start - copied);
+        left_len += hits[i]->body_start - copied;
+        size_t newlines = scan_count(data, hits[i]->body_start, hits[i]->body_end, '\n', '\n');
+        memset(left + left_len, '\n', newlines);
+        left_len += newlines;
+        copied = hits[i]->body_end;
+    }
+    memcpy(left + left_len, data + copied, len - copied);
+    left_len += len - copied;
+    free(hits);
+
+    compiler->cache_source = compiler->source;
+    scanner_open_buffer(left, left_len);
+}
+
+void func_cache_add(Func_cache_list *list, int first_line)
+{
+    for (size_t i = 0; i < list->count; i++)
+    {
+        list->funcs[i].close_line += first_line - 1;
+        list_append(&compiler->cache_funcs, &list->funcs[i]);
+    }
+    free(list->funcs);
+    *list = (Func_cache_list){.funcs = NULL, .count = 0, .cap = 0};
+    list_sort(&compiler->cache_funcs);
+}
+
+/// CACHE
+
+/**
+ * @brief - Name used by a body, collected while the body is hashed
+ * @param name - interned name
+ * @param kind - 'F' function identifier, 'I' other identifier
+ */
+typedef struct
+{
+    char *name;
+    char kind;
+} Func_cache_name;
+
+static int compare_names(const void *a, const void *b)
+{
+    const Func_cache_name *na = a, *nb = b;
+    if (na->name != nb->name)
+    {
+        return ((uintptr_t)na->name > (uintptr_t)nb->name) - ((uintptr_t)na->name < (uintptr_t)nb->name);
+    }
+    return (na->kind > nb->kind) - (na->kind < nb->kind);
+}
+
+/**
+ * @brief Checks the function whose body has been left out, the closing brace must follow and the names of the body
+ * must stand for what they stood for when the code was stored.
+ */
+static bool check_hit(Func_cache *cache, symtable_item *func)
+{
+    // indexing the functions tokenizes the whole input, so the next token can be read ahead
+    bool complete;
+    (void)find_indexed_func(func->id, &complete);
+    Token token;
+    if (!token_stream_peek(0, &token) || token.type != TOKEN_R_CURLY || token.line_num != cache->close_line)
+    {
+        return false;
+    }
+    uint64_t deps[2];
+    deps_init(deps, func);
+    const char *names = cache->entry->names, *end = names + cache->entry->names_len;
+    while (names + 2 < end)
+    {
+        const char *name_end = memchr(names + 2, '\n', (size_t)(end - names - 2));
+        if (name_end == NULL)
+        {
+            return false;
+        }
+        (void)key_add_name(deps, names[0], intern(names + 2, (size_t)(name_end - names - 2)));
+        names = name_end + 1;
+    }
+    return deps[0] == cache->entry->deps[0] && deps[1] == cache->entry->deps[1];
+}
+
+/**
+ * @brief Hashes what the names of the body stand for, the body is read ahead up to its closing brace.
+ *
+ * @return false if the function cannot be cached
+ */
+static bool hash_body(Func_cache *cache, symtable_item *func)
+{
+    // indexing the functions tokenizes the whole input, so the body can be read ahead
+    bool complete;
+    (void)find_indexed_func(func->id, &complete);
+
+    Func_cache_name *names = NULL;
+    size_t count = 0, cap = 0;
+    int depth = 1;
+    Token token;
+    for (size_t k = 0;; k++)
+    {
+        if (!token_stream_peek(k, &token) || token.type == TOKEN_EOF)
+        {
+            free(names);
+            return false; // the body does not end, the parser reports it
+        }
+        if (token.type == TOKEN_L_CURLY)
+        {
+            depth++;
+        }
+        else if (token.type == TOKEN_R_CURLY && --depth == 0)
+        {
+            break;
+        }
+        else if (token.type == TOKEN_IDENTIFICATOR || token.type == TOKEN_FUNC_ID)
+        {
+            if (count == cap)
+            {
+                cap = cap == 0 ? 32 : cap * 2;
+                Func_cache_name *grown = realloc(names, sizeof(Func_cache_name) * cap);
+                if (grown == NULL)
+                {
+                    free(names);
+                    return false;
+                }
+                names = grown;
+            }
+            names[count++] = (Func_cache_name){.name = token.token_value,
+                                               .kind = token.type == TOKEN_FUNC_ID ? 'F' : 'I'};
+        }
+    }
+    // the lexer must have found the body where the skim has
+    if (token.line_num != cache->close_line)
+    {
+        free(names);
+        return false;
+    }
+
+    // each name once, with its kind and a newline
+    size_t unique = 0, names_len = 0;
+    if (count > 0)
+    {
+        qsort(names, count, sizeof(Func_cache_name), compare_names);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (unique == 0 || compare_names(&names[unique - 1], &names[i]) != 0)
+        {
+            names[unique++] = names[i];
+            names_len += strlen(names[i].name) + 3;
+        }
+    }
+    deps_init(cache->deps, func);
+    cache->names = ast_alloc(names_len + 1);
+    cache->names_len = names_len;
+    char *out = cache->names;
+    for (size_t i = 0; i < unique; i++)
+    {
+        complete = key_add_name(cache->deps, names[i].kind, names[i].name) && complete;
+        out += sprintf(out, "%c %s\n", names[i].kind, names[i].name);
+    }
+    free(names);
+    return complete; // a lexical error follows if not, the compilation fails
+}
+
+Func_cache *func_cache_lookup(symtable_item *func)
+{
+    Func_cache *cache = find_func(func->id);
+    if (cache == NULL || !cache->is_unique)
+    {
+        return NULL;
+    }
+    if (cache->hit)
+    {
+        if (!check_hit(cache, func))
+        {
+            // the body is needed, the code written until the compilation runs again is not used
+            compiler->cache_retry = true;
+        }
+        return cache;
+    }
+    return hash_body(cache, func) ? cache : NULL;
+}
+
+size_t func_cache_callees(char *name, char ***callees)
+{
+    Func_cache *cache = find_func(name);
+    if (cache == NULL || !cache->hit)
+    {
+        return 0;
+    }
+    const char *names = cache->entry->names, *end = names + cache->entry->names_len;
+    size_t count = 0;
+    for (const char *c = names; c < end; c++)
+    {
+        count += *c == '\n';
+    }
+    *callees = ast_alloc(sizeof(char *) * (count > 0 ? count : 1));
+    count = 0;
+    while (names + 2 < end)
+    {
+        const char *name_end = memchr(names + 2, '\n', (size_t)(end - names - 2));
+        if (name_end == NULL)
+        {
+            break;
+        }
+        if (names[0] == 'F')
+        {
+            (*callees)[count++] = intern(names + 2, (size_t)(name_end - names - 2));
+        }
+        names = name_end + 1;
+    }
+    return count;
+}
+
+bool func_cache_lower_begin(Func_cache *cache)
+{
+    if (cache == NULL)
+    {
+        return false;
+    }
+    if (cache->hit)
+    {
+        fwrite(cache->entry->code, 1, cache->entry->code_len, compiler->out_code_file);
+        return true;
+    }
+    cache->begin = ftell(compiler->out_code_file);
+    return false;
+}
+
+void func_cache_lower_end(Func_cache *cache)
+{
+    if (cache == NULL || cache->hit)
+    {
+        return;
+    }
+    cache->end = ftell(compiler->out_code_file);
+    cache->next = compiler->cache_stores;
+    compiler->cache_stores = cache;
+}
+
+/**
+ * @brief Writes the entries of the functions generated by the compilation, then the entries used by it and then the
+ * rest of the old ones, up to the most entries kept.
+ *
+ * @return true if all of the entries have been written
+ */
+static bool store_entries(FILE *file, Func_cache_pack *pack, bool *written)
+{
+    // the code of the functions is taken from the output read at once
+    FILE *out = compiler->out_code_file;
+    long out_len = fseek(out, 0, SEEK_END) == 0 ? ftell(out) : -1;
+    char *code = out_len > 0 && fseek(out, 0, SEEK_SET) == 0 ? malloc((size_t)out_len) : NULL;
+    bool ok = code != NULL && fread(code, 1, (size_t)out_len, out) == (size_t)out_len;
+    fseek(out, 0, SEEK_END);
+
+    size_t count = 0;
+    ok = ok && fprintf(file, FUNC_CACHE_FORMAT " " FUNC_CACHE_BUILD "\n") > 0;
+    for (Func_cache *cache = compiler->cache_stores; ok && cache != NULL; cache = cache->next)
+    {
+        if (cache->begin < 0 || cache->end < cache->begin || cache->end > out_len || count == FUNC_CACHE_MAX_ENTRIES)
+        {
+            continue;
+        }
+        ok = entry_write(file, cache->key, cache->deps, cache->names, cache->names_len, code + cache->begin,
+                         (size_t)(cache->end - cache->begin));
+        count++;
+
+        // the old entry of the key is replaced
+        Func_cache_entry *old = pack_find(pack, cache->key);
+        if (old != NULL)
+        {
+            written[old - pack->entries] = true;
+        }
+    }
+    for (int pass = 0; pass < 2 && pack != NULL; pass++)
+    {
+        if (pass == 0)
+        {
+            // the hits are written first, so the entries of the programs not compiled for long are dropped
+            Func_cache_list *list = &compiler->cache_funcs;
+            for (size_t i = 0; ok && i < list->count && count < FUNC_CACHE_MAX_ENTRIES; i++)
+            {
+                Func_cache_entry *entry = list->funcs[i].hit ? list->funcs[i].entry : NULL;
+                if (entry != NULL && !written[entry - pack->entries])
+                {
+                    written[entry - pack->entries] = true;
+                    ok = entry_write(file, entry->key, entry->deps, entry->names, entry->names_len, entry->code,
+                                     entry->code_len);
+                    count++;
+                }
+            }
+            continue;
+        }
+        for (size_t i = 0; ok && i < pack->count && count < FUNC_CACHE_MAX_ENTRIES; i++)
+        {
+            Func_cache_entry *entry = &pack->entries[i];
+            if (!written[i] && pack_find(pack, entry->key) == entry)
+            {
+                written[i] = true;
+                ok = entry_write(file, entry->key, entry->deps, entry->names, entry->names_len, entry->code,
+                                 entry->code_len);
+                count++;
+            }
+        }
+    }
+    free(code);
+    return ok;
+}
+
+void func_cache_store()
+{
+    if (compiler->cache_stores == NULL)
+    {
+        return; // every function has been taken from the cache
+    }
+    mkdir(compiler->cache_dir, 0777); // fails if it exists
+    fflush(compiler->out_code_file);
+
+    // the file is written under another name first, so a reader never sees a part of it
+    char path[FUNC_CACHE_PATH_MAX];
+    char tmp_path[FUNC_CACHE_PATH_MAX + 64];
+    cache_path(path);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%ld.%p.tmp", path, (long)getpid(), (void *)compiler);
+    Func_cache_pack *pack = compiler->cache_pack;
+    bool *written = calloc(pack != NULL && pack->count > 0 ? pack->count : 1, sizeof(bool));
+    FILE *file = written != NULL ? fopen(tmp_path, "wb") : NULL;
+    if (file != NULL)
+    {
+        bool ok = store_entries(file, pack, written);
+        if (fclose(file) != 0 || !ok || rename(tmp_path, path) != 0)
+        {
+            remove(tmp_path);
+        }
+    }
+    free(written);
+    compiler->cache_stores = NULL;
+}
+
+bool func_cache_again(bool failed)
+{
+    if (!compiler->cache_reuse || (!compiler->cache_retry && !failed))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < compiler->cache_funcs.count; i++)
+    {
+        if (compiler->cache_funcs.funcs[i].hit)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+Scanner_source func_cache_take_source()
+{
+    Scanner_source source = compiler->cache_source;
+    compiler->cache_source = (Scanner_source){.data = NULL, .len = 0, .pos = 0, .is_mapped = false};
+    return source;
+}
+
+void func_cache_free()
+{
+    pack_free(compiler->cache_pack);
+    compiler->cache_pack = NULL;
+    free(compiler->cache_funcs.funcs);
+    compiler->cache_funcs = (Func_cache_list){.funcs = NULL, .count = 0, .cap = 0};
+    Scanner_source source = func_cache_take_source();
+    if (source.is_mapped)
+    {
+        munmap(source.data, source.len);
+    }
+    else
+    {
+        free(source.data);
+    }
+    compiler->cache_stores = NULL; // allocated from the syntax tree arena
+    compiler->cache_retry = false;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file func_cache.h
+ * @brief Cache of the generated code of the functions, the code of an unchanged function is reused by the next
+ * compilation instead of lexing, parsing and generating the function again.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ * Before the source is lexed, one pass over its characters finds the functions of the global block and the braces of
+ * their bodies. The key of a function hashes its name and the characters of its body. The bodies whose key is in the
+ * cache are left out of the source - only their newlines are kept so the lines do not change - so the lexer and the
+ * parser only read the header of such a function.
+ *
+ * The code also depends on the headers of the functions and the global variables the body names. Each entry keeps
+ * these names and a hash of what they stood for, checked once the header of the function has been parsed. If a name
+ * has changed its meaning, the body left out is needed after all and the program is compiled again with all of the
+ * bodies. The label and temporary counters start from zero in every function, so the code does not depend on the
+ * code before it. All of the entries are kept in one file of the cache directory, read once per compilation and
+ * written again when a compilation adds any.
+ */
+
+#ifndef FUNC_CACHE_H
+#define FUNC_CACHE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "symtable.h"
+#include "ast.h"
+#include "scanner.h"
+
+/**
+ * @brief - Function of the global block found in the source, with its entry of the cache
+ * @param name - interned name of the function
+ * @param key - hash of the name and the characters of the body, two independent 64 bit halves
+ * @param body_start - offset of the first character of the body in the source
+ * @param body_end - offset of the closing brace of the body
+ * @param close_line - line of the closing brace of the body
+ * @param hit - the code is in the cache and the body has been left out of the source
+ * @param is_unique - the function is defined only once, a function defined twice is not cached
+ * @param entry - entry of the cache (hit)
+ * @param deps - hash of what the names of the body stand for (miss)
+ * @param names - names of the body, a line of the kind ('F' function, 'I' identifier) and the name for each (miss)
+ * @param names_len - length of names
+ * @param begin - offset of the code of the function in the output file (miss)
+ * @param end - offset after the code of the function
+ * @param next - next function to be stored
+ */
+typedef struct Func_cache
+{
+    char *name;
+    uint64_t key[2];
+    size_t body_start;
+    size_t body_end;
+    int close_line;
+    bool hit;
+    bool is_unique;
+    struct Func_cache_entry *entry;
+    uint64_t deps[2];
+    char *names;
+    size_t names_len;
+    long begin;
+    long end;
+    struct Func_cache *next;
+} Func_cache;
+
+/**
+ * @brief - Functions found by the skim of a source, allocated by malloc
+ * @param funcs - the functions, sorted by the name once the skim is done
+ * @param count - count of funcs
+ * @param cap - capacity of funcs
+ */
+typedef struct
+{
+    Func_cache *funcs;
+    size_t count;
+    size_t cap;
+} Func_cache_list;
+
+/**
+ * @brief Reads the entries of the cache directory of the compilation, a missing or damaged file is an empty cache.
+ */
+void func_cache_load();
+
+/**
+ * @brief Finds the functions of the source being opened and leaves out the bodies whose code is in the cache, the
+ * lexer reads the source without them and the source read is kept to be compiled again.
+ */
+void func_cache_skim();
+
+/**
+ * @brief Adds the functions found by the skim of a file of the program, the lines of the file start at first_line.
+ *
+ * @param list functions of the file, they are taken over
+ * @param first_line line of the program the file starts at
+ */
+void func_cache_add(Func_cache_list *list, int first_line);
+
+/**
+ * @brief Finds the function whose header has just been parsed and checks it, the next token is the first token of
+ * the body. Must be called while the global scope is on the top of the scope stack. A function left out of the source
+ * whose names have changed their meaning makes the compilation be run again.
+ *
+ * @param func function with the parsed header
+ * @return Func_cache* - the entry with the hit set if the code is in the cache, NULL if the function cannot be cached
+ */
+Func_cache *func_cache_lookup(symtable_item *func);
+
+/**
+ * @brief Lists the functions called by the body of the function that has been left out of the source.
+ *
+ * @param name interned name of the function
+ * @param callees the names of the called functions are stored here, allocated from the syntax tree arena
+ * @return size_t - count of the callees, 0 if the body has not been left out
+ */
+size_t func_cache_callees(char *name, char ***callees);
+
+/**
+ * @brief Starts the code of the function inside of its label scope, cached code is written out right away.
+ *
+ * @param cache entry of the function, may be NULL
+ * @return true if the cached code has been written and the function is not to be generated
+ */
+bool func_cache_lower_begin(Func_cache *cache);
+
+/**
+ * @brief Ends the generated code of the function, it is stored if the compilation succeeds.
+ *
+ * @param cache entry of the function, may be NULL
+ */
+void func_cache_lower_end(Func_cache *cache);
+
+/**
+ * @brief Stores the code of the functions generated by the successful compilation to the cache directory.
+ */
+void func_cache_store();
+
+/**
+ * @brief Tells whether the compilation is to be run again with all of the bodies: a body left out is needed after
+ * all, or the compilation has failed and the errors of the whole source are to be reported.
+ *
+ * @param failed the compilation has reported an error
+ * @return true if any body has been left out and it is to be run again
+ */
+bool func_cache_again(bool failed);
+
+/**
+ * @brief Takes the source read before the bodies were left out, so the program can be compiled again.
+ *
+ * @return Scanner_source - the source, its data is NULL if no body has been left out
+ */
+Scanner_source func_cache_take_source();
+
+/**
+ * @brief Releases the entries, the functions found and the source kept by the compilation.
+ */
+void func_cache_free();
+
+#endif // FUNC_CACHE_H
@@ -0,0 +1,570 @@
+/**
+ * @file func_pool.c
+ * @brief Pool of threads parsing, checking and generating the bodies of the functions.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include "func_pool.h"
+#include "parser.h"
+#include "lower.h"
+#include "compiler.h"
+
+/**
+ * @brief - Body of one function handed over to the pool
+ * @param func - copy of the function with the parsed header
+ * @param globals - copies of the global symbols named by the body, as they are at the header
+ * @param global_count - count of globals
+ * @param header - opening brace of the body
+ * @param tokens - token buffer of the program positioned at the first token of the body
+ * @param body_tokens - count of the tokens between the braces of the body
+ * @param code - code of the function generated by a worker, allocated by malloc
+ * @param code_len - length of code
+ * @param errors - errors of the body, the last one on the top, NULL if there is none
+ */
+struct Func_unit
+{
+    symtable_item *func;
+    symtable_item **globals;
+    size_t global_count;
+    Token header;
+    Token_buffer tokens;
+    size_t body_tokens;
+    char *code;
+    size_t code_len;
+    Error_stack *errors;
+};
+
+/**
+ * @brief - Threads of one compilation and the bodies they take in order under the lock
+ * @param program - compilation the bodies belong to
+ * @param func_index - index of the functions of the program, read by all the workers
+ * @param units - bodies handed over, in the order of the source
+ * @param count - count of units
+ * @param cap - capacity of units
+ * @param next - index of the next body to be taken by a worker
+ * @param closing - no more bodies come, the workers exit once units are taken
+ * @param threads - the workers
+ * @param thread_count - count of the started workers
+ * @param lock - lock of units, count, next and closing
+ * @param ready - signaled when a body is handed over or the pool is closing
+ */
+typedef struct Func_pool
+{
+    Compiler *program;
+    symtable func_index;
+    Func_unit **units;
+    size_t count;
+    size_t cap;
+    size_t next;
+    bool closing;
+    pthread_t *threads;
+    int thread_count;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+} Func_pool;
+
+/// WORKERS
+
+/**
+ * @brief Copies the generated code of the function out of the output file of the worker.
+ */
+static void unit_take_code(Func_unit *unit)
+{
+    FILE *out = compiler->out_code_file;
+    fflush(out);
+    long len = ftell(out);
+    unit->code = malloc(len > 0 ? (size_t)len : 1);
+    if (unit->code == NULL || len < 0 || fseek(out, 0, SEEK_SET) != 0 || fread(unit->code, 1, (size_t)len, out) != (size_t)len)
+    {
+        throw_error(INTERNAL_ERR, -1, "Cannot read the code of function %s.", unit->func->id);
+    }
+    unit->code_len = (size_t)len;
+}
+
+/**
+ * @brief Parses the body from its opening brace and generates the code of the function, the errors are kept in the
+ * unit. The parser continues after the errors as the parser of the program does, the code is not generated then.
+ */
+static void unit_run(Func_pool *pool, Compiler *ctx, Func_unit *unit)
+{
+    jmp_buf on_error;
+    ctx->on_error = &on_error;
+    if (setjmp(on_error) == 0)
+    {
+        // the tokens and the index of the functions belong to the program, they are only read
+        ctx->token_buffer = unit->tokens;
+        ctx->func_index = pool->func_index;
+        ctx->func_index_complete = true;
+        scanner_init();
+        if (ctx->out_code_file == NULL)
+        {
+            ctx->out_code_file = tmpfile();
+            if (ctx->out_code_file == NULL)
+            {
+                throw_error(INTERNAL_ERR, -1, "Cannot create temporary file for the output code.");
+            }
+        }
+
+        // the global scope holds just the symbols the body names
+        ctx->sym_st = symtable_stack_init();
+        symtable globals = symtable_init();
+        for (size_t i = 0; i < unit->global_count; i++)
+        {
+            symtable_add(unit->globals[i], globals);
+        }
+        symtable_stack_push(ctx->sym_st, globals);
+
+        sym_items *items = ast_alloc(sizeof(sym_items));
+        items->funcItem = unit->func;
+        items->varItem = init_symtable_item(false);
+        ast_program_begin();
+
+        // the header is parsed again, the parser of the program has checked it already
+        Token token = unit->header;
+        run_control(&token, items, FUNC_HEADER_DONE);
+        get_token(&token);
+        if (!parse_func_body(&token, items))
+        {
+            throw_error(SYNTACTIC_ERR, token.line_num, RED "Unexpected token: '%s'!" RESET "\n", token.token_value);
+        }
+        if (ctx->error_st == NULL || Error_stack_empty(ctx->error_st))
+        {
+            lower_block(ast_program_end());
+            unit_take_code(unit);
+        }
+    }
+    ctx->on_error = NULL;
+
+    // the program takes the errors once the workers have finished
+    unit->errors = ctx->error_st;
+    ctx->error_st = NULL;
+
+    ctx->token_buffer = (Token_buffer){.types = NULL, .count = 0, .cap = 0, .pos = 0, .is_active = false};
+    ctx->func_index = NULL;
+    compiler_reset(ctx);
+}
+
+/**
+ * @brief Takes the next body, waits for it if there is none yet.
+ *
+ * @return Func_unit* - the body, NULL if the pool is closing and all the bodies have been taken
+ */
+static Func_unit *pool_take(Func_pool *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    while (pool->next == pool->count && !pool->closing)
+    {
+        pthread_cond_wait(&pool->ready, &pool->lock);
+    }
+    Func_unit *unit = pool->next < pool->count ? pool->units[pool->next++] : NULL;
+    pthread_mutex_unlock(&pool->lock);
+    return unit;
+}
+
+static void *pool_worker(void *arg)
+{
+    Func_pool *pool = arg;
+    Compiler *ctx = malloc(sizeof(Compiler));
+    if (ctx == NULL)
+    {
+        return NULL;
+    }
+    compiler_init(ctx, NULL);
+    ctx->parent = pool->program;
+
+    Func_unit *unit;
+    while ((unit = pool_take(pool)) != NULL)
+    {
+        unit_run(pool, ctx, unit);
+    }
+
+    // the identifiers belong to the program
+    ctx->parent = NULL;
+    compiler_free(ctx);
+    free(ctx);
+    return NULL;
+}
+
+/// POOL
+
+/**
+ * @brief Starts the workers, the identifiers of the program are interned under the lock from now on.
+ *
+ * @return Func_pool* - the pool, NULL if no thread could be started
+ */
+static Func_pool *pool_start()
+{
+    Func_pool *pool = calloc(1, sizeof(Func_pool));
+    pthread_t *threads = calloc((size_t)compiler->func_threads, sizeof(pthread_t));
+    if (pool == NULL || threads == NULL)
+    {
+        free(pool);
+        free(threads);
+        return NULL;
+    }
+    pool->program = compiler;
+    pool->func_index = compiler->func_index;
+    pool->threads = threads;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->ready, NULL);
+
+    intern_set_concurrent(true);
+    while (pool->thread_count < compiler->func_threads &&
+           pthread_create(&pool->threads[pool->thread_count], NULL, pool_worker, pool) == 0)
+    {
+        pool->thread_count++;
+    }
+    if (pool->thread_count == 0)
+    {
+        intern_set_concurrent(false);
+        pthread_mutex_destroy(&pool->lock);
+        pthread_cond_destroy(&pool->ready);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+/**
+ * @brief Lets the workers finish the bodies handed over and waits for them.
+ */
+static void pool_stop(Func_pool *pool)
+{
+    if (pool->threads == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->closing = true;
+    pthread_cond_broadcast(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->thread_count; i++)
+    {
+        pthread_join(pool->threads[i], NULL);
+    }
+    free(pool->threads);
+    pool->threads = NULL;
+    intern_set_concurrent(false);
+}
+
+static void pool_add(Func_pool *pool, Func_unit *unit)
+{
+    pthread_mutex_lock(&pool->lock);
+    if (pool->count == pool->cap)
+    {
+        size_t cap = pool->cap == 0 ? 64 : pool->cap * 2;
+        Func_unit **units = realloc(pool->units, sizeof(Func_unit *) * cap);
+        if (units == NULL)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            throw_error(INTERNAL_ERR, -1, "Memory allocation for function pool failed.");
+        }
+        pool->units = units;
+        pool->cap = cap;
+    }
+    pool->units[pool->count++] = unit;
+    pthread_cond_signal(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/// BODIES
+
+static int compare_names(const void *a, const void *b)
+{
+    const char *x = *(char *const *)a, *y = *(char *const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Returns true if the global scope has a variable of the name.
+ */
+static bool is_global_var(symtable global, char *name)
+{
+    uint32_t bucket = hash(name);
+    for (symtable_item *item = bucket != (uint32_t)-1 && global->symtable != NULL ? global->symtable[bucket] : NULL; item != NULL; item = item->next)
+    {
+        if (item->id == name && item->type == VARIABLE)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static symtable_item *copy_item(symtable_item *item)
+{
+    symtable_item *copy = ast_alloc(sizeof(symtable_item));
+    *copy = *item;
+    copy->next = NULL;
+    if (item->type == VARIABLE)
+    {
+        copy->data.var_data = ast_alloc(sizeof(VariableData));
+        *copy->data.var_data = *item->data.var_data;
+    }
+    else
+    {
+        copy->data.func_data = ast_alloc(sizeof(FunctionData));
+        *copy->data.func_data = *item->data.func_data;
+    }
+    return copy;
+}
+
+/**
+ * @brief Copies the global symbols of the names, every name once, the symbols of one name keep their order.
+ */
+static void unit_copy_globals(Func_unit *unit, symtable global, char **names, size_t name_count)
+{
+    qsort(names, name_count, sizeof(char *), compare_names);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < name_count; i++)
+        {
+            uint32_t bucket = hash(names[i]);
+            if ((i > 0 && names[i] == names[i - 1]) || bucket == (uint32_t)-1 || global->symtable == NULL)
+            {
+                continue;
+            }
+            for (symtable_item *item = global->symtable[bucket]; item != NULL; item = item->next)
+            {
+                if (item->id == names[i])
+                {
+                    if (pass == 1)
+                    {
+                        unit->globals[count] = copy_item(item);
+                    }
+                    count++;
+                }
+            }
+        }
+        // the first pass counts the symbols
+        if (pass == 0)
+        {
+            unit->global_count = count;
+            unit->globals = ast_alloc(sizeof(symtable_item *) * (count > 0 ? count : 1));
+        }
+    }
+}
+
+/**
+ * @brief Reads ahead the body of the function whose header has just been parsed up to its closing brace.
+ *
+ * @param func function with the parsed header
+ * @param body_tokens count of the tokens between the braces is stored here
+ * @param names the names the body uses are stored here (allocated by malloc), NULL if they are not needed
+ * @param name_count count of the names
+ * @return false if the body does not end or if it assigns to a global variable
+ */
+static bool body_scan(symtable_item *func, size_t *body_tokens, char ***names, size_t *name_count)
+{
+    // indexing the functions tokenizes the whole input, so the body can be read ahead
+    bool complete;
+    (void)find_indexed_func(func->id, &complete);
+    if (!complete)
+    {
+        return false; // a lexical error follows, the compilation fails
+    }
+    symtable global = symtable_stack_top(compiler->sym_st);
+    size_t count = 0, cap = 64;
+    char **found = names != NULL ? malloc(sizeof(char *) * cap) : NULL;
+    int depth = 1;
+    Token token, next;
+    for (size_t k = 0;; k++)
+    {
+        if ((names != NULL && found == NULL) || !token_stream_peek(k, &token) || token.type == TOKEN_EOF)
+        {
+            free(found);
+            return false; // the body does not end, the parser reports it
+        }
+        if (token.type == TOKEN_L_CURLY)
+        {
+            depth++;
+        }
+        else if (token.type == TOKEN_R_CURLY && --depth == 0)
+        {
+            *body_tokens = k;
+            break;
+        }
+        if (token.type != TOKEN_IDENTIFICATOR && token.type != TOKEN_FUNC_ID)
+        {
+            continue;
+        }
+        if (token.type == TOKEN_IDENTIFICATOR && token_stream_peek(k + 1, &next) && next.type == TOKEN_ASSIGN &&
+            is_global_var(global, token.token_value))
+        {
+            // the assignment initializes the global variable for the code after the function
+            free(found);
+            return false;
+        }
+        if (names == NULL)
+        {
+            continue;
+        }
+        if (count == cap)
+        {
+            cap *= 2;
+            char **grown = realloc(found, sizeof(char *) * cap);
+            if (grown == NULL)
+            {
+                free(found);
+                return false;
+            }
+            found = grown;
+        }
+        found[count++] = token.token_value;
+    }
+    if (names != NULL)
+    {
+        *names = found;
+        *name_count = count;
+    }
+    return true;
+}
+
+Func_unit *func_pool_submit(symtable_item *func, Token *header)
+{
+    // the body up to its closing brace and the names it uses
+    symtable global = symtable_stack_top(compiler->sym_st);
+    size_t body_tokens, name_count;
+    char **names;
+    if (!body_scan(func, &body_tokens, &names, &name_count))
+    {
+        return NULL;
+    }
+
+    // the worker reads the body from the buffer, the tokens the ring has read ahead must be the ones in the buffer
+    Token_buffer *buffer = &compiler->token_buffer;
+    size_t unread = compiler->token_ring.count - compiler->token_ring.cursor;
+    size_t body_pos = buffer->pos - unread;
+    Token first, buffered;
+    if (!buffer->is_active || buffer->pos < unread || !token_stream_peek(0, &first) || body_pos >= buffer->count ||
+        body_pos >= buffer->error_pos)
+    {
+        free(names);
+        return NULL;
+    }
+    buffered = token_buffer_get(body_pos);
+    if (first.type != buffered.type || first.token_value != buffered.token_value || first.line_num != buffered.line_num)
+    {
+        free(names);
+        return NULL;
+    }
+
+    if (compiler->func_pool == NULL)
+    {
+        compiler->func_pool = pool_start();
+        if (compiler->func_pool == NULL)
+        {
+            free(names);
+            compiler->func_threads = 0; // the bodies are parsed by the program
+            return NULL;
+        }
+    }
+
+    Func_unit *unit = ast_alloc(sizeof(Func_unit));
+    unit->func = copy_item(func);
+    unit->header = *header;
+    unit->tokens = *buffer;
+    unit->tokens.pos = body_pos;
+    unit->body_tokens = body_tokens;
+    unit->errors = NULL;
+    unit_copy_globals(unit, global, names, name_count);
+    free(names);
+
+    pool_add(compiler->func_pool, unit);
+    return unit;
+}
+
+void func_pool_skip_body(Func_unit *unit)
+{
+    for (size_t i = 0; i < unit->body_tokens; i++)
+    {
+        (void)token_ring_advance();
+    }
+}
+
+bool func_pool_drop_body(symtable_item *func)
+{
+    size_t body_tokens;
+    if (!body_scan(func, &body_tokens, NULL, NULL))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < body_tokens; i++)
+    {
+        (void)token_ring_advance();
+    }
+    return true;
+}
+
+void func_pool_join()
+{
+    Func_pool *pool = compiler->func_pool;
+    if (pool == NULL || pool->threads == NULL)
+    {
+        return;
+    }
+    pool_stop(pool);
+
+    // the bodies come before everything the parser has read after them, the errors are added from the last one, so
+    // the errors of one line keep the order of the source
+    for (size_t i = pool->count; i-- > 0;)
+    {
+        Error_stack *errors = pool->units[i]->errors;
+        while (errors != NULL && !Error_stack_empty(errors))
+        {
+            add_error_by_line(Error_stack_pop(errors));
+        }
+    }
+}
+
+bool func_pool_lower(Func_unit *unit)
+{
+    if (unit == NULL)
+    {
+        return false;
+    }
+    fwrite(unit->code, 1, unit->code_len, compiler->out_code_file);
+    return true;
+}
+
+void func_pool_free()
+{
+    Func_pool *pool = compiler->func_pool;
+    if (pool == NULL)
+    {
+        return;
+    }
+    pool_stop(pool);
+    // the units have been allocated from the syntax tree arena
+    for (size_t i = 0; i < pool->count; i++)
+    {
+        free(pool->units[i]->code);
+        Error_stack *errors = pool->units[i]->errors;
+        while (errors != NULL && !Error_stack_empty(errors))
+        {
+            free(Error_stack_pop(errors).message);
+        }
+        if (errors != NULL)
+        {
+            Error_stack_free(errors);
+        }
+    }
+    free(pool->units);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->ready);
+    free(pool);
+    compiler->func_pool = NULL;
+}
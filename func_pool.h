@@ -0,0 +1,77 @@
+/**
+ * @file func_pool.h
+ * @brief Pool of threads parsing, checking and generating the bodies of the functions while the parser goes on with
+ * the rest of the program.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ * The parser hands the body of a function of the global block over to the pool and continues after its closing
+ * brace. A worker parses the body in a compilation of its own, which reads the tokens and the index of the functions
+ * of the program and interns to its identifier table. The global symbols the body names are copied as they are at
+ * the header of the function. The code of the body is generated to a private buffer and written out in the place of
+ * the function. The labels and temporaries of a function do not depend on the code around it, so the output is the
+ * same as without the pool.
+ */
+
+#ifndef FUNC_POOL_H
+#define FUNC_POOL_H
+
+#include <stdbool.h>
+#include "scanner.h"
+#include "symtable.h"
+
+/**
+ * Body of one function handed over to the pool
+ */
+typedef struct Func_unit Func_unit;
+
+/**
+ * @brief Hands the body of the function whose header has just been parsed over to the pool, the next token is the
+ * first token of the body. Must be called while the global scope is on the top of the scope stack. The body is
+ * parsed by the program if it assigns to a global variable or if it does not end.
+ *
+ * @param func function with the parsed header
+ * @param header the opening brace of the body
+ * @return Func_unit* - the body handed over, NULL if the parser has to parse it
+ */
+Func_unit *func_pool_submit(symtable_item *func, Token *header);
+
+/**
+ * @brief Reads the tokens of the body handed over to the pool, the next token is the closing brace.
+ *
+ * @param unit the body handed over
+ */
+void func_pool_skip_body(Func_unit *unit);
+
+/**
+ * @brief Reads the tokens of the body of a function that is not compiled at all, the next token is the closing brace.
+ * Like in func_pool_submit, the body is left to the parser if it assigns to a global variable or if it does not end.
+ *
+ * @param func function with the parsed header
+ * @return true if the body has been skipped
+ */
+bool func_pool_drop_body(symtable_item *func);
+
+/**
+ * @brief Waits for all the bodies handed over to the pool and stops its threads. The first error found in each body
+ * is put among the errors of the parser by its line.
+ */
+void func_pool_join();
+
+/**
+ * @brief Writes the code generated by the pool for the function, must be called after func_pool_join.
+ *
+ * @param unit the body handed over, may be NULL
+ * @return true if the code has been written and the function is not to be generated
+ */
+bool func_pool_lower(Func_unit *unit);
+
+/**
+ * @brief Stops the pool and releases the bodies and their code.
+ */
+void func_pool_free();
+
+#endif // FUNC_POOL_H
@@ -11,6 +11,8 @@
  */
 
 #include "psa.h"
+#include "compiler.h"
+#include "fold.h"
 
 PSA_Token parseFunctionCall(PSA_Token_stack *main_s, PSA_Token id, int *param_count)
 {
@@ -19,26 +21,24 @@ PSA_Token parseFunctionCall(PSA_Token_stack *main_s, PSA_Token id, int *param_co
     bool is_ok = true;
 
     // check if the id of the function is in the symtable
+    symtable_item func_def_item;
     symtable_item *found_func = NULL;
-    symtable_item *potentially_found_func = symtable_find_in_stack(id.token_value, sym_st, true);
+    symtable_item *potentially_found_func = symtable_find_in_stack(id.token_value, compiler->sym_st, true);
     if (potentially_found_func != NULL && potentially_found_func->type == FUNCTION)
     {
-        found_func = malloc(sizeof(symtable_item));
-        *found_func = *potentially_found_func;
+        func_def_item = *potentially_found_func;
+        found_func = &func_def_item;
     }
 
     if (found_func == NULL)
     {
         is_ok = false;
 
-        Token func_def;
-        symtable_item func_def_item;
-        bool is_defined_somewhere = get_func_definition(&func_def, id.token_value, &func_def_item);
+        bool is_defined_somewhere = get_func_definition(id.token_value, &func_def_item);
 
         if (is_defined_somewhere)
         {
-            found_func = malloc(sizeof(symtable_item));
-            *found_func = func_def_item;
+            found_func = &func_def_item;
             is_ok = true;
         }
         else
@@ -59,7 +59,6 @@ PSA_Token parseFunctionCall(PSA_Token_stack *main_s, PSA_Token id, int *param_co
         throw_error(SYNTACTIC_ERR, l_bracket.line_num, "Missing '(' after function name!");
 
         is_ok = false;
-        free(found_func);
         return ERROR_TOKEN;
     }
 
@@ -68,6 +67,11 @@ PSA_Token parseFunctionCall(PSA_Token_stack *main_s, PSA_Token id, int *param_co
     bool params_ok = true;
     psa_return_type parsed_param;
 
+    // syntax trees of the arguments, ast_call copies them
+    int args_cap = unknown_params ? 4 : found_func->data.func_data->params_count;
+    args_cap = args_cap > 0 ? args_cap : 1;
+    Ast_expr **args = ast_alloc(sizeof(Ast_expr *) * args_cap);
+
     while (unknown_params || *param_count < found_func->data.func_data->params_count)
     {
         params_ok = params_ok && checkParameter(main_s, *param_count, found_func, &parsed_param, unknown_params, id);
@@ -80,6 +84,15 @@ PSA_Token parseFunctionCall(PSA_Token_stack *main_s, PSA_Token id, int *param_co
             *param_count = *param_count - 1;
             break;
         }
+
+        if (*param_count > args_cap)
+        {
+            Ast_expr **grown = ast_alloc(sizeof(Ast_expr *) * args_cap * 2);
+            memcpy(grown, args, sizeof(Ast_expr *) * args_cap);
+            args = grown;
+            args_cap *= 2;
+        }
+        args[*param_count - 1] = parsed_param.expr;
     }
 
     // read the next token (should be ) token)
@@ -107,15 +120,15 @@ PSA_Token parseFunctionCall(PSA_Token_stack *main_s, PSA_Token id, int *param_co
     if (is_ok)
     {
         symtable_item func_item = *found_func;
-        free(found_func);
+        Ast_expr *call = fold_expr(ast_call(func_item.id, func_item.data.func_data->return_type, args, *param_count));
         return (PSA_Token){
             .type = TOKEN_FUNC_ID,
             .token_value = func_item.id,
             .expr_type = func_item.data.func_data->return_type,
-            .preceded_by_nl = id.preceded_by_nl};
+            .preceded_by_nl = id.preceded_by_nl,
+            .node = call};
     }
 
-    free(found_func);
     return ERROR_TOKEN;
 }
 
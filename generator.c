@@ -11,17 +11,13 @@
  */
 
 #include "generator.h"
+#include "compiler.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 /// GLOBAL COUNTERS
 
-int if_counter = 0;
-int while_counter = 0;
-int tmp_counter = 0;
-int label_counter = 0;
-int_stack *else_label_st = NULL;
 
 DEFINE_STACK_FUNCTIONS(int);
 
@@ -29,50 +25,52 @@ DEFINE_STACK_FUNCTIONS(int);
 
 char *label(char *name)
 {
-    char *label = malloc(sizeof(char) * (strlen(name) + 1));
-    sprintf(label, "%s", name);
-    return label;
+    // labels are written as they are named
+    return name;
+}
+
+char *local_label(const char *format, int first, int second)
+{
+    // the labels inside of a function start with its name, so they are unique although its counters start from zero,
+    // the labels of the main body start with $main$, no prefix is an identifier the functions could be named by
+    const char *prefix = compiler->label_prefix != NULL ? compiler->label_prefix : "$main$";
+    size_t len = strlen(prefix) + strlen(format) + 2 * 12;
+    char *name = ast_alloc(len);
+    int prefix_len = snprintf(name, len, "%s", prefix);
+    snprintf(name + prefix_len, len - prefix_len, format, first, second);
+    return name;
 }
 
 char *type(Expression_type type)
 {
-    char *type_str = malloc(sizeof(char) * 10);
     switch (type)
     {
     case TYPE_INT:
     case TYPE_INT_NIL:
-        sprintf(type_str, "int");
-        break;
+        return "int";
     case TYPE_DOUBLE:
     case TYPE_DOUBLE_NIL:
-        sprintf(type_str, "float");
-        break;
+        return "float";
     case TYPE_STRING:
     case TYPE_STRING_NIL:
-        sprintf(type_str, "string");
-        break;
+        return "string";
     case TYPE_BOOL:
     case TYPE_BOOL_NIL:
-        sprintf(type_str, "bool");
-        break;
+        return "bool";
     case TYPE_NIL:
-        sprintf(type_str, "nil");
-        break;
+        return "nil";
     case TYPE_INVALID:
-        sprintf(type_str, "invalid");
-        break;
+        return "invalid";
     default:
-        sprintf(type_str, "unknown");
-        break;
+        return "unknown";
     }
-    return type_str;
 }
 
 char *variable(char *id, int scope, bool has_suffix)
 {
-    char *var_name = malloc(sizeof(char) * (10 + strlen(id)));
+    char *var_name = ast_alloc(sizeof(char) * (10 + strlen(id) + 20));
     char *scope_prefix = scope == 0 ? "GF" : (scope < 0 ? "TF" : "LF"); // scope determies the frame prefix
-    char *suffix = malloc(sizeof(char) * 10);
+    char suffix[20];
     sprintf(suffix, "%d", scope);
 
     sprintf(var_name, "%s@$%s%s", scope_prefix, id, has_suffix ? suffix : "");
@@ -93,30 +91,26 @@ char *symbol(Token symbol)
 
 void handle_0_operand_instructions(Instruction inst)
 {
-    char *instruction = instructionToString(inst);
-    fprintf(out_code_file, "%s\n", instruction);
-    free(instruction);
+    const char *instruction = instructionToString(inst);
+    fprintf(compiler->out_code_file, "%s\n", instruction);
 }
 
 void handle_1_operand_instructions(Instruction inst, char *op1)
 {
-    char *instruction = instructionToString(inst);
-    fprintf(out_code_file, "%s %s\n", instruction, op1);
-    free(instruction);
+    const char *instruction = instructionToString(inst);
+    fprintf(compiler->out_code_file, "%s %s\n", instruction, op1);
 }
 
 void handle_2_operand_instructions(Instruction inst, char *op1, char *op2)
 {
-    char *instruction = instructionToString(inst);
-    fprintf(out_code_file, "%s %s %s\n", instruction, op1, op2);
-    free(instruction);
+    const char *instruction = instructionToString(inst);
+    fprintf(compiler->out_code_file, "%s %s %s\n", instruction, op1, op2);
 }
 
 void handle_3_operand_instructions(Instruction inst, char *op1, char *op2, char *op3)
 {
-    char *instruction = instructionToString(inst);
-    fprintf(out_code_file, "%s %s %s %s\n", instruction, op1, op2, op3);
-    free(instruction);
+    const char *instruction = instructionToString(inst);
+    fprintf(compiler->out_code_file, "%s %s %s %s\n", instruction, op1, op2, op3);
 }
 
 void processInstruction(Instruction inst, char **operands, int operands_count)
@@ -145,13 +139,13 @@ void processInstruction(Instruction inst, char **operands, int operands_count)
 
 char *symb_resolve(Token token)
 {
-    char *var_name = malloc(sizeof(char) * (10 + strlen(token.token_value)));
+    char *var_name = ast_alloc(sizeof(char) * (10 + strlen(token.token_value) + 20));
     switch (token.type)
     {
     case TOKEN_IDENTIFICATOR:
     {
         // for identificators, we need to find the variable in the symtable
-        symtable_item *found = symtable_find_in_stack(token.token_value, sym_st, false);
+        symtable_item *found = symtable_find_in_stack(token.token_value, compiler->sym_st, false);
         if (found == NULL)
         {
             // if the symbol has not been found, we we will presume that it's just temporary
@@ -188,11 +182,11 @@ char *symb_resolve(Token token)
     case TOKEN_STRING:
     case TOKEN_INT:
     case TOKEN_DOUBLE:
+    case TOKEN_EXP:
     case TOKEN_NIL:
     case TOKEN_BOOL:
     {
         // literals need to be formatted based on their type
-        free(var_name);
         var_name = format_token(token);
         break;
     }
@@ -207,6 +201,12 @@ char *format_token(Token token)
 {
     char *formatted_value = NULL;
 
+    if (token.literal != NULL)
+    {
+        // literals read from the source have been encoded by the scanner already
+        return token.literal->operand;
+    }
+
     switch (token.type)
     {
     case TOKEN_IDENTIFICATOR:
@@ -215,43 +215,45 @@ char *format_token(Token token)
     case TOKEN_INT:
     {
         // Format integer literals with "int@"
-        formatted_value = malloc(strlen(token.token_value) + 5); //"int@" and '\0'
+        formatted_value = ast_alloc(strlen(token.token_value) + 5); //"int@" and '\0'
         sprintf(formatted_value, "int@%s", token.token_value);
         break;
     }
     case TOKEN_DOUBLE:
+    case TOKEN_EXP:
     {
         // Format floating-point literals with "float@"
         double double_value = atof(token.token_value); // Convert to double
-        formatted_value = malloc(sizeof(char) * 60);   // Allocating enough space
+        formatted_value = ast_alloc(sizeof(char) * 60);   // Allocating enough space
         sprintf(formatted_value, "float@%a", double_value);
         break;
     }
     case TOKEN_STRING:
     {
         // Format string literals with "string@"
-        formatted_value = malloc((strlen(token.token_value) * 10) + 8); //"string@" and '\0'
-        sprintf(formatted_value, "string@%s", escapeString(token.token_value));
+        formatted_value = ast_alloc(string_operand_encode(token.token_value, NULL) + 8); //"string@" and '\0'
+        memcpy(formatted_value, "string@", 7);
+        string_operand_encode(token.token_value, formatted_value + 7);
         break;
     }
     case TOKEN_BOOL:
     {
         // Format bool literals with "bool@"
-        formatted_value = malloc(strlen(token.token_value) + 6); //"bool@" and '\0'
+        formatted_value = ast_alloc(strlen(token.token_value) + 6); //"bool@" and '\0'
         sprintf(formatted_value, "bool@%s", token.token_value);
         break;
     }
     case TOKEN_NIL:
     {
         // Format nil with "nil@"
-        formatted_value = malloc(strlen("nil@nil") + 1); //"nil@" and '\0'
+        formatted_value = ast_alloc(strlen("nil@nil") + 1); //"nil@" and '\0'
         sprintf(formatted_value, "nil@nil");
         break;
     }
     default:
     {
         // Format other tokens with their value
-        formatted_value = malloc(strlen(token.token_value) + 1);
+        formatted_value = ast_alloc(strlen(token.token_value) + 1);
         sprintf(formatted_value, "%s", token.token_value);
         break;
     }
@@ -259,161 +261,185 @@ char *format_token(Token token)
     return formatted_value;
 }
 
-void print_out_code()
+/**
+ * @brief Copies the rest of the source stream to the destination in blocks. The streams lock on every call once the
+ * process has started a thread, so they are not copied by characters.
+ */
+static void copy_stream(FILE *source, FILE *destination)
+{
+    char block[BUFSIZ];
+    size_t len;
+    while ((len = fread(block, 1, sizeof(block), source)) > 0)
+    {
+        fwrite(block, 1, len, destination);
+    }
+}
+
+void print_out_code(FILE *out)
 {
     // Check if out_code_file is NULL
-    if (out_code_file == NULL)
+    if (compiler->out_code_file == NULL)
     {
         throw_error(INTERNAL_ERR, -1, "Error: out_code_file is not initialized.\n");
         return;
     }
 
     // Reset the file position to the beginning of the file
-    if (fseek(out_code_file, 0, SEEK_SET) != 0)
+    if (fseek(compiler->out_code_file, 0, SEEK_SET) != 0)
     {
         throw_error(INTERNAL_ERR, -1, "Error: Failed to seek in out_code_file.\n");
         return;
     }
 
-    int c; // fgetc returns int, not char
-    while ((c = fgetc(out_code_file)) != EOF)
-    {
-        printf("%c", (char)c);
-    }
+    copy_stream(compiler->out_code_file, out);
 }
 
 /// GENERATION FUNCTIONS
 
-void generate_func_header(symtable_item func_item)
+void generate_func_header(char *name, char **params, int param_count)
 {
     // CREATE OPERANDS
-    char *func_lbl = malloc(sizeof(char) * (strlen(func_item.id) + 5));
-    strcpy(func_lbl, func_item.id);
+    char *func_lbl = malloc(sizeof(char) * (strlen(name) + 5));
+    strcpy(func_lbl, name);
 
-    char *func_end_lbl = malloc(sizeof(char) * (strlen(func_item.id) + 5));
-    sprintf(func_end_lbl, "%s_end", func_item.id);
+    char *func_end_lbl = malloc(sizeof(char) * (strlen(name) + 5));
+    sprintf(func_end_lbl, "%s$end", name);
 
     generate_instruction(JUMP, label(func_end_lbl)); // jump over the function body
     generate_instruction(LABEL, label(func_lbl));    // function label
 
-    fprintf(out_code_file, "\n");
+    fprintf(compiler->out_code_file, "\n");
 
     // frame initialization
     generate_instruction(PUSHFRAME);
     generate_instruction(CREATEFRAME);
 
     // initialize function params (in reverse order, because of stack)
-    fprintf(out_code_file, "# function params\n");
-    for (int i = func_item.data.func_data->params_count - 1; i >= 0; i--)
+    fprintf(compiler->out_code_file, "# function params\n");
+    for (int i = param_count - 1; i >= 0; i--)
     {
-        Token param = (Token){
-            .type = TOKEN_IDENTIFICATOR,
-            .token_value = malloc(sizeof(char) * (strlen(func_item.data.func_data->params[i].id) + 1)),
-        };
-        strcpy(param.token_value, func_item.data.func_data->params[i].id);
-
-        char *var_name = symbol(param);
-
-        HANDLE_DEFVAR(generate_instruction(DEFVAR, var_name););
-        generate_instruction(POPS, var_name);
-
-        free(var_name);
+        HANDLE_DEFVAR(generate_instruction(DEFVAR, params[i]););
+        generate_instruction(POPS, params[i]);
     }
 
-    fprintf(out_code_file, "# function params end\n\n");
+    fprintf(compiler->out_code_file, "# function params end\n\n");
 
     free(func_end_lbl);
     free(func_lbl);
 }
 
-void generate_func_end(symtable_item func_item)
+void generate_func_end(char *name)
 {
     char *func_lbl;
-    func_lbl = malloc(sizeof(char) * (strlen(func_item.id) + 5));
-    sprintf(func_lbl, "%s_end", func_item.id);
+    func_lbl = malloc(sizeof(char) * (strlen(name) + 5));
+    sprintf(func_lbl, "%s$end", name);
 
     generate_instruction(LABEL, label(func_lbl)); // function end label
-    fprintf(out_code_file, "\n");
+    fprintf(compiler->out_code_file, "\n");
 
     free(func_lbl);
 }
 
+void generate_func_scope_begin(char *name)
+{
+    compiler->outer_counters[0] = compiler->if_counter;
+    compiler->outer_counters[1] = compiler->while_counter;
+    compiler->outer_counters[2] = compiler->tmp_counter;
+    compiler->outer_counters[3] = compiler->label_counter;
+    compiler->if_counter = 0;
+    compiler->while_counter = 0;
+    compiler->tmp_counter = 0;
+    compiler->label_counter = 0;
+
+    compiler->label_prefix = ast_alloc(strlen(name) + 2);
+    sprintf(compiler->label_prefix, "%s$", name);
+}
+
+void generate_func_scope_end()
+{
+    compiler->if_counter = compiler->outer_counters[0];
+    compiler->while_counter = compiler->outer_counters[1];
+    compiler->tmp_counter = compiler->outer_counters[2];
+    compiler->label_counter = compiler->outer_counters[3];
+    compiler->label_prefix = NULL;
+}
+
 void generate_builtin_func_call(Token func, int param_cnt)
 {
-    char *tmp_token = malloc(sizeof(char) * 20);
-    sprintf(tmp_token, "tmp%d", tmp_counter);
+    char tmp_token[32];
+    sprintf(tmp_token, "tmp%d", compiler->tmp_counter);
     char *tmp_token_name = variable(tmp_token, -1, false);
     BuiltinFunc builting_inst = getBuiltInFunctionName(func);
 
     switch (builting_inst)
     {
     case B_WRITE:
-        fprintf(out_code_file, "# WRITE\n");
+        fprintf(compiler->out_code_file, "# WRITE\n");
 
         // all the parameters separately in reverse order (because of stack)
         for (int i = 0; i < param_cnt; i++)
         {
-            sprintf(tmp_token, "tmp%d", tmp_counter + param_cnt - i - 1);
+            sprintf(tmp_token, "tmp%d", compiler->tmp_counter + param_cnt - i - 1);
             char *tmp_token_name = variable(tmp_token, -1, false);
 
             HANDLE_DEFVAR(generate_instruction(DEFVAR, tmp_token_name););
             generate_instruction(POPS, tmp_token_name);
 
             // tmp_counter++;
-            sprintf(tmp_token, "tmp%d", tmp_counter);
+            sprintf(tmp_token, "tmp%d", compiler->tmp_counter);
             tmp_token_name = variable(tmp_token, -1, false);
         }
 
         // write all the parameters separately
         for (int i = 0; i < param_cnt; i++)
         {
-            sprintf(tmp_token, "tmp%d", tmp_counter);
+            sprintf(tmp_token, "tmp%d", compiler->tmp_counter);
             char *tmp_token_name = variable(tmp_token, -1, false);
 
             generate_instruction(WRITE, tmp_token_name);
 
-            tmp_counter++;
-            sprintf(tmp_token, "tmp%d", tmp_counter);
+            compiler->tmp_counter++;
+            sprintf(tmp_token, "tmp%d", compiler->tmp_counter);
             tmp_token_name = variable(tmp_token, -1, false);
         }
 
-        tmp_counter--;
-        fprintf(out_code_file, "# WRITE END\n");
-        fprintf(out_code_file, "\n");
+        compiler->tmp_counter--;
+        fprintf(compiler->out_code_file, "# WRITE END\n");
+        fprintf(compiler->out_code_file, "\n");
         break;
     case B_READ:
         // read the input and push it on the stack
-        fprintf(out_code_file, "# READ\n");
+        fprintf(compiler->out_code_file, "# READ\n");
         HANDLE_DEFVAR(generate_instruction(DEFVAR, tmp_token_name););
         generate_instruction(READ, tmp_token_name, type(getReadType(func))); // the type is determined by the function name
         generate_instruction(PUSHS, tmp_token_name);
-        fprintf(out_code_file, "# READ END\n");
-        fprintf(out_code_file, "\n");
+        fprintf(compiler->out_code_file, "# READ END\n");
+        fprintf(compiler->out_code_file, "\n");
         break;
     case B_INT2DOUBLE:
         // just a stack instruction
-        fprintf(out_code_file, "# INT2DOUBLE\n");
+        fprintf(compiler->out_code_file, "# INT2DOUBLE\n");
         generate_instruction(INT2FLOATS);
-        fprintf(out_code_file, "# INT2DOUBLE END\n");
-        fprintf(out_code_file, "\n");
+        fprintf(compiler->out_code_file, "# INT2DOUBLE END\n");
+        fprintf(compiler->out_code_file, "\n");
         break;
     case B_DOUBLE2INT:
         // just a stack instruction
-        fprintf(out_code_file, "# FLOAT2INT\n");
+        fprintf(compiler->out_code_file, "# FLOAT2INT\n");
         generate_instruction(FLOAT2INTS);
-        fprintf(out_code_file, "# FLOAT2INT END\n");
-        fprintf(out_code_file, "\n");
+        fprintf(compiler->out_code_file, "# FLOAT2INT END\n");
+        fprintf(compiler->out_code_file, "\n");
         break;
     case B_LENGTH:
     {
-        fprintf(out_code_file, "# LENGTH\n");
-        sprintf(tmp_token, "tmp%d", tmp_counter);
+        fprintf(compiler->out_code_file, "# LENGTH\n");
+        sprintf(tmp_token, "tmp%d", compiler->tmp_counter);
 
-        tmp_counter++;
+        compiler->tmp_counter++;
 
-        sprintf(tmp_token, "tmp%d", tmp_counter);
+        sprintf(tmp_token, "tmp%d", compiler->tmp_counter);
         char *tmp_token_name_2 = variable(tmp_token, -1, false);
-        tmp_counter++;
+        compiler->tmp_counter++;
 
         // get the string to a temporary variable
         HANDLE_DEFVAR(generate_instruction(DEFVAR, tmp_token_name););
@@ -424,43 +450,43 @@ void generate_builtin_func_call(Token func, int param_cnt)
         // push the length on the stack
         generate_instruction(PUSHS, tmp_token_name);
 
-        fprintf(out_code_file, "# LENGTH END\n");
-        fprintf(out_code_file, "\n");
+        fprintf(compiler->out_code_file, "# LENGTH END\n");
+        fprintf(compiler->out_code_file, "\n");
         break;
     }
     case B_SUBSTRING:
     {
-        fprintf(out_code_file, "# SUBSTRING\n");
+        fprintf(compiler->out_code_file, "# SUBSTRING\n");
 
         // end index variable
-        char *end_name = malloc(sizeof(char) * 20);
-        sprintf(end_name, "tmp%d", tmp_counter);
+        char end_name[32];
+        sprintf(end_name, "tmp%d", compiler->tmp_counter);
         char *end = variable(end_name, -1, false);
-        tmp_counter++;
+        compiler->tmp_counter++;
 
         // start index variable
-        char *start_name = malloc(sizeof(char) * 20);
-        sprintf(start_name, "tmp%d", tmp_counter);
+        char start_name[32];
+        sprintf(start_name, "tmp%d", compiler->tmp_counter);
         char *start = variable(start_name, -1, false);
-        tmp_counter++;
+        compiler->tmp_counter++;
 
         // string variable
-        char *string_name = malloc(sizeof(char) * 20);
-        sprintf(string_name, "tmp%d", tmp_counter);
+        char string_name[32];
+        sprintf(string_name, "tmp%d", compiler->tmp_counter);
         char *string = variable(string_name, -1, false);
-        tmp_counter++;
+        compiler->tmp_counter++;
 
         // internal variable (used for storing the characters)
-        char *internal_name = malloc(sizeof(char) * 20);
-        sprintf(internal_name, "tmp%d", tmp_counter);
+        char internal_name[32];
+        sprintf(internal_name, "tmp%d", compiler->tmp_counter);
         char *internal = variable(internal_name, -1, false);
-        tmp_counter++;
+        compiler->tmp_counter++;
 
         // result variable (used for storing the resulting string)
-        char *result_name = malloc(sizeof(char) * 20);
-        sprintf(result_name, "tmp%d", tmp_counter);
+        char result_name[32];
+        sprintf(result_name, "tmp%d", compiler->tmp_counter);
         char *result = variable(result_name, -1, false);
-        tmp_counter++;
+        compiler->tmp_counter++;
 
         HANDLE_DEFVAR(generate_instruction(DEFVAR, end););
         HANDLE_DEFVAR(generate_instruction(DEFVAR, start););
@@ -477,10 +503,8 @@ void generate_builtin_func_call(Token func, int param_cnt)
                                                .token_value = "",
                                            }));
 
-        char *loop_label = malloc(sizeof(char) * 20);
-        sprintf(loop_label, "loop_substring_%d", tmp_counter);
-        char *end_label = malloc(sizeof(char) * 20);
-        sprintf(end_label, "end_substring_%d", tmp_counter);
+        char *loop_label = local_label("loop_substring_%d", compiler->tmp_counter, 0);
+        char *end_label = local_label("end_substring_%d", compiler->tmp_counter, 0);
 
         // loop until start != end
         generate_instruction(LABEL, label(loop_label));
@@ -500,16 +524,16 @@ void generate_builtin_func_call(Token func, int param_cnt)
         // push the resulting string on the stack
         generate_instruction(PUSHS, result);
 
-        fprintf(out_code_file, "# SUBSTRING END\n");
-        fprintf(out_code_file, "\n");
+        fprintf(compiler->out_code_file, "# SUBSTRING END\n");
+        fprintf(compiler->out_code_file, "\n");
 
-        tmp_counter++;
+        compiler->tmp_counter++;
 
         break;
     }
     case B_ORD:
     {
-        fprintf(out_code_file, "# STRI2INT\n");
+        fprintf(compiler->out_code_file, "# STRI2INT\n");
 
         // push 0 as the index for the STRI2INTS instruction
         generate_instruction(PUSHS, literal((Token){
@@ -517,284 +541,238 @@ void generate_builtin_func_call(Token func, int param_cnt)
                                         .token_value = "0",
                                     }));
         generate_instruction(STRI2INTS);
-        fprintf(out_code_file, "# STRI2INT END\n");
-        fprintf(out_code_file, "\n");
+        fprintf(compiler->out_code_file, "# STRI2INT END\n");
+        fprintf(compiler->out_code_file, "\n");
         break;
     }
     case B_CHR:
     {
         // just a stack instruction
-        fprintf(out_code_file, "# CHR\n");
+        fprintf(compiler->out_code_file, "# CHR\n");
         generate_instruction(INT2CHARS);
-        fprintf(out_code_file, "# CHR END\n");
-        fprintf(out_code_file, "\n");
+        fprintf(compiler->out_code_file, "# CHR END\n");
+        fprintf(compiler->out_code_file, "\n");
         break;
     }
     default:
         throw_error(INTERNAL_ERR, -1, "Invalid built-in function.\n");
         break;
     }
-    tmp_counter++;
+    compiler->tmp_counter++;
+}
+
+/**
+ * @brief Takes the number of the innermost if being generated and the count of its conditions from the stack, the
+ * number is under the count.
+ */
+static int if_labels_pop(int *if_num)
+{
+    int elif_counter = int_stack_pop(compiler->else_label_st);
+    *if_num = int_stack_top(compiler->else_label_st);
+    return elif_counter;
 }
 
-void generate_if_start()
+char *generate_if_start()
 {
-    if (else_label_st == NULL)
+    if (compiler->else_label_st == NULL)
     {
-        else_label_st = int_stack_init();
-        int_stack_push(else_label_st, 0);
+        compiler->else_label_st = int_stack_init();
     }
 
-    int elif_counter = int_stack_top(else_label_st);
-
-    char *true_op = literal((Token){
-        .type = TOKEN_BOOL,
-        .token_value = "true",
-    });
-
-    char *if_lbl = malloc(sizeof(char) * 20);
-    sprintf(if_lbl, "else%d_%d", if_counter, elif_counter);
-
-    fprintf(out_code_file, "# if%d start\n", if_counter);
-
-    generate_instruction(PUSHS, true_op); // push true to check the condition
-    generate_instruction(JUMPIFNEQS, label(if_lbl));
-
-    fprintf(out_code_file, "\n");
+    // every if gets its own number, the labels of two ifs in the same block differ
+    int if_num = compiler->if_counter++;
+    char *if_lbl = local_label("else%d_%d", if_num, 0);
 
-    free(if_lbl);
+    fprintf(compiler->out_code_file, "# if%d start\n", if_num);
 
-    if_counter++;
-    int_stack_push(else_label_st, 0);
+    int_stack_push(compiler->else_label_st, if_num);
+    int_stack_push(compiler->else_label_st, 0);
+    return label(if_lbl);
 }
 
 void generate_elseif_else()
 {
-    if_counter--;
-    int elif_counter = 0;
-    if (!int_stack_empty(else_label_st))
-    {
-        elif_counter = int_stack_pop(else_label_st);
-    }
+    int if_num;
+    int elif_counter = if_labels_pop(&if_num);
 
-    char *endif_lbl = malloc(sizeof(char) * 10);
-    sprintf(endif_lbl, "else%d_%d", if_counter, elif_counter);
+    char *endif_lbl = local_label("endif%d", if_num, 0);
 
-    char *elsif_else_lbl = malloc(sizeof(char) * 20);
-    sprintf(elsif_else_lbl, "else%d_%d", if_counter, elif_counter);
+    char *elsif_else_lbl = local_label("else%d_%d", if_num, elif_counter);
 
     generate_instruction(JUMP, label(endif_lbl)); // jump to end of if block
     generate_instruction(LABEL, label(elsif_else_lbl));
 
-    fprintf(out_code_file, "\n");
+    fprintf(compiler->out_code_file, "\n");
 
     elif_counter++;
 
-    free(endif_lbl);
-    free(elsif_else_lbl);
-
-    int_stack_push(else_label_st, elif_counter);
-    if_counter++;
+    int_stack_push(compiler->else_label_st, elif_counter);
 }
 
-void generate_elseif_if()
+char *generate_elseif_if()
 {
-    if_counter--;
-    int elif_counter = 0;
-    if (!int_stack_empty(else_label_st))
-    {
-        elif_counter = int_stack_pop(else_label_st);
-    }
-
-    char *true_op = literal((Token){
-        .type = TOKEN_BOOL,
-        .token_value = "true",
-    });
-
-    char *elsif_if_lbl = malloc(sizeof(char) * 20);
-    sprintf(elsif_if_lbl, "else%d_%d", if_counter, elif_counter);
+    int if_num;
+    int elif_counter = if_labels_pop(&if_num);
 
-    fprintf(out_code_file, "# elseif%d start\n", elif_counter);
+    char *elsif_if_lbl = local_label("else%d_%d", if_num, elif_counter);
 
-    generate_instruction(PUSHS, true_op); // push true to check the condition
-    generate_instruction(JUMPIFNEQS, label(elsif_if_lbl));
+    fprintf(compiler->out_code_file, "# elseif%d start\n", elif_counter);
 
-    fprintf(out_code_file, "\n");
-
-    free(elsif_if_lbl);
-
-    int_stack_push(else_label_st, elif_counter);
-    if_counter++;
+    int_stack_push(compiler->else_label_st, elif_counter);
+    return label(elsif_if_lbl);
 }
 
 void generate_else()
 {
-    if_counter--;
-    int elif_counter = 0;
-    if (!int_stack_empty(else_label_st))
-    {
-        elif_counter = int_stack_pop(else_label_st);
-    }
+    int if_num;
+    int elif_counter = if_labels_pop(&if_num);
 
-    char *else_lbl = malloc(sizeof(char) * 10);
-    sprintf(else_lbl, "else%d_%d", if_counter, elif_counter);
+    char *else_lbl = local_label("else%d_%d", if_num, elif_counter);
 
     elif_counter++;
 
-    char *endif_lbl = malloc(sizeof(char) * 10);
-    sprintf(endif_lbl, "else%d_%d", if_counter, elif_counter);
+    char *endif_lbl = local_label("endif%d", if_num, 0);
 
-    fprintf(out_code_file, "# if%d else\n", if_counter);
+    fprintf(compiler->out_code_file, "# if%d else\n", if_num);
     generate_instruction(JUMP, label(endif_lbl)); // jump to end of if block
     generate_instruction(LABEL, label(else_lbl));
 
-    fprintf(out_code_file, "\n");
-
-    free(else_lbl);
-    free(endif_lbl);
+    fprintf(compiler->out_code_file, "\n");
 
-    int_stack_push(else_label_st, elif_counter);
-    if_counter++;
+    int_stack_push(compiler->else_label_st, elif_counter);
 }
 
 void generate_if_end()
 {
-    if_counter--;
-    int elif_counter = 0;
-    if (!int_stack_empty(else_label_st))
-    {
-        elif_counter = int_stack_pop(else_label_st);
-    }
+    int if_num;
+    int elif_counter = if_labels_pop(&if_num);
+    int_stack_pop(compiler->else_label_st);
 
-    fprintf(out_code_file, "# if%d end\n", if_counter);
+    fprintf(compiler->out_code_file, "# if%d end\n", if_num);
 
-    char *endif_lbl = malloc(sizeof(char) * 10);
-    sprintf(endif_lbl, "else%d_%d", if_counter, elif_counter);
+    // the last condition jumps here if it does not hold, the branches jump to the end
+    char *else_lbl = local_label("else%d_%d", if_num, elif_counter);
+    char *endif_lbl = local_label("endif%d", if_num, 0);
+    generate_instruction(LABEL, label(else_lbl));
     generate_instruction(LABEL, label(endif_lbl)); // ending label of the if block
 
-    fprintf(out_code_file, "\n");
-
-    free(endif_lbl);
+    fprintf(compiler->out_code_file, "\n");
 }
 
 void generate_while_start()
 {
     // just the label to jump to
 
-    char *while_lbl = malloc(sizeof(char) * 10);
-    sprintf(while_lbl, "while%d", while_counter);
+    if (compiler->while_label_st == NULL)
+    {
+        compiler->while_label_st = int_stack_init();
+    }
+
+    // every loop gets its own number, the labels of two loops in the same block differ
+    int while_num = compiler->while_counter++;
+    int_stack_push(compiler->while_label_st, while_num);
+
+    char *while_lbl = local_label("while%d", while_num, 0);
 
-    fprintf(out_code_file, "# while%d start\n", while_counter);
+    fprintf(compiler->out_code_file, "# while%d start\n", while_num);
 
     // all the variable definitions should be above the looping while body, so we need to create another file just for the while body, save only the variable defenitions of the body into the original file and then copy the body file back to the original file
-    while_def_out_code_file = out_code_file;
-    out_code_file = tmpfile();
-    if (out_code_file == NULL)
+    // the nested loops are generated to the file of the outermost one, their variables are defined before it too
+    if (compiler->loop_depth++ == 0)
     {
-        throw_error(INTERNAL_ERR, -1, "Error: out_code_file is not initialized.\n");
-        return;
+        compiler->while_def_out_code_file = compiler->out_code_file;
+        compiler->out_code_file = tmpfile();
+        if (compiler->out_code_file == NULL)
+        {
+            throw_error(INTERNAL_ERR, -1, "Error: out_code_file is not initialized.\n");
+            return;
+        }
+        compiler->is_in_loop = true;
     }
-    is_in_loop = true;
 
     generate_instruction(LABEL, label(while_lbl));
 
-    fprintf(out_code_file, "\n");
-
-    free(while_lbl);
-
-    while_counter++;
+    fprintf(compiler->out_code_file, "\n");
 }
 
-void generate_while_condition()
+char *generate_while_condition()
 {
-    while_counter--;
-
-    char *endwhile_lbl = malloc(sizeof(char) * 10);
-    sprintf(endwhile_lbl, "endwhile%d", while_counter);
+    int while_num = int_stack_top(compiler->while_label_st);
 
-    char *true_op = literal((Token){
-        .type = TOKEN_BOOL,
-        .token_value = "true",
-    });
+    char *endwhile_lbl = local_label("endwhile%d", while_num, 0);
 
-    fprintf(out_code_file, "# while%d condition\n", while_counter);
+    fprintf(compiler->out_code_file, "# while%d condition\n", while_num);
 
-    // check condition and jump accordingly
-    generate_instruction(PUSHS, true_op);
-    generate_instruction(JUMPIFNEQS, label(endwhile_lbl));
-
-    fprintf(out_code_file, "\n");
-
-    while_counter++;
+    return label(endwhile_lbl);
 }
 
 void generate_while_end()
 {
-    while_counter--;
+    int while_num = int_stack_pop(compiler->while_label_st);
 
-    // copy the while body back to the original file, swap the pointers back and delete the temporary file
-    copyFileContents(out_code_file, while_def_out_code_file);
-    out_code_file = while_def_out_code_file;
-    is_in_loop = false;
+    if (--compiler->loop_depth == 0)
+    {
+        // copy the while body back to the original file, swap the pointers back and delete the temporary file
+        copyFileContents(compiler->out_code_file, compiler->while_def_out_code_file);
+        if (compiler->out_code_file != compiler->while_def_out_code_file)
+        {
+            fclose(compiler->out_code_file);
+        }
+        compiler->out_code_file = compiler->while_def_out_code_file;
+        compiler->is_in_loop = false;
+    }
 
-    fprintf(out_code_file, "# while%d end\n", if_counter);
+    fprintf(compiler->out_code_file, "# while%d end\n", while_num);
 
-    char *endwhile_lbl = malloc(sizeof(char) * 10);
-    sprintf(endwhile_lbl, "endwhile%d", while_counter);
+    char *endwhile_lbl = local_label("endwhile%d", while_num, 0);
 
-    char *while_lbl = malloc(sizeof(char) * 10);
-    sprintf(while_lbl, "while%d", while_counter);
+    char *while_lbl = local_label("while%d", while_num, 0);
 
     generate_instruction(JUMP, label(while_lbl));     // jump back to condition
     generate_instruction(LABEL, label(endwhile_lbl)); // while ending label
 
-    fprintf(out_code_file, "\n");
-
-    free(endwhile_lbl);
+    fprintf(compiler->out_code_file, "\n");
 }
 
-void generate_implicit_init(symtable_item var_item)
+void generate_implicit_init(char *var)
 {
-    if (var_item.data.var_data->is_initialized == false)
-    {
-        Expression_type type = var_item.data.var_data->type;
-        if (type == TYPE_INT_NIL || type == TYPE_DOUBLE_NIL || type == TYPE_STRING_NIL || type == TYPE_BOOL_NIL)
-        {
-            char *nil = literal((Token){
-                .type = TOKEN_NIL,
-                .token_value = "nil",
-            });
-            generate_instruction(MOVE, variable(var_item.id, sym_st->size - 1, true), nil);
-        }
-    }
+    generate_instruction(MOVE, var, "nil@nil");
 }
 
 void generate_temp_pop()
 {
     // create a temporary variable and pop the stack into it
-    char *tmp_token = malloc(sizeof(char) * 20);
-    sprintf(tmp_token, "tmp%d", tmp_counter);
+    char tmp_token[32];
+    sprintf(tmp_token, "tmp%d", compiler->tmp_counter);
     char *tmp_token_name = variable(tmp_token, -1, false);
     HANDLE_DEFVAR(generate_instruction(DEFVAR, tmp_token_name););
     generate_instruction(POPS, tmp_token_name);
 
-    tmp_counter++;
+    compiler->tmp_counter++;
+}
+
+char *generate_condition_var()
+{
+    // the variable is in the frame of the function, a call replaces the temporary frame but not this one
+    char tmp_token[32];
+    sprintf(tmp_token, "cond$%d", compiler->tmp_counter);
+    char *tmp_token_name = variable(tmp_token, 1, false);
+    HANDLE_DEFVAR(generate_instruction(DEFVAR, tmp_token_name););
 
-    free(tmp_token);
+    compiler->tmp_counter++;
+    return tmp_token_name;
 }
 
 void generate_temp_push()
 {
     // push the value of the latest temporary value back onto the stack
-    tmp_counter--;
-    char *tmp_token = malloc(sizeof(char) * 20);
-    sprintf(tmp_token, "tmp%d", tmp_counter);
+    compiler->tmp_counter--;
+    char tmp_token[32];
+    sprintf(tmp_token, "tmp%d", compiler->tmp_counter);
     char *tmp_token_name = variable(tmp_token, -1, false);
     generate_instruction(PUSHS, tmp_token_name);
 
-    tmp_counter++;
-
-    free(tmp_token);
+    compiler->tmp_counter++;
 }
 
 void generate_nil_coelacing()
@@ -804,19 +782,17 @@ void generate_nil_coelacing()
 
     // operand deinitions
 
-    char *tmp_token1 = malloc(sizeof(char) * 20);
-    sprintf(tmp_token1, "tmp%d", tmp_counter - 2);
+    char tmp_token1[32];
+    sprintf(tmp_token1, "tmp%d", compiler->tmp_counter - 2);
     char *tmp_token_name1 = variable(tmp_token1, -1, false);
 
-    char *tmp_token2 = malloc(sizeof(char) * 20);
-    sprintf(tmp_token2, "tmp%d", tmp_counter - 1);
+    char tmp_token2[32];
+    sprintf(tmp_token2, "tmp%d", compiler->tmp_counter - 1);
     char *tmp_token_name2 = variable(tmp_token2, -1, false);
 
-    char *not_nil_label = malloc(sizeof(char) * 20);
-    sprintf(not_nil_label, "not_nil_%d", tmp_counter);
+    char *not_nil_label = local_label("not_nil_%d", compiler->tmp_counter, 0);
 
-    char *was_nil_label = malloc(sizeof(char) * 20);
-    sprintf(was_nil_label, "was_nil_%d", tmp_counter);
+    char *was_nil_label = local_label("was_nil_%d", compiler->tmp_counter, 0);
 
     // instruction generation
 
@@ -844,12 +820,12 @@ void generate_string_concat()
 
     // operand deinitions
 
-    char *tmp_token1 = malloc(sizeof(char) * 20);
-    sprintf(tmp_token1, "tmp%d", tmp_counter - 2);
+    char tmp_token1[32];
+    sprintf(tmp_token1, "tmp%d", compiler->tmp_counter - 2);
     char *tmp_token_name1 = variable(tmp_token1, -1, false);
 
-    char *tmp_token2 = malloc(sizeof(char) * 20);
-    sprintf(tmp_token2, "tmp%d", tmp_counter - 1);
+    char tmp_token2[32];
+    sprintf(tmp_token2, "tmp%d", compiler->tmp_counter - 1);
     char *tmp_token_name2 = variable(tmp_token2, -1, false);
 
     // concant the two strings and push the result
@@ -858,185 +834,125 @@ void generate_string_concat()
 }
 
 /// UTILITY FUNCTIONS
-char *instructionToString(Instruction in)
+const char *instructionToString(Instruction in)
 {
-    char *instruction = malloc(sizeof(char) * 100);
     switch (in)
     {
     case CREATEFRAME:
-        sprintf(instruction, "CREATEFRAME");
-        break;
+        return "CREATEFRAME";
     case PUSHFRAME:
-        sprintf(instruction, "PUSHFRAME");
-        break;
+        return "PUSHFRAME";
     case POPFRAME:
-        sprintf(instruction, "POPFRAME");
-        break;
+        return "POPFRAME";
     case RETURN:
-        sprintf(instruction, "RETURN");
-        break;
+        return "RETURN";
     case CLEARS:
-        sprintf(instruction, "CLEARS");
-        break;
+        return "CLEARS";
     case ADDS:
-        sprintf(instruction, "ADDS");
-        break;
+        return "ADDS";
     case SUBS:
-        sprintf(instruction, "SUBS");
-        break;
+        return "SUBS";
     case DIVS:
-        sprintf(instruction, "DIVS");
-        break;
+        return "DIVS";
     case IDIVS:
-        sprintf(instruction, "IDIVS");
-        break;
+        return "IDIVS";
     case MULS:
-        sprintf(instruction, "MULS");
-        break;
+        return "MULS";
     case LTS:
-        sprintf(instruction, "LTS");
-        break;
+        return "LTS";
     case EQS:
-        sprintf(instruction, "EQS");
-        break;
+        return "EQS";
     case GTS:
-        sprintf(instruction, "GTS");
-        break;
+        return "GTS";
     case ANDS:
-        sprintf(instruction, "ANDS");
-        break;
+        return "ANDS";
     case ORS:
-        sprintf(instruction, "ORS");
-        break;
+        return "ORS";
     case NOTS:
-        sprintf(instruction, "NOTS");
-        break;
+        return "NOTS";
     case INT2FLOATS:
-        sprintf(instruction, "INT2FLOATS");
-        break;
+        return "INT2FLOATS";
     case FLOAT2INTS:
-        sprintf(instruction, "FLOAT2INTS");
-        break;
+        return "FLOAT2INTS";
     case INT2CHARS:
-        sprintf(instruction, "INT2CHARS");
-        break;
+        return "INT2CHARS";
     case STRI2INTS:
-        sprintf(instruction, "STRI2INTS");
-        break;
+        return "STRI2INTS";
     case BREAK:
-        sprintf(instruction, "BREAK");
-        break;
+        return "BREAK";
     case CALL:
-        sprintf(instruction, "CALL");
-        break;
+        return "CALL";
     case LABEL:
-        sprintf(instruction, "LABEL");
-        break;
+        return "LABEL";
     case JUMP:
-        sprintf(instruction, "JUMP");
-        break;
+        return "JUMP";
     case JUMPIFEQS:
-        sprintf(instruction, "JUMPIFEQS");
-        break;
+        return "JUMPIFEQS";
     case JUMPIFNEQS:
-        sprintf(instruction, "JUMPIFNEQS");
-        break;
+        return "JUMPIFNEQS";
     case DEFVAR:
-        sprintf(instruction, "DEFVAR");
-        break;
+        return "DEFVAR";
     case POPS:
-        sprintf(instruction, "POPS");
-        break;
+        return "POPS";
     case PUSHS:
-        sprintf(instruction, "PUSHS");
-        break;
+        return "PUSHS";
     case WRITE:
-        sprintf(instruction, "WRITE");
-        break;
+        return "WRITE";
     case EXIT:
-        sprintf(instruction, "EXIT");
-        break;
+        return "EXIT";
     case DPRINT:
-        sprintf(instruction, "DPRINT");
-        break;
+        return "DPRINT";
     case READ:
-        sprintf(instruction, "READ");
-        break;
+        return "READ";
     case MOVE:
-        sprintf(instruction, "MOVE");
-        break;
+        return "MOVE";
     case INT2FLOAT:
-        sprintf(instruction, "INT2FLOAT");
-        break;
+        return "INT2FLOAT";
     case FLOAT2INT:
-        sprintf(instruction, "FLOAT2INT");
-        break;
+        return "FLOAT2INT";
     case INT2CHAR:
-        sprintf(instruction, "INT2CHAR");
-        break;
+        return "INT2CHAR";
     case STRI2INT:
-        sprintf(instruction, "STRI2INT");
-        break;
+        return "STRI2INT";
     case STRLEN:
-        sprintf(instruction, "STRLEN");
-        break;
+        return "STRLEN";
     case TYPE:
-        sprintf(instruction, "TYPE");
-        break;
+        return "TYPE";
     case ADD:
-        sprintf(instruction, "ADD");
-        break;
+        return "ADD";
     case SUB:
-        sprintf(instruction, "SUB");
-        break;
+        return "SUB";
     case DIV:
-        sprintf(instruction, "DIV");
-        break;
+        return "DIV";
     case IDIV:
-        sprintf(instruction, "IDIV");
-        break;
+        return "IDIV";
     case MUL:
-        sprintf(instruction, "MUL");
-        break;
+        return "MUL";
     case LT:
-        sprintf(instruction, "LT");
-        break;
+        return "LT";
     case GT:
-        sprintf(instruction, "GT");
-        break;
+        return "GT";
     case EQ:
-        sprintf(instruction, "EQ");
-        break;
+        return "EQ";
     case AND:
-        sprintf(instruction, "AND");
-        break;
+        return "AND";
     case OR:
-        sprintf(instruction, "OR");
-        break;
+        return "OR";
     case NOT:
-        sprintf(instruction, "NOT");
-        break;
+        return "NOT";
     case CONCAT:
-        sprintf(instruction, "CONCAT");
-        break;
+        return "CONCAT";
     case GETCHAR:
-        sprintf(instruction, "GETCHAR");
-        break;
+        return "GETCHAR";
     case SETCHAR:
-        sprintf(instruction, "SETCHAR");
-        break;
+        return "SETCHAR";
     case JUMPIFEQ:
-        sprintf(instruction, "JUMPIFEQ");
-        break;
+        return "JUMPIFEQ";
     case JUMPIFNEQ:
-        sprintf(instruction, "JUMPIFNEQ");
-        break;
+        return "JUMPIFNEQ";
     default:
-        sprintf(instruction, "UNKNOWN");
-        break;
+        return "UNKNOWN";
     }
-
-    return instruction;
 }
 
 Instruction stringToInstruction(char *str)
@@ -1268,177 +1184,65 @@ Instruction stringToInstruction(char *str)
     return EMPTY;
 }
 
-bool isBuiltInFunction(Token token)
+/**
+ * Builtin functions, the interned name of each function is tagged with its index + 1
+ */
+static const struct
 {
-
-    if (strcmp(token.token_value, "readString") == 0)
-    {
-        return true;
-    }
-    else if (strcmp(token.token_value, "readInt") == 0)
-    {
-        return true;
-    }
-    else if (strcmp(token.token_value, "readDouble") == 0)
-    {
-        return true;
-    }
-    else if (strcmp(token.token_value, "write") == 0)
-    {
-        return true;
-    }
-    else if (strcmp(token.token_value, "Int2Double") == 0)
-    {
-        return true;
-    }
-    else if (strcmp(token.token_value, "Double2Int") == 0)
-    {
-        return true;
-    }
-    else if (strcmp(token.token_value, "length") == 0)
-    {
-        return true;
-    }
-    else if (strcmp(token.token_value, "substring") == 0)
-    {
-        return true;
-    }
-    else if (strcmp(token.token_value, "ord") == 0)
-    {
-        return true;
-    }
-    else if (strcmp(token.token_value, "chr") == 0)
+    const char *name;
+    BuiltinFunc func;
+    Expression_type read_type;
+} builtin_functions[] = {
+    {"readString", B_READ, TYPE_STRING},
+    {"readInt", B_READ, TYPE_INT},
+    {"readDouble", B_READ, TYPE_DOUBLE},
+    {"write", B_WRITE, TYPE_INVALID},
+    {"Int2Double", B_INT2DOUBLE, TYPE_INVALID},
+    {"Double2Int", B_DOUBLE2INT, TYPE_INVALID},
+    {"length", B_LENGTH, TYPE_INVALID},
+    {"substring", B_SUBSTRING, TYPE_INVALID},
+    {"ord", B_ORD, TYPE_INVALID},
+    {"chr", B_CHR, TYPE_INVALID},
+};
+
+#define BUILTIN_FUNCTIONS_CNT (int)(sizeof(builtin_functions) / sizeof(*builtin_functions))
+
+void register_builtin_functions()
+{
+    for (int i = 0; i < BUILTIN_FUNCTIONS_CNT; i++)
     {
-        return true;
+        intern_set_tag(intern_cstr(builtin_functions[i].name), i + 1);
     }
+}
 
-    return false;
+bool isBuiltInFunction(Token token)
+{
+    // function ids are interned, the builtin ones carry a tag
+    int tag = intern_tag(token.token_value);
+    return tag > 0 && tag <= BUILTIN_FUNCTIONS_CNT;
 }
 
 BuiltinFunc getBuiltInFunctionName(Token token)
 {
-    if (strcmp(token.token_value, "readString") == 0)
-    {
-        return B_READ;
-    }
-    else if (strcmp(token.token_value, "readInt") == 0)
-    {
-        return B_READ;
-    }
-    else if (strcmp(token.token_value, "readDouble") == 0)
-    {
-        return B_READ;
-    }
-    else if (strcmp(token.token_value, "write") == 0)
-    {
-        return B_WRITE;
-    }
-    else if (strcmp(token.token_value, "Int2Double") == 0)
-    {
-        return B_INT2DOUBLE;
-    }
-    else if (strcmp(token.token_value, "Double2Int") == 0)
-    {
-        return B_DOUBLE2INT;
-    }
-    else if (strcmp(token.token_value, "length") == 0)
-    {
-        return B_LENGTH;
-    }
-    else if (strcmp(token.token_value, "substring") == 0)
-    {
-        return B_SUBSTRING;
-    }
-    else if (strcmp(token.token_value, "ord") == 0)
-    {
-        return B_ORD;
-    }
-    else if (strcmp(token.token_value, "chr") == 0)
-    {
-        return B_CHR;
-    }
-    else
+    if (!isBuiltInFunction(token))
     {
         throw_error(INTERNAL_ERR, -1, "wrong builtin function");
         return B_INVALID;
     }
+    return builtin_functions[intern_tag(token.token_value) - 1].func;
 }
 
 Expression_type getReadType(Token token)
 {
-    if (strcmp(token.token_value, "readString") == 0)
+    if (!isBuiltInFunction(token))
     {
-        return TYPE_STRING;
+        return TYPE_INVALID;
     }
-    else if (strcmp(token.token_value, "readInt") == 0)
-    {
-        return TYPE_INT;
-    }
-    else if (strcmp(token.token_value, "readDouble") == 0)
-    {
-        return TYPE_DOUBLE;
-    }
-    return TYPE_INVALID;
-}
-
-char *escapeString(char *input)
-{
-    char *result = malloc(strlen(input) * 4 + 1); // Alokace paměti s dostatečnou kapacitou
-    if (!result)
-    {
-        return NULL;
-    }
-
-    result[0] = '\0'; // Inicializace result jako prázdného řetězce
-    int pos = 0;
-    for (int i = 0; input[i] != '\0'; i++)
-    {
-        switch (input[i])
-        {
-        case '\0':
-            pos += sprintf(result + pos, "\\000");
-            break;
-        case '\a':
-            pos += sprintf(result + pos, "\\007");
-            break;
-        case '\b':
-            pos += sprintf(result + pos, "\\008");
-            break;
-        case '\t':
-            pos += sprintf(result + pos, "\\009");
-            break;
-        case '\n':
-            pos += sprintf(result + pos, "\\010");
-            break;
-        case '\v':
-            pos += sprintf(result + pos, "\\011");
-            break;
-        case '\f':
-            pos += sprintf(result + pos, "\\012");
-            break;
-        case '\r':
-            pos += sprintf(result + pos, "\\013");
-            break;
-        case ' ':
-            pos += sprintf(result + pos, "\\032");
-            break;
-        case '#':
-            pos += sprintf(result + pos, "\\035");
-            break;
-        case '\\':
-            pos += sprintf(result + pos, "\\092");
-            break;
-        default:
-            result[pos++] = input[i];
-            result[pos] = '\0'; // Udržujeme řetězec ukončený
-        }
-    }
-    return result;
+    return builtin_functions[intern_tag(token.token_value) - 1].read_type;
 }
 
 void copyFileContents(FILE *source, FILE *destination)
 {
-    char ch;
 
     // Check if either file is NULL
     if (source == NULL || destination == NULL)
@@ -1453,10 +1257,7 @@ void copyFileContents(FILE *source, FILE *destination)
     fprintf(destination, "# ======== while ========\n");
 
     // Read from source and write to destination
-    while ((ch = fgetc(source)) != EOF)
-    {
-        fputc(ch, destination);
-    }
+    copy_stream(source, destination);
 
     fprintf(destination, "# ====== end while ======\n");
 }
\ No newline at end of file
@@ -20,10 +20,6 @@
 #include "scanner.h"
 #include "stack.h"
 
-extern FILE *out_code_file;
-extern FILE *while_def_out_code_file;
-extern bool is_in_loop;
-
 typedef enum
 {
     EMPTY,
@@ -116,6 +112,17 @@ typedef enum
  */
 char *label(char *name);
 
+/**
+ * @brief Generates the name of a label numbered by the counters, inside of a function it is prefixed with the name
+ * of the function.
+ *
+ * @param format Format of the name with up to two %d.
+ * @param first First number.
+ * @param second Second number.
+ * @return char* - the name, released together with the syntax tree
+ */
+char *local_label(const char *format, int first, int second);
+
 /**
  * @brief Generates a type operand for IFJcode23.
  *
@@ -130,7 +137,7 @@ char *type(Expression_type type);
  * @param id Token with the id of the variable.
  * @param scope -1 for temporary, 0 for global, 1+ for local
  * @param has_suffix Whether the variable has a suffix with the scope index
- * @return char*
+ * @return char* - the operand, it is released together with the syntax tree
  */
 char *variable(char *id, int scope, bool has_suffix);
 
@@ -154,7 +161,7 @@ char *symbol(Token symbol);
  * @brief Returns the format of symb for IFJcode23.
  *
  * @param token Token with type and value.
- * @return char* - string with the variable in the format for IFJcode23
+ * @return char* - string with the variable in the format for IFJcode23, released together with the syntax tree
  */
 char *symb_resolve(Token token);
 
@@ -162,7 +169,7 @@ char *symb_resolve(Token token);
  * @brief Returns the format of the literal for IFJcode23.
  *
  * @param token Token record of the literal.
- * @return char* - string with the literal in the format for IFJcode23
+ * @return char* - string with the literal in the format for IFJcode23, released together with the syntax tree
  */
 char *format_token(Token token);
 
@@ -220,23 +227,38 @@ void processInstruction(Instruction inst, char **operands, int operands_count);
     } while (0)
 
 /**
- * @brief Prints the output code to stdout.
+ * @brief Prints the output code to the stream.
+ *
+ * @param out the stream
  */
-void print_out_code();
+void print_out_code(FILE *out);
 
 /**
  * @brief Generates the header of the IFJcode23 function.
  *
  * @param func_item symtable item of the function.
  */
-void generate_func_header(symtable_item func_item);
+void generate_func_header(char *name, char **params, int param_count);
 
 /**
  * @brief Generates the end of the IFJcode23 function.
  *
  * @param func_item symtable item of the function.
  */
-void generate_func_end(symtable_item func_item);
+void generate_func_end(char *name);
+
+/**
+ * @brief Starts the code of a function. The label and temporary counters start from zero in every function and its
+ * labels are prefixed with its name, so the code of the function does not depend on the code before it.
+ *
+ * @param name Name of the function.
+ */
+void generate_func_scope_begin(char *name);
+
+/**
+ * @brief Ends the code of a function, the counters of the code around it are restored.
+ */
+void generate_func_scope_end();
 
 /**
  * @brief Generates the IFJcode23 built-in function call.
@@ -246,9 +268,11 @@ void generate_func_end(symtable_item func_item);
 void generate_builtin_func_call(Token func, int param_count);
 
 /**
- * @brief Generates the IFJcode23 if header.
+ * @brief Generates the IFJcode23 if header, the condition is generated after it.
+ *
+ * @return char* - label the condition jumps to if it does not hold
  */
-void generate_if_start();
+char *generate_if_start();
 
 /**
  * @brief Generates the IFJcode23 the else part of the elseif.
@@ -256,9 +280,11 @@ void generate_if_start();
 void generate_elseif_else();
 
 /**
- * @brief Generates the IFJcode23 the if part of the elseif.
+ * @brief Generates the IFJcode23 the if part of the elseif, the condition is generated after it.
+ *
+ * @return char* - label the condition jumps to if it does not hold
  */
-void generate_elseif_if();
+char *generate_elseif_if();
 
 /**
  * @brief Generates the IFJcode23 else header.
@@ -276,9 +302,11 @@ void generate_if_end();
 void generate_while_start();
 
 /**
- * @brief Generates the IFJcode23 while condition.
+ * @brief Generates the IFJcode23 while condition header, the condition is generated after it.
+ *
+ * @return char* - label the condition jumps to if it does not hold
  */
-void generate_while_condition();
+char *generate_while_condition();
 
 /**
  * @brief Generates the IFJcode23 while end.
@@ -299,7 +327,7 @@ void generate_while_end();
  * @param var_item The symtable_item representing the variable to be initialized.
  *                 It contains information about the variable's initialization state and type.
  */
-void generate_implicit_init(symtable_item var_item);
+void generate_implicit_init(char *var);
 
 /**
  * @brief Generates the IFJcode23 a temporary variable initialization.
@@ -311,6 +339,13 @@ void generate_temp_pop();
  */
 void generate_temp_push();
 
+/**
+ * @brief Generates the IFJcode23 definition of a variable holding the result of a comparison in a condition.
+ *
+ * @return char* - the variable
+ */
+char *generate_condition_var();
+
 /**
  * @brief Generates the IFJcode23 for the nil coelacing operation.
  */
@@ -327,9 +362,9 @@ void generate_string_concat();
  * @brief Converts the instruction to string.
  *
  * @param in Instruction to be converted.
- * @return char* - string with the instruction
+ * @return const char* - name of the instruction, a constant string
  */
-char *instructionToString(Instruction in);
+const char *instructionToString(Instruction in);
 
 /**
  * @brief Converts the string to instruction.
@@ -339,6 +374,11 @@ char *instructionToString(Instruction in);
  */
 Instruction stringToInstruction(char *str);
 
+/**
+ * @brief Tags the interned names of the built-in functions, must be called before isBuiltInFunction.
+ */
+void register_builtin_functions();
+
 /**
  * @brief Checks if the token is a built-in function.
  *
@@ -364,14 +404,6 @@ BuiltinFunc getBuiltInFunctionName(Token token);
  */
 Expression_type getReadType(Token token);
 
-/**
- * @brief Replaces the special characters in the string with their escape sequences.
- *
- * @param input
- * @return char*
- */
-char *escapeString(char *input);
-
 /**
  * @brief Copies the contents of the source file to the destination file.
  *
@@ -380,16 +412,16 @@ char *escapeString(char *input);
  */
 void copyFileContents(FILE *source, FILE *destination);
 
-#define HANDLE_DEFVAR(provided_code)                 \
-    do                                               \
-    {                                                \
-        FILE *temp = out_code_file;                  \
-        if (is_in_loop)                              \
-        {                                            \
-            out_code_file = while_def_out_code_file; \
-        }                                            \
-        provided_code;                               \
-        out_code_file = temp;                        \
+#define HANDLE_DEFVAR(provided_code)                                     \
+    do                                                                   \
+    {                                                                    \
+        FILE *temp = compiler->out_code_file;                            \
+        if (compiler->is_in_loop)                                        \
+        {                                                                \
+            compiler->out_code_file = compiler->while_def_out_code_file; \
+        }                                                                \
+        provided_code;                                                   \
+        compiler->out_code_file = temp;                                  \
     } while (0)
 
 #endif // GENERATOR_H
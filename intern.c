@@ -0,0 +1,239 @@
+/**
+ * @file intern.c
+ * @brief Table of interned identifiers - every identifier is stored once and carries its precomputed hash.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "intern.h"
+#include "error.h"
+#include "compiler.h"
+
+#define INTERN_INITIAL_BUCKETS 256
+#define INTERN_BLOCK_SIZE (16 * 1024) // entries are allocated from blocks of this size
+
+/**
+ * @brief - Block of memory the entries are allocated from
+ */
+typedef struct Intern_block
+{
+    struct Intern_block *next;
+    size_t used;
+    size_t size;
+    char data[];
+} Intern_block;
+
+/**
+ * Table of the current compilation, the workers of the function pool intern to the table of the program
+ */
+static Intern_table *current_table()
+{
+    return compiler->parent != NULL ? &compiler->parent->intern : &compiler->intern;
+}
+
+static uint32_t intern_fnv(const char *str, size_t len)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (uint32_t)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static Intern_entry *entry_of(const char *interned)
+{
+    return (Intern_entry *)(interned - offsetof(Intern_entry, str));
+}
+
+/**
+ * Allocates the memory from the blocks of the table, the size is rounded up to keep the allocations aligned. Returns
+ * NULL if the allocation failed, the error is thrown by the caller once the lock of the table is released.
+ */
+static void *block_alloc(size_t size)
+{
+    Intern_table *table = current_table();
+    size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    if (table->blocks == NULL || table->blocks->size - table->blocks->used < size)
+    {
+        size_t block_size = size > INTERN_BLOCK_SIZE ? size : INTERN_BLOCK_SIZE;
+        Intern_block *block = malloc(sizeof(Intern_block) + block_size);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        block->next = table->blocks;
+        block->used = 0;
+        block->size = block_size;
+        table->blocks = block;
+    }
+    void *memory = table->blocks->data + table->blocks->used;
+    table->blocks->used += size;
+    return memory;
+}
+
+static Intern_entry *alloc_entry(size_t len)
+{
+    return block_alloc(offsetof(Intern_entry, str) + len + 1);
+}
+
+/**
+ * Doubles the count of buckets, returns false if the allocation failed
+ */
+static bool grow_buckets()
+{
+    Intern_table *table = current_table();
+    size_t new_cnt = table->bucket_cnt == 0 ? INTERN_INITIAL_BUCKETS : table->bucket_cnt * 2;
+    Intern_entry **new_buckets = calloc(new_cnt, sizeof(Intern_entry *));
+    if (new_buckets == NULL)
+    {
+        return false;
+    }
+    // rehash using the cached hashes
+    for (size_t i = 0; i < table->bucket_cnt; i++)
+    {
+        Intern_entry *entry = table->buckets[i];
+        while (entry != NULL)
+        {
+            Intern_entry *next = entry->next;
+            size_t idx = entry->hash & (new_cnt - 1);
+            entry->next = new_buckets[idx];
+            new_buckets[idx] = entry;
+            entry = next;
+        }
+    }
+    free(table->buckets);
+    table->buckets = new_buckets;
+    table->bucket_cnt = new_cnt;
+    return true;
+}
+
+/**
+ * Looks up the string and inserts it if it is not in the table yet, returns NULL if the allocation failed
+ */
+static char *intern_insert(const char *str, size_t len)
+{
+    Intern_table *table = current_table();
+    if (table->entry_cnt >= table->bucket_cnt - table->bucket_cnt / 4 && !grow_buckets())
+    {
+        return NULL;
+    }
+
+    uint32_t hash = intern_fnv(str, len);
+    Intern_entry **slot = &table->buckets[hash & (table->bucket_cnt - 1)];
+    for (Intern_entry *entry = *slot; entry != NULL; entry = entry->next)
+    {
+        if (entry->hash == hash && entry->len == len && memcmp(entry->str, str, len) == 0)
+        {
+            return entry->str;
+        }
+    }
+
+    Intern_entry *entry = alloc_entry(len);
+    if (entry == NULL)
+    {
+        return NULL;
+    }
+    entry->hash = hash;
+    entry->len = (uint32_t)len;
+    entry->tag = 0;
+    memcpy(entry->str, str, len);
+    entry->str[len] = '\0';
+    entry->next = *slot;
+    *slot = entry;
+    table->entry_cnt++;
+    return entry->str;
+}
+
+char *intern(const char *str, size_t len)
+{
+    Intern_table *table = current_table();
+    char *interned;
+    if (!table->is_concurrent)
+    {
+        interned = intern_insert(str, len);
+    }
+    else
+    {
+        pthread_mutex_lock(&table->lock);
+        interned = intern_insert(str, len);
+        pthread_mutex_unlock(&table->lock);
+    }
+    if (interned == NULL)
+    {
+        throw_error(INTERNAL_ERR, -1, "Memory allocation for identifier failed.");
+    }
+    return interned;
+}
+
+void *intern_alloc(size_t size)
+{
+    Intern_table *table = current_table();
+    void *memory;
+    if (!table->is_concurrent)
+    {
+        memory = block_alloc(size);
+    }
+    else
+    {
+        pthread_mutex_lock(&table->lock);
+        memory = block_alloc(size);
+        pthread_mutex_unlock(&table->lock);
+    }
+    if (memory == NULL)
+    {
+        throw_error(INTERNAL_ERR, -1, "Memory allocation for identifier failed.");
+    }
+    return memory;
+}
+
+void intern_set_concurrent(bool concurrent)
+{
+    Intern_table *table = current_table();
+    table->is_concurrent = concurrent;
+}
+
+char *intern_cstr(const char *str)
+{
+    return intern(str, strlen(str));
+}
+
+uint32_t intern_hash(const char *interned)
+{
+    return entry_of(interned)->hash;
+}
+
+int intern_tag(const char *interned)
+{
+    return entry_of(interned)->tag;
+}
+
+void intern_set_tag(const char *interned, int tag)
+{
+    entry_of(interned)->tag = tag;
+}
+
+void intern_free()
+{
+    Intern_table *table = &compiler->intern;
+    while (table->blocks != NULL)
+    {
+        Intern_block *next = table->blocks->next;
+        free(table->blocks);
+        table->blocks = next;
+    }
+    free(table->buckets);
+    table->buckets = NULL;
+    table->bucket_cnt = 0;
+    table->entry_cnt = 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file intern.h
+ * @brief Table of interned identifiers - every identifier is stored once and carries its precomputed hash.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/**
+ * @brief - Interned identifier, the characters are stored right after the header
+ * @param next - next entry in the same bucket of the intern table
+ * @param hash - FNV-1a hash of the identifier
+ * @param len - length of the identifier
+ * @param tag - user value attached to the identifier, 0 if not set
+ * @param str - characters of the identifier terminated by '\0'
+ */
+typedef struct Intern_entry
+{
+    struct Intern_entry *next;
+    uint32_t hash;
+    uint32_t len;
+    int tag;
+    char str[];
+} Intern_entry;
+
+/**
+ * @brief - Hash table of the interned strings of one compilation
+ * @param buckets - chains of the entries
+ * @param bucket_cnt - count of the buckets, a power of two
+ * @param entry_cnt - count of the entries
+ * @param blocks - memory the entries are allocated from
+ * @param is_concurrent - the table is locked on every intern
+ * @param lock - lock of the table
+ */
+typedef struct
+{
+    Intern_entry **buckets;
+    size_t bucket_cnt;
+    size_t entry_cnt;
+    struct Intern_block *blocks;
+    bool is_concurrent;
+    pthread_mutex_t lock;
+} Intern_table;
+
+/**
+ * @brief Returns the unique copy of the string, equal strings are always interned to the same pointer.
+ *
+ * @param str characters of the string (need not be terminated)
+ * @param len length of the string
+ * @return char* - pointer to the interned string, valid until intern_free is called
+ */
+char *intern(const char *str, size_t len);
+
+/**
+ * @brief Interns '\0' terminated string.
+ *
+ * @param str string to intern
+ * @return char* - pointer to the interned string
+ */
+char *intern_cstr(const char *str);
+
+/**
+ * @brief Returns the precomputed FNV-1a hash of the interned string.
+ *
+ * @param interned string returned by intern
+ * @return uint32_t - hash of the string
+ */
+uint32_t intern_hash(const char *interned);
+
+/**
+ * @brief Returns the tag attached to the interned string.
+ *
+ * @param interned string returned by intern
+ * @return int - tag of the string, 0 if not set
+ */
+int intern_tag(const char *interned);
+
+/**
+ * @brief Attaches the tag to the interned string.
+ *
+ * @param interned string returned by intern
+ * @param tag value to attach
+ */
+void intern_set_tag(const char *interned, int tag);
+
+/**
+ * @brief Allocates memory that lives as long as the interned strings, it is released by intern_free.
+ * Used for the values of the tokens that are not interned.
+ *
+ * @param size size of the allocation
+ * @return void* - pointer aligned for any value
+ */
+void *intern_alloc(size_t size);
+
+/**
+ * @brief Switches the locking of the table, it has to be enabled while several threads may intern at once.
+ * Tags are not guarded, they may be set only while a single thread uses the table.
+ *
+ * @param concurrent true to lock the table on every intern
+ */
+void intern_set_concurrent(bool concurrent);
+
+/**
+ * @brief Frees all the interned strings, the pointers returned by intern become invalid.
+ */
+void intern_free();
+
+#endif // INTERN_H
@@ -14,17 +14,12 @@
 
 PSA_Token readNextToken(PSA_Token_stack *s, char *next_token_error, int *num_of_brackets, bool ignore_func_call)
 {
-    Token *tkn = malloc(sizeof(Token));
-    if (tkn == NULL)
-    {
-        throw_error(INTERNAL_ERR, -1, "Memory allocation for next PSA token failed.");
-        return PSA_TOKEN_EOF;
-    }
-    *tkn = (Token){
+    Token next_token = {
         .type = (Token_type)TOKEN_EOF,
         .token_value = "$",
         .preceded_by_nl = true,
     };
+    Token *tkn = &next_token;
 
     Error_code scanner_returned = (Error_code)main_scanner(tkn);
     if (scanner_returned != NO_ERR)
@@ -33,7 +28,7 @@ PSA_Token readNextToken(PSA_Token_stack *s, char *next_token_error, int *num_of_
         DEBUG_PSA_CODE(printf_red("\nSCANNER VRATIL: ");
                        printError((Error){
                            .code = scanner_returned,
-                           .line_num = line_num,
+                           .line_num = tkn->line_num,
                            .message = "Scanner error."});
                        printf("\n\n"););
     }
@@ -50,20 +45,19 @@ PSA_Token readNextToken(PSA_Token_stack *s, char *next_token_error, int *num_of_
         .preceded_by_nl = tkn->type == TOKEN_EOF ? true : tkn->preceded_by_nl,
         .is_literal = isTokenLiteral(tkn->type),
         .line_num = tkn->line_num,
+        .literal = tkn->literal,
     };
 
-    free(tkn);
-
     PSA_Token a = PSA_TOKEN_EOF;
 
-    if (s != NULL && !PSA_Token_stack_empty(s) && s->top != NULL)
+    if (s != NULL && !PSA_Token_stack_empty(s))
     {
-        a = PSA_Token_stack_top(s); // HERE IS THE SEGFAULT
+        a = PSA_Token_stack_top(s);
     }
 
     bool is_func_call = b.type == TOKEN_FUNC_ID;
     bool is_after_binary_operator = isTokenBinaryOperator(a.type);
-    bool is_after_unwrap_operator = s->size >= 2 && a.type == TOKEN_NOT && s->top->next->data.type == TOKEN_EXPRSN;
+    bool is_after_unwrap_operator = s->size >= 2 && a.type == TOKEN_NOT && s->items[s->size - 2].type == TOKEN_EXPRSN;
     bool is_first_token = a.type == TOKEN_EOF;
     if (is_func_call && !ignore_func_call)
     {
@@ -73,24 +67,10 @@ PSA_Token readNextToken(PSA_Token_stack *s, char *next_token_error, int *num_of_
             DEBUG_PSA_CODE(PSA_Token og_b = b;
                            printf("func call: %s\n", og_b.token_value););
 
+            // the whole call is parsed at once, the token carries its syntax tree
             int param_count = 0;
             b = parseFunctionCall(s, b, &param_count);
 
-            // YEET - tady se vola a funkce
-
-            if (b.expr_type != TYPE_INVALID && b.type != TOKEN_EOF)
-            {
-                if (isBuiltInFunction(convertPSATokenToToken(b)))
-                {
-                    generate_builtin_func_call(convertPSATokenToToken(b), param_count);
-                }
-                else
-                {
-                    generate_instruction(CALL, label(b.token_value));
-                    generate_instruction(PUSHS, variable("retval", -1, false));
-                }
-            }
-
             DEBUG_PSA_CODE(printf_cyan("func call type: ");
                            print_expression_type(b.expr_type););
         }
@@ -141,24 +121,17 @@ PSA_Token readNextToken(PSA_Token_stack *s, char *next_token_error, int *num_of_
     return b;
 }
 
-void printStackRec(PSA_Token_node *top)
+void printStack(PSA_Token_stack *s)
 {
-    if (top == NULL)
+    if (s->size == 0)
     {
+        printf("Stack empty!\n");
         return;
     }
-    printStackRec(top->next);
-    printf("%s", top->data.token_value);
-}
-
-void printStack(PSA_Token_node *top)
-{
-    if (top == NULL)
+    for (unsigned int i = 0; i < s->size; i++)
     {
-        printf("Stack empty!\n");
-        return;
+        printf("%s", s->items[i].token_value);
     }
-    printStackRec(top);
     printf("\n");
 }
 
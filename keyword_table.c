@@ -0,0 +1,70 @@
+/**
+ * @file keyword_table.c
+ * @brief Perfect hash table of keywords, generated by utils/create_keyword_table.py - do not edit by hand.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <string.h>
+#include "scanner.h"
+
+#define KEYWORD_TABLE_SIZE 32
+#define KEYWORD_LEN_MUL 10
+#define KEYWORD_FIRST_MUL 6
+
+/**
+ * @brief - Entry of the keyword table
+ * @param code - keyword, NULL for an empty slot
+ * @param len - length of the keyword
+ * @param token - token type of the keyword
+ */
+typedef struct
+{
+    const char *code;
+    size_t len;
+    Token_type token;
+} Keyword_entry;
+
+/**
+ * Keywords indexed by their hash
+ */
+static const Keyword_entry keyword_table[KEYWORD_TABLE_SIZE] = {
+    [0] = {"Bool", 4, TOKEN_TYPE_BOOL},
+    [1] = {"while", 5, TOKEN_WHILE},
+    [5] = {"true", 4, TOKEN_BOOL},
+    [7] = {"continue", 8, TOKEN_CONTINUE},
+    [8] = {"Int", 3, TOKEN_TYPE_INT},
+    [9] = {"break", 5, TOKEN_BREAK},
+    [11] = {"else", 4, TOKEN_ELSE},
+    [15] = {"func", 4, TOKEN_FUNC},
+    [16] = {"if", 2, TOKEN_IF},
+    [20] = {"var", 3, TOKEN_VAR},
+    [21] = {"String", 6, TOKEN_TYPE_STRING},
+    [22] = {"return", 6, TOKEN_RETURN},
+    [25] = {"Double", 6, TOKEN_TYPE_DOUBLE},
+    [26] = {"let", 3, TOKEN_LET},
+    [27] = {"false", 5, TOKEN_BOOL},
+    [30] = {"nil", 3, TOKEN_NIL},
+};
+
+bool keyword_lookup(const char *code, size_t len, Token_type *type)
+{
+    if (len == 0)
+    {
+        return false;
+    }
+    unsigned int hash = (unsigned int)(len * KEYWORD_LEN_MUL + (unsigned char)code[0] * KEYWORD_FIRST_MUL +
+                                       (unsigned char)code[len - 1]) &
+                        (KEYWORD_TABLE_SIZE - 1);
+    const Keyword_entry *entry = &keyword_table[hash];
+    if (entry->len != len || memcmp(entry->code, code, len) != 0)
+    {
+        return false;
+    }
+    *type = entry->token;
+    return true;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file lazy.c
+ * @brief Lazy compilation, only the functions the program can call are compiled.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "lazy.h"
+#include "compiler.h"
+
+/**
+ * @brief - Call found by the skim
+ * @param caller - function whose body the call is in, NULL outside of the functions
+ * @param callee - name of the called function
+ */
+typedef struct
+{
+    char *caller;
+    char *callee;
+} Lazy_call;
+
+// the names are interned, so they are ordered by their addresses
+static int compare_names(const char *a, const char *b)
+{
+    return ((uintptr_t)a > (uintptr_t)b) - ((uintptr_t)a < (uintptr_t)b);
+}
+
+static int compare_funcs(const void *a, const void *b)
+{
+    return compare_names(((const Lazy_func *)a)->name, ((const Lazy_func *)b)->name);
+}
+
+static int compare_calls(const void *a, const void *b)
+{
+    return compare_names(((const Lazy_call *)a)->caller, ((const Lazy_call *)b)->caller);
+}
+
+static Lazy_func *find_func(char *name)
+{
+    Lazy_func key = {.name = name, .reachable = false};
+    return bsearch(&key, compiler->lazy_funcs, compiler->lazy_func_count, sizeof(Lazy_func), compare_funcs);
+}
+
+/**
+ * @brief Returns the index of the first call from the caller in the calls sorted by the caller.
+ */
+static size_t first_call(Lazy_call *calls, size_t count, char *caller)
+{
+    size_t low = 0, high = count;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (compare_names(calls[mid].caller, caller) < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * @brief Appends the item to the array allocated by malloc, the capacity is doubled when it is full.
+ *
+ * @return false if the array could not be grown
+ */
+static bool append(void **array, size_t *count, size_t *cap, const void *item, size_t size)
+{
+    if (*count == *cap)
+    {
+        size_t new_cap = *cap == 0 ? 64 : *cap * 2;
+        void *grown = realloc(*array, size * new_cap);
+        if (grown == NULL)
+        {
+            return false;
+        }
+        *array = grown;
+        *cap = new_cap;
+    }
+    memcpy((char *)*array + size * (*count)++, item, size);
+    return true;
+}
+
+void lazy_skim()
+{
+    Token_buffer *buffer = &compiler->token_buffer;
+    size_t end = buffer->count < buffer->error_pos ? buffer->count : buffer->error_pos;
+    Lazy_func *funcs = NULL;
+    Lazy_call *calls = NULL;
+    size_t func_count = 0, func_cap = 0, call_count = 0, call_cap = 0;
+
+    // the functions of the global block and the calls, the bodies are told apart by matching the braces
+    bool ok = true;
+    int depth = 0;
+    char *header = NULL;  // function whose header is being read
+    char *current = NULL; // function whose body is being read
+    for (size_t pos = 0; pos < end && ok; pos++)
+    {
+        switch (buffer->types[pos])
+        {
+        case TOKEN_FUNC:
+            if (depth == 0 && pos + 1 < end && buffer->types[pos + 1] == TOKEN_FUNC_ID)
+            {
+                header = buffer->values[++pos];
+            }
+            break;
+        case TOKEN_L_CURLY:
+            if (depth++ == 0 && header != NULL)
+            {
+                current = header;
+                header = NULL;
+                Lazy_func func = {.name = current, .reachable = false};
+                ok = append((void **)&funcs, &func_count, &func_cap, &func, sizeof(Lazy_func));
+
+                // the body left out of the source by the function cache has no tokens, its entry keeps the calls
+                char **callees;
+                size_t callee_count = func_cache_callees(current, &callees);
+                for (size_t i = 0; i < callee_count && ok; i++)
+                {
+                    Lazy_call call = {.caller = current, .callee = callees[i]};
+                    ok = append((void **)&calls, &call_count, &call_cap, &call, sizeof(Lazy_call));
+                }
+            }
+            break;
+        case TOKEN_R_CURLY:
+            if (depth > 0 && --depth == 0)
+            {
+                current = NULL;
+            }
+            break;
+        case TOKEN_FUNC_ID:
+        {
+            Lazy_call call = {.caller = current, .callee = buffer->values[pos]};
+            ok = append((void **)&calls, &call_count, &call_cap, &call, sizeof(Lazy_call));
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // a function defined twice is reported by the parser, one entry per name is enough
+    size_t unique = 0;
+    if (ok && func_count > 0)
+    {
+        qsort(funcs, func_count, sizeof(Lazy_func), compare_funcs);
+        for (size_t i = 0; i < func_count; i++)
+        {
+            if (unique == 0 || funcs[unique - 1].name != funcs[i].name)
+            {
+                funcs[unique++] = funcs[i];
+            }
+        }
+        compiler->lazy_funcs = ast_alloc(sizeof(Lazy_func) * unique);
+        memcpy(compiler->lazy_funcs, funcs, sizeof(Lazy_func) * unique);
+        compiler->lazy_func_count = unique;
+    }
+    free(funcs);
+
+    // the functions called outside of the functions and everything they call
+    char **pending = ok && unique > 0 ? malloc(sizeof(char *) * unique) : NULL;
+    if (pending != NULL)
+    {
+        if (call_count > 0)
+        {
+            qsort(calls, call_count, sizeof(Lazy_call), compare_calls);
+        }
+        size_t pending_count = 0;
+        char *caller = NULL;
+        bool from_main = true;
+        while (from_main || pending_count > 0)
+        {
+            if (!from_main)
+            {
+                caller = pending[--pending_count];
+            }
+            from_main = false;
+            for (size_t i = first_call(calls, call_count, caller); i < call_count && calls[i].caller == caller; i++)
+            {
+                Lazy_func *func = find_func(calls[i].callee);
+                if (func != NULL && !func->reachable)
+                {
+                    func->reachable = true;
+                    pending[pending_count++] = func->name;
+                }
+            }
+        }
+    }
+    else
+    {
+        // without the graph every function is compiled
+        compiler->lazy_funcs = NULL;
+        compiler->lazy_func_count = 0;
+    }
+    free(pending);
+    free(calls);
+}
+
+bool lazy_unreachable(char *name)
+{
+    if (!compiler->lazy || compiler->lazy_funcs == NULL)
+    {
+        return false;
+    }
+    Lazy_func *func = find_func(name);
+    return func != NULL && !func->reachable;
+}
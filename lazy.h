@@ -0,0 +1,46 @@
+/**
+ * @file lazy.h
+ * @brief Lazy compilation, only the functions the program can call are compiled.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ * Before the parser starts, one pass over the tokens finds the functions of the global block and the functions
+ * their bodies and the code outside of them call. The functions reachable from the code outside of the functions
+ * are compiled as usual. The bodies of the others are only brace-matched and no code is generated for them, unless
+ * they are to be checked, then they are parsed and checked but still not generated.
+ */
+
+#ifndef LAZY_H
+#define LAZY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief - Function of the global block found by the skim
+ * @param name - interned name of the function
+ * @param reachable - the function can be called from the code outside of the functions
+ */
+typedef struct
+{
+    char *name;
+    bool reachable;
+} Lazy_func;
+
+/**
+ * @brief Finds the functions reachable from the code outside of the functions, the whole input must be tokenized.
+ */
+void lazy_skim();
+
+/**
+ * @brief Tells whether the function of the global block can never be called.
+ *
+ * @param name interned name of the function
+ * @return true if the compilation is lazy and the function is not reachable
+ */
+bool lazy_unreachable(char *name);
+
+#endif // LAZY_H
@@ -0,0 +1,371 @@
+/**
+ * @file link.c
+ * @brief Programs of several source files, the files are read in parallel and linked into one token stream.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "link.h"
+#include "compiler.h"
+
+/**
+ * @brief - Function defined by a source file
+ * @param name - interned name of the function
+ * @param line - line of the name in the program
+ */
+typedef struct
+{
+    char *name;
+    int line;
+} Link_func;
+
+/**
+ * @brief - Source file read by a thread
+ * @param path - path of the file
+ * @param tokens - tokens of the file, the lines are the lines of the file
+ * @param line_count - line of the end of the file
+ * @param funcs - functions defined by the file, the lines are the lines of the file
+ * @param func_count - count of funcs
+ * @param func_cap - capacity of funcs
+ * @param cache_funcs - functions found by the skim of the function cache, the lines are the lines of the file
+ * @param error - error of the file, NO_ERR if it has been read
+ */
+typedef struct
+{
+    const char *path;
+    Token_buffer tokens;
+    int line_count;
+    Link_func *funcs;
+    size_t func_count;
+    size_t func_cap;
+    Func_cache_list cache_funcs;
+    Error error;
+} Link_unit;
+
+/**
+ * @brief - Files of a program, the threads take the next file to read under the lock
+ * @param program - compilation the identifiers are interned into
+ * @param units - the files in the order of the command line
+ * @param count - count of units
+ * @param next - index of the next file to read
+ * @param lock - lock of next
+ */
+typedef struct
+{
+    Compiler *program;
+    Link_unit *units;
+    int count;
+    int next;
+    pthread_mutex_t lock;
+} Link_job;
+
+/// READING THE FILES
+
+static void unit_add_func(Link_unit *unit, char *name, int line)
+{
+    if (unit->func_count == unit->func_cap)
+    {
+        size_t cap = unit->func_cap == 0 ? 16 : unit->func_cap * 2;
+        Link_func *funcs = realloc(unit->funcs, sizeof(Link_func) * cap);
+        if (funcs == NULL)
+        {
+            throw_error(INTERNAL_ERR, -1, "Memory allocation failed.");
+        }
+        unit->funcs = funcs;
+        unit->func_cap = cap;
+    }
+    unit->funcs[unit->func_count++] = (Link_func){.name = name, .line = line};
+}
+
+/**
+ * @brief Finds the functions of the global block of the file, the bodies are told apart by matching the braces.
+ */
+static void unit_scan_funcs(Link_unit *unit)
+{
+    Token_buffer *tokens = &unit->tokens;
+    size_t end = tokens->count < tokens->error_pos ? tokens->count : tokens->error_pos;
+    int depth = 0;
+    for (size_t pos = 0; pos < end; pos++)
+    {
+        switch (tokens->types[pos])
+        {
+        case TOKEN_FUNC:
+            if (depth == 0 && pos + 1 < end && tokens->types[pos + 1] == TOKEN_FUNC_ID)
+            {
+                pos++;
+                unit_add_func(unit, tokens->values[pos], tokens->lines[pos]);
+            }
+            break;
+        case TOKEN_L_CURLY:
+            depth++;
+            break;
+        case TOKEN_R_CURLY:
+            depth--;
+            break;
+        default:
+            break;
+        }
+    }
+
+    // the next file must not continue the block, the parser would not tell the files apart
+    if (tokens->error_pos == SIZE_MAX && depth > 0)
+    {
+        throw_error(SYNTACTIC_ERR, unit->line_count, "File %s ends inside of a block.", unit->path);
+    }
+}
+
+/**
+ * @brief Reads the tokens and the functions of the file, the errors are kept in the unit.
+ */
+static void unit_read(Compiler *ctx, Link_unit *unit)
+{
+    jmp_buf on_error;
+    ctx->on_error = &on_error;
+    if (setjmp(on_error) == 0)
+    {
+        scanner_open(unit->path);
+        func_cache_skim(); // the bodies in the cache of the program are left out
+        unit->cache_funcs = ctx->cache_funcs;
+        ctx->cache_funcs = (Func_cache_list){.funcs = NULL, .count = 0, .cap = 0};
+        scanner_pretokenize(1); // the files are the parallel parts
+        unit->tokens = ctx->token_buffer;
+        ctx->token_buffer = (Token_buffer){.types = NULL, .count = 0, .cap = 0, .pos = 0, .is_active = false};
+        unit->line_count = unit->tokens.error_pos == SIZE_MAX ? unit->tokens.lines[unit->tokens.count - 1]
+                                                               : unit->tokens.error_line;
+        unit_scan_funcs(unit);
+    }
+    else if (ctx->error_st != NULL && !Error_stack_empty(ctx->error_st))
+    {
+        unit->error = Error_stack_pop(ctx->error_st);
+    }
+    ctx->on_error = NULL;
+    compiler_reset(ctx);
+}
+
+static void *link_worker(void *arg)
+{
+    Link_job *job = arg;
+    Compiler *ctx = malloc(sizeof(Compiler));
+    if (ctx == NULL)
+    {
+        return NULL;
+    }
+    compiler_init(ctx, NULL);
+    ctx->parent = job->program;
+
+    while (true)
+    {
+        pthread_mutex_lock(&job->lock);
+        int i = job->next < job->count ? job->next++ : -1;
+        pthread_mutex_unlock(&job->lock);
+        if (i < 0)
+        {
+            break;
+        }
+        unit_read(ctx, &job->units[i]);
+    }
+
+    // the identifiers belong to the program
+    ctx->parent = NULL;
+    compiler_free(ctx);
+    free(ctx);
+    return NULL;
+}
+
+/// LINKING
+
+static int compare_funcs(const void *a, const void *b)
+{
+    const Link_func *fa = a, *fb = b;
+    if (fa->name != fb->name)
+    {
+        // the names are interned, so they are ordered by their addresses
+        return ((uintptr_t)fa->name > (uintptr_t)fb->name) - ((uintptr_t)fa->name < (uintptr_t)fb->name);
+    }
+    return (fa->line > fb->line) - (fa->line < fb->line);
+}
+
+/**
+ * @brief Collects the functions of the files linked, the lines are the lines of the program.
+ */
+static Link_func *collect_funcs(Link_job *job, size_t *count)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < compiler->file_count; i++)
+    {
+        total += job->units[i].func_count;
+    }
+    *count = 0;
+    Link_func *funcs = ast_alloc(sizeof(Link_func) * (total > 0 ? total : 1));
+    for (size_t i = 0; i < compiler->file_count; i++)
+    {
+        Link_unit *unit = &job->units[i];
+        for (size_t j = 0; j < unit->func_count; j++)
+        {
+            funcs[*count] = unit->funcs[j];
+            funcs[(*count)++].line += compiler->files[i].first_line - 1;
+        }
+    }
+    return funcs;
+}
+
+/**
+ * @brief Reports the function defined again closest to the beginning of the program.
+ */
+static void check_duplicates(Link_func *funcs, size_t count)
+{
+    qsort(funcs, count, sizeof(Link_func), compare_funcs);
+    Link_func *again = NULL;
+    Link_func *first = NULL;
+    for (size_t i = 1; i < count; i++)
+    {
+        if (funcs[i].name == funcs[i - 1].name && (again == NULL || funcs[i].line < again->line))
+        {
+            again = &funcs[i];
+            first = &funcs[i - 1];
+            while (first > funcs && (first - 1)->name == first->name)
+            {
+                first--;
+            }
+        }
+    }
+    if (again != NULL)
+    {
+        const Source_file *file = link_file_of_line(first->line);
+        throw_error(FUNCTIONS_ERR, again->line, "Function %s is already defined in %s:%d.", again->name, file->path,
+                    first->line - file->first_line + 1);
+    }
+}
+
+static void job_free(Link_job *job)
+{
+    for (int i = 0; i < job->count; i++)
+    {
+        scanner_take_tokens(&job->units[i].tokens, 0, 0);
+        free(job->units[i].funcs);
+        free(job->units[i].cache_funcs.funcs);
+        free(job->units[i].error.message);
+    }
+    free(job->units);
+    pthread_mutex_destroy(&job->lock);
+}
+
+void link_open(const char *const *paths, int count, int threads)
+{
+    scanner_open_buffer(NULL, 0); // the program has no source of its own, only the tokens of the files
+
+    Link_job job = {.program = compiler, .units = calloc((size_t)count, sizeof(Link_unit)), .count = count, .next = 0};
+    if (job.units == NULL)
+    {
+        throw_error(INTERNAL_ERR, -1, "Memory allocation failed.");
+    }
+    pthread_mutex_init(&job.lock, NULL);
+    for (int i = 0; i < count; i++)
+    {
+        job.units[i].path = paths[i];
+        job.units[i].error.code = NO_ERR;
+    }
+
+    if (threads <= 0)
+    {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = processors > 1 ? (int)processors : 1;
+    }
+    threads = threads < count ? threads : count;
+    pthread_t *workers = calloc((size_t)threads, sizeof(pthread_t));
+    int started = 0;
+    intern_set_concurrent(true);
+    while (workers != NULL && started < threads && pthread_create(&workers[started], NULL, link_worker, &job) == 0)
+    {
+        started++;
+    }
+    if (started == 0)
+    {
+        // the files are read one by one, the worker has a compilation of its own
+        Compiler *program = compiler;
+        link_worker(&job);
+        compiler = program;
+    }
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+    intern_set_concurrent(false);
+    free(workers);
+
+    // the tokens of the files follow each other, a lexical error ends the program where the parser reports it
+    compiler->files = ast_alloc(sizeof(Source_file) * count);
+    int line_delta = 0;
+    bool is_done = false;
+    Error error = {.code = NO_ERR, .line_num = 0, .message = NULL};
+    for (int i = 0; i < count && !is_done; i++)
+    {
+        Link_unit *unit = &job.units[i];
+        compiler->files[compiler->file_count++] = (Source_file){.path = unit->path, .first_line = line_delta + 1};
+        if (unit->error.code != NO_ERR)
+        {
+            error = unit->error;
+            if ((int)error.line_num > 0)
+            {
+                error.line_num += line_delta;
+            }
+            unit->error.message = NULL;
+            break;
+        }
+
+        func_cache_add(&unit->cache_funcs, line_delta + 1);
+        bool is_last = i == count - 1;
+        if (unit->tokens.error_pos != SIZE_MAX)
+        {
+            scanner_take_tokens(&unit->tokens, unit->tokens.error_pos, line_delta);
+            compiler->token_buffer.error_pos = compiler->token_buffer.count;
+            compiler->token_buffer.error_line = unit->line_count + line_delta;
+            is_done = true;
+        }
+        else
+        {
+            // only the last end of file is kept
+            scanner_take_tokens(&unit->tokens, unit->tokens.count - (is_last ? 0 : 1), line_delta);
+        }
+        line_delta += unit->line_count;
+    }
+    compiler->main_lexer.line_num = line_delta;
+
+    size_t func_count;
+    Link_func *funcs = collect_funcs(&job, &func_count);
+    job_free(&job);
+    if (error.code != NO_ERR)
+    {
+        throw_error_base(error.code, error.message, (int)error.line_num);
+    }
+    if (compiler->token_buffer.error_pos == SIZE_MAX)
+    {
+        check_duplicates(funcs, func_count);
+    }
+}
+
+const Source_file *link_file_of_line(int line)
+{
+    if (compiler->files == NULL || line < 1)
+    {
+        return NULL;
+    }
+    const Source_file *file = &compiler->files[0];
+    for (size_t i = 1; i < compiler->file_count && compiler->files[i].first_line <= line; i++)
+    {
+        file = &compiler->files[i];
+    }
+    return file;
+}
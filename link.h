@@ -0,0 +1,49 @@
+/**
+ * @file link.h
+ * @brief Programs of several source files, the files are read in parallel and linked into one token stream.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ * Each file is lexed by a thread of its own, which also finds the functions the file defines. The tokens of the files
+ * are then put one after another in the order of the command line, so the program has one header, its main body is
+ * made of the main bodies of the files in that order and the functions of all the files are visible everywhere. The
+ * lines of the files are numbered on as if the files were one, the errors are printed with the file and its own line.
+ */
+
+#ifndef LINK_H
+#define LINK_H
+
+/**
+ * @brief - Source file of a program of several files
+ * @param path - path of the file given on the command line
+ * @param first_line - number of the first line of the file in the lines of the program
+ */
+typedef struct
+{
+    const char *path;
+    int first_line;
+} Source_file;
+
+/**
+ * @brief Reads the source files in parallel and puts their tokens together into the token buffer of the compilation.
+ * A function defined twice, a file that cannot be read and a file ending inside of a block are reported here, other
+ * errors are reported by the parser.
+ *
+ * @param paths paths of the source files
+ * @param count count of paths
+ * @param threads count of threads to read with, 0 chooses it by the count of processors
+ */
+void link_open(const char *const *paths, int count, int threads);
+
+/**
+ * @brief Finds the source file of the line of the program.
+ *
+ * @param line line of the program
+ * @return const Source_file* - the file, NULL if the program is read from one input or the line is not valid
+ */
+const Source_file *link_file_of_line(int line);
+
+#endif // LINK_H
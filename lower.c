@@ -0,0 +1,696 @@
+/**
+ * @file lower.c
+ * @brief Lowering of the abstract syntax tree to IFJcode23, the order of the instructions is the order in which the
+ * parser used to generate them.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <string.h>
+#include "lower.h"
+#include "psa.h"
+#include "compiler.h"
+#include "func_cache.h"
+#include "func_pool.h"
+
+/// OPERANDS
+
+static char *var_operand(Ast_var var)
+{
+    return variable(var.id, var.scope, var.has_suffix);
+}
+
+static void push_var(Ast_var var)
+{
+    generate_instruction(PUSHS, var_operand(var));
+}
+
+static void pop_var(Ast_var var)
+{
+    generate_instruction(POPS, var_operand(var));
+}
+
+static char *literal_operand(Ast_expr *expr)
+{
+    if (expr->data.literal.literal != NULL)
+    {
+        // the operand has been encoded by the scanner already
+        return expr->data.literal.literal->operand;
+    }
+    return format_token((Token){
+        .type = expr->data.literal.token_type,
+        .token_value = expr->data.literal.value,
+    });
+}
+
+static void push_literal(Ast_expr *expr)
+{
+    generate_instruction(PUSHS, literal_operand(expr));
+}
+
+/**
+ * @brief Operand of a variable or a literal, NULL if the expression has to be evaluated on the stack.
+ */
+static char *symbol_operand(Ast_expr *expr)
+{
+    // the value is used as it is, nil has been ruled out by the type check
+    while (expr->kind == AST_UNWRAP)
+    {
+        expr = expr->data.operand;
+    }
+    switch (expr->kind)
+    {
+    case AST_LITERAL:
+        return literal_operand(expr);
+    case AST_VARIABLE:
+        return var_operand(expr->data.variable);
+    default:
+        return NULL;
+    }
+}
+
+/// EXPRESSIONS
+
+/**
+ * @brief Step of lowering an expression, the operation waits on an explicit stack until its operands are lowered,
+ * so the depth of an expression is not limited by the call stack.
+ */
+typedef enum
+{
+    EXPR_VALUE,        // value of the expression pushed to the data stack
+    EXPR_BRANCH,       // jump to the target if the expression evaluates to jump_if
+    EXPR_BINARY,       // operation of the binary expression, the operands have been pushed
+    EXPR_UNARY,        // operation of the unary expression, the operand has been pushed
+    EXPR_CALL,         // call whose arguments have been pushed, its result is pushed
+    EXPR_CALL_BRANCH,  // call whose arguments have been pushed, its result decides the jump
+    EXPR_STACK_BRANCH, // jump decided by the value on the top of the data stack
+    EXPR_LABEL,        // label of the target
+    EXPR_LOGICAL_END,  // value of && or || if the left operand has decided it, the target is where it is pushed
+} Expr_step;
+
+typedef struct
+{
+    Expr_step step;
+    Ast_expr *expr;
+    char *target;
+    char *end; // end of && or || evaluated to a value
+    bool jump_if;
+} Expr_task;
+
+// most expressions fit without allocating
+#define EXPR_STACK_INLINE 64
+
+typedef struct
+{
+    Expr_task *tasks;
+    size_t size;
+    size_t capacity;
+    Expr_task inline_tasks[EXPR_STACK_INLINE];
+} Expr_stack;
+
+static void expr_push(Expr_stack *stack, Expr_step step, Ast_expr *expr, char *target, bool jump_if)
+{
+    if (stack->size == stack->capacity)
+    {
+        size_t capacity = stack->capacity * 2;
+        Expr_task *tasks;
+        if (stack->tasks == stack->inline_tasks)
+        {
+            tasks = malloc(sizeof(Expr_task) * capacity);
+            if (tasks != NULL)
+            {
+                memcpy(tasks, stack->tasks, sizeof(Expr_task) * stack->size);
+            }
+        }
+        else
+        {
+            tasks = realloc(stack->tasks, sizeof(Expr_task) * capacity);
+        }
+        if (tasks == NULL)
+        {
+            throw_error(INTERNAL_ERR, -1, "Memory allocation for code generation failed.");
+        }
+        stack->tasks = tasks;
+        stack->capacity = capacity;
+    }
+    stack->tasks[stack->size++] = (Expr_task){.step = step, .expr = expr, .target = target, .jump_if = jump_if};
+}
+
+/**
+ * @brief Pushes the arguments of the call, the first one is lowered first.
+ */
+static void expr_push_args(Expr_stack *stack, Ast_expr *call)
+{
+    for (int i = call->data.call.arg_count - 1; i >= 0; i--)
+    {
+        expr_push(stack, EXPR_VALUE, call->data.call.args[i], NULL, false);
+    }
+}
+
+/**
+ * @brief Generates the call after its arguments, the result of a built-in function is pushed.
+ *
+ * @return char* - operand of the result of a user function, NULL for a built-in function
+ */
+static char *lower_call_result(Ast_expr *expr)
+{
+    Token func = (Token){.type = TOKEN_FUNC_ID, .token_value = expr->data.call.name};
+    if (isBuiltInFunction(func))
+    {
+        generate_builtin_func_call(func, expr->data.call.arg_count);
+        return NULL;
+    }
+    generate_instruction(CALL, expr->data.call.name);
+    return "TF@$retval";
+}
+
+/**
+ * @brief Generates the comparison of two symbols by the instructions taking them as operands, nothing is pushed.
+ *
+ * @return bool - false if the condition is not such a comparison, nothing has been generated then
+ */
+static bool lower_compare(Ast_expr *cond, char *target, bool jump_if)
+{
+    if (cond->data.binary.conversion != AST_CONVERT_NONE)
+    {
+        return false;
+    }
+    char *left = symbol_operand(cond->data.binary.left);
+    char *right = symbol_operand(cond->data.binary.right);
+    if (left == NULL || right == NULL)
+    {
+        return false;
+    }
+
+    Instruction compare;
+    switch (cond->data.binary.op)
+    {
+    case TOKEN_EQ:
+        generate_instruction(jump_if ? JUMPIFEQ : JUMPIFNEQ, target, left, right);
+        return true;
+    case TOKEN_NEQ:
+        generate_instruction(jump_if ? JUMPIFNEQ : JUMPIFEQ, target, left, right);
+        return true;
+    case TOKEN_LESS:
+        compare = LT;
+        break;
+    case TOKEN_MORE:
+        compare = GT;
+        break;
+    case TOKEN_LESS_EQ:
+        // a <= b is !(a > b)
+        compare = GT;
+        jump_if = !jump_if;
+        break;
+    case TOKEN_MORE_EQ:
+        compare = LT;
+        jump_if = !jump_if;
+        break;
+    default:
+        return false;
+    }
+
+    char *result = generate_condition_var();
+    generate_instruction(compare, result, left, right);
+    generate_instruction(JUMPIFEQ, target, result, jump_if ? "bool@true" : "bool@false");
+    return true;
+}
+
+/**
+ * @brief Generates the jump to the target if the condition evaluates to jump_if, the code falls through otherwise.
+ * The operands of && and || jump on their own, the right operand is not evaluated if the left one decides.
+ */
+static void lower_branch_step(Expr_stack *stack, Ast_expr *cond, char *target, bool jump_if)
+{
+    switch (cond->kind)
+    {
+    case AST_LITERAL:
+        // the condition has been folded
+        if ((strcmp(cond->data.literal.value, "true") == 0) == jump_if)
+        {
+            generate_instruction(JUMP, target);
+        }
+        return;
+    case AST_NOT:
+        expr_push(stack, EXPR_BRANCH, cond->data.operand, target, !jump_if);
+        return;
+    case AST_BINARY:
+        if (cond->data.binary.op == TOKEN_AND || cond->data.binary.op == TOKEN_OR)
+        {
+            // value of the left operand that decides the result
+            bool decides = cond->data.binary.op == TOKEN_OR;
+            if (decides == jump_if)
+            {
+                expr_push(stack, EXPR_BRANCH, cond->data.binary.right, target, jump_if);
+                expr_push(stack, EXPR_BRANCH, cond->data.binary.left, target, jump_if);
+            }
+            else
+            {
+                char *skip = label(local_label("cond%d_skip", compiler->label_counter++, 0));
+                expr_push(stack, EXPR_LABEL, NULL, skip, false);
+                expr_push(stack, EXPR_BRANCH, cond->data.binary.right, target, jump_if);
+                expr_push(stack, EXPR_BRANCH, cond->data.binary.left, skip, decides);
+            }
+            return;
+        }
+        if (lower_compare(cond, target, jump_if))
+        {
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+
+    // a variable or the result of a call is compared with true by the jump, only the rest goes through the stack
+    if (cond->kind == AST_CALL)
+    {
+        expr_push(stack, EXPR_CALL_BRANCH, cond, target, jump_if);
+        expr_push_args(stack, cond);
+        return;
+    }
+    char *operand = symbol_operand(cond);
+    if (operand != NULL)
+    {
+        generate_instruction(jump_if ? JUMPIFEQ : JUMPIFNEQ, target, operand, "bool@true");
+        return;
+    }
+    expr_push(stack, EXPR_STACK_BRANCH, NULL, target, jump_if);
+    expr_push(stack, EXPR_VALUE, cond, NULL, false);
+}
+
+/**
+ * @brief Pushes the steps of the value of the expression, the operands come before the operation.
+ */
+static void lower_value_step(Expr_stack *stack, Ast_expr *expr)
+{
+    switch (expr->kind)
+    {
+    case AST_LITERAL:
+        push_literal(expr);
+        break;
+    case AST_VARIABLE:
+        push_var(expr->data.variable);
+        break;
+    case AST_CALL:
+        expr_push(stack, EXPR_CALL, expr, NULL, false);
+        expr_push_args(stack, expr);
+        break;
+    case AST_BINARY:
+        if (psa_operation(expr->data.binary.op, expr->data.binary.left->type, expr->data.binary.right->type)->emit ==
+            PSA_EMIT_SHORT_CIRCUIT)
+        {
+            // the right operand is evaluated only if the left one does not decide the value
+            bool decides = expr->data.binary.op == TOKEN_OR;
+            char *decided = label(local_label("logic%d", compiler->label_counter, 0));
+            char *end = label(local_label("logic%d_end", compiler->label_counter++, 0));
+            expr_push(stack, EXPR_LOGICAL_END, expr, decided, decides);
+            stack->tasks[stack->size - 1].end = end;
+            expr_push(stack, EXPR_VALUE, expr->data.binary.right, NULL, false);
+            expr_push(stack, EXPR_BRANCH, expr->data.binary.left, decided, decides);
+            break;
+        }
+        expr_push(stack, EXPR_BINARY, expr, NULL, false);
+        expr_push(stack, EXPR_VALUE, expr->data.binary.right, NULL, false);
+        expr_push(stack, EXPR_VALUE, expr->data.binary.left, NULL, false);
+        break;
+    case AST_UNWRAP:
+        // the value is used as it is, nil has been ruled out by the type check
+        expr_push(stack, EXPR_VALUE, expr->data.operand, NULL, false);
+        break;
+    case AST_NOT:
+    case AST_INT2DOUBLE:
+    case AST_IS_NOT_NIL:
+        expr_push(stack, EXPR_UNARY, expr, NULL, false);
+        expr_push(stack, EXPR_VALUE, expr->data.operand, NULL, false);
+        break;
+    }
+}
+
+static void lower_binary(Ast_expr *expr)
+{
+    // literal Int operand of a Double operation
+    switch (expr->data.binary.conversion)
+    {
+    case AST_CONVERT_LEFT:
+        // the right operand is on the top of the stack
+        generate_temp_pop();
+        generate_instruction(INT2FLOATS);
+        generate_temp_push();
+        break;
+    case AST_CONVERT_RIGHT:
+        generate_instruction(INT2FLOATS);
+        break;
+    default:
+        break;
+    }
+
+    const Psa_operation *op = psa_operation(expr->data.binary.op, expr->data.binary.left->type, expr->data.binary.right->type);
+    switch (op->emit)
+    {
+    case PSA_EMIT_NIL_COALESCING:
+        generate_nil_coelacing();
+        break;
+    case PSA_EMIT_CONCAT:
+        generate_string_concat();
+        break;
+    default:
+        for (int i = 0; i < op->len; i++)
+        {
+            generate_instruction(op->inst[i]);
+        }
+        break;
+    }
+}
+
+static void lower_unary(Ast_expr *expr)
+{
+    switch (expr->kind)
+    {
+    case AST_NOT:
+        generate_instruction(NOTS);
+        break;
+    case AST_INT2DOUBLE:
+        generate_instruction(INT2FLOATS);
+        break;
+    case AST_IS_NOT_NIL:
+        generate_instruction(PUSHS, "nil@nil");
+        generate_instruction(EQS);
+        generate_instruction(NOTS);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Runs the steps of the expression until the stack is empty.
+ */
+static void lower_expr_run(Expr_step step, Ast_expr *expr, char *target, bool jump_if)
+{
+    Expr_stack stack;
+    stack.tasks = stack.inline_tasks;
+    stack.size = 0;
+    stack.capacity = EXPR_STACK_INLINE;
+    expr_push(&stack, step, expr, target, jump_if);
+
+    while (stack.size > 0)
+    {
+        Expr_task task = stack.tasks[--stack.size];
+        switch (task.step)
+        {
+        case EXPR_VALUE:
+            if (task.expr != NULL)
+            {
+                lower_value_step(&stack, task.expr);
+            }
+            break;
+        case EXPR_BRANCH:
+            lower_branch_step(&stack, task.expr, task.target, task.jump_if);
+            break;
+        case EXPR_BINARY:
+            lower_binary(task.expr);
+            break;
+        case EXPR_UNARY:
+            lower_unary(task.expr);
+            break;
+        case EXPR_CALL:
+        {
+            char *result = lower_call_result(task.expr);
+            if (result != NULL)
+            {
+                generate_instruction(PUSHS, result);
+            }
+            break;
+        }
+        case EXPR_CALL_BRANCH:
+        {
+            char *result = lower_call_result(task.expr);
+            if (result != NULL)
+            {
+                generate_instruction(task.jump_if ? JUMPIFEQ : JUMPIFNEQ, task.target, result, "bool@true");
+                break;
+            }
+            generate_instruction(PUSHS, "bool@true");
+            generate_instruction(task.jump_if ? JUMPIFEQS : JUMPIFNEQS, task.target);
+            break;
+        }
+        case EXPR_STACK_BRANCH:
+            generate_instruction(PUSHS, "bool@true");
+            generate_instruction(task.jump_if ? JUMPIFEQS : JUMPIFNEQS, task.target);
+            break;
+        case EXPR_LABEL:
+            generate_instruction(LABEL, task.target);
+            break;
+        case EXPR_LOGICAL_END:
+            generate_instruction(JUMP, task.end);
+            generate_instruction(LABEL, task.target);
+            generate_instruction(PUSHS, task.jump_if ? "bool@true" : "bool@false");
+            generate_instruction(LABEL, task.end);
+            break;
+        }
+    }
+    if (stack.tasks != stack.inline_tasks)
+    {
+        free(stack.tasks);
+    }
+}
+
+static void lower_branch(Ast_expr *cond, char *target, bool jump_if)
+{
+    lower_expr_run(EXPR_BRANCH, cond, target, jump_if);
+}
+
+void lower_expr(Ast_expr *expr)
+{
+    lower_expr_run(EXPR_VALUE, expr, NULL, false);
+}
+
+/// STATEMENTS
+
+static void lower_var_decl(Ast_stmt *stmt)
+{
+    char *var = var_operand(stmt->data.var_decl.var);
+    HANDLE_DEFVAR(
+        fprintf(compiler->out_code_file, "# variable definition\n");
+        generate_instruction(DEFVAR, var);
+        fprintf(compiler->out_code_file, "\n"););
+
+    if (stmt->data.var_decl.has_init)
+    {
+        lower_expr(stmt->data.var_decl.init);
+
+        fprintf(compiler->out_code_file, "# variable initialization\n");
+        pop_var(stmt->data.var_decl.target);
+        fprintf(compiler->out_code_file, "\n");
+    }
+    else if (stmt->data.var_decl.nil_init)
+    {
+        generate_implicit_init(var);
+    }
+}
+
+static void lower_return(Ast_stmt *stmt)
+{
+    lower_expr(stmt->data.expr);
+
+    fprintf(compiler->out_code_file, "\n");
+    fprintf(compiler->out_code_file, "# return\n");
+    generate_instruction(POPFRAME);
+    generate_instruction(CREATEFRAME);
+    HANDLE_DEFVAR(generate_instruction(DEFVAR, "TF@$retval"););
+    generate_instruction(POPS, "TF@$retval");
+    generate_instruction(RETURN);
+    fprintf(compiler->out_code_file, "\n");
+}
+
+static void lower_func_header(Ast_stmt *stmt)
+{
+    int param_count = stmt->data.func.param_count;
+    char **params = malloc(sizeof(char *) * (param_count > 0 ? param_count : 1));
+    for (int i = 0; i < param_count; i++)
+    {
+        params[i] = var_operand(stmt->data.func.params[i]);
+    }
+
+    fprintf(compiler->out_code_file, "# function header\n");
+    generate_func_header(stmt->data.func.name, params, param_count);
+
+    free(params);
+}
+
+/// BLOCKS
+
+/**
+ * @brief Step of lowering a compound statement, steps wait on an explicit stack so the nesting depth of the blocks
+ * is not limited by the call stack.
+ */
+typedef enum
+{
+    LOWER_STMTS,     // statement and the rest of its block
+    LOWER_IF_BRANCH, // next else if branch or the else of the if statement
+    LOWER_IF_END,    // end of the if statement
+    LOWER_WHILE_END, // end of the while loop
+    LOWER_FUNC_END,  // end of the function
+} Lower_step;
+
+typedef struct
+{
+    Lower_step step;
+    Ast_stmt *stmt;
+    Ast_branch *branch;
+} Lower_task;
+
+typedef struct
+{
+    Lower_task *tasks;
+    size_t size;
+    size_t capacity;
+} Lower_stack;
+
+static void lower_push(Lower_stack *stack, Lower_step step, Ast_stmt *stmt, Ast_branch *branch)
+{
+    if (stack->size == stack->capacity)
+    {
+        stack->capacity = stack->capacity == 0 ? 64 : stack->capacity * 2;
+        stack->tasks = realloc(stack->tasks, sizeof(Lower_task) * stack->capacity);
+        if (stack->tasks == NULL)
+        {
+            throw_error(INTERNAL_ERR, -1, "Memory allocation for code generation failed.");
+        }
+    }
+    stack->tasks[stack->size++] = (Lower_task){.step = step, .stmt = stmt, .branch = branch};
+}
+
+/**
+ * @brief Generates the statement, the blocks of a compound statement are pushed to the stack.
+ */
+static void lower_stmt(Lower_stack *stack, Ast_stmt *stmt)
+{
+    switch (stmt->kind)
+    {
+    case AST_VAR_DECL:
+        lower_var_decl(stmt);
+        break;
+    case AST_ASSIGN:
+        lower_expr(stmt->data.assign.value);
+
+        fprintf(compiler->out_code_file, "# variable assigment\n");
+        pop_var(stmt->data.assign.target);
+        fprintf(compiler->out_code_file, "\n");
+        break;
+    case AST_EXPR:
+        lower_expr(stmt->data.expr);
+        break;
+    case AST_RETURN:
+        lower_return(stmt);
+        break;
+    case AST_IF:
+    {
+        Ast_branch *branch = stmt->data.if_stmt.first;
+        lower_branch(branch->cond, generate_if_start(), false);
+        lower_push(stack, LOWER_IF_BRANCH, stmt, branch->next);
+        lower_push(stack, LOWER_STMTS, branch->body.first, NULL);
+        break;
+    }
+    case AST_WHILE:
+        generate_while_start();
+        lower_branch(stmt->data.while_stmt.cond, generate_while_condition(), false);
+        lower_push(stack, LOWER_WHILE_END, stmt, NULL);
+        lower_push(stack, LOWER_STMTS, stmt->data.while_stmt.body.first, NULL);
+        break;
+    case AST_FUNC:
+        if (stmt->data.func.unreachable)
+        {
+            break; // the program never calls the function
+        }
+        generate_func_scope_begin(stmt->data.func.name);
+        if (func_cache_lower_begin(stmt->data.func.cache))
+        {
+            // the code of the function has been taken from the cache
+            generate_func_scope_end();
+            break;
+        }
+        if (func_pool_lower(stmt->data.func.unit))
+        {
+            // the code of the function has been generated by the function pool
+            func_cache_lower_end(stmt->data.func.cache);
+            generate_func_scope_end();
+            break;
+        }
+        lower_func_header(stmt);
+        lower_push(stack, LOWER_FUNC_END, stmt, NULL);
+        lower_push(stack, LOWER_STMTS, stmt->data.func.body.first, NULL);
+        break;
+    }
+}
+
+void lower_block(Ast_block *block)
+{
+    Lower_stack stack = {.tasks = NULL, .size = 0, .capacity = 0};
+    lower_push(&stack, LOWER_STMTS, block->first, NULL);
+
+    while (stack.size > 0)
+    {
+        Lower_task task = stack.tasks[--stack.size];
+        switch (task.step)
+        {
+        case LOWER_STMTS:
+            if (task.stmt != NULL)
+            {
+                // the rest of the block comes after the nested blocks of the statement
+                lower_push(&stack, LOWER_STMTS, task.stmt->next, NULL);
+                lower_stmt(&stack, task.stmt);
+            }
+            break;
+        case LOWER_IF_BRANCH:
+            if (task.branch != NULL)
+            {
+                generate_elseif_else();
+                lower_branch(task.branch->cond, generate_elseif_if(), false);
+                lower_push(&stack, LOWER_IF_BRANCH, task.stmt, task.branch->next);
+                lower_push(&stack, LOWER_STMTS, task.branch->body.first, NULL);
+            }
+            else if (task.stmt->data.if_stmt.else_body != NULL)
+            {
+                generate_else();
+                lower_push(&stack, LOWER_IF_END, task.stmt, NULL);
+                lower_push(&stack, LOWER_STMTS, task.stmt->data.if_stmt.else_body->first, NULL);
+            }
+            else
+            {
+                generate_if_end();
+            }
+            break;
+        case LOWER_IF_END:
+            generate_if_end();
+            break;
+        case LOWER_WHILE_END:
+            generate_while_end();
+            break;
+        case LOWER_FUNC_END:
+            fprintf(compiler->out_code_file, "# function end\n");
+            generate_func_end(task.stmt->data.func.name);
+            func_cache_lower_end(task.stmt->data.func.cache);
+            generate_func_scope_end();
+            break;
+        }
+    }
+    free(stack.tasks);
+}
+
+void lower_program(Ast_block *program)
+{
+    // push necessary instructions to the beginning of the file
+    fprintf(compiler->out_code_file, ".IFJcode23\n");
+    generate_instruction(CREATEFRAME);
+    generate_instruction(PUSHFRAME);
+    generate_instruction(CREATEFRAME);
+    fprintf(compiler->out_code_file, "\n");
+
+    lower_block(program);
+}
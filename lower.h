@@ -0,0 +1,39 @@
+/**
+ * @file lower.h
+ * @brief Lowering of the abstract syntax tree to IFJcode23.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#ifndef LOWER_H
+#define LOWER_H
+
+#include "ast.h"
+#include "generator.h"
+
+/**
+ * @brief Generates the code of the whole program to out_code_file.
+ *
+ * @param program global block of the program
+ */
+void lower_program(Ast_block *program);
+
+/**
+ * @brief Generates the code that leaves the value of the expression on the data stack.
+ *
+ * @param expr the expression, NULL for an empty expression
+ */
+void lower_expr(Ast_expr *expr);
+
+/**
+ * @brief Generates the code of all the statements of the block.
+ *
+ * @param block the block
+ */
+void lower_block(Ast_block *block);
+
+#endif // LOWER_H
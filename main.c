@@ -8,48 +8,101 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include "symtable.h"
+#include <string.h>
+#include "compiler.h"
+#include "server.h"
 
-symtable_stack *sym_st;
-
-#include "psa.h"
-#include "error.h"
-#include "parser.h"
-#include "utils.h"
-#include "generator.h"
-
-FILE *out_code_file = NULL;
-FILE *while_def_out_code_file = NULL;
-bool is_in_loop = false;
-
-int main(void)
+int main(int argc, char **argv)
 {
-    // open the temporary file
-    out_code_file = tmpfile();
-    if (out_code_file == NULL)
+    // parse the arguments: [--pretokenize] [--lex-threads N] [--cache DIR] [--func-threads N] [--lazy|--lazy-check]
+    //                      [source files...]
+    //                      --batch DIR [--jobs N] [--out DIR] [--cache DIR] [--func-threads N] [--lazy|--lazy-check]
+    //                      --serve [--socket PATH] [--cache DIR] [--func-threads N]
+    const char *source_paths[argc];
+    int source_count = 0;
+    const char *batch_dir = NULL;
+    const char *out_dir = NULL;
+    const char *socket_path = NULL;
+    bool serve = false;
+    int jobs = 0;
+    Compiler_options options = {.pretokenize = false, .lex_threads = 0, .cache_dir = NULL, .func_threads = 0, .lazy = false, .lazy_check = false};
+    for (int i = 1; i < argc; i++)
     {
-        return INTERNAL_ERR;
+        if (strcmp(argv[i], "--pretokenize") == 0)
+        {
+            options.pretokenize = true;
+        }
+        else if (strcmp(argv[i], "--lex-threads") == 0 && i + 1 < argc)
+        {
+            // lexing in threads needs the whole input tokenized at once
+            options.pretokenize = true;
+            options.lex_threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            options.cache_dir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--func-threads") == 0 && i + 1 < argc)
+        {
+            options.func_threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--lazy") == 0)
+        {
+            options.lazy = true;
+        }
+        else if (strcmp(argv[i], "--lazy-check") == 0)
+        {
+            options.lazy = true;
+            options.lazy_check = true;
+        }
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+        {
+            batch_dir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+        {
+            jobs = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+        {
+            out_dir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--serve") == 0)
+        {
+            serve = true;
+        }
+        else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc)
+        {
+            serve = true;
+            socket_path = argv[++i];
+        }
+        else
+        {
+            source_paths[source_count++] = argv[i];
+        }
     }
 
-    // push necessary instructions to the beginning of the file
-    fprintf(out_code_file, ".IFJcode23\n");
-    generate_instruction(CREATEFRAME);
-    generate_instruction(PUSHFRAME);
-    generate_instruction(CREATEFRAME);
-    fprintf(out_code_file, "\n");
-
-    scanner_init(); // initialize the scanner
-
-    sym_st = symtable_stack_init(); // initialize the symbol table stack
-
-    run_parser(); // run the parser
+    if (serve)
+    {
+        return compile_server(socket_path, options); // compile the sources sent by the clients
+    }
+    if (batch_dir != NULL)
+    {
+        return compile_batch(batch_dir, out_dir, jobs, options); // compile all the files of the directory
+    }
 
-    // if there were any errors, print them and exit
-    Error_code error_code = print_errors();
-    if (error_code == NO_ERR)
+    Compiler ctx;
+    compiler_init(&ctx, stderr);
+    Error_code error_code;
+    if (source_count > 1)
+    {
+        // the files are linked into one program in the order they are given
+        error_code = compiler_run_files(&ctx, source_paths, source_count, options, stdout);
+    }
+    else
     {
-        print_out_code(); // if there were no errors, print the compiled code
+        error_code = compiler_run(&ctx, source_count == 1 ? source_paths[0] : NULL, options, stdout);
     }
-    fclose(out_code_file);
+    compiler_free(&ctx);
     return error_code; // return the appropriate error code
 }
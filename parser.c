@@ -7,7 +7,9 @@
  * Project: IFJ compiler
  */
 
+#include <setjmp.h>
 #include "parser.h"
+#include "compiler.h"
 
 /**
  * @def get_token
@@ -54,577 +56,355 @@ bool cmp_type(Token *token, sym_items *items, Token_type type, Control_state sem
     }
 }
 
-bool START(Token *token, sym_items *items)
+/**
+ * @brief - Symbol waiting on the parser stack
+ * @param symbol - grammar symbol
+ * @param action - semantic rule of the symbol, inherited ones are already resolved
+ */
+typedef struct
 {
-    DEBUG_SYNTAX_CODE(printf("START token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // START -> STMT_LIST eof
-    case TOKEN_EOF:
-    case TOKEN_FUNC:
-    case TOKEN_IF:
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-    case TOKEN_WHILE:
-    case TOKEN_VAR:
-    case TOKEN_LET:
-        run_control(token, items, STARTING);
-        return STMT_LIST(token, items) && cmp_type(token, items, TOKEN_EOF, SEM_NONE);
-    default:
-        return false;
-    }
-}
+    const Ll_symbol *symbol;
+    Control_state action;
+} Ll_item;
 
-bool STMT_LIST(Token *token, sym_items *items)
+/**
+ * @brief - Statement of a block the parser goes back to after an error
+ * @param size - size of the parser stack below the statement list of the block
+ * @param list - the statement list of the block
+ * @param position - position of the first token of the statement, kept in the token ring by a mark
+ * @param scopes - count of the scopes open at the statement
+ * @param block - block of the syntax tree the statement is appended to
+ * @param func - function whose body the block is in, NULL outside of the functions
+ */
+typedef struct
 {
-    DEBUG_SYNTAX_CODE(printf("STMT_LIST token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // STMT_LIST -> eps
-    case TOKEN_EOF:
-    case TOKEN_R_CURLY:
-        return true;
-    // STMT_LIST -> STMT STMT_LIST
-    case TOKEN_FUNC:
-    case TOKEN_IF:
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-    case TOKEN_WHILE:
-    case TOKEN_VAR:
-    case TOKEN_LET:
-        return STMT(token, items) && STMT_LIST(token, items);
-    default:
-        return false;
-    }
-}
+    size_t size;
+    Ll_item list;
+    size_t position;
+    unsigned int scopes;
+    Ast_block *block;
+    symtable_item *func;
+} Ll_sync_point;
 
-bool LOCAL_STMT_LIST(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("STMT_LIST token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // STMT_LIST -> eps
-    case TOKEN_EOF:
-    case TOKEN_R_CURLY:
-        return true;
-    // STMT_LIST -> STMT STMT_LIST
-    case TOKEN_IF:
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-    case TOKEN_WHILE:
-    case TOKEN_VAR:
-    case TOKEN_LET:
-        return LOCAL_STMT(token, items) && LOCAL_STMT_LIST(token, items);
-    default:
-        return false;
-    }
-}
+/**
+ * @brief - State of the parser, it is taken from the syntax tree arena so it outlives the jump back from an error
+ * @param stack - symbols waiting to be parsed
+ * @param size - count of the symbols
+ * @param capacity - capacity of stack
+ * @param points - statements of the blocks being parsed, the innermost block is the last
+ * @param point_count - count of points
+ * @param point_cap - capacity of points
+ * @param marks - marks of the token ring set before the parser has started
+ * @param recover - the parser continues after the errors
+ * @param current - symbol being parsed
+ * @param position - position in the token ring after the token current has started at
+ */
+typedef struct
+{
+    Ll_item *stack;
+    size_t size;
+    size_t capacity;
+    Ll_sync_point *points;
+    size_t point_count;
+    size_t point_cap;
+    size_t marks;
+    bool recover;
+    Ll_item current;
+    size_t position;
+} Ll_parser;
 
-bool STMT(Token *token, sym_items *items)
+/**
+ * @brief Remembers the statement the list is expanded to, the list of a block has one point updated by each statement.
+ */
+static void sync_point_update(Ll_parser *p, Ll_item list, const Ll_production *production, sym_items *items)
 {
-    DEBUG_SYNTAX_CODE(printf("STMT token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // STMT -> DEF_FUNC
-    case TOKEN_FUNC:
-        return DEF_FUNC(token, items);
-    // STMT -> IF_STMT
-    case TOKEN_IF:
+    Ll_sync_point *point = p->point_count > 0 ? &p->points[p->point_count - 1] : NULL;
+    if (point != NULL && point->size == p->size)
     {
-        bool res = IF_STMT(token, items);
-        run_control(token, items, IF_END);
-        return res;
-    }
-    // STMT -> LOAD_ID
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-        return LOAD_ID(token, items);
-    // STMT -> WHILE_STMT
-    case TOKEN_WHILE:
-        return WHILE_STMT(token, items);
-    // STMT -> VAR_LET
-    case TOKEN_VAR:
-        return VAR_LET(token, items);
-    // STMT -> VAR_LET
-    case TOKEN_LET:
-        return VAR_LET(token, items);
-    default:
-        return false;
+        token_ring_release(point->position);
+        if (production != NULL && production->len == 0)
+        {
+            // the block ends
+            p->point_count--;
+            return;
+        }
     }
-}
-
-bool LOCAL_STMT(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("STMT token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // STMT -> IF_STMT
-    case TOKEN_IF:
+    else if (production != NULL && production->len == 0)
     {
-        bool res = IF_STMT(token, items);
-        run_control(token, items, IF_END);
-        return res;
+        return;
     }
-    // STMT -> LOAD_ID
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-        return LOAD_ID(token, items);
-    // STMT -> WHILE_STMT
-    case TOKEN_WHILE:
-        return WHILE_STMT(token, items);
-    // STMT -> VAR_LET
-    case TOKEN_VAR:
-        return VAR_LET(token, items);
-    // STMT -> VAR_LET
-    case TOKEN_LET:
-        return VAR_LET(token, items);
-    default:
-        return false;
-    }
-}
-
-bool VAR_LET(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("VAR_LET token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    else
     {
-    // VAR_LET -> VAR_SCOPE id TYPE_AND_ASSIGN
-    case TOKEN_VAR:
-    case TOKEN_LET:
-        return VAR_SCOPE(token, items) && cmp_type(token, items, TOKEN_IDENTIFICATOR, VAR_ID) && TYPE_AND_ASIGN(token, items);
-    default:
-        return false;
+        if (p->point_count == p->point_cap)
+        {
+            p->point_cap *= 2;
+            Ll_sync_point *grown = ast_alloc(sizeof(Ll_sync_point) * p->point_cap);
+            memcpy(grown, p->points, sizeof(Ll_sync_point) * p->point_count);
+            p->points = grown;
+        }
+        point = &p->points[p->point_count++];
     }
-}
 
-bool VAR_SCOPE(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("VAR_SCOPE token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    case TOKEN_VAR:
-        return cmp_type(token, items, TOKEN_VAR, VAR);
-    case TOKEN_LET:
-        return cmp_type(token, items, TOKEN_LET, LET);
-    default:
-        return false;
-    }
+    // the current token has been read already, the mark is the position after it
+    point->size = p->size;
+    point->list = list;
+    point->position = token_ring_mark() - 1;
+    point->scopes = compiler->sym_st->size;
+    point->block = compiler->ast.current;
+    point->func = items->funcItem;
+    compiler->is_cascade = false;
 }
 
-bool TYPE_AND_ASIGN(Token *token, sym_items *items)
+/**
+ * @brief Continues the header of an if, a while or a function after a semantic error, the syntax of the header is
+ * intact and its body is parsed with the statement list of its block. The header is parsed on after an error of a
+ * name or a parameter, a failed condition is skipped up to the brace and left out of the syntax tree.
+ *
+ * @return false if the error is not in a header, the statement is skipped then
+ */
+static bool header_recover(Ll_parser *p, Ll_sync_point *point, Token *token, sym_items *items)
 {
-    DEBUG_SYNTAX_CODE(printf("TYPE_AND_ASIGN token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    // the brace opening the body is the next one on the stack while its header is being parsed
+    size_t brace = p->size;
+    while (brace > point->size && !(p->stack[brace - 1].symbol->kind == LL_TERMINAL &&
+                                     p->stack[brace - 1].symbol->value == TOKEN_L_CURLY))
     {
-    // TYPE_AND_ASIGN -> : D_TYPE R_FLEX
-    case TOKEN_DOUBLE_DOT:
-        return cmp_type(token, items, TOKEN_DOUBLE_DOT, SEM_NONE) && D_TYPE(token, items, VAR_TYPE) && R_FLEX(token, items);
-    // TYPE_AND_ASIGN -> = EXP
-    case TOKEN_ASSIGN:
-        return cmp_type(token, items, TOKEN_ASSIGN, VAR_ASSIGN1) && EXP(token, items, VAR_EXP);
-    default:
-        return false;
+        brace--;
     }
-}
-
-bool R_FLEX(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("R_FLEX token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    if (brace == point->size)
     {
-    // R_FLEX -> = EXP
-    case TOKEN_ASSIGN:
-        return cmp_type(token, items, TOKEN_ASSIGN, VAR_ASSIGN2) && EXP(token, items, VAR_EXP);
-    // R_FLEX -> eps
-    case TOKEN_EOF:
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-    case TOKEN_VAR:
-    case TOKEN_LET:
-    case TOKEN_FUNC:
-    case TOKEN_R_CURLY:
-    case TOKEN_RETURN:
-    case TOKEN_WHILE:
-    case TOKEN_IF:
-        run_control(token, items, VAR_ADD);
-        return true;
-    default:
         return false;
     }
-}
 
-bool D_TYPE(Token *token, sym_items *items, Control_state sem_rule)
-{
-    DEBUG_SYNTAX_CODE(printf("D_TYPE token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    size_t marks = p->marks + p->point_count;
+    if (p->current.symbol->kind == LL_TERMINAL)
     {
-    case TOKEN_TYPE_STRING:
-        return cmp_type(token, items, TOKEN_TYPE_STRING, sem_rule);
-    case TOKEN_TYPE_INT:
-        return cmp_type(token, items, TOKEN_TYPE_INT, sem_rule);
-    case TOKEN_TYPE_DOUBLE:
-        return cmp_type(token, items, TOKEN_TYPE_DOUBLE, sem_rule);
-    case TOKEN_TYPE_BOOL:
-        return cmp_type(token, items, TOKEN_TYPE_BOOL, sem_rule);
-    case TOKEN_TYPE_STRING_NIL:
-        return cmp_type(token, items, TOKEN_TYPE_STRING_NIL, sem_rule);
-    case TOKEN_TYPE_INT_NIL:
-        return cmp_type(token, items, TOKEN_TYPE_INT_NIL, sem_rule);
-    case TOKEN_TYPE_DOUBLE_NIL:
-        return cmp_type(token, items, TOKEN_TYPE_DOUBLE_NIL, sem_rule);
-    case TOKEN_TYPE_BOOL_NIL:
-        return cmp_type(token, items, TOKEN_TYPE_BOOL_NIL, sem_rule);
-    default:
-        return false;
+        // the token of the terminal has been matched, its action has failed
+        token_ring_recover(p->position, marks);
+        if (p->current.action == LET_IN_IF &&
+            symtable_find_in_stack(token->token_value, compiler->sym_st, false) == NULL)
+        {
+            symtable_poison(token->token_value);
+        }
     }
-}
-
-bool DEF_FUNC(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("DEF_FUNC token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    else
     {
-    //  DEF_FUNC -> func func_id ( P_LIST ) RET_TYPE { FUNC_STMT_LIST }
-    case TOKEN_FUNC:
-        return cmp_type(token, items, TOKEN_FUNC, SEM_NONE) && cmp_type(token, items, TOKEN_FUNC_ID, FUNC_ID) && cmp_type(token, items, TOKEN_L_BRACKET, SEM_NONE) &&
-               P_LIST(token, items) && cmp_type(token, items, TOKEN_R_BRACKET, SEM_NONE) && RET_TYPE(token, items) && cmp_type(token, items, TOKEN_L_CURLY, FUNC_HEADER_DONE) &&
-               FUNC_STMT_LIST(token, items) && cmp_type(token, items, TOKEN_R_CURLY, FUNC_BODY_DONE);
-    default:
-        return false;
+        token_ring_recover(p->position - 1, marks);
     }
-}
-
-bool P_LIST(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("P_LIST token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    if (p->current.symbol->kind == LL_EXPRESSION)
     {
-    // P_LIST -> PARAM
-    case TOKEN_IDENTIFICATOR:
-        return PARAM(token, items);
-    // P_LIST -> eps
-    case TOKEN_R_BRACKET:
-        return true;
-    default:
-        return false;
+        // the tokens of a condition have no braces, the brace may only be on the next line
+        for (Token *next = token_ring_peek(0); next->type != TOKEN_L_CURLY; next = token_ring_peek(0))
+        {
+            if (next->type == TOKEN_EOF || next->type == TOKEN_R_CURLY || next->preceded_by_nl)
+            {
+                return false;
+            }
+            token_ring_advance();
+        }
+        p->size = brace;
+        items->expr = NULL;
     }
-}
 
-bool PARAM(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("PARAM token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // PARAM -> id id : D_TYPE SEP
-    case TOKEN_IDENTIFICATOR:
-        return cmp_type(token, items, TOKEN_IDENTIFICATOR, P_NAME) && cmp_type(token, items, TOKEN_IDENTIFICATOR, P_ID) && cmp_type(token, items, TOKEN_DOUBLE_DOT, SEM_NONE) &&
-               D_TYPE(token, items, P_TYPE) && P_SEP(token, items);
-    default:
-        return false;
-    }
+    psa_release_stacks();
+    compiler->is_cascade = false;
+    get_token(token);
+    return true;
 }
 
-bool P_SEP(Token *token, sym_items *items)
+/**
+ * @brief Skips the statement with the error up to the next statement of the innermost block being parsed, the
+ * statements are told apart by the newlines before them and by the braces. The state of the parser is put back to
+ * the beginning of the statement.
+ *
+ * @return false if the parser cannot continue
+ */
+static bool sync_point_recover(Ll_parser *p, Token *token, sym_items *items)
 {
-    DEBUG_SYNTAX_CODE(printf("P_SEP token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    Error_code code = Error_stack_top(compiler->error_st).code;
+    if (code == LEXICAL_ERR || code == INTERNAL_ERR || p->point_count == 0)
     {
-    // P_SEP -> eps
-    case TOKEN_R_BRACKET:
-        return true;
-    // P_SEP -> , PARAM
-    case TOKEN_COMMA:
-        return cmp_type(token, items, TOKEN_COMMA, SEM_NONE) && PARAM(token, items);
-    default:
         return false;
     }
-}
-
-bool RET_TYPE(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("RET_TYPE token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    Ll_sync_point *point = &p->points[p->point_count - 1];
+    if (compiler->is_cascade)
     {
-    // RET_TYPE -> eps
-    case TOKEN_L_CURLY:
-        return true;
-    // RET_TYPE -> -> D_TYPE
-    case TOKEN_ARROW:
-        return cmp_type(token, items, TOKEN_ARROW, SEM_NONE) && D_TYPE(token, items, R_TYPE);
-    default:
-        return false;
+        free(Error_stack_pop(compiler->error_st).message);
     }
-}
-
-bool FUNC_STMT_LIST(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("FUNC_STMT_LIST token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    if (code != SYNTACTIC_ERR && header_recover(p, point, token, items))
     {
-    // FUNC_STMT_LIST -> FUNC_STMT FUNC_STMT_LIST
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-    case TOKEN_VAR:
-    case TOKEN_LET:
-    case TOKEN_RETURN:
-    case TOKEN_WHILE:
-    case TOKEN_IF:
-        return FUNC_STMT(token, items) && FUNC_STMT_LIST(token, items);
-    // FUNC_STMT_LIST -> eps
-    case TOKEN_R_CURLY:
         return true;
-    default:
-        return false;
     }
-}
 
-bool FUNC_STMT(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("FUNC_STMT token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // FUNC_STMT -> LOAD_ID
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-        return LOAD_ID(token, items);
-    // FUNC_STMT -> VAR_LET
-    case TOKEN_VAR:
-        return VAR_LET(token, items);
-    case TOKEN_LET:
-        return VAR_LET(token, items);
-    // FUNC_STMT -> RET
-    case TOKEN_RETURN:
-        return RET(token, items);
-    // FUNC_STMT -> FUNC_WHILE
-    case TOKEN_WHILE:
-        return FUNC_WHILE(token, items);
-    // FUNC_STMT -> FUNC_IF
-    case TOKEN_IF:
+    token_ring_recover(point->position, p->marks + p->point_count);
+    Token first = token_ring_advance();
+    if (first.type == TOKEN_EOF)
     {
-        bool res = FUNC_IF(token, items);
-        run_control(token, items, IF_END);
-        return res;
-    }
-    default:
         return false;
     }
-}
-
-bool RET(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("RET token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // RET -> return EXP
-    case TOKEN_RETURN:
-        return cmp_type(token, items, TOKEN_RETURN, SEM_NONE) && EXP(token, items, R_EXP);
-    default:
-        return false;
-    }
-}
-
-bool FUNC_WHILE(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("FUNC_WHILE token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    Token second = *token_ring_peek(0);
+    int depth = first.type == TOKEN_L_CURLY ? 1 : 0;
+    for (Token *next = token_ring_peek(0); next->type != TOKEN_EOF; next = token_ring_peek(0))
     {
-    // FUNC_WHILE -> while EXP { FUNC_STMT_LIST }
-    case TOKEN_WHILE:
-        return cmp_type(token, items, TOKEN_WHILE, WHILE_START) && EXP(token, items, COND_EXP) && cmp_type(token, items, TOKEN_L_CURLY, WHILE_COND) &&
-               FUNC_STMT_LIST(token, items) && cmp_type(token, items, TOKEN_R_CURLY, WHILE_END);
-    default:
-        return false;
+        if (depth == 0 && (next->preceded_by_nl || next->type == TOKEN_R_CURLY) &&
+            ll_predict(point->list.symbol->value, next->type) != NULL)
+        {
+            break;
+        }
+        if (next->type == TOKEN_L_CURLY)
+        {
+            depth++;
+        }
+        else if (next->type == TOKEN_R_CURLY && depth > 0)
+        {
+            depth--;
+        }
+        token_ring_advance();
     }
-}
 
-bool FUNC_IF(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("FUNC_IF token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    while (compiler->sym_st->size > point->scopes)
     {
-    // 	FUNC_IF -> if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE
-    case TOKEN_IF:
-        return cmp_type(token, items, TOKEN_IF, FUNC_IF_FOUND) && IF_COND(token, items) && cmp_type(token, items, TOKEN_L_CURLY, IF_START) &&
-               FUNC_STMT_LIST(token, items) && cmp_type(token, items, TOKEN_R_CURLY, POP_SCOPE) && FUNC_ELSE_CLAUSE(token, items);
-    default:
-        return false;
+        (void)symtable_stack_pop(compiler->sym_st);
     }
-}
+    compiler->ast.current = point->block;
+    psa_release_stacks();
+    items->funcItem = point->func;
+    items->varItem = init_symtable_item(false);
+    items->expr = NULL;
+    items->body_skipped = point->func != NULL; // the statements of the body are missing, its return is not checked
 
-bool FUNC_ELSE_IF(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("FUNC_IF token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    // the uses of a name the statement has failed to declare are not reported
+    bool is_var = first.type == TOKEN_LET || first.type == TOKEN_VAR;
+    if (is_var && second.type == TOKEN_IDENTIFICATOR &&
+        symtable_find(second.token_value, symtable_stack_top(compiler->sym_st), false) == NULL)
     {
-    // 	FUNC_IF -> if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE
-    case TOKEN_IF:
-        return cmp_type(token, items, TOKEN_IF, ELSE_IF_START) && IF_COND(token, items) && cmp_type(token, items, TOKEN_L_CURLY, ELSE_IF_AFTER_COND) &&
-               FUNC_STMT_LIST(token, items) && cmp_type(token, items, TOKEN_R_CURLY, POP_SCOPE) && FUNC_ELSE_CLAUSE(token, items);
-    default:
-        return false;
+        symtable_poison(second.token_value);
     }
-}
-
-bool FUNC_ELSE_CLAUSE(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("FUNC_ELSE_CLAUSE token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    else if (first.type == TOKEN_FUNC && second.type == TOKEN_FUNC_ID &&
+             symtable_find(second.token_value, symtable_stack_top(compiler->sym_st), true) == NULL)
     {
-    // FUNC_ELSE_CLAUSE -> eps
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-    case TOKEN_VAR:
-    case TOKEN_LET:
-    case TOKEN_R_CURLY:
-    case TOKEN_RETURN:
-    case TOKEN_WHILE:
-    case TOKEN_IF:
-        return true;
-    // FUNC_ELSE_CLAUSE -> else FUNC_AFTER_ELSE
-    case TOKEN_ELSE:
-        return cmp_type(token, items, TOKEN_ELSE, FUNC_ELSE) && FUNC_AFTER_ELSE(token, items);
-    default:
-        return false;
+        bool complete;
+        if (find_indexed_func(second.token_value, &complete) == NULL)
+        {
+            symtable_poison(second.token_value);
+        }
     }
-}
+    compiler->is_cascade = false;
 
-bool FUNC_AFTER_ELSE(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("FUNC_AFTER_ELSE token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // FUNC_AFTER_ELSE -> { FUNC_STMT_LIST }
-    case TOKEN_L_CURLY:
-        return cmp_type(token, items, TOKEN_L_CURLY, ELSE_START) && FUNC_STMT_LIST(token, items) && cmp_type(token, items, TOKEN_R_CURLY, POP_SCOPE);
-    // FUNC_AFTER_ELSE -> FUNC_IF
-    case TOKEN_IF:
-        return FUNC_ELSE_IF(token, items);
-    default:
-        return false;
-    }
+    p->size = point->size;
+    p->stack[p->size++] = point->list;
+    get_token(token);
+    return true;
 }
 
-bool IF_STMT(Token *token, sym_items *items)
+/**
+ * @brief Parses the input derived from the symbol. With recovery, an error is reported and the parser continues from
+ * the next statement of the innermost block, or with the body after a semantic error in its header. Only a lexical
+ * error and an error at the end of the input stop it.
+ */
+static bool parse_symbol(Token *token, sym_items *items, const Ll_symbol *start, bool recover)
 {
-    DEBUG_SYNTAX_CODE(printf("IF_STMT token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // IF_STMT -> if EXP { LOCAL_STMT_LIST } ELSE_CLAUSE
-    case TOKEN_IF:
-        return cmp_type(token, items, TOKEN_IF, SEM_NONE) && IF_COND(token, items) && cmp_type(token, items, TOKEN_L_CURLY, IF_START) &&
-               LOCAL_STMT_LIST(token, items) && cmp_type(token, items, TOKEN_R_CURLY, POP_SCOPE) && ELSE_CLAUSE(token, items);
-    default:
-        return false;
-    }
-}
+    // the stack is taken from the syntax tree arena, an error may leave the parser at any point
+    Ll_parser *p = ast_alloc(sizeof(Ll_parser));
+    p->capacity = 64;
+    p->stack = ast_alloc(sizeof(Ll_item) * p->capacity);
+    p->stack[p->size++] = (Ll_item){.symbol = start, .action = SEM_NONE};
+    p->point_cap = 16;
+    p->points = ast_alloc(sizeof(Ll_sync_point) * p->point_cap);
+    p->marks = compiler->token_ring.marks;
 
-bool ELSE_IF_STMT(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("IF_STMT token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // ELSE_IF_STMT -> if EXP { LOCAL_STMT_LIST } ELSE_CLAUSE
-    case TOKEN_IF:
-        return cmp_type(token, items, TOKEN_IF, ELSE_IF_START) && IF_COND(token, items) && cmp_type(token, items, TOKEN_L_CURLY, ELSE_IF_AFTER_COND) &&
-               LOCAL_STMT_LIST(token, items) && cmp_type(token, items, TOKEN_R_CURLY, POP_SCOPE) && ELSE_CLAUSE(token, items);
-    default:
-        return false;
-    }
-}
+    p->recover = recover && compiler->on_error != NULL;
 
-bool IF_COND(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("IF_COND token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    jmp_buf *outer = compiler->on_error;
+    jmp_buf on_error;
+    if (p->recover)
     {
-    // IF_COND -> EXP
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-    case TOKEN_L_BRACKET:
-    case TOKEN_DOUBLE:
-    case TOKEN_INT:
-    case TOKEN_STRING:
-    case TOKEN_BOOL:
-    case TOKEN_NIL:
-    case TOKEN_EXP:
-    case TOKEN_NOT:
-        return EXP(token, items, COND_EXP);
-    // IF_COND -> let id
-    case TOKEN_LET:
-        return cmp_type(token, items, TOKEN_LET, SEM_NONE) && cmp_type(token, items, TOKEN_IDENTIFICATOR, LET_IN_IF);
-    default:
-        return false;
+        if (setjmp(on_error) != 0 && !sync_point_recover(p, token, items))
+        {
+            compiler->on_error = outer;
+            longjmp(*outer, 1);
+        }
+        compiler->on_error = &on_error;
     }
-}
 
-bool ELSE_CLAUSE(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("ELSE_CLAUSE token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    while (p->size > 0)
     {
-    // ELSE_CLAUSE -> eps
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-    case TOKEN_VAR:
-    case TOKEN_LET:
-    case TOKEN_FUNC:
-    case TOKEN_R_CURLY:
-    case TOKEN_WHILE:
-    case TOKEN_IF:
-    case TOKEN_EOF:
-        return true;
-    // ELSE_CLAUSE -> else AFTER_ELSE
-    case TOKEN_ELSE:
-        return cmp_type(token, items, TOKEN_ELSE, SEM_NONE) && AFTER_ELSE(token, items);
-    default:
-        return false;
-    }
-}
+        Ll_item top = p->stack[--p->size];
+        bool result = true;
+        if (p->recover)
+        {
+            p->current = top;
+            p->position = token_ring_position();
+        }
+        switch (top.symbol->kind)
+        {
+        case LL_TERMINAL:
+            result = cmp_type(token, items, (Token_type)top.symbol->value, top.action);
+            break;
+        case LL_EXPRESSION:
+            result = EXP(token, items, top.action);
+            break;
+        case LL_ACTION:
+            run_control(token, items, top.action);
+            break;
+        case LL_NONTERMINAL:
+        {
+            const Ll_production *production = ll_predict(top.symbol->value, token->type);
+            if (p->recover && ll_is_sync(top.symbol->value))
+            {
+                sync_point_update(p, top, production, items);
+            }
+            if (production == NULL)
+            {
+                result = false;
+                break;
+            }
+            DEBUG_SYNTAX_CODE(printf("%s token: %d value: %s\n", production->name, token->type, token->token_value););
+
+            while (p->size + production->len > p->capacity)
+            {
+                p->capacity *= 2;
+                Ll_item *grown = ast_alloc(sizeof(Ll_item) * p->capacity);
+                memcpy(grown, p->stack, sizeof(Ll_item) * p->size);
+                p->stack = grown;
+            }
+            // the right hand side is pushed in reverse so its first symbol is processed first
+            for (int i = production->len - 1; i >= 0; i--)
+            {
+                const Ll_symbol *symbol = &production->symbols[i];
+                p->stack[p->size++] = (Ll_item){.symbol = symbol, .action = symbol->inherit ? top.action : symbol->action};
+            }
+            break;
+        }
+        }
 
-bool AFTER_ELSE(Token *token, sym_items *items)
-{
-    DEBUG_SYNTAX_CODE(printf("AFTER_ELSE token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // AFTER_ELSE -> { LOCAL_STMT_LIST }
-    case TOKEN_L_CURLY:
-        return cmp_type(token, items, TOKEN_L_CURLY, ELSE_START) && LOCAL_STMT_LIST(token, items) && cmp_type(token, items, TOKEN_R_CURLY, POP_SCOPE);
-    // AFTER_ELSE -> IF_STMT
-    case TOKEN_IF:
-        return ELSE_IF_STMT(token, items);
-    default:
-        return false;
+        if (!result && !p->recover)
+        {
+            return false;
+        }
+        if (!result)
+        {
+            throw_error(SYNTACTIC_ERR, token->line_num, RED "Unexpected token: '%s'!" RESET "\n", token->token_value);
+        }
     }
+    compiler->on_error = outer;
+    return true;
 }
 
-bool WHILE_STMT(Token *token, sym_items *items)
+bool parse_program(Token *token, sym_items *items)
 {
-    DEBUG_SYNTAX_CODE(printf("WHILE_STMT token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
-    {
-    // WHILE_STMT -> while EXP { LOCAL_STMT_LIST }
-    case TOKEN_WHILE:
-        return cmp_type(token, items, TOKEN_WHILE, WHILE_START) && EXP(token, items, COND_EXP) && cmp_type(token, items, TOKEN_L_CURLY, WHILE_COND) &&
-               LOCAL_STMT_LIST(token, items) && cmp_type(token, items, TOKEN_R_CURLY, WHILE_END);
-    default:
-        return false;
-    }
+    return parse_symbol(token, items, &ll_start, true);
 }
 
-bool LOAD_ID(Token *token, sym_items *items)
+bool parse_func_body(Token *token, sym_items *items)
 {
-    DEBUG_SYNTAX_CODE(printf("LOAD_ID token: %d value: %s\n", token->type, token->token_value););
-    switch (token->type)
+    if (!parse_symbol(token, items, &ll_func_body, true) || token->type != TOKEN_R_CURLY)
     {
-    // LOAD_ID -> id = EXP
-    case TOKEN_IDENTIFICATOR:
-        return cmp_type(token, items, TOKEN_IDENTIFICATOR, LOAD_IDENTIF) && cmp_type(token, items, TOKEN_ASSIGN, SEM_NONE) && EXP(token, items, IDENTIF_EXP);
-    // LOAD_ID -> func_id
-    case TOKEN_FUNC_ID:
-        return EXP(token, items, FUNC_CALL_PSA);
-    default:
         return false;
     }
+    // the token after the body belongs to whoever parses the rest of the program
+    run_control(token, items, FUNC_BODY_DONE);
+    return true;
 }
 
 bool EXP(Token *token, sym_items *items, Control_state sem_rule)
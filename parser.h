@@ -23,6 +23,7 @@
 #include "semantic.h"
 #include "generator.h"
 #include "symtable.h"
+#include "ast.h"
 
 #define RED "\x1B[31m"
 #define GREEN "\x1B[32m"
@@ -34,8 +35,10 @@
 
 /**
  * @brief Initializes needed structures and runs the parser.
+ *
+ * @return Ast_block* - global block of the syntax tree of the program
  */
-void run_parser();
+Ast_block *run_parser();
 
 /**
  * @brief Asks scanner for next token.
@@ -70,312 +73,92 @@ void add_builtin_functions(sym_items *items);
  */
 int run_control(Token *token, sym_items *items, Control_state sem_rule);
 
-// RECURSIVE DESCENT PARSER
-
-/**
- * @brief Parses the START nonterminal in the defined grammar.
- * START signifies the top-level rule of the grammar, structured as:
- * START -> STMT_LIST eof
- * This function manages the initial parsing step, ensuring that the entire input
- * conforms to the STMT_LIST followed by an end-of-file (eof) token.
- *
- * @param token A pointer to the current token, marking the beginning of the parsing process.
- * @param items A pointer to sym_items, used for contextual information and state management during parsing.
- * @return Returns true if the entire input sequence correctly matches the START rule, false otherwise.
- */
-bool START(Token *token, sym_items *items);
-
-/**
- * @brief Parses STMT_LIST nonterminal in the defined grammar.
- * STMT_LIST -> STMT STMT_LIST | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool STMT_LIST(Token *token, sym_items *items);
-
-/**
- * @brief Parses LOCAL_STMT_LIST nonterminal in the defined grammar.
- * LOCAL_STMT_LIST -> LOCAL_STMT LOCAL_STMT_LIST | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool LOCAL_STMT_LIST(Token *token, sym_items *items);
-
-/**
- * @brief Parses STMT nonterminal in the defined grammar.
- * STMT -> VAR_LET | LOAD_ID | DEF_FUNC | FUNC_STMT | IF_STMT | WHILE_STMT | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool STMT(Token *token, sym_items *items);
-
-/**
- * @brief Parses LOCAL_STMT nonterminal in the defined grammar.
- * LOCAL_STMT -> VAR_LET | LOAD_ID | FUNC_STMT | IF_STMT | WHILE_STMT | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool LOCAL_STMT(Token *token, sym_items *items);
-
-/**
- * @brief Parses VAR_LET nonterminal in the defined grammar.
- * VAR_LET -> VAR_LET -> VAR_SCOPE id TYPE_AND_ASSIGN
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool VAR_LET(Token *token, sym_items *items);
-
-/**
- * @brief Parses VAR_SCOPE nonterminal in the defined grammar.
- * VAR_SCOPE -> let | var
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool VAR_SCOPE(Token *token, sym_items *items);
-
-/**
- * @brief Parses TYPE_AND_ASSIGN nonterminal in the defined grammar.
- * TYPE_AND_ASSIGN -> : D_TYPE R_FLEX | = EXP
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @param sem_rule Semantic rule to apply.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool TYPE_AND_ASIGN(Token *token, sym_items *items);
-
-/**
- * @brief Parses D_TYPE nonterminal in the defined grammar.
- * D_TYPE -> Int | Int? | Double | Double? | String | String? | Bool | Bool?
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @param sem_rule Semantic rule to apply.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool D_TYPE(Token *token, sym_items *items, Control_state sem_rule);
-
-/**
- * @brief Parses R_FLEX nonterminal in the defined grammar.
- * R_FLEX -> = EXP | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool R_FLEX(Token *token, sym_items *items);
-
-/**
- * @brief Parses DEF_FUNC nonterminal in the defined grammar.
- * DEF_FUNC -> func id ( P_LIST ) RET_TYPE { FUNC_STMT_LIST }
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool DEF_FUNC(Token *token, sym_items *items);
-
-/**
- * @brief Parses P_LIST nonterminal in the defined grammar.
- * P_LIST -> PARAM | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool P_LIST(Token *token, sym_items *items);
-
-/**
- * @brief Parses PARAM nonterminal in the defined grammar.
- * PARAM -> id id : D_TYPE SEP
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool PARAM(Token *token, sym_items *items);
-
-/**
- * @brief Parses SEP nonterminal in the defined grammar.
- * SEP -> , PARAM | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for context propagation during parsing.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool P_SEP(Token *token, sym_items *items);
-
-/**
- * @brief Parses RET_TYPE nonterminal in the defined grammar.
- * RET_TYPE -> -> D_TYPE | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool RET_TYPE(Token *token, sym_items *items);
-
-/**
- * @brief Parses FUNC_STMT_LIST nonterminal in the defined grammar.
- * FUNC_STMT_LIST -> FUNC_STMT FUNC_STMT_LIST | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool FUNC_STMT_LIST(Token *token, sym_items *items);
-
-/**
- * @brief Parses FUNC_STMT nonterminal in the defined grammar.
- * FUNC_STMT -> VAR_LET | LOAD_ID | FUNC_WHILE | FUNC_IF | RET | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool FUNC_STMT(Token *token, sym_items *items);
-
-/**
- * @brief Parses RET nonterminal in the defined grammar.
- * RET -> return EXP
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool RET(Token *token, sym_items *items);
-
-/**
- * @brief Parses FUNC_WHILE nonterminal in the defined grammar.
- * FUNC_WHILE -> while EXP { FUNC_STMT_LIST }
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool FUNC_WHILE(Token *token, sym_items *items);
-
-/**
- * @brief Parses FUNC_IF nonterminal in the defined grammar.
- * FUNC_IF -> if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool FUNC_IF(Token *token, sym_items *items);
-
-/**
- * @brief Parses FUNC_ELSE_IF nonterminal in the defined grammar.
- * FUNC_ELSE_IF -> if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
- */
-bool FUNC_ELSE_IF(Token *token, sym_items *items);
+// TABLE-DRIVEN PARSER
 
 /**
- * @brief Parses FUNC_ELSE_CLAUSE nonterminal in the defined grammar.
- * FUNC_ELSE_CLAUSE -> else FUNC_AFTER_ELSE | ε
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
+ * @brief Kind of a grammar symbol on the parser stack.
  */
-bool FUNC_ELSE_CLAUSE(Token *token, sym_items *items);
+typedef enum
+{
+    LL_TERMINAL,    // token that has to be matched
+    LL_NONTERMINAL, // replaced by the right hand side of the production chosen by the lookahead token
+    LL_EXPRESSION,  // expression parsed by the PSA
+    LL_ACTION,      // semantic action without a token
+} Ll_symbol_kind;
 
 /**
- * @brief Parses FUNC_AFTER_ELSE nonterminal in the defined grammar.
- * FUNC_AFTER_ELSE -> { FUNC_STMT_LIST } | FUNC_IF
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
+ * @brief - Symbol of the right hand side of a production
+ * @param kind - kind of the symbol
+ * @param value - Token_type of a terminal, index of a nonterminal
+ * @param action - semantic rule run when the symbol is processed
+ * @param inherit - the action of the nonterminal the symbol was derived from is run instead
  */
-bool FUNC_AFTER_ELSE(Token *token, sym_items *items);
+typedef struct
+{
+    Ll_symbol_kind kind;
+    int value;
+    Control_state action;
+    bool inherit;
+} Ll_symbol;
 
 /**
- * @brief Parses IF_STMT nonterminal in the defined grammar.
- * IF_STMT -> if EXP { LOCAL_STMT_LIST } ELSE_CLAUSE
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
+ * @brief - Production of the LL grammar
+ * @param symbols - right hand side
+ * @param len - count of the symbols, 0 for an empty right hand side
+ * @param name - the production as text for debugging
  */
-bool IF_STMT(Token *token, sym_items *items);
+typedef struct
+{
+    const Ll_symbol *symbols;
+    int len;
+    const char *name;
+} Ll_production;
 
 /**
- * @brief Parses ELSE_IF_STMT nonterminal in the defined grammar.
- * ELSE_IF_STMT -> if EXP { LOCAL_STMT_LIST } ELSE_CLAUSE
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
+ * @brief Start symbol of the grammar, defined in parser_table.c generated by utils/create_ll_table.py.
  */
-bool ELSE_IF_STMT(Token *token, sym_items *items);
+extern const Ll_symbol ll_start;
 
 /**
- * @brief Parses IF_COND nonterminal in the defined grammar.
- * IF_COND -> EXP | let id
- *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
+ * @brief Statements of a function body, the symbol the bodies parsed apart from the program start from.
  */
-bool IF_COND(Token *token, sym_items *items);
+extern const Ll_symbol ll_func_body;
 
 /**
- * @brief Parses ELSE_CLAUSE nonterminal in the defined grammar.
- * ELSE_CLAUSE -> else AFTER_ELSE | ε
+ * @brief Looks up the LL(1) table.
  *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
+ * @param nonterminal nonterminal on the top of the parser stack
+ * @param lookahead type of the current token
+ * @return const Ll_production* - production to expand, NULL if the token cannot follow
  */
-bool ELSE_CLAUSE(Token *token, sym_items *items);
+const Ll_production *ll_predict(int nonterminal, Token_type lookahead);
 
 /**
- * @brief Parses AFTER_ELSE nonterminal in the defined grammar.
- * AFTER_ELSE -> { LOCAL_STMT_LIST } | IF_STMT
+ * @brief Tells whether the nonterminal is a statement list, the parser continues from its next statement after an error.
  *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
+ * @param nonterminal nonterminal popped from the parser stack
+ * @return true if the parser synchronizes on the nonterminal
  */
-bool AFTER_ELSE(Token *token, sym_items *items);
+bool ll_is_sync(int nonterminal);
 
 /**
- * @brief Parses WHILE_STMT nonterminal in the defined grammar.
- * WHILE_STMT -> while EXP { LOCAL_STMT_LIST }
+ * @brief Parses the whole program with an explicit stack, the nesting depth is limited only by memory.
  *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
+ * @param token A pointer to the current token, the first token of the program.
+ * @param items A pointer to sym_items, used for contextual information and state management during parsing.
+ * @return Returns true if the entire input matches the grammar, false otherwise (token is the unexpected token).
  */
-bool WHILE_STMT(Token *token, sym_items *items);
+bool parse_program(Token *token, sym_items *items);
 
 /**
- * @brief Parses LOAD_ID nonterminal in the defined grammar.
- * LOAD_ID -> id = EXP | func_id
+ * @brief Parses the statements of a function body up to its closing brace, the brace is not read past. An error is
+ * reported and the parser continues from the next statement of the body, as the parser of the program does.
  *
- * @param token A pointer to the current token in the parsing process.
- * @param items A pointer to sym_items, used for semantic analysis.
- * @return Returns true if parsing succeeds, false otherwise.
+ * @param token A pointer to the current token, the first token of the body.
+ * @param items A pointer to sym_items with the function whose header has been parsed.
+ * @return Returns true if the body matches the grammar, false otherwise (token is the unexpected token).
  */
-bool LOAD_ID(Token *token, sym_items *items);
+bool parse_func_body(Token *token, sym_items *items);
 
 /**
  * @brief Parses EXP nonterminal in the defined grammar.
@@ -11,23 +11,29 @@
  */
 
 #include "parser.h"
+#include "compiler.h"
+#include "func_cache.h"
+#include "func_pool.h"
+#include "lazy.h"
 
-void run_parser()
+Ast_block *run_parser()
 {
     // initilizes variables needed for parser
-    Token *token = malloc(sizeof(Token));
+    Token *token = ast_alloc(sizeof(Token));
     symtable s_tb = symtable_init();
-    symtable_stack_push(sym_st, s_tb);
-    sym_items *items = malloc(sizeof(sym_items));
+    symtable_stack_push(compiler->sym_st, s_tb);
+    sym_items *items = ast_alloc(sizeof(sym_items));
     items->funcItem = init_symtable_item(true);
     items->varItem = init_symtable_item(false);
+    items->expr = NULL;
 
     add_builtin_functions(items);
+    ast_program_begin();
 
     get_token(token);
 
-    // starts recursive descent
-    bool all_ok = START(token, items);
+    // parses the program by the LL table
+    bool all_ok = parse_program(token, items);
     if (all_ok)
     {
         DEBUG_SYNTAX_CODE(printf(GREEN "\nAll OK" RESET "\n"););
@@ -36,7 +42,7 @@ void run_parser()
     {
         throw_error(SYNTACTIC_ERR, token->line_num, RED "Unexpected token: '%s'!" RESET "\n", token->token_value);
     }
-    free(token);
+    return ast_program_end();
 }
 
 int run_control(Token *token, sym_items *items, Control_state sem_rule)
@@ -54,34 +60,39 @@ int run_control(Token *token, sym_items *items, Control_state sem_rule)
 
         break;
     case VAR_ID:
+    {
         sem_var_id(token, items);
 
-        HANDLE_DEFVAR(
-            fprintf(out_code_file, "# variable definition\n");
-            generate_instruction(DEFVAR, variable(items->varItem->id, sym_st->size - 1, true));
-            fprintf(out_code_file, "\n"););
+        Ast_stmt *stmt = ast_stmt_append(AST_VAR_DECL, token->line_num);
+        stmt->data.var_decl.var = ast_scope_var(items->varItem->id);
 
         break;
+    }
     case VAR_TYPE:
         sem_var_type(token, items);
         break;
     case VAR_EXP:
+    {
         sem_var_exp(token, items);
         sem_var_add(token, items);
 
-        fprintf(out_code_file, "# variable initialization\n");
-        generate_instruction(POPS, symbol((Token){
-                                       .type = TOKEN_IDENTIFICATOR,
-                                       .token_value = items->varItem->id,
-                                       .line_num = token->line_num,
-                                   }));
-        fprintf(out_code_file, "\n");
+        Ast_stmt *stmt = ast_last_stmt();
+        stmt->data.var_decl.has_init = true;
+        stmt->data.var_decl.init = items->expr;
+        stmt->data.var_decl.target = ast_resolve_var(items->varItem->id);
 
         break;
+    }
     case VAR_ADD:
-        generate_implicit_init(*(items->varItem));
+    {
+        // variables that can be nil are initialized to nil implicitly
+        Expression_type type = items->varItem->data.var_data->type;
+        bool can_be_nil = type == TYPE_INT_NIL || type == TYPE_DOUBLE_NIL || type == TYPE_STRING_NIL || type == TYPE_BOOL_NIL;
+        ast_last_stmt()->data.var_decl.nil_init = !items->varItem->data.var_data->is_initialized && can_be_nil;
+
         sem_var_add(token, items);
         break;
+    }
     case FUNC_ID:
         sem_func_id(token, items);
         break;
@@ -98,87 +109,122 @@ int run_control(Token *token, sym_items *items, Control_state sem_rule)
         sem_r_type(token, items);
         break;
     case FUNC_HEADER_DONE:
-        sem_func_header_done(token, items);
+    {
+        // only the functions of the global block are cached, handed over to the function pool or left out by the
+        // lazy compilation, all need the global scope on the top
+        Func_cache *cache = NULL;
+        Func_unit *unit = NULL;
+        bool unreachable = false;
+        if (compiler->ast.current == compiler->ast.program)
+        {
+            unreachable = lazy_unreachable(items->funcItem->id);
+            cache = func_cache_lookup(items->funcItem);
+            if (cache != NULL && unreachable && !cache->hit)
+            {
+                cache = NULL; // no code is generated to be stored
+            }
+            // after an error the bodies are parsed here, the parser reports all of their errors
+            bool is_clean = compiler->error_st == NULL || Error_stack_empty(compiler->error_st);
+            if (!unreachable && is_clean && compiler->func_threads > 0 && (cache == NULL || !cache->hit))
+            {
+                unit = func_pool_submit(items->funcItem, token);
+            }
+        }
 
-        fprintf(out_code_file, "# function header\n");
-        generate_func_header(*(items->funcItem));
+        sem_func_header_done(token, items);
 
+        // the parameters are variables of the function body scope
+        FunctionData *func_data = items->funcItem->data.func_data;
+        Ast_stmt *stmt = ast_stmt_append(AST_FUNC, token->line_num);
+        stmt->data.func.name = items->funcItem->id;
+        stmt->data.func.param_count = func_data->params_count;
+        stmt->data.func.params = ast_alloc(sizeof(Ast_var) * func_data->params_count);
+        for (int i = 0; i < func_data->params_count; i++)
+        {
+            stmt->data.func.params[i] = ast_resolve_var(func_data->params[i].id);
+        }
+        ast_block_open(&stmt->data.func.body);
+
+        // the body is not parsed here, the closing brace follows
+        stmt->data.func.cache = cache;
+        stmt->data.func.unit = unit;
+        stmt->data.func.unreachable = unreachable;
+        // the body of a cached function has been left out of the source, only its closing brace follows
+        items->body_skipped = (cache != NULL && cache->hit) || unit != NULL;
+        if (unit != NULL)
+        {
+            func_pool_skip_body(unit);
+        }
+        else if (unreachable && !compiler->lazy_check)
+        {
+            items->body_skipped = func_pool_drop_body(items->funcItem);
+        }
         break;
+    }
     case PUSH_SCOPE:
         sem_push_scope(token, items);
         break;
     case POP_SCOPE:
         sem_pop_scope(token, items);
+        ast_block_close();
         break;
     case R_EXP:
-    {
         sem_r_exp(token, items);
-
-        fprintf(out_code_file, "\n");
-        fprintf(out_code_file, "# return\n");
-        generate_instruction(POPFRAME);
-        generate_instruction(CREATEFRAME);
-        HANDLE_DEFVAR(generate_instruction(DEFVAR, variable("retval", -1, false)););
-        generate_instruction(POPS, variable("retval", -1, false));
-        generate_instruction(RETURN);
-        fprintf(out_code_file, "\n");
-
+        ast_stmt_append(AST_RETURN, token->line_num)->data.expr = items->expr;
         break;
-    }
     case COND_EXP:
-        sem_cond_exp(token, items);
+        // the scope of the body is open even if the condition fails, the parser continues with the body
         run_control(token, items, PUSH_SCOPE);
+        sem_cond_exp(token, items);
         break;
     case IF_START:
-        generate_if_start();
-        break;
-    case ELSE_IF_START:
-        generate_elseif_else();
+        ast_if_branch(ast_stmt_append(AST_IF, token->line_num), items->expr);
         break;
     case ELSE_IF_AFTER_COND:
-        generate_elseif_if();
+        ast_if_branch(ast_last_stmt(), items->expr);
         break;
     case ELSE_START:
-        generate_else();
+    {
+        Ast_stmt *if_stmt = ast_last_stmt();
+        if_stmt->data.if_stmt.else_body = ast_alloc(sizeof(Ast_block));
         run_control(token, items, PUSH_SCOPE);
+        ast_block_open(if_stmt->data.if_stmt.else_body);
         break;
-    case IF_END:
-        generate_if_end();
-        break;
+    }
     case FUNC_IF_FOUND:
         sem_func_if_start(token, items);
         break;
     case FUNC_ELSE:
         sem_func_else(token, items);
         break;
-    case WHILE_START:
-        generate_while_start();
-        break;
     case WHILE_COND:
-        generate_while_condition();
+    {
+        Ast_stmt *stmt = ast_stmt_append(AST_WHILE, token->line_num);
+        stmt->data.while_stmt.cond = items->expr;
+        ast_block_open(&stmt->data.while_stmt.body);
         break;
+    }
     case WHILE_END:
         run_control(token, items, POP_SCOPE);
-        generate_while_end();
         break;
     case LET_IN_IF:
     {
-        generate_instruction(PUSHS, symbol((Token){.type = TOKEN_IDENTIFICATOR, .token_value = token->token_value, .line_num = token->line_num}));
-        generate_instruction(PUSHS, literal((Token){.type = TOKEN_NIL, .token_value = "nil", .line_num = token->line_num}));
-        generate_instruction(EQS);
-        generate_instruction(NOTS);
+        // if let id -> the body runs if id is not nil
+        Ast_expr *value = ast_operand(*token, getIdType(convertTokenToPSAToken(*token)));
+        items->expr = ast_unary(AST_IS_NOT_NIL, TYPE_BOOL, value);
 
         sem_let_in_if(token, items);
 
         break;
     }
     case FUNC_BODY_DONE:
-        sem_func_body_done(token, items);
+        if (!items->body_skipped)
+        {
+            sem_func_body_done(token, items);
+        }
+        items->body_skipped = false;
         run_control(token, items, POP_SCOPE);
 
-        fprintf(out_code_file, "# function end\n");
-        generate_func_end(*(items->funcItem));
-
         items->funcItem = NULL;
         break;
     case LOAD_IDENTIF:
@@ -186,23 +232,22 @@ int run_control(Token *token, sym_items *items, Control_state sem_rule)
 
         break;
     case IDENTIF_EXP:
+    {
         sem_identif_exp(token, items);
 
-        fprintf(out_code_file, "# variable assigment\n");
-        generate_instruction(POPS, symbol((Token){
-                                       .type = TOKEN_IDENTIFICATOR,
-                                       .token_value = items->varItem->id,
-                                       .line_num = token->line_num,
-                                   }));
-        fprintf(out_code_file, "\n");
+        Ast_stmt *stmt = ast_stmt_append(AST_ASSIGN, token->line_num);
+        stmt->data.assign.target = ast_resolve_var(items->varItem->id);
+        stmt->data.assign.value = items->expr;
 
         break;
+    }
     case FUNC_CALL_PSA:
         sem_func_call_psa(token, items);
+        ast_stmt_append(AST_EXPR, token->line_num)->data.expr = items->expr;
         break;
     default:
         break;
     }
 
     return 0;
-}
\ No newline at end of file
+}
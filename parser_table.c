@@ -0,0 +1,357 @@
+/**
+ * @file parser_table.c
+ * @brief LL(1) parse table of the grammar in doc/ll_grammar.xlsx, generated by utils/create_ll_table.py - do not edit
+ * by hand.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <stdint.h>
+#include "parser.h"
+
+#define LL_NONTERMINAL_COUNT 30
+#define LL_TOKEN_COUNT (TOKEN_UNSHIFT + 1)
+
+enum
+{
+    LL_START,
+    LL_STMT_LIST,
+    LL_STMT,
+    LL_VAR_LET,
+    LL_VAR_SCOPE,
+    LL_TYPE_AND_ASSIGN,
+    LL_D_TYPE,
+    LL_R_FLEX,
+    LL_DEF_FUNC,
+    LL_P_LIST,
+    LL_PARAM,
+    LL_P_SEP,
+    LL_RET_TYPE,
+    LL_FUNC_STMT_LIST,
+    LL_FUNC_STMT,
+    LL_RET,
+    LL_FUNC_WHILE,
+    LL_FUNC_IF,
+    LL_FUNC_ELSE_CLAUSE,
+    LL_FUNC_AFTER_ELSE,
+    LL_IF_STMT,
+    LL_ELSE_CLAUSE,
+    LL_AFTER_ELSE,
+    LL_WHILE_STMT,
+    LL_LOAD_ID,
+    LL_IF_COND,
+    LL_LOCAL_STMT_LIST,
+    LL_LOCAL_STMT,
+    LL_FUNC_ELSE_IF,
+    LL_ELSE_IF_STMT,
+};
+
+// right hand sides of the productions
+static const Ll_symbol ll_symbols[] = {
+    // START ::= STMT_LIST eof
+    {.kind = LL_ACTION, .value = 0, .action = STARTING, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_EOF, .action = SEM_NONE, .inherit = false},
+    // STMT_LIST ::= ''
+    // STMT_LIST ::= STMT STMT_LIST
+    {.kind = LL_NONTERMINAL, .value = LL_STMT, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    // STMT ::= VAR_LET
+    {.kind = LL_NONTERMINAL, .value = LL_VAR_LET, .action = SEM_NONE, .inherit = false},
+    // STMT ::= DEF_FUNC
+    {.kind = LL_NONTERMINAL, .value = LL_DEF_FUNC, .action = SEM_NONE, .inherit = false},
+    // STMT ::= IF_STMT
+    {.kind = LL_NONTERMINAL, .value = LL_IF_STMT, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_ACTION, .value = 0, .action = IF_END, .inherit = false},
+    // STMT ::= LOAD_ID
+    {.kind = LL_NONTERMINAL, .value = LL_LOAD_ID, .action = SEM_NONE, .inherit = false},
+    // STMT ::= WHILE_STMT
+    {.kind = LL_NONTERMINAL, .value = LL_WHILE_STMT, .action = SEM_NONE, .inherit = false},
+    // VAR_LET ::= VAR_SCOPE id TYPE_AND_ASSIGN
+    {.kind = LL_NONTERMINAL, .value = LL_VAR_SCOPE, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_IDENTIFICATOR, .action = VAR_ID, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_TYPE_AND_ASSIGN, .action = SEM_NONE, .inherit = false},
+    // VAR_SCOPE ::= var
+    {.kind = LL_TERMINAL, .value = TOKEN_VAR, .action = VAR, .inherit = false},
+    // VAR_SCOPE ::= let
+    {.kind = LL_TERMINAL, .value = TOKEN_LET, .action = LET, .inherit = false},
+    // TYPE_AND_ASSIGN ::= : D_TYPE R_FLEX
+    {.kind = LL_TERMINAL, .value = TOKEN_DOUBLE_DOT, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_D_TYPE, .action = VAR_TYPE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_R_FLEX, .action = SEM_NONE, .inherit = false},
+    // TYPE_AND_ASSIGN ::= = exp
+    {.kind = LL_TERMINAL, .value = TOKEN_ASSIGN, .action = VAR_ASSIGN1, .inherit = false},
+    {.kind = LL_EXPRESSION, .value = 0, .action = VAR_EXP, .inherit = false},
+    // D_TYPE ::= Bool
+    {.kind = LL_TERMINAL, .value = TOKEN_TYPE_BOOL, .action = SEM_NONE, .inherit = true},
+    // D_TYPE ::= Double
+    {.kind = LL_TERMINAL, .value = TOKEN_TYPE_DOUBLE, .action = SEM_NONE, .inherit = true},
+    // D_TYPE ::= Int
+    {.kind = LL_TERMINAL, .value = TOKEN_TYPE_INT, .action = SEM_NONE, .inherit = true},
+    // D_TYPE ::= String
+    {.kind = LL_TERMINAL, .value = TOKEN_TYPE_STRING, .action = SEM_NONE, .inherit = true},
+    // D_TYPE ::= Bool_Nil
+    {.kind = LL_TERMINAL, .value = TOKEN_TYPE_BOOL_NIL, .action = SEM_NONE, .inherit = true},
+    // D_TYPE ::= Double_Nil
+    {.kind = LL_TERMINAL, .value = TOKEN_TYPE_DOUBLE_NIL, .action = SEM_NONE, .inherit = true},
+    // D_TYPE ::= Int_Nil
+    {.kind = LL_TERMINAL, .value = TOKEN_TYPE_INT_NIL, .action = SEM_NONE, .inherit = true},
+    // D_TYPE ::= String_Nil
+    {.kind = LL_TERMINAL, .value = TOKEN_TYPE_STRING_NIL, .action = SEM_NONE, .inherit = true},
+    // R_FLEX ::= ''
+    {.kind = LL_ACTION, .value = 0, .action = VAR_ADD, .inherit = false},
+    // R_FLEX ::= = exp
+    {.kind = LL_TERMINAL, .value = TOKEN_ASSIGN, .action = VAR_ASSIGN2, .inherit = false},
+    {.kind = LL_EXPRESSION, .value = 0, .action = VAR_EXP, .inherit = false},
+    // DEF_FUNC ::= func func_id ( P_LIST ) RET_TYPE { FUNC_STMT_LIST }
+    {.kind = LL_TERMINAL, .value = TOKEN_FUNC, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_FUNC_ID, .action = FUNC_ID, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_L_BRACKET, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_P_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_R_BRACKET, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_RET_TYPE, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_L_CURLY, .action = FUNC_HEADER_DONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_R_CURLY, .action = FUNC_BODY_DONE, .inherit = false},
+    // P_LIST ::= PARAM
+    {.kind = LL_NONTERMINAL, .value = LL_PARAM, .action = SEM_NONE, .inherit = false},
+    // P_LIST ::= ''
+    // PARAM ::= id id : D_TYPE P_SEP
+    {.kind = LL_TERMINAL, .value = TOKEN_IDENTIFICATOR, .action = P_NAME, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_IDENTIFICATOR, .action = P_ID, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_DOUBLE_DOT, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_D_TYPE, .action = P_TYPE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_P_SEP, .action = SEM_NONE, .inherit = false},
+    // P_SEP ::= ''
+    // P_SEP ::= , PARAM
+    {.kind = LL_TERMINAL, .value = TOKEN_COMMA, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_PARAM, .action = SEM_NONE, .inherit = false},
+    // RET_TYPE ::= ''
+    // RET_TYPE ::= -> D_TYPE
+    {.kind = LL_TERMINAL, .value = TOKEN_ARROW, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_D_TYPE, .action = R_TYPE, .inherit = false},
+    // FUNC_STMT_LIST ::= FUNC_STMT FUNC_STMT_LIST
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_STMT, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    // FUNC_STMT_LIST ::= ''
+    // FUNC_STMT ::= VAR_LET
+    {.kind = LL_NONTERMINAL, .value = LL_VAR_LET, .action = SEM_NONE, .inherit = false},
+    // FUNC_STMT ::= RET
+    {.kind = LL_NONTERMINAL, .value = LL_RET, .action = SEM_NONE, .inherit = false},
+    // FUNC_STMT ::= FUNC_WHILE
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_WHILE, .action = SEM_NONE, .inherit = false},
+    // FUNC_STMT ::= LOAD_ID
+    {.kind = LL_NONTERMINAL, .value = LL_LOAD_ID, .action = SEM_NONE, .inherit = false},
+    // FUNC_STMT ::= FUNC_IF
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_IF, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_ACTION, .value = 0, .action = IF_END, .inherit = false},
+    // RET ::= return exp
+    {.kind = LL_TERMINAL, .value = TOKEN_RETURN, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_EXPRESSION, .value = 0, .action = R_EXP, .inherit = false},
+    // FUNC_WHILE ::= while exp { FUNC_STMT_LIST }
+    {.kind = LL_TERMINAL, .value = TOKEN_WHILE, .action = WHILE_START, .inherit = false},
+    {.kind = LL_EXPRESSION, .value = 0, .action = COND_EXP, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_L_CURLY, .action = WHILE_COND, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_R_CURLY, .action = WHILE_END, .inherit = false},
+    // FUNC_IF ::= if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE
+    {.kind = LL_TERMINAL, .value = TOKEN_IF, .action = FUNC_IF_FOUND, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_IF_COND, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_L_CURLY, .action = IF_START, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_R_CURLY, .action = POP_SCOPE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_ELSE_CLAUSE, .action = SEM_NONE, .inherit = false},
+    // FUNC_ELSE_CLAUSE ::= ''
+    // FUNC_ELSE_CLAUSE ::= else FUNC_AFTER_ELSE
+    {.kind = LL_TERMINAL, .value = TOKEN_ELSE, .action = FUNC_ELSE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_AFTER_ELSE, .action = SEM_NONE, .inherit = false},
+    // FUNC_AFTER_ELSE ::= FUNC_ELSE_IF
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_ELSE_IF, .action = SEM_NONE, .inherit = false},
+    // FUNC_AFTER_ELSE ::= { FUNC_STMT_LIST }
+    {.kind = LL_TERMINAL, .value = TOKEN_L_CURLY, .action = ELSE_START, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_R_CURLY, .action = POP_SCOPE, .inherit = false},
+    // IF_STMT ::= if IF_COND { LOCAL_STMT_LIST } ELSE_CLAUSE
+    {.kind = LL_TERMINAL, .value = TOKEN_IF, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_IF_COND, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_L_CURLY, .action = IF_START, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_LOCAL_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_R_CURLY, .action = POP_SCOPE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_ELSE_CLAUSE, .action = SEM_NONE, .inherit = false},
+    // ELSE_CLAUSE ::= else AFTER_ELSE
+    {.kind = LL_TERMINAL, .value = TOKEN_ELSE, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_AFTER_ELSE, .action = SEM_NONE, .inherit = false},
+    // ELSE_CLAUSE ::= ''
+    // AFTER_ELSE ::= ELSE_IF_STMT
+    {.kind = LL_NONTERMINAL, .value = LL_ELSE_IF_STMT, .action = SEM_NONE, .inherit = false},
+    // AFTER_ELSE ::= { LOCAL_STMT_LIST }
+    {.kind = LL_TERMINAL, .value = TOKEN_L_CURLY, .action = ELSE_START, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_LOCAL_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_R_CURLY, .action = POP_SCOPE, .inherit = false},
+    // WHILE_STMT ::= while exp { LOCAL_STMT_LIST }
+    {.kind = LL_TERMINAL, .value = TOKEN_WHILE, .action = WHILE_START, .inherit = false},
+    {.kind = LL_EXPRESSION, .value = 0, .action = COND_EXP, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_L_CURLY, .action = WHILE_COND, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_LOCAL_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_R_CURLY, .action = WHILE_END, .inherit = false},
+    // LOAD_ID ::= id = exp
+    {.kind = LL_TERMINAL, .value = TOKEN_IDENTIFICATOR, .action = LOAD_IDENTIF, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_ASSIGN, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_EXPRESSION, .value = 0, .action = IDENTIF_EXP, .inherit = false},
+    // LOAD_ID ::= call
+    {.kind = LL_EXPRESSION, .value = 0, .action = FUNC_CALL_PSA, .inherit = false},
+    // IF_COND ::= exp
+    {.kind = LL_EXPRESSION, .value = 0, .action = COND_EXP, .inherit = false},
+    // IF_COND ::= let id
+    {.kind = LL_TERMINAL, .value = TOKEN_LET, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_IDENTIFICATOR, .action = LET_IN_IF, .inherit = false},
+    // LOCAL_STMT_LIST ::= LOCAL_STMT LOCAL_STMT_LIST
+    {.kind = LL_NONTERMINAL, .value = LL_LOCAL_STMT, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_LOCAL_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    // LOCAL_STMT_LIST ::= ''
+    // LOCAL_STMT ::= VAR_LET
+    {.kind = LL_NONTERMINAL, .value = LL_VAR_LET, .action = SEM_NONE, .inherit = false},
+    // LOCAL_STMT ::= LOAD_ID
+    {.kind = LL_NONTERMINAL, .value = LL_LOAD_ID, .action = SEM_NONE, .inherit = false},
+    // LOCAL_STMT ::= IF_STMT
+    {.kind = LL_NONTERMINAL, .value = LL_IF_STMT, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_ACTION, .value = 0, .action = IF_END, .inherit = false},
+    // LOCAL_STMT ::= WHILE_STMT
+    {.kind = LL_NONTERMINAL, .value = LL_WHILE_STMT, .action = SEM_NONE, .inherit = false},
+    // FUNC_ELSE_IF ::= if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE
+    {.kind = LL_TERMINAL, .value = TOKEN_IF, .action = ELSE_IF_START, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_IF_COND, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_L_CURLY, .action = ELSE_IF_AFTER_COND, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_R_CURLY, .action = POP_SCOPE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_FUNC_ELSE_CLAUSE, .action = SEM_NONE, .inherit = false},
+    // ELSE_IF_STMT ::= if IF_COND { LOCAL_STMT_LIST } ELSE_CLAUSE
+    {.kind = LL_TERMINAL, .value = TOKEN_IF, .action = ELSE_IF_START, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_IF_COND, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_L_CURLY, .action = ELSE_IF_AFTER_COND, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_LOCAL_STMT_LIST, .action = SEM_NONE, .inherit = false},
+    {.kind = LL_TERMINAL, .value = TOKEN_R_CURLY, .action = POP_SCOPE, .inherit = false},
+    {.kind = LL_NONTERMINAL, .value = LL_ELSE_CLAUSE, .action = SEM_NONE, .inherit = false},
+};
+
+static const Ll_production ll_productions[] = {
+    {.symbols = &ll_symbols[0], .len = 3, .name = "START ::= STMT_LIST eof"},
+    {.symbols = &ll_symbols[3], .len = 0, .name = "STMT_LIST ::= ''"},
+    {.symbols = &ll_symbols[3], .len = 2, .name = "STMT_LIST ::= STMT STMT_LIST"},
+    {.symbols = &ll_symbols[5], .len = 1, .name = "STMT ::= VAR_LET"},
+    {.symbols = &ll_symbols[6], .len = 1, .name = "STMT ::= DEF_FUNC"},
+    {.symbols = &ll_symbols[7], .len = 2, .name = "STMT ::= IF_STMT"},
+    {.symbols = &ll_symbols[9], .len = 1, .name = "STMT ::= LOAD_ID"},
+    {.symbols = &ll_symbols[10], .len = 1, .name = "STMT ::= WHILE_STMT"},
+    {.symbols = &ll_symbols[11], .len = 3, .name = "VAR_LET ::= VAR_SCOPE id TYPE_AND_ASSIGN"},
+    {.symbols = &ll_symbols[14], .len = 1, .name = "VAR_SCOPE ::= var"},
+    {.symbols = &ll_symbols[15], .len = 1, .name = "VAR_SCOPE ::= let"},
+    {.symbols = &ll_symbols[16], .len = 3, .name = "TYPE_AND_ASSIGN ::= : D_TYPE R_FLEX"},
+    {.symbols = &ll_symbols[19], .len = 2, .name = "TYPE_AND_ASSIGN ::= = exp"},
+    {.symbols = &ll_symbols[21], .len = 1, .name = "D_TYPE ::= Bool"},
+    {.symbols = &ll_symbols[22], .len = 1, .name = "D_TYPE ::= Double"},
+    {.symbols = &ll_symbols[23], .len = 1, .name = "D_TYPE ::= Int"},
+    {.symbols = &ll_symbols[24], .len = 1, .name = "D_TYPE ::= String"},
+    {.symbols = &ll_symbols[25], .len = 1, .name = "D_TYPE ::= Bool_Nil"},
+    {.symbols = &ll_symbols[26], .len = 1, .name = "D_TYPE ::= Double_Nil"},
+    {.symbols = &ll_symbols[27], .len = 1, .name = "D_TYPE ::= Int_Nil"},
+    {.symbols = &ll_symbols[28], .len = 1, .name = "D_TYPE ::= String_Nil"},
+    {.symbols = &ll_symbols[29], .len = 1, .name = "R_FLEX ::= ''"},
+    {.symbols = &ll_symbols[30], .len = 2, .name = "R_FLEX ::= = exp"},
+    {.symbols = &ll_symbols[32], .len = 9, .name = "DEF_FUNC ::= func func_id ( P_LIST ) RET_TYPE { FUNC_STMT_LIST }"},
+    {.symbols = &ll_symbols[41], .len = 1, .name = "P_LIST ::= PARAM"},
+    {.symbols = &ll_symbols[42], .len = 0, .name = "P_LIST ::= ''"},
+    {.symbols = &ll_symbols[42], .len = 5, .name = "PARAM ::= id id : D_TYPE P_SEP"},
+    {.symbols = &ll_symbols[47], .len = 0, .name = "P_SEP ::= ''"},
+    {.symbols = &ll_symbols[47], .len = 2, .name = "P_SEP ::= , PARAM"},
+    {.symbols = &ll_symbols[49], .len = 0, .name = "RET_TYPE ::= ''"},
+    {.symbols = &ll_symbols[49], .len = 2, .name = "RET_TYPE ::= -> D_TYPE"},
+    {.symbols = &ll_symbols[51], .len = 2, .name = "FUNC_STMT_LIST ::= FUNC_STMT FUNC_STMT_LIST"},
+    {.symbols = &ll_symbols[53], .len = 0, .name = "FUNC_STMT_LIST ::= ''"},
+    {.symbols = &ll_symbols[53], .len = 1, .name = "FUNC_STMT ::= VAR_LET"},
+    {.symbols = &ll_symbols[54], .len = 1, .name = "FUNC_STMT ::= RET"},
+    {.symbols = &ll_symbols[55], .len = 1, .name = "FUNC_STMT ::= FUNC_WHILE"},
+    {.symbols = &ll_symbols[56], .len = 1, .name = "FUNC_STMT ::= LOAD_ID"},
+    {.symbols = &ll_symbols[57], .len = 2, .name = "FUNC_STMT ::= FUNC_IF"},
+    {.symbols = &ll_symbols[59], .len = 2, .name = "RET ::= return exp"},
+    {.symbols = &ll_symbols[61], .len = 5, .name = "FUNC_WHILE ::= while exp { FUNC_STMT_LIST }"},
+    {.symbols = &ll_symbols[66], .len = 6, .name = "FUNC_IF ::= if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE"},
+    {.symbols = &ll_symbols[72], .len = 0, .name = "FUNC_ELSE_CLAUSE ::= ''"},
+    {.symbols = &ll_symbols[72], .len = 2, .name = "FUNC_ELSE_CLAUSE ::= else FUNC_AFTER_ELSE"},
+    {.symbols = &ll_symbols[74], .len = 1, .name = "FUNC_AFTER_ELSE ::= FUNC_ELSE_IF"},
+    {.symbols = &ll_symbols[75], .len = 3, .name = "FUNC_AFTER_ELSE ::= { FUNC_STMT_LIST }"},
+    {.symbols = &ll_symbols[78], .len = 6, .name = "IF_STMT ::= if IF_COND { LOCAL_STMT_LIST } ELSE_CLAUSE"},
+    {.symbols = &ll_symbols[84], .len = 2, .name = "ELSE_CLAUSE ::= else AFTER_ELSE"},
+    {.symbols = &ll_symbols[86], .len = 0, .name = "ELSE_CLAUSE ::= ''"},
+    {.symbols = &ll_symbols[86], .len = 1, .name = "AFTER_ELSE ::= ELSE_IF_STMT"},
+    {.symbols = &ll_symbols[87], .len = 3, .name = "AFTER_ELSE ::= { LOCAL_STMT_LIST }"},
+    {.symbols = &ll_symbols[90], .len = 5, .name = "WHILE_STMT ::= while exp { LOCAL_STMT_LIST }"},
+    {.symbols = &ll_symbols[95], .len = 3, .name = "LOAD_ID ::= id = exp"},
+    {.symbols = &ll_symbols[98], .len = 1, .name = "LOAD_ID ::= call"},
+    {.symbols = &ll_symbols[99], .len = 1, .name = "IF_COND ::= exp"},
+    {.symbols = &ll_symbols[100], .len = 2, .name = "IF_COND ::= let id"},
+    {.symbols = &ll_symbols[102], .len = 2, .name = "LOCAL_STMT_LIST ::= LOCAL_STMT LOCAL_STMT_LIST"},
+    {.symbols = &ll_symbols[104], .len = 0, .name = "LOCAL_STMT_LIST ::= ''"},
+    {.symbols = &ll_symbols[104], .len = 1, .name = "LOCAL_STMT ::= VAR_LET"},
+    {.symbols = &ll_symbols[105], .len = 1, .name = "LOCAL_STMT ::= LOAD_ID"},
+    {.symbols = &ll_symbols[106], .len = 2, .name = "LOCAL_STMT ::= IF_STMT"},
+    {.symbols = &ll_symbols[108], .len = 1, .name = "LOCAL_STMT ::= WHILE_STMT"},
+    {.symbols = &ll_symbols[109], .len = 6, .name = "FUNC_ELSE_IF ::= if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE"},
+    {.symbols = &ll_symbols[115], .len = 6, .name = "ELSE_IF_STMT ::= if IF_COND { LOCAL_STMT_LIST } ELSE_CLAUSE"},
+};
+
+// production to expand for the nonterminal and the lookahead token, 0 is a syntax error, otherwise index + 1
+static const uint8_t ll_table[LL_NONTERMINAL_COUNT][LL_TOKEN_COUNT] = {
+    [LL_START] = {[TOKEN_EOF] = 1, [TOKEN_FUNC] = 1, [TOKEN_FUNC_ID] = 1, [TOKEN_IDENTIFICATOR] = 1, [TOKEN_IF] = 1, [TOKEN_LET] = 1, [TOKEN_VAR] = 1, [TOKEN_WHILE] = 1},
+    [LL_STMT_LIST] = {[TOKEN_EOF] = 2, [TOKEN_FUNC] = 3, [TOKEN_FUNC_ID] = 3, [TOKEN_IDENTIFICATOR] = 3, [TOKEN_IF] = 3, [TOKEN_LET] = 3, [TOKEN_VAR] = 3, [TOKEN_WHILE] = 3},
+    [LL_STMT] = {[TOKEN_FUNC] = 5, [TOKEN_FUNC_ID] = 7, [TOKEN_IDENTIFICATOR] = 7, [TOKEN_IF] = 6, [TOKEN_LET] = 4, [TOKEN_VAR] = 4, [TOKEN_WHILE] = 8},
+    [LL_VAR_LET] = {[TOKEN_LET] = 9, [TOKEN_VAR] = 9},
+    [LL_VAR_SCOPE] = {[TOKEN_LET] = 11, [TOKEN_VAR] = 10},
+    [LL_TYPE_AND_ASSIGN] = {[TOKEN_ASSIGN] = 13, [TOKEN_DOUBLE_DOT] = 12},
+    [LL_D_TYPE] = {[TOKEN_TYPE_BOOL] = 14, [TOKEN_TYPE_BOOL_NIL] = 18, [TOKEN_TYPE_DOUBLE] = 15, [TOKEN_TYPE_DOUBLE_NIL] = 19, [TOKEN_TYPE_INT] = 16, [TOKEN_TYPE_INT_NIL] = 20, [TOKEN_TYPE_STRING] = 17, [TOKEN_TYPE_STRING_NIL] = 21},
+    [LL_R_FLEX] = {[TOKEN_ASSIGN] = 23, [TOKEN_EOF] = 22, [TOKEN_FUNC] = 22, [TOKEN_FUNC_ID] = 22, [TOKEN_IDENTIFICATOR] = 22, [TOKEN_IF] = 22, [TOKEN_LET] = 22, [TOKEN_RETURN] = 22, [TOKEN_R_CURLY] = 22, [TOKEN_VAR] = 22, [TOKEN_WHILE] = 22},
+    [LL_DEF_FUNC] = {[TOKEN_FUNC] = 24},
+    [LL_P_LIST] = {[TOKEN_IDENTIFICATOR] = 25, [TOKEN_R_BRACKET] = 26},
+    [LL_PARAM] = {[TOKEN_IDENTIFICATOR] = 27},
+    [LL_P_SEP] = {[TOKEN_COMMA] = 29, [TOKEN_R_BRACKET] = 28},
+    [LL_RET_TYPE] = {[TOKEN_ARROW] = 31, [TOKEN_L_CURLY] = 30},
+    [LL_FUNC_STMT_LIST] = {[TOKEN_FUNC_ID] = 32, [TOKEN_IDENTIFICATOR] = 32, [TOKEN_IF] = 32, [TOKEN_LET] = 32, [TOKEN_RETURN] = 32, [TOKEN_R_CURLY] = 33, [TOKEN_VAR] = 32, [TOKEN_WHILE] = 32},
+    [LL_FUNC_STMT] = {[TOKEN_FUNC_ID] = 37, [TOKEN_IDENTIFICATOR] = 37, [TOKEN_IF] = 38, [TOKEN_LET] = 34, [TOKEN_RETURN] = 35, [TOKEN_VAR] = 34, [TOKEN_WHILE] = 36},
+    [LL_RET] = {[TOKEN_RETURN] = 39},
+    [LL_FUNC_WHILE] = {[TOKEN_WHILE] = 40},
+    [LL_FUNC_IF] = {[TOKEN_IF] = 41},
+    [LL_FUNC_ELSE_CLAUSE] = {[TOKEN_ELSE] = 43, [TOKEN_FUNC_ID] = 42, [TOKEN_IDENTIFICATOR] = 42, [TOKEN_IF] = 42, [TOKEN_LET] = 42, [TOKEN_RETURN] = 42, [TOKEN_R_CURLY] = 42, [TOKEN_VAR] = 42, [TOKEN_WHILE] = 42},
+    [LL_FUNC_AFTER_ELSE] = {[TOKEN_IF] = 44, [TOKEN_L_CURLY] = 45},
+    [LL_IF_STMT] = {[TOKEN_IF] = 46},
+    [LL_ELSE_CLAUSE] = {[TOKEN_ELSE] = 47, [TOKEN_EOF] = 48, [TOKEN_FUNC] = 48, [TOKEN_FUNC_ID] = 48, [TOKEN_IDENTIFICATOR] = 48, [TOKEN_IF] = 48, [TOKEN_LET] = 48, [TOKEN_R_CURLY] = 48, [TOKEN_VAR] = 48, [TOKEN_WHILE] = 48},
+    [LL_AFTER_ELSE] = {[TOKEN_IF] = 49, [TOKEN_L_CURLY] = 50},
+    [LL_WHILE_STMT] = {[TOKEN_WHILE] = 51},
+    [LL_LOAD_ID] = {[TOKEN_FUNC_ID] = 53, [TOKEN_IDENTIFICATOR] = 52},
+    [LL_IF_COND] = {[TOKEN_BOOL] = 54, [TOKEN_DOUBLE] = 54, [TOKEN_EXP] = 54, [TOKEN_FUNC_ID] = 54, [TOKEN_IDENTIFICATOR] = 54, [TOKEN_INT] = 54, [TOKEN_LET] = 55, [TOKEN_L_BRACKET] = 54, [TOKEN_NIL] = 54, [TOKEN_NOT] = 54, [TOKEN_STRING] = 54},
+    [LL_LOCAL_STMT_LIST] = {[TOKEN_FUNC_ID] = 56, [TOKEN_IDENTIFICATOR] = 56, [TOKEN_IF] = 56, [TOKEN_LET] = 56, [TOKEN_R_CURLY] = 57, [TOKEN_VAR] = 56, [TOKEN_WHILE] = 56},
+    [LL_LOCAL_STMT] = {[TOKEN_FUNC_ID] = 59, [TOKEN_IDENTIFICATOR] = 59, [TOKEN_IF] = 60, [TOKEN_LET] = 58, [TOKEN_VAR] = 58, [TOKEN_WHILE] = 61},
+    [LL_FUNC_ELSE_IF] = {[TOKEN_IF] = 62},
+    [LL_ELSE_IF_STMT] = {[TOKEN_IF] = 63},
+};
+
+// statement lists the parser synchronizes on after an error
+static const bool ll_sync[LL_NONTERMINAL_COUNT] = {[LL_STMT_LIST] = true, [LL_FUNC_STMT_LIST] = true, [LL_LOCAL_STMT_LIST] = true};
+
+const Ll_symbol ll_start = {.kind = LL_NONTERMINAL, .value = LL_START, .action = SEM_NONE, .inherit = false};
+
+const Ll_symbol ll_func_body = {.kind = LL_NONTERMINAL, .value = LL_FUNC_STMT_LIST, .action = SEM_NONE, .inherit = false};
+
+const Ll_production *ll_predict(int nonterminal, Token_type lookahead)
+{
+    unsigned int production = ll_table[nonterminal][lookahead];
+    return production == 0 ? NULL : &ll_productions[production - 1];
+}
+
+bool ll_is_sync(int nonterminal)
+{
+    return ll_sync[nonterminal];
+}
@@ -11,112 +11,114 @@
  */
 
 #include "parser.h"
+#include "compiler.h"
 
 void add_builtin_functions(sym_items *items)
 {
+    register_builtin_functions();
     // readString() -> String?
     items->funcItem = init_symtable_item(true);
-    items->funcItem->id = "readString";
+    items->funcItem->id = intern_cstr("readString");
     items->funcItem->data.func_data->return_type = TYPE_STRING_NIL;
     items->funcItem->data.func_data->found_return = true;
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
     // readInt() -> Int?
     items->funcItem = init_symtable_item(true);
-    items->funcItem->id = "readInt";
+    items->funcItem->id = intern_cstr("readInt");
     items->funcItem->data.func_data->return_type = TYPE_INT_NIL;
     items->funcItem->data.func_data->found_return = true;
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
     // readDouble() -> Double?
     items->funcItem = init_symtable_item(true);
-    items->funcItem->id = "readDouble";
+    items->funcItem->id = intern_cstr("readDouble");
     items->funcItem->data.func_data->return_type = TYPE_DOUBLE_NIL;
     items->funcItem->data.func_data->found_return = true;
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
     // write ( term1 , term2 , …, term𝑛 )
     items->funcItem = init_symtable_item(true);
-    items->funcItem->id = "write";
+    items->funcItem->id = intern_cstr("write");
     items->funcItem->data.func_data->return_type = TYPE_EMPTY;
     items->funcItem->data.func_data->found_return = true;
     items->funcItem->data.func_data->params_count = -1;
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
     // Int2Double(_ term ∶ Int) -> Double
     items->funcItem = init_symtable_item(true);
-    items->funcItem->id = "Int2Double";
+    items->funcItem->id = intern_cstr("Int2Double");
     items->funcItem->data.func_data->return_type = TYPE_DOUBLE;
     items->funcItem->data.func_data->found_return = true;
     // reset param
     add_param(items->funcItem->data.func_data);
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = "_";
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = "";
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = intern_cstr("_");
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = intern_cstr("");
     items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].type = TYPE_INT;
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
     // Double2Int(_ term ∶ Double) -> Int
     items->funcItem = init_symtable_item(true);
-    items->funcItem->id = "Double2Int";
+    items->funcItem->id = intern_cstr("Double2Int");
     items->funcItem->data.func_data->return_type = TYPE_INT;
     items->funcItem->data.func_data->found_return = true;
     // reset param
     add_param(items->funcItem->data.func_data);
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = "_";
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = "";
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = intern_cstr("_");
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = intern_cstr("");
     items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].type = TYPE_DOUBLE;
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
     // length(_ 𝑠 : String) -> Int
     items->funcItem = init_symtable_item(true);
-    items->funcItem->id = "length";
+    items->funcItem->id = intern_cstr("length");
     items->funcItem->data.func_data->return_type = TYPE_INT;
     items->funcItem->data.func_data->found_return = true;
     // reset param
     add_param(items->funcItem->data.func_data);
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = "_";
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = "";
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = intern_cstr("_");
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = intern_cstr("");
     items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].type = TYPE_STRING;
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
     // substring(of 𝑠 : String, startingAt 𝑖 : Int, endingBefore 𝑗 : Int) -> String?
     items->funcItem = init_symtable_item(true);
-    items->funcItem->id = "substring";
+    items->funcItem->id = intern_cstr("substring");
     items->funcItem->data.func_data->return_type = TYPE_STRING_NIL;
     items->funcItem->data.func_data->found_return = true;
     // reset param
     add_param(items->funcItem->data.func_data);
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = "of";
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = "";
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = intern_cstr("of");
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = intern_cstr("");
     items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].type = TYPE_STRING;
     // reset param
     add_param(items->funcItem->data.func_data);
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = "startingAt";
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = "";
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = intern_cstr("startingAt");
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = intern_cstr("");
     items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].type = TYPE_INT;
     // reset param
     add_param(items->funcItem->data.func_data);
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = "endingBefore";
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = "";
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = intern_cstr("endingBefore");
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = intern_cstr("");
     items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].type = TYPE_INT;
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
     // ord(_ 𝑐 : String) -> Int
     items->funcItem = init_symtable_item(true);
-    items->funcItem->id = "ord";
+    items->funcItem->id = intern_cstr("ord");
     items->funcItem->data.func_data->return_type = TYPE_INT;
     items->funcItem->data.func_data->found_return = true;
     // reset param
     add_param(items->funcItem->data.func_data);
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = "_";
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = "";
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = intern_cstr("_");
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = intern_cstr("");
     items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].type = TYPE_STRING;
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
     // chr(_ 𝑖 : Int) -> String
     items->funcItem = init_symtable_item(true);
-    items->funcItem->id = "chr";
+    items->funcItem->id = intern_cstr("chr");
     items->funcItem->data.func_data->return_type = TYPE_STRING;
     items->funcItem->data.func_data->found_return = true;
     // reset param
     add_param(items->funcItem->data.func_data);
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = "_";
-    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = "";
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name = intern_cstr("_");
+    items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = intern_cstr("");
     items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].type = TYPE_INT;
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
 
-    DEBUG_SEMANTIC_CODE(symtable_print(symtable_stack_top(sym_st)););
+    DEBUG_SEMANTIC_CODE(symtable_print(symtable_stack_top(compiler->sym_st)););
 }
 
 Expression_type get_expression_type(Token *token)
@@ -168,32 +170,37 @@ void print_items(sym_items *items)
         } printf("\n"););
 }
 
-void push_token_get_next(Token *token, Token_stack *token_stack)
+void push_token_get_next(Token *token)
 {
-    Token_stack_push(token_stack, *token);
     main_scanner(token);
 }
 
-bool get_func_definition(Token *token, char *name, symtable_item *psa_item)
+/**
+ * @brief Reads the next token of the index walk, the end of the token stream is returned as EOF.
+ */
+static void index_next(size_t *k, Token *token)
 {
-    Token_stack *token_stack = Token_stack_init();
-
-    bool is_ok = true;
-
-    // find function
-    do
-    {
-        push_token_get_next(token, token_stack);
-    } while (token != NULL && token->type != TOKEN_EOF && (strcmp(token->token_value, name) || token->type != TOKEN_FUNC_ID));
-
-    // check if function was found
-    if (token == NULL || token->type == TOKEN_EOF)
+    if (!token_stream_peek(*k, token))
     {
-        is_ok = false;
-        goto return_tokens;
+        token->type = TOKEN_EOF;
+        return;
     }
+    (*k)++;
+}
 
-    psa_item->data.func_data = malloc(sizeof(FunctionData));
+/**
+ * @brief Parses the function header starting at the function name.
+ *
+ * @param k Position of the function name in the token stream, moved after the header.
+ * @param psa_item The signature is stored here.
+ * @return true if the header is valid.
+ */
+static bool parse_func_header(size_t *k, symtable_item *psa_item)
+{
+    bool is_ok = true;
+    Token token_data;
+    Token *token = &token_data;
+    index_next(k, token);
 
     typedef enum
     {
@@ -226,9 +233,9 @@ bool get_func_definition(Token *token, char *name, symtable_item *psa_item)
             else
             {
                 is_ok = false;
-                goto return_tokens;
+                goto header_end;
             }
-            push_token_get_next(token, token_stack);
+            index_next(k, token);
             break;
         case L_BRACKET:
             if (token->type == TOKEN_L_BRACKET)
@@ -238,23 +245,24 @@ bool get_func_definition(Token *token, char *name, symtable_item *psa_item)
             else
             {
                 is_ok = false;
-                goto return_tokens;
+                goto header_end;
             }
-            push_token_get_next(token, token_stack);
+            index_next(k, token);
             break;
         case P_LIST:
             if (token->type == TOKEN_R_BRACKET)
             {
                 nstate = R_BRACKET;
+                index_next(k, token);
             }
-            else if (token->type == TOKEN_IDENTIFICATOR)
+            else if (token->type == TOKEN_IDENTIFICATOR || token->type == TOKEN_UNDERSCORE)
             {
                 nstate = PARAM;
             }
             else
             {
                 is_ok = false;
-                goto return_tokens;
+                goto header_end;
             }
             break;
         case PARAM:
@@ -264,15 +272,15 @@ bool get_func_definition(Token *token, char *name, symtable_item *psa_item)
             if (token->type == TOKEN_IDENTIFICATOR || token->type == TOKEN_UNDERSCORE)
             {
                 new_psa_param->name = token->token_value;
-                push_token_get_next(token, token_stack);
+                index_next(k, token);
                 if (token->type == TOKEN_IDENTIFICATOR)
                 {
                     new_psa_param->id = token->token_value;
-                    push_token_get_next(token, token_stack);
+                    index_next(k, token);
                     if (token->type == TOKEN_DOUBLE_DOT)
                     {
-                        push_token_get_next(token, token_stack);
-                        if (token->type == TOKEN_TYPE_INT || token->type == TOKEN_TYPE_DOUBLE || token->type == TOKEN_TYPE_STRING || token->type == TOKEN_TYPE_BOOL)
+                        index_next(k, token);
+                        if (get_expression_type(token) != TYPE_INVALID)
                         {
                             new_psa_param->type = get_expression_type(token);
                             nstate = P_SEP;
@@ -280,44 +288,44 @@ bool get_func_definition(Token *token, char *name, symtable_item *psa_item)
                         else
                         {
                             is_ok = false;
-                            goto return_tokens;
+                            goto header_end;
                         }
                     }
                     else
                     {
                         is_ok = false;
-                        goto return_tokens;
+                        goto header_end;
                     }
                 }
                 else
                 {
                     is_ok = false;
-                    goto return_tokens;
+                    goto header_end;
                 }
             }
             else
             {
                 is_ok = false;
-                goto return_tokens;
+                goto header_end;
             }
-            push_token_get_next(token, token_stack);
+            index_next(k, token);
             break;
         }
         case P_SEP:
             if (token->type == TOKEN_COMMA)
             {
                 nstate = PARAM;
-                push_token_get_next(token, token_stack);
+                index_next(k, token);
             }
             else if (token->type == TOKEN_R_BRACKET)
             {
                 nstate = R_BRACKET;
-                push_token_get_next(token, token_stack);
+                index_next(k, token);
             }
             else
             {
                 is_ok = false;
-                goto return_tokens;
+                goto header_end;
             }
             break;
         case R_BRACKET:
@@ -332,12 +340,12 @@ bool get_func_definition(Token *token, char *name, symtable_item *psa_item)
             else
             {
                 is_ok = false;
-                goto return_tokens;
+                goto header_end;
             }
-            push_token_get_next(token, token_stack);
+            index_next(k, token);
             break;
         case RET_TYPE:
-            if (token->type == TOKEN_TYPE_INT || token->type == TOKEN_TYPE_DOUBLE || token->type == TOKEN_TYPE_STRING || token->type == TOKEN_TYPE_BOOL)
+            if (get_expression_type(token) != TYPE_INVALID)
             {
                 psa_item->data.func_data->return_type = get_expression_type(token);
                 nstate = DONE;
@@ -345,26 +353,97 @@ bool get_func_definition(Token *token, char *name, symtable_item *psa_item)
             else
             {
                 is_ok = false;
-                goto return_tokens;
+                goto header_end;
             }
-            push_token_get_next(token, token_stack);
+            index_next(k, token);
             break;
         default:
             is_ok = false;
-            goto return_tokens;
+            goto header_end;
         }
     }
 
-return_tokens:
-    // return tokens to scanner
-    return_token(*token);
-    while (token_stack->size > 1)
+header_end:
+    return is_ok;
+}
+
+/**
+ * @brief Indexes the headers of all the functions defined in the rest of the token stream.
+ */
+static void build_func_index()
+{
+    compiler->func_index = symtable_init();
+    if (!compiler->token_buffer.is_active)
     {
-        *token = Token_stack_pop(token_stack);
-        return_token(*token);
+        // the index needs the whole rest of the input, lex it in one go
+        scanner_pretokenize(0);
     }
 
-    return is_ok;
+    size_t k = 0;
+    Token token;
+    symtable_item *item = NULL;
+    for (index_next(&k, &token); token.type != TOKEN_EOF; index_next(&k, &token))
+    {
+        if (token.type != TOKEN_FUNC)
+        {
+            continue;
+        }
+        if (item == NULL)
+        {
+            item = init_symtable_item(true);
+        }
+        item->data.func_data->params_count = 0;
+        item->data.func_data->return_type = TYPE_EMPTY;
+        size_t header = k;
+        if (!parse_func_header(&header, item) || symtable_find(item->id, compiler->func_index, true) != NULL)
+        {
+            // invalid header is reported by the parser once it gets there, redefinition by the semantic analysis
+            continue;
+        }
+        symtable_add(item, compiler->func_index);
+        item = NULL;
+        k = header;
+    }
+    // the walk stops at the EOF token unless a lexical error comes first
+    compiler->func_index_complete = k > 0 && token_stream_peek(k - 1, &token) && token.type == TOKEN_EOF;
+}
+
+bool get_func_definition(char *name, symtable_item *psa_item)
+{
+    if (compiler->func_index == NULL)
+    {
+        build_func_index();
+    }
+
+    symtable_item *found = symtable_find(name, compiler->func_index, true);
+    if (found != NULL)
+    {
+        *psa_item = *found;
+        return true;
+    }
+
+    if (!compiler->func_index_complete)
+    {
+        // the definition may follow the lexical error, which is reported first
+        size_t mark = token_ring_mark();
+        Token token;
+        do
+        {
+            push_token_get_next(&token);
+        } while (token.type != TOKEN_EOF);
+        token_ring_rewind(mark);
+    }
+    return false;
+}
+
+symtable_item *find_indexed_func(char *name, bool *complete)
+{
+    if (compiler->func_index == NULL)
+    {
+        build_func_index();
+    }
+    *complete = compiler->func_index_complete;
+    return symtable_find(name, compiler->func_index, true);
 }
 
 bool check_ret_values(Expression_type t_exp, Expression_type t_id)
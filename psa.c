@@ -11,19 +11,116 @@
  */
 
 #include "psa.h"
+#include "compiler.h"
 
-DEFINE_STACK_FUNCTIONS(PSA_Token)
+/**
+ * @brief Grows the array to hold one more item, the capacity is doubled.
+ */
+static void *grow(void *items, unsigned int *cap, size_t item_size)
+{
+    unsigned int new_cap = *cap == 0 ? 32 : *cap * 2;
+    void *grown = realloc(items, item_size * new_cap);
+    if (grown == NULL)
+    {
+        throw_error(INTERNAL_ERR, -1, "PSA stack allocation failed.");
+    }
+    *cap = new_cap;
+    return grown;
+}
 
-psa_return_type parse_expression_base(bool is_param)
+void PSA_Token_stack_push(PSA_Token_stack *s, PSA_Token token)
 {
+    if (s->size == s->cap)
+    {
+        s->items = grow(s->items, &s->cap, sizeof(PSA_Token));
+    }
+    if (token.type == (Token_type)TOKEN_SHIFT)
+    {
+        if (s->shift_count == s->shift_cap)
+        {
+            s->shifts = grow(s->shifts, &s->shift_cap, sizeof(unsigned int));
+        }
+        s->shifts[s->shift_count++] = s->size;
+    }
+    s->items[s->size++] = token;
+}
 
-    int num_of_brackets = 0; // number of brackets in the expression
+PSA_Token PSA_Token_stack_pop(PSA_Token_stack *s)
+{
+    PSA_Token token = s->items[--s->size];
+    if (s->shift_count > 0 && s->shifts[s->shift_count - 1] == s->size)
+    {
+        s->shift_count--;
+    }
+    return token;
+}
 
-    PSA_Token_stack *s = PSA_Token_stack_init();
-    if (s == NULL)
+/**
+ * @brief Takes the stack of an expression, the stacks are kept by the compilation and reused by the next expressions.
+ */
+static PSA_Token_stack *expr_stack_open()
+{
+    if (compiler->expr_stacks_count == compiler->expr_stacks_made)
     {
-        throw_error(INTERNAL_ERR, -1, "PSA stack initialization failed.");
+        if (compiler->expr_stacks_made == compiler->expr_stacks_cap)
+        {
+            size_t cap = compiler->expr_stacks_cap == 0 ? 8 : compiler->expr_stacks_cap * 2;
+            void **stacks = realloc(compiler->expr_stacks, sizeof(void *) * cap);
+            if (stacks == NULL)
+            {
+                throw_error(INTERNAL_ERR, -1, "PSA stack initialization failed.");
+            }
+            compiler->expr_stacks = stacks;
+            compiler->expr_stacks_cap = cap;
+        }
+        PSA_Token_stack *s = calloc(1, sizeof(PSA_Token_stack));
+        if (s == NULL)
+        {
+            throw_error(INTERNAL_ERR, -1, "PSA stack initialization failed.");
+        }
+        compiler->expr_stacks[compiler->expr_stacks_made++] = s;
     }
+    PSA_Token_stack *s = compiler->expr_stacks[compiler->expr_stacks_count++];
+    s->size = 0;
+    s->shift_count = 0;
+    return s;
+}
+
+/**
+ * @brief Gives the stack of an expression back, the nested expressions are closed before the outer ones.
+ */
+static void expr_stack_close()
+{
+    compiler->expr_stacks_count--;
+}
+
+void psa_release_stacks()
+{
+    compiler->expr_stacks_count = 0;
+}
+
+void psa_free_stacks()
+{
+    for (size_t i = 0; i < compiler->expr_stacks_made; i++)
+    {
+        PSA_Token_stack *s = compiler->expr_stacks[i];
+        free(s->items);
+        free(s->shifts);
+        free(s);
+    }
+    free(compiler->expr_stacks);
+    compiler->expr_stacks = NULL;
+    compiler->expr_stacks_count = 0;
+    compiler->expr_stacks_made = 0;
+    compiler->expr_stacks_cap = 0;
+}
+
+psa_return_type parse_expression_base(bool is_param)
+{
+
+    int num_of_brackets = 0; // number of brackets in the expression
+
+    PSA_Token_stack *s = expr_stack_open();
     PSA_Token_stack_push(s, PSA_TOKEN_EOF); // initialize the stack with the EOF token
 
     /*
@@ -47,7 +144,7 @@ psa_return_type parse_expression_base(bool is_param)
         // if the stack top is of type (Token_type)TOKEN_EXPRSN, then we need to use the second top of the stack to determine the rule
         if (a.type == (Token_type)TOKEN_EXPRSN)
         {
-            a = s->top->next->data;
+            a = s->items[s->size - 2];
         }
 
         // FOR PARAMETER EXPRESSIONS CHECK FOR END OF PARAMETER
@@ -100,18 +197,19 @@ psa_return_type parse_expression_base(bool is_param)
         if (a.type == TOKEN_EOF && b.type == TOKEN_EOF)
         {
             // empty expression may be valid in some cases, so we need to note it and return it to the parser
-            PSA_Token_stack_free(s);
+            expr_stack_close();
             return (psa_return_type){
                 .end_token = TOKEN_EXPRSN,
                 .is_ok = true,
                 .type = TYPE_EMPTY, // empty expression
                 .is_literal = false,
+                .expr = NULL,
             };
         }
 
         DEBUG_PSA_CODE(printf_blue("Bracket count: %d\n", num_of_brackets););
         DEBUG_PSA_CODE(printf("na stacku: ");
-                       printStack(s->top);
+                       printStack(s);
                        printf_yellow("na vstupu: {'%s', %d}\n", b.token_value, b.type);
                        printf_magenta("P_TABLE[{%d, '%s'}][{%d, '%s'}] = %c\n", getSymbolValue(a.type), a.token_value, (b.type), b.token_value, P_TABLE[getSymbolValue(a.type)][getSymbolValue(b.type)]););
 
@@ -121,7 +219,7 @@ psa_return_type parse_expression_base(bool is_param)
 
         // choosing further behaviour based on the value in the precedence table is necessary for the '!' token due to the duality of it's meaning (not and forced unwrapping)
         char ptable_val = P_TABLE[a_val][b_val];
-        if (s->size >= 2 && s->top->next->data.type == TOKEN_EXPRSN && a.type == TOKEN_NOT)
+        if (s->size >= 2 && s->items[s->size - 2].type == TOKEN_EXPRSN && a.type == TOKEN_NOT)
         {
             // if the top of the stack is an expression and the token on the top of the stack is '!', then the '!' token is forced unwrapping
             ptable_val = '>';
@@ -158,75 +256,18 @@ psa_return_type parse_expression_base(bool is_param)
             break;
         case '>': // closing of a handle
         {
-            PSA_Token top = a; // the top of the stack - saving it for later (generator)
-
             // get the handle (array of tokens) from the stack
             int handle_len = 0;
             PSA_Token *handle = getHandleFromStack(s, &handle_len);
             int handle_line_num = handle_len > 0 ? handle[0].line_num : b.line_num;
 
-            // get the derivated token from the handle
+            // get the derivated token from the handle, it carries the syntax tree of the derivation
             PSA_Token rule = getRule(handle, handle_len);
             rule.line_num = handle_line_num;
             DEBUG_PSA_CODE(printf_cyan("rule type: ");
                            print_expression_type(rule.expr_type);
                            printf("\n"););
 
-            // check if the derivation was successful
-            bool derivation_ok = rule.expr_type != TYPE_INVALID && rule.type != TOKEN_EOF;
-
-            /// CODE GENERATION
-
-            if (derivation_ok && top.type == TOKEN_BINARY_OPERATOR)
-            {
-                // binary operator is not represented by one or more stack instructions
-                generate_nil_coelacing();
-            }
-            else if (derivation_ok && isTokenBinaryOperator(top.type))
-            {
-                // binary operators are (in most cases) represented by one or more stack instructions
-                switch (top.type)
-                {
-                case TOKEN_PLUS: // + is a special case, as it can be used for both string (concatenation) and numeric addition
-                    if (rule.expr_type == TYPE_STRING)
-                    {
-                        generate_string_concat();
-                    }
-                    else
-                    {
-                        generate_instruction(ADDS);
-                    }
-                    break;
-                default:
-                {
-                    // get the stack instruction list for the given operation
-                    Instruction_list inst_list = tokenTypeToStackInstruction(top.type);
-                    for (int i = 0; i < inst_list.len; i++)
-                    {
-                        // an exception is made for the division of doubles and integers, as it is represented by two differenc stack instructions
-                        Instruction inst = inst_list.inst[i];
-                        if (inst == IDIVS && rule.expr_type == TYPE_DOUBLE)
-                        {
-                            inst = DIVS;
-                        }
-                        generate_instruction(inst);
-                    }
-                    break;
-                }
-                }
-            }
-            else if (derivation_ok && (isTokenLiteral(top.type) || top.type == TOKEN_IDENTIFICATOR))
-            {
-                // for operands, we just need to push them on the stack
-                generate_instruction(PUSHS, symbol(convertPSATokenToToken(top)));
-            }
-
-            if (!PSA_Token_stack_empty(s) && PSA_Token_stack_top(s).type == TOKEN_NOT)
-            {
-                // if the top of the stack is '!', then we need to generate the NOTS instruction
-                generate_instruction(NOTS);
-            }
-
             // the resulting successfully derivated token of the derivation is pushed on the stack
             if (rule.type != TOKEN_EOF)
             {
@@ -239,8 +280,7 @@ psa_return_type parse_expression_base(bool is_param)
 
                 throw_error(SYNTACTIC_ERR, b.line_num, "Unexpected token '%s' in expression.", b.token_value);
 
-                PSA_Token_stack_free(s);
-                free(handle);
+                expr_stack_close();
                 return (psa_return_type){
                     .end_token = TOKEN_EXPRSN,
                     .is_ok = false,
@@ -248,7 +288,6 @@ psa_return_type parse_expression_base(bool is_param)
                     .is_literal = false,
                 };
             }
-            free(handle);
 
             break;
         }
@@ -257,7 +296,7 @@ psa_return_type parse_expression_base(bool is_param)
             // a missing (on an ivalid '-') rule in the precedence table is an error
             throw_error(SYNTACTIC_ERR, b.line_num, "Invalid combination of operands '%s' and '%s'.", a.token_value, b.token_value);
 
-            PSA_Token_stack_free(s);
+            expr_stack_close();
             return (psa_return_type){
                 .end_token = TOKEN_EOF,
                 .is_ok = false,
@@ -266,7 +305,7 @@ psa_return_type parse_expression_base(bool is_param)
             };
         }
 
-        DEBUG_PSA_CODE(printStack(s->top);
+        DEBUG_PSA_CODE(printStack(s);
                        printf("\n-----------\n\n"););
 
         a = PSA_Token_stack_top(s);
@@ -290,12 +329,13 @@ psa_return_type parse_expression_base(bool is_param)
         printf_cyan("%s\n", a.is_literal ? "true" : "false"););
 
     // free the stack and return the result
-    PSA_Token_stack_free(s);
+    expr_stack_close();
     return (psa_return_type){
         .is_ok = a.expr_type != TYPE_INVALID,
         .type = a.expr_type,
         .end_token = a.type,
         .is_literal = a.is_literal,
+        .expr = a.node,
     };
 }
 
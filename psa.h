@@ -25,8 +25,7 @@
 #include "stack.h"
 #include "symtable.h"
 #include "generator.h"
-
-extern symtable_stack *sym_st;
+#include "ast.h"
 
 #include "error.h"
 
@@ -41,6 +40,7 @@ typedef struct
     bool is_ok;           // is the expression valid?
     Expression_type type; // type of the expression
     bool is_literal;      // is the expression a literal?
+    Ast_expr *expr;       // syntax tree of the expression, NULL if empty
 } psa_return_type;
 
 /**
@@ -54,16 +54,39 @@ typedef struct
     bool preceded_by_nl;
     bool is_literal;
     int line_num;
+    Literal *literal;
+    Ast_expr *node; // syntax tree of the derived expression (and function calls)
 } PSA_Token;
 
 /**
- * @brief Struct to hold the instruction list representing an operation.
+ * @brief How the code of a binary operation is generated.
+ */
+typedef enum
+{
+    PSA_EMIT_STACK,          // the instructions of the operation on the data stack
+    PSA_EMIT_CONCAT,         // concatenation of the strings
+    PSA_EMIT_NIL_COALESCING, // ?? operator
+    PSA_EMIT_SHORT_CIRCUIT,  // && and || jumping over the right operand
+} Psa_emit;
+
+/**
+ * @brief Binary operation on operands of the given types, an entry of the table generated by utils/create_psa_table.py.
  */
 typedef struct
 {
-    Instruction inst[10];
-    int len;
-} Instruction_list;
+    Expression_type type;      // type of the result, TYPE_INVALID if the operands do not fit the operation
+    Error_code error;          // error of the operands, NO_ERR if they fit
+    Ast_conversion conversion; // operand converted from Int to Double
+    bool needs_literal;        // the converted operand must be a literal
+    Psa_emit emit;             // how the code is generated
+    Instruction inst[2];       // instructions of PSA_EMIT_STACK
+    uint8_t len;               // count of inst
+} Psa_operation;
+
+/**
+ * @brief Count of the operand types of the operations, the types from TYPE_INT to TYPE_BOOL_NIL.
+ */
+#define PSA_TYPE_COUNT (TYPE_BOOL_NIL + 1)
 
 /**
  * @brief PSA_Token that represents the end of the file. It is used as a bottom of the stack and for error states.
@@ -72,7 +95,58 @@ typedef struct
     (PSA_Token) { .type = TOKEN_EOF, .token_value = "$", .expr_type = TYPE_INVALID, .preceded_by_nl = true, .is_literal = false }
 
 // STACK FUNCTIONS
-DECLARE_STACK_FUNCTIONS(PSA_Token);
+
+/**
+ * @brief Stack of the PSA, a contiguous array reused by the expressions of the compilation. The indices of the '<'
+ * markers are kept apart, so the handle is the slice of the stack above the last one.
+ */
+typedef struct
+{
+    PSA_Token *items;     // tokens from the bottom of the stack
+    unsigned int size;    // count of items
+    unsigned int cap;     // capacity of items
+    unsigned int *shifts; // indices of the TOKEN_SHIFT markers in items, the last one opens the handle
+    unsigned int shift_count;
+    unsigned int shift_cap;
+} PSA_Token_stack;
+
+/**
+ * @brief Pushes the token, the stack grows only when the expression is deeper than any before it.
+ *
+ * @param s stack of tokens
+ * @param token token to push
+ */
+void PSA_Token_stack_push(PSA_Token_stack *s, PSA_Token token);
+
+/**
+ * @brief Pops the token from the top of the stack.
+ *
+ * @param s stack of tokens, must not be empty
+ * @return PSA_Token - the popped token
+ */
+PSA_Token PSA_Token_stack_pop(PSA_Token_stack *s);
+
+/**
+ * @brief Returns the token on the top of the stack.
+ *
+ * @param s stack of tokens, must not be empty
+ * @return PSA_Token - the token on the top
+ */
+static inline PSA_Token PSA_Token_stack_top(PSA_Token_stack *s)
+{
+    return s->items[s->size - 1];
+}
+
+/**
+ * @brief Tells whether the stack is empty.
+ *
+ * @param s stack of tokens
+ * @return true if there is no token on the stack
+ */
+static inline bool PSA_Token_stack_empty(PSA_Token_stack *s)
+{
+    return s->size == 0;
+}
 
 /**
  * @brief Precedence table for the precedent bottom-up parser.
@@ -112,19 +186,6 @@ typedef enum
     RULE_1g = TOKEN_NIL,                                                                        // E -> i
     RULE_2 = (char)TOKEN_L_BRACKET << 16 | (char)TOKEN_EXPRSN << 8 | (char)TOKEN_R_BRACKET,     // E -> (E)
     RULE_3 = (char)TOKEN_NOT << 8 | (char)TOKEN_EXPRSN,                                         // E -> !E
-    RULE_6 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_MUL << 8 | (char)TOKEN_EXPRSN,              // E -> E*E
-    RULE_7 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_DIV << 8 | (char)TOKEN_EXPRSN,              // E -> E/E
-    RULE_8 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_PLUS << 8 | (char)TOKEN_EXPRSN,             // E -> E+E
-    RULE_9 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_MINUS << 8 | (char)TOKEN_EXPRSN,            // E -> E-E
-    RULE_10 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_EQ << 8 | (char)TOKEN_EXPRSN,              // E -> E==E
-    RULE_11 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_NEQ << 8 | (char)TOKEN_EXPRSN,             // E -> E!=E
-    RULE_12 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_LESS << 8 | (char)TOKEN_EXPRSN,            // E -> E<E
-    RULE_13 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_MORE << 8 | (char)TOKEN_EXPRSN,            // E -> E>E
-    RULE_14 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_LESS_EQ << 8 | (char)TOKEN_EXPRSN,         // E -> E<=E
-    RULE_15 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_MORE_EQ << 8 | (char)TOKEN_EXPRSN,         // E -> E>=E
-    RULE_16 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_AND << 8 | (char)TOKEN_EXPRSN,             // E -> E&&E
-    RULE_17 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_OR << 8 | (char)TOKEN_EXPRSN,              // E -> E||E
-    RULE_18 = (char)TOKEN_EXPRSN << 16 | (char)TOKEN_BINARY_OPERATOR << 8 | (char)TOKEN_EXPRSN, // E -> E??E
     RULE_19 = (char)TOKEN_EXPRSN << 8 | (char)TOKEN_NOT,                                        // E -> E!
 } PSA_Rules;
 
@@ -226,14 +287,6 @@ char getOperationChar(Token_type token);
  */
 Expression_type removeTypeNil(Expression_type expr_type);
 
-/**
- * @brief Converts the token type to the instruction type.
- *
- * @param tt token type
- * @return Instruction
- */
-Instruction_list tokenTypeToStackInstruction(Token_type tt);
-
 // PSA FUNCTIONS
 
 /**
@@ -246,10 +299,11 @@ Instruction_list tokenTypeToStackInstruction(Token_type tt);
 PSA_Token getRule(PSA_Token *handle, unsigned int len);
 
 /**
- * @brief Get all the tokens forming the handle from the stack.
+ * @brief Takes the handle off the stack, the tokens above the last '<' marker.
  *
  * @param s stack of tokens
- * @return PSA_Token* - array of tokens (handle)
+ * @param i the length of the handle is written here
+ * @return PSA_Token* - the handle, a slice of the stack valid until the next push
  */
 PSA_Token *getHandleFromStack(PSA_Token_stack *s, int *i);
 
@@ -262,14 +316,14 @@ PSA_Token *getHandleFromStack(PSA_Token_stack *s, int *i);
 unsigned int getSymbolValue(Token_type token);
 
 /**
- * @brief Returns the type of the expression based on the types of the operands.
-    Supports: (int, int), (int, double), (double, int), (double, double)
+ * @brief Looks the binary operation up in the table of the operations.
  *
- * @param l_operand left operand
- * @param r_operand right operand
- * @return Expression_type
+ * @param operation token of the operator
+ * @param left type of the left operand
+ * @param right type of the right operand
+ * @return const Psa_operation* - the operation, its error is set if the operands do not fit it
  */
-Expression_type getTypeCombination(PSA_Token l_operand, PSA_Token r_operand);
+const Psa_operation *psa_operation(Token_type operation, Expression_type left, Expression_type right);
 
 /**
  * @brief Get the expression type based on the operands and the operation (for binary operations).
@@ -277,7 +331,7 @@ Expression_type getTypeCombination(PSA_Token l_operand, PSA_Token r_operand);
  * @param l_operand left operand
  * @param operation operation
  * @param r_operand right operand
- * @return PSA_Token - token with the type of the expression
+ * @return PSA_Token - token with the type of the expression and its syntax tree
  */
 PSA_Token getHandleType(PSA_Token l_operand, Token_type operation, PSA_Token r_operand);
 
@@ -289,21 +343,12 @@ PSA_Token getHandleType(PSA_Token l_operand, Token_type operation, PSA_Token r_o
  */
 Expression_type getIdType(PSA_Token id);
 
-/**
- * @brief Checks if the type can be nil.
- *
- * @param type type to be checked
- * @return true
- * @return false
- */
-bool canTypeBeNil(Expression_type type);
-
 /**
  * @brief Prints the token values of each token in the handle into a string (for error messages.)
  *
  * @param handle array of tokens (handle)
  * @param handle_len length of the handle
- * @return char* - string with the token values
+ * @return char* - string with the token values, released together with the syntax tree
  */
 char *hadleToString(PSA_Token *handle, unsigned int handle_len);
 
@@ -324,6 +369,16 @@ psa_return_type parse_expression();
  */
 psa_return_type parse_expression_base(bool is_param);
 
+/**
+ * @brief Gives back the stacks of the expressions left unfinished by an error, they are kept for reuse.
+ */
+void psa_release_stacks();
+
+/**
+ * @brief Frees the stacks of the expressions kept by the compilation.
+ */
+void psa_free_stacks();
+
 /**
  * @brief Parses the expression that is a function parameter using the precedent bottom-up parser. Reads tokens from the scanner. Separating commas (,) are consumed, but closing bracket (]) is not.
  *
@@ -347,18 +402,11 @@ psa_return_type parse_expression_param();
 PSA_Token readNextToken(PSA_Token_stack *s, char *next_token_error, int *num_of_brackets, bool ignore_func_call);
 
 /**
- * @brief Prints the stack of tokens recursively.
+ * @brief Prints the stack of tokens from the bottom.
  *
- * @param top top of the stack
- */
-void printStackRec(PSA_Token_node *top);
-
-/**
- * @brief Prints the stack of tokens.
- *
- * @param top top of the stack
+ * @param s stack of tokens
  */
-void printStack(PSA_Token_node *top);
+void printStack(PSA_Token_stack *s);
 
 /**
  * @brief Prints the token array.
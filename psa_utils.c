@@ -160,21 +160,6 @@ bool canTokenBeEndOfExpression(Token_type token)
     }
 }
 
-bool canTypeBeNil(Expression_type type)
-{
-    switch (type)
-    {
-    case TYPE_INT_NIL:
-    case TYPE_DOUBLE_NIL:
-    case TYPE_BOOL_NIL:
-    case TYPE_STRING_NIL:
-    case TYPE_NIL:
-        return true;
-    default:
-        return false;
-    }
-}
-
 char getOperationChar(Token_type token)
 {
     switch (token)
@@ -225,44 +210,9 @@ Expression_type removeTypeNil(Expression_type expr_type)
     }
 }
 
-Instruction_list tokenTypeToStackInstruction(Token_type tt)
-{
-    switch (tt)
-    {
-    case TOKEN_MUL:
-        return (Instruction_list){.inst = {MULS}, .len = 1};
-    case TOKEN_DIV:
-        return (Instruction_list){.inst = {DIVS}, .len = 1};
-    case TOKEN_PLUS:
-        return (Instruction_list){.inst = {ADDS}, .len = 1};
-    case TOKEN_MINUS:
-        return (Instruction_list){.inst = {SUBS}, .len = 1};
-    case TOKEN_EQ:
-        return (Instruction_list){.inst = {EQS}, .len = 1};
-    case TOKEN_NEQ:
-        return (Instruction_list){.inst = {EQS, NOTS}, .len = 2};
-    case TOKEN_LESS:
-        return (Instruction_list){.inst = {LTS}, .len = 1};
-    case TOKEN_MORE:
-        return (Instruction_list){.inst = {GTS}, .len = 1};
-    case TOKEN_LESS_EQ:
-        return (Instruction_list){.inst = {GTS, NOTS}, .len = 2};
-    case TOKEN_MORE_EQ:
-        return (Instruction_list){.inst = {LTS, NOTS}, .len = 2};
-    case TOKEN_AND:
-        return (Instruction_list){.inst = {ANDS}, .len = 1};
-    case TOKEN_OR:
-        return (Instruction_list){.inst = {ORS}, .len = 1};
-    case TOKEN_NOT:
-        return (Instruction_list){.inst = {NOTS}, .len = 1};
-    default:
-        return (Instruction_list){.inst = {EMPTY}, .len = 1};
-    }
-}
-
 char *hadleToString(PSA_Token *handle, unsigned int handle_len)
 {
-    char *result = calloc(100, sizeof(char));
+    char *result = ast_alloc(100);
     for (unsigned int i = 0; i < handle_len; i++)
     {
         strcat(result, handle[i].token_value);
@@ -1,9 +1,9 @@
 /**
  * @file ptable.c
- * @author Anastasia Butok (xbutok00@vutbr.cz)
- * @brief Precedence table for PSA along with getSymbolValue LUT.
+ * @brief Precedence table of the PSA and the types and instructions of the binary operations, generated by
+ * utils/create_psa_table.py - do not edit by hand.
  * @version 0.1
- * @date 2023-11-24
+ * @date 2023-12-01
  *
  * @copyright Copyright (c) 2023
  * Project: IFJ compiler
@@ -12,9 +12,12 @@
 
 #include "psa.h"
 
+#define PSA_TOKEN_COUNT (TOKEN_UNSHIFT + 1)
+#define INVALID {TYPE_INVALID, COMPATIBILITY_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EMPTY}, 0}
+
 char P_TABLE[10][10] = {
     // INPUT >
-    //!	   */   +-  REL  LOG  ??   i    (    )	  $
+    // !    */   +-   REL  LOG  ??   i    (    )    $
     {'-', '>', '>', '>', '>', '>', '<', '<', '>', '>'}, // !
     {'<', '>', '>', '>', '>', '>', '<', '<', '>', '>'}, // */
     {'<', '<', '>', '>', '>', '>', '<', '<', '>', '>'}, // +-
@@ -25,65 +28,346 @@ char P_TABLE[10][10] = {
     {'<', '<', '<', '<', '<', '<', '<', '<', '=', '-'}, // (
     {'>', '>', '>', '>', '>', '>', '-', '-', '>', '>'}, // )
     {'<', '<', '<', '<', '<', '<', '<', '<', '-', '-'}, // $
-                                                        // ^ TOP OF STACK
+    // ^ TOP OF STACK
+};
+
+// class of the token in the precedence table, 0 is not a token of an expression, otherwise index + 1
+static const uint8_t psa_symbols[PSA_TOKEN_COUNT] = {
+    [TOKEN_NOT] = 1, // !
+    [TOKEN_MUL] = 2, // */
+    [TOKEN_DIV] = 2, // */
+    [TOKEN_PLUS] = 3, // +-
+    [TOKEN_MINUS] = 3, // +-
+    [TOKEN_EQ] = 4, // REL
+    [TOKEN_NEQ] = 4, // REL
+    [TOKEN_LESS] = 4, // REL
+    [TOKEN_MORE] = 4, // REL
+    [TOKEN_LESS_EQ] = 4, // REL
+    [TOKEN_MORE_EQ] = 4, // REL
+    [TOKEN_AND] = 5, // LOG
+    [TOKEN_OR] = 5, // LOG
+    [TOKEN_BINARY_OPERATOR] = 6, // ??
+    [TOKEN_IDENTIFICATOR] = 7, // i
+    [TOKEN_FUNC_ID] = 7, // i
+    [TOKEN_INT] = 7, // i
+    [TOKEN_DOUBLE] = 7, // i
+    [TOKEN_EXP] = 7, // i
+    [TOKEN_BOOL] = 7, // i
+    [TOKEN_STRING] = 7, // i
+    [TOKEN_NIL] = 7, // i
+    [TOKEN_L_BRACKET] = 8, // (
+    [TOKEN_R_BRACKET] = 9, // )
+    [TOKEN_EOF] = 10, // $
+};
+
+// row of the operator in psa_operations, 0 is not a binary operator, otherwise index + 1
+static const uint8_t psa_operators[PSA_TOKEN_COUNT] = {
+    [TOKEN_MUL] = 1, // *
+    [TOKEN_DIV] = 2, // /
+    [TOKEN_PLUS] = 3, // +
+    [TOKEN_MINUS] = 4, // -
+    [TOKEN_EQ] = 5, // ==
+    [TOKEN_NEQ] = 6, // !=
+    [TOKEN_LESS] = 7, // <
+    [TOKEN_MORE] = 8, // >
+    [TOKEN_LESS_EQ] = 9, // <=
+    [TOKEN_MORE_EQ] = 10, // >=
+    [TOKEN_AND] = 11, // &&
+    [TOKEN_OR] = 12, // ||
+    [TOKEN_BINARY_OPERATOR] = 13, // ??
+};
 
-    // REL = RELATIONAL OPERATOR (==, !=, <, >, <=, >=)
-    // LOG = LOGICAL OPERATOR (&&, ||)
+static const Psa_operation psa_invalid = INVALID;
+
+// operation of the operator on the left and the right operand type
+static const Psa_operation psa_operations[13][PSA_TYPE_COUNT][PSA_TYPE_COUNT] = {
+    // *
+    {
+        // INT
+        {{TYPE_INT, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {MULS}, 1}, {TYPE_DOUBLE, NO_ERR, AST_CONVERT_LEFT, true, PSA_EMIT_STACK, {MULS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {{TYPE_DOUBLE, NO_ERR, AST_CONVERT_RIGHT, true, PSA_EMIT_STACK, {MULS}, 1}, {TYPE_DOUBLE, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {MULS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, {TYPE_STRING, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {MULS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
+    // /
+    {
+        // INT
+        {{TYPE_INT, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {IDIVS}, 1}, {TYPE_DOUBLE, NO_ERR, AST_CONVERT_LEFT, true, PSA_EMIT_STACK, {DIVS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {{TYPE_DOUBLE, NO_ERR, AST_CONVERT_RIGHT, true, PSA_EMIT_STACK, {DIVS}, 1}, {TYPE_DOUBLE, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {DIVS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, {TYPE_STRING, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {DIVS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
+    // +
+    {
+        // INT
+        {{TYPE_INT, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {ADDS}, 1}, {TYPE_DOUBLE, NO_ERR, AST_CONVERT_LEFT, true, PSA_EMIT_STACK, {ADDS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {{TYPE_DOUBLE, NO_ERR, AST_CONVERT_RIGHT, true, PSA_EMIT_STACK, {ADDS}, 1}, {TYPE_DOUBLE, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {ADDS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, {TYPE_STRING, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_CONCAT, {EMPTY}, 0}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
+    // -
+    {
+        // INT
+        {{TYPE_INT, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {SUBS}, 1}, {TYPE_DOUBLE, NO_ERR, AST_CONVERT_LEFT, true, PSA_EMIT_STACK, {SUBS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {{TYPE_DOUBLE, NO_ERR, AST_CONVERT_RIGHT, true, PSA_EMIT_STACK, {SUBS}, 1}, {TYPE_DOUBLE, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {SUBS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, {TYPE_STRING, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {SUBS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
+    // ==
+    {
+        // INT
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS}, 1}, {TYPE_BOOL, NO_ERR, AST_CONVERT_LEFT, true, PSA_EMIT_STACK, {EQS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_RIGHT, true, PSA_EMIT_STACK, {EQS}, 1}, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS}, 1}, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS}, 1}, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS}, 1}, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS}, 1}, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS}, 1}},
+    },
+    // !=
+    {
+        // INT
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS, NOTS}, 2}, {TYPE_BOOL, NO_ERR, AST_CONVERT_LEFT, true, PSA_EMIT_STACK, {EQS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_RIGHT, true, PSA_EMIT_STACK, {EQS, NOTS}, 2}, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS, NOTS}, 2}, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS, NOTS}, 2}, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS, NOTS}, 2}, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EQS, NOTS}, 2}},
+    },
+    // <
+    {
+        // INT
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS}, 1}, {TYPE_BOOL, NO_ERR, AST_CONVERT_LEFT, true, PSA_EMIT_STACK, {LTS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_RIGHT, true, PSA_EMIT_STACK, {LTS}, 1}, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS}, 1}, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS}, 1}, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS}, 1}, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
+    // >
+    {
+        // INT
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS}, 1}, {TYPE_BOOL, NO_ERR, AST_CONVERT_LEFT, true, PSA_EMIT_STACK, {GTS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_RIGHT, true, PSA_EMIT_STACK, {GTS}, 1}, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS}, 1}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS}, 1}, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS}, 1}, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS}, 1}, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
+    // <=
+    {
+        // INT
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS, NOTS}, 2}, {TYPE_BOOL, NO_ERR, AST_CONVERT_LEFT, true, PSA_EMIT_STACK, {GTS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_RIGHT, true, PSA_EMIT_STACK, {GTS, NOTS}, 2}, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS, NOTS}, 2}, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS, NOTS}, 2}, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {GTS, NOTS}, 2}, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
+    // >=
+    {
+        // INT
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS, NOTS}, 2}, {TYPE_BOOL, NO_ERR, AST_CONVERT_LEFT, true, PSA_EMIT_STACK, {LTS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {{TYPE_BOOL, NO_ERR, AST_CONVERT_RIGHT, true, PSA_EMIT_STACK, {LTS, NOTS}, 2}, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS, NOTS}, 2}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS, NOTS}, 2}, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS, NOTS}, 2}, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {LTS, NOTS}, 2}, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
+    // &&
+    {
+        // INT
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_SHORT_CIRCUIT, {EMPTY}, 0}, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
+    // ||
+    {
+        // INT
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_SHORT_CIRCUIT, {EMPTY}, 0}, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
+    // ??
+    {
+        // INT
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // NIL
+        {INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // INT_NIL
+        {{TYPE_INT, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_NIL_COALESCING, {EMPTY}, 0}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // DOUBLE_NIL
+        {INVALID, {TYPE_DOUBLE, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_NIL_COALESCING, {EMPTY}, 0}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // STRING_NIL
+        {INVALID, INVALID, {TYPE_STRING, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_NIL_COALESCING, {EMPTY}, 0}, INVALID, INVALID, INVALID, INVALID, INVALID, INVALID},
+        // BOOL_NIL
+        {INVALID, INVALID, INVALID, {TYPE_BOOL, NO_ERR, AST_CONVERT_NONE, false, PSA_EMIT_NIL_COALESCING, {EMPTY}, 0}, INVALID, INVALID, INVALID, INVALID, INVALID},
+    },
 };
 
 unsigned int getSymbolValue(Token_type token)
 {
-    // symbols: !,* /,+ -,== != < > <= >=,??,i,(,),$
+    unsigned int symbol = (unsigned int)token < PSA_TOKEN_COUNT ? psa_symbols[token] : 0;
+    return symbol == 0 ? 99 : symbol - 1;
+}
 
-    switch (token)
+const Psa_operation *psa_operation(Token_type operation, Expression_type left, Expression_type right)
+{
+    unsigned int op = (unsigned int)operation < PSA_TOKEN_COUNT ? psa_operators[operation] : 0;
+    if (op == 0 || (unsigned int)left >= PSA_TYPE_COUNT || (unsigned int)right >= PSA_TYPE_COUNT)
     {
-    // !
-    case TOKEN_NOT:
-        return 0;
-    // */
-    case TOKEN_MUL:
-    case TOKEN_DIV:
-        return 1;
-    // +-
-    case TOKEN_PLUS:
-    case TOKEN_MINUS:
-        return 2;
-    // REL: == != < > <= >=
-    case TOKEN_EQ:
-    case TOKEN_NEQ:
-    case TOKEN_LESS:
-    case TOKEN_MORE:
-    case TOKEN_LESS_EQ:
-    case TOKEN_MORE_EQ:
-        return 3;
-    // LOG: && ||
-    case TOKEN_AND:
-    case TOKEN_OR:
-        return 4;
-    // ??
-    case TOKEN_BINARY_OPERATOR:
-        return 5;
-    // i
-    case TOKEN_IDENTIFICATOR:
-    case TOKEN_FUNC_ID:
-    case TOKEN_INT:
-    case TOKEN_DOUBLE:
-    case TOKEN_EXP:
-    case TOKEN_BOOL:
-    case TOKEN_STRING:
-    case TOKEN_NIL:
-        return 6;
-    // (
-    case TOKEN_L_BRACKET:
-        return 7;
-    // )
-    case TOKEN_R_BRACKET:
-        return 8;
-    // $
-    case TOKEN_EOF:
-        return 9;
-    // error
-    default:
-        return 99;
+        return &psa_invalid;
     }
+    return &psa_operations[op - 1][left][right];
 }
@@ -11,9 +11,18 @@
  */
 
 #include "psa.h"
+#include "compiler.h"
+#include "fold.h"
 
 PSA_Token getRule(PSA_Token *handle, unsigned int len)
 {
+    // binary operations are reduced by the table of the operations
+    if (len == 3 && handle[0].type == (Token_type)TOKEN_EXPRSN && handle[2].type == (Token_type)TOKEN_EXPRSN && isTokenBinaryOperator(handle[1].type))
+    {
+        DEBUG_PSA_CODE(printf_cyan("rule: E -> E%sE\n", handle[1].token_value););
+        return getHandleType(handle[0], handle[1].type, handle[2]);
+    }
+
     uint32_t handle_val = handleToUInt32(handle, len);
     /*
         E -> f
@@ -47,6 +56,7 @@ PSA_Token getRule(PSA_Token *handle, unsigned int len)
             .token_value = "E",
             .expr_type = handle[0].expr_type,
             .is_literal = isTokenLiteral(handle[0].type),
+            .node = handle[0].node, // the call has been parsed already
         };
     case RULE_1a:
     case RULE_1b:
@@ -68,7 +78,7 @@ PSA_Token getRule(PSA_Token *handle, unsigned int len)
                 throw_error(SYNTACTIC_ERR, handle[0].line_num, "Variable name cannot be '_'.");
             }
 
-            symtable_item *found = symtable_find_in_stack(handle[0].token_value, sym_st, true);
+            symtable_item *found = symtable_find_in_stack(handle[0].token_value, compiler->sym_st, true);
             bool found_valid_var = found != NULL && found->type == VARIABLE && found->data.var_data != NULL && found->data.var_data->type != TYPE_INVALID;
             if (found_valid_var)
             {
@@ -89,6 +99,7 @@ PSA_Token getRule(PSA_Token *handle, unsigned int len)
             .token_value = "E",
             .expr_type = type,
             .is_literal = isTokenLiteral(handle[0].type),
+            .node = ast_operand(convertPSATokenToToken(handle[0]), type),
         };
     case RULE_2:
         DEBUG_PSA_CODE(printf_cyan("rule: E -> (E)\n"););
@@ -97,6 +108,7 @@ PSA_Token getRule(PSA_Token *handle, unsigned int len)
             .token_value = "E",
             .expr_type = handle[1].expr_type,
             .is_literal = handle[1].is_literal,
+            .node = handle[1].node,
         };
     case RULE_3:
         DEBUG_PSA_CODE(printf_cyan("rule: E -> !E\n"););
@@ -107,6 +119,7 @@ PSA_Token getRule(PSA_Token *handle, unsigned int len)
                 .token_value = "E",
                 .expr_type = TYPE_BOOL,
                 .is_literal = false,
+                .node = fold_expr(ast_unary(AST_NOT, TYPE_BOOL, handle[1].node)),
             };
         }
 
@@ -117,45 +130,6 @@ PSA_Token getRule(PSA_Token *handle, unsigned int len)
             .expr_type = TYPE_INVALID,
             .is_literal = false,
         };
-    case RULE_6:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E*E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_7:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E/E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_8:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E+E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_9:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E-E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_10:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E==E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_11:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E!=E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_12:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E<E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_13:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E>E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_14:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E<=E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_15:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E>=E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_16:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E&&E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_17:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E||E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
-    case RULE_18:
-        DEBUG_PSA_CODE(printf_cyan("rule: E -> E??E\n"););
-        return getHandleType(handle[0], handle[1].type, handle[2]);
     case RULE_19:
     {
         DEBUG_PSA_CODE(printf_cyan("rule: E -> E!\n"););
@@ -169,6 +143,7 @@ PSA_Token getRule(PSA_Token *handle, unsigned int len)
             .token_value = "E",
             .expr_type = type,
             .is_literal = false,
+            .node = ast_unary(AST_UNWRAP, type, handle[0].node),
         };
     }
     default:
@@ -191,23 +166,9 @@ PSA_Token getRule(PSA_Token *handle, unsigned int len)
 
 PSA_Token *getHandleFromStack(PSA_Token_stack *s, int *i)
 {
-    PSA_Token *handle = malloc(sizeof(PSA_Token) * s->size);
-
-    *i = 0;
-    while (PSA_Token_stack_top(s).type != TOKEN_SHIFT)
-    {
-        handle[*i] = ((PSA_Token)PSA_Token_stack_pop(s));
-        *i = *i + 1;
-    }
-    (void)PSA_Token_stack_pop(s); // pop the <
-
-    // reverse the array
-    for (int j = 0; j < *i / 2; j++)
-    {
-        PSA_Token tmp = handle[j];
-        handle[j] = handle[*i - j - 1];
-        handle[*i - j - 1] = tmp;
-    }
-
-    return handle;
+    // the tokens above the marker are the handle in the order they have been read, the marker is dropped with them
+    unsigned int shift = s->shifts[--s->shift_count];
+    *i = (int)(s->size - shift - 1);
+    s->size = shift;
+    return &s->items[shift + 1];
 }
@@ -6,495 +6,198 @@
  * Project: IFJ compiler
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <string.h>
 
 #include <stdlib.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
 #include "scanner.h"
-#include "stack.h"
+#include "compiler.h"
+
+#define SOURCE_BLOCK_SIZE (64 * 1024) // size of one block when reading non-mappable input
+#define LEXEME_INITIAL_SIZE 16         // initial capacity of the lexeme buffer
+#define TOKEN_RING_INITIAL_SIZE 64     // initial capacity of the token ring, must be a power of two
+#define TOKEN_RING_HISTORY 16          // count of already read tokens kept in the ring for return_token
+#define TOKEN_BUFFER_INITIAL_SIZE 1024 // initial capacity of the token buffer, must be a multiple of 64
+#define PARALLEL_LEX_MIN_SIZE (1024 * 1024) // inputs smaller than this are lexed by a single thread
+
+// characters that end a run of plain characters in a string, (char)EOF is included as it is treated as the end of input
+#define STRING_SPECIAL_CHARS "\"\\\n\r\xff"
+#define STRING_BLOCK_SPECIAL_CHARS "\"\\\n\r \t\xff"
+
+/*
+ * Reads next character from the source buffer, reading past the end always yields EOF
+ */
+static inline char next_char(Lexer *lx)
+{
+    size_t pos = lx->pos++;
+    return pos < lx->len ? lx->data[pos] : (char)EOF;
+}
 
-DEFINE_STACK_FUNCTIONS(Token)
+/*
+ * Returns the last read character back to the source buffer
+ */
+static inline void unget_char(Lexer *lx)
+{
+    lx->pos--;
+}
 
-#define CHAR_WTH_SPACE_LENGTH (sizeof(char_without_space) / sizeof(*char_without_space)) // length of array *char_without_space
-Scanner_state state = NEW_TOKEN;                                                         // initial state of scanner
-char *char_without_space[] = {":", "{", "}", "(", ")", ",", " ", "=", "!", "+", "-", "*", "/", "<", ">", "\n",
-                              "?"};
+/**
+ * Appends one character to the lexeme, the buffer grows geometrically
+ */
+static inline void lexeme_push(Lexeme *lexeme, char c)
+{
+    if (lexeme->len + 2 > lexeme->cap)
+    {
+        lexeme_grow(lexeme, 1);
+    }
+    lexeme->data[lexeme->len++] = c;
+}
 
-int ret = 0;
-unsigned int line_num = 1;
-Token_stack *scanner_stack;
+/**
+ * Empties the lexeme while keeping its buffer
+ */
+static inline void lexeme_clear(Lexeme *lexeme)
+{
+    lexeme->len = 0;
+}
 
 int main_scanner(Token *token)
 {
-    ret = 0;
-    if (Token_stack_empty(scanner_stack))
+    compiler->main_lexer.ret = 0;
+    *token = token_ring_advance();
+    return compiler->main_lexer.ret;
+}
+
+void lexer_init(Lexer *lx, const char *data, size_t len)
+{
+    lx->data = data;
+    lx->len = len;
+    lx->pos = 0;
+    lx->state = NEW_TOKEN;
+    lx->line_num = 1;
+    lx->ret = 0;
+    lx->lexeme_start = 0;
+}
+
+int generate_token(Token *token)
+{
+    return lexer_next(&compiler->main_lexer, token);
+}
+
+/*
+ * Copies the number to the lexeme without the leading zeros of the integer part and the zeros right after the sign
+ * of the exponent
+ */
+static void number_lexeme(Lexeme *code, const char *str, size_t len)
+{
+    lexeme_clear(code);
+    size_t i = 0;
+    while (i < len && str[i] == '0')
     {
-        char *code = "\0";
-        int ret = generate_token(token, code);
-        if (ret != 0)
-        {
-            throw_error(LEXICAL_ERR, token->line_num, "Lexical error.")
-        }
-        code = NULL;
+        i++;
     }
-    else
+    size_t digits = i;
+    while (digits < len && str[digits] >= '0' && str[digits] <= '9')
     {
-        *token = Token_stack_pop(scanner_stack);
-    }
-    return ret;
-}
-
-int generate_token(Token *token, char *code)
-{
-    // Definition of keywords and their corresponding tokens
-    Token_map defined_tokens[] = {
-        {"Double", TOKEN_TYPE_DOUBLE},
-        {"String", TOKEN_TYPE_STRING},
-        {"Int", TOKEN_TYPE_INT},
-        {"Bool", TOKEN_TYPE_BOOL},
-        {"Double?", TOKEN_TYPE_DOUBLE_NIL},
-        {"String?", TOKEN_TYPE_STRING_NIL},
-        {"Int?", TOKEN_TYPE_INT_NIL},
-        {"Bool?", TOKEN_TYPE_BOOL_NIL},
-        {"func", TOKEN_FUNC},
-        {"nil", TOKEN_NIL},
-        {"if", TOKEN_IF},
-        {"else", TOKEN_ELSE},
-        {"true", TOKEN_BOOL},
-        {"false", TOKEN_BOOL},
-        {"return", TOKEN_RETURN},
-        {"while", TOKEN_WHILE},
-        {"var", TOKEN_VAR},
-        {"let", TOKEN_LET},
-        {"break", TOKEN_BREAK},
-        {"continue", TOKEN_CONTINUE}};
-
-    // Initialization of used flags
-    token->preceded_by_nl = false;
-    int code_len = 1;
-    int previous_indent_cnt = 0;
-    bool indent_set = false;
-    bool string_newline = false;
-    bool first_line = true;
-
-    code = calloc(code_len + 1, sizeof(char));
-    if (code == NULL)
+        digits++;
+    }
+    if (digits == i)
     {
-        ret = INTERNAL_ERR;
-        throw_error(INTERNAL_ERR, -1, "Memory allocation for code failed.");
+        lexeme_push(code, '0');
     }
-
-    while (1)
+    else
     {
-        check_length(&code_len, 0, &code);
-        // Finite state machine to recognize different tokens.
-        switch (state)
-        {
-        /*
-         * NEW_TOKEN state each time before generating new token
-         */
-        case NEW_TOKEN:
-        {
-            memset(code, '\0', strlen(code));
-            char c = (char)getchar();
-            switch (c)
-            {
-            case '\t':
-            case ' ':
-            case '\v':
-            case '\r':
-                state = NEW_TOKEN;
-                break;
-            case '\f':
-            case '\n':
-                token->preceded_by_nl = true;
-                state = NEW_TOKEN;
-                line_num++;
-                break;
-            case EOF:
-                return set_token(END_STATE, "", TOKEN_EOF, token);
-            case ',':
-                return set_token(NEW_TOKEN, ",", TOKEN_COMMA, token);
-            case ':':
-                return set_token(NEW_TOKEN, ":", TOKEN_DOUBLE_DOT, token);
-            case '+':
-                return set_token(NEW_TOKEN, "+", TOKEN_PLUS, token);
-            case '-':
-                c = getchar();
-                if (c == '>')
-                {
-                    return set_token(NEW_TOKEN, "->", TOKEN_ARROW, token);
-                }
-                else
-                {
-                    ungetc(c, stdin);
-                    return set_token(NEW_TOKEN, "-", TOKEN_MINUS, token);
-                }
-            case '*':
-                return set_token(NEW_TOKEN, "*", TOKEN_MUL, token);
-            case '/':
-                c = getchar();
-                /*
-                 * COMMENTARY starts after '//' is read from stdin
-                 * COMMENTARY_BL starts after '/'+'*' is read from stdin
-                 * Any other pair or subsequent sequence means nothing else so '/' is generated as division
-                 */
-                if (c == '/')
-                {
-                    state = COMMENTARY;
-                }
-                else if (c == '*')
-                {
-                    state = COMMENTARY_BL;
-                }
-                else
-                {
-                    ungetc(c, stdin);
-                    return set_token(NEW_TOKEN, "/", TOKEN_DIV, token);
-                }
-                break;
-            case ')':
-                return set_token(NEW_TOKEN, ")", TOKEN_R_BRACKET, token);
-            case '(':
-                return set_token(NEW_TOKEN, "(", TOKEN_L_BRACKET, token);
-            case '}':
-                return set_token(NEW_TOKEN, "}", TOKEN_R_CURLY, token);
-            case '{':
-                return set_token(NEW_TOKEN, "{", TOKEN_L_CURLY, token);
-            case '?':
-                c = (char)getchar();
-                /*
-                 * Only valid combinations with ? are ?? or suffix of identificator
-                 */
-                if (c == '?')
-                {
-                    return set_token(NEW_TOKEN, "??", TOKEN_BINARY_OPERATOR, token);
-                }
-                else
-                {
-                    ungetc(c, stdin);
-                    ret = LEXICAL_ERR;
-                    return LEXICAL_ERR;
-                }
-            case '<':
-                c = (char)getchar();
-                if (c == '=')
-                {
-                    return set_token(NEW_TOKEN, "<=", TOKEN_LESS_EQ, token);
-                }
-                else
-                {
-                    ungetc(c, stdin);
-                    return set_token(NEW_TOKEN, "<", TOKEN_LESS, token);
-                }
-            case '>':
-                c = (char)getchar();
-                if (c == '=')
-                {
-                    return set_token(NEW_TOKEN, ">=", TOKEN_MORE_EQ, token);
-                }
-                else
-                {
-                    ungetc(c, stdin);
-                    return set_token(NEW_TOKEN, ">", TOKEN_MORE, token);
-                }
-            case '=':
-                /*
-                 * After '=' is read and there is no other '=' sign after that we generate TOKEN_ASSIGN
-                 * Otherwise only 3 subsequent '==' means equal so any other sequence is LEXICAL_ERR
-                 */
-                c = (char)getchar();
-                if (c == '=')
-                {
-                    return set_token(NEW_TOKEN, "==", TOKEN_EQ, token);
-                }
-                else
-                {
-                    ungetc(c, stdin);
-                    return set_token(NEW_TOKEN, "=", TOKEN_ASSIGN, token);
-                }
-            case '!':
-                /*
-                 * '!' at the beginning of token tas to create sequence '!=' otherwise it has no meaning and ends with LEXICAL_ERR
-                 */
-                c = (char)getchar();
-                if (c == '=')
-                {
-                    return set_token(NEW_TOKEN, "!=", TOKEN_NEQ, token);
-                }
-                else
-                {
-                    ungetc(c, stdin);
-                    return set_token(NEW_TOKEN, "!", TOKEN_NOT, token);
-                }
-            case '&':
-                c = (char)getchar();
-                if (c == '&')
-                {
-                    return set_token(NEW_TOKEN, "&&", TOKEN_AND, token);
-                }
-                else
-                {
-                    ungetc(c, stdin);
-                    ret = LEXICAL_ERR;
-                    return LEXICAL_ERR;
-                }
-            case '|':
-                c = (char)getchar();
-                if (c == '|')
-                {
-                    return set_token(NEW_TOKEN, "||", TOKEN_OR, token);
-                }
-                else
-                {
-                    ungetc(c, stdin);
-                    ret = LEXICAL_ERR;
-                    return LEXICAL_ERR;
-                }
-            case '"':
-                state = STRING_1;
-                break;
-            case '0' ... '9':
-                check_length(&code_len, 0, &code);
-                strncat(code, &c, 1);
-                state = INTEGER;
-                break;
-            case 'A' ... 'Z':
-            case 'a' ... 'z':
-                check_length(&code_len, 0, &code);
-                strncat(code, &c, 1);
-                state = IDENTIFICATOR;
-                break;
-            case '_':
-                state = UNDERSCORE;
-                break;
-            default:
-                return LEXICAL_ERR;
-            }
-            break;
-        }
-        case UNDERSCORE:
-        {
-            char c = (char)getchar();
-            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c <= '9' && c >= '0') || c == '_')
-            {
-                check_length(&code_len, 0, &code);
-                code[strlen(code)] = '_';
-                ungetc(c, stdin);
-                state = IDENTIFICATOR;
-            }
-            else
-            {
-                ungetc(c, stdin);
-                return set_token(NEW_TOKEN, "_", TOKEN_IDENTIFICATOR, token);
-            }
-            break;
-        }
-        case COMMENTARY:
+        lexeme_append(code, str + i, digits - i);
+    }
+    for (i = digits; i < len; i++)
+    {
+        char last = code->data[code->len - 1];
+        if (str[i] != '0' || (last != '+' && last != '-'))
         {
-            char c = (char)getchar();
-            while (c != '\n' && c != '\f' && c != EOF)
-            {
-                c = (char)getchar();
-            }
-            ungetc(c, stdin);
-            state = NEW_TOKEN;
-            break;
+            lexeme_push(code, str[i]);
         }
-            /*
-             * Block commentary has to end with sequence '*'+'/'otherwise it cannot be considered a commentary and LEXICAL_ERR is generated
-             */
-        case COMMENTARY_BL:
+    }
+}
+
+/*
+ * Identifier has been matched, it is either a keyword, a function identifier (followed by '(') or an identifier
+ */
+static int lexer_identifier(Lexer *lx, size_t start, Token *token)
+{
+    const char *name_start = lx->data + start;
+    size_t len = lx->pos - start;
+    // Keywords are looked up in the perfect hash table, types followed by ? are types with nil possibility
+    Token_type keyword_type;
+    if (keyword_lookup(name_start, len, &keyword_type))
+    {
+        if (lx->pos < lx->len && lx->data[lx->pos] == '?' && keyword_type >= TOKEN_TYPE_STRING && keyword_type <= TOKEN_TYPE_BOOL)
         {
-            char c = (char)getchar();
-            while (1)
-            {
-                if (c == '\n')
-                {
-                    line_num++;
-                }
-                if (c == '*')
-                {
-                    c = (char)getchar();
-                    if (c == '/')
-                    {
-                        state = NEW_TOKEN;
-                        break;
-                    }
-                }
-                else if (c == EOF)
-                {
-                    ungetc(c, stdin);
-                    return LEXICAL_ERR;
-                }
-                c = (char)getchar();
-            }
-            break;
+            lx->pos++;
+            len++;
+            keyword_type += TOKEN_TYPE_STRING_NIL - TOKEN_TYPE_STRING;
         }
-        break;
-            /*
-             * We expect identifier to be a particular keyword,
-             * builtin function or some user defined identifier
-             */
-        case IDENTIFICATOR:
+        return set_token(lx, NEW_TOKEN, intern(name_start, len), keyword_type, token);
+    }
+    // Identifiers are interned, so equal names share one pointer with precomputed hash
+    char *name = intern(name_start, len);
+    // Look past the spaces after identifier to find out whether it is a function identifier
+    size_t lookahead = lx->pos;
+    bool had_newline = false;
+    bool had_space = false;
+    unsigned int skipped_lines = 0;
+    while (lookahead < lx->len && isspace(lx->data[lookahead]))
+    {
+        if (lx->data[lookahead] == ' ')
         {
-            char c = (char)getchar();
-            while ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')
-            {
-                check_length(&code_len, 0, &code);
-                strncat(code, &c, 1);
-                c = (char)getchar();
-            }
-            // Find out whether the type is with nil possibility
-            if (c == '?' &&
-                (strcmp(code, "Double") == 0 || strcmp(code, "Int") == 0 || strcmp(code, "String") == 0 ||
-                 strcmp(code, "Bool") == 0))
-            {
-                check_length(&code_len, 0, &code);
-                strncat(code, &c, 1);
-            }
-            else
-            {
-                ungetc(c, stdin);
-            }
-            for (size_t i = 0; i < sizeof(defined_tokens) / sizeof(defined_tokens[0]); i++)
-            {
-                if (strcmp(code, defined_tokens[i].code) == 0)
-                {
-                    return set_token(NEW_TOKEN, code, defined_tokens[i].token, token);
-                }
-            }
-            // Ignore spaces after identifier to find out whether it is a function identifier
-            c = (char)getchar();
-            bool had_newline = false;
-            bool had_space = false;
-            while (isspace(c))
-            {
-                if (c == ' ')
-                {
-                    had_space = true;
-                }
-                else if (c == '\n' || c == '\f')
-                {
-                    line_num++;
-                    had_newline = true;
-                }
-                c = (char)getchar();
-            }
-            if (c == '(')
-            {
-                ungetc(c, stdin);
-                return set_token(NEW_TOKEN, code, TOKEN_FUNC_ID, token);
-            }
-            else
-            {
-                ungetc(c, stdin);
-                if (had_space)
-                {
-                    ungetc(' ', stdin);
-                }
-                if (had_newline)
-                {
-                    line_num--;
-                    ungetc('\n', stdin);
-                }
-                return set_token(NEW_TOKEN, code, TOKEN_IDENTIFICATOR, token);
-            }
+            had_space = true;
         }
-        break;
-            /*
-             * TOKEN_INT is generated if integer is read and there is no dec.point subsequent to it
-             * TOKEN_DOUBLE is generated if dec.point and dec.part has been read
-             * state = EXP_START if there is e/E read after the end of float/int
-             */
-        case DEC_POINT:
-        case INTEGER:
+        else if (lx->data[lookahead] == '\n' || lx->data[lookahead] == '\f')
         {
-            if (state == INTEGER)
-            {
-                ungetc(code[strlen(code) - 1], stdin);
-                code[strlen(code) - 1] = '\0';
-            }
-            char c = (char)getchar();
-            while (c <= '9' && c >= '0')
-            {
-                if (c != '0' || *code != '\0')
-                {
-                    check_length(&code_len, 0, &code);
-                    strncat(code, &c, 1);
-                }
-                c = (char)getchar();
-            }
-            if (*code == '\0')
-            {
-                *code = '0';
-            }
-            if (c == 'e' || c == 'E')
-            {
-                check_length(&code_len, 0, &code);
-                strncat(code, &c, 1);
-                state = EXP_START;
-            }
-            else if (c == '.' && state == INTEGER)
-            {
-                check_length(&code_len, 0, &code);
-                strncat(code, &c, 1);
-                state = DEC_POINT;
-                break;
-            }
-            else
-            {
-                ungetc(c, stdin);
-                if (state == INTEGER)
-                {
-                    return set_token(NEW_TOKEN, code, TOKEN_INT, token);
-                }
-                else
-                {
-                    return set_token(NEW_TOKEN, code, TOKEN_DOUBLE, token);
-                }
-            }
+            skipped_lines++;
+            had_newline = true;
         }
-        break;
-            /*
-             * E/e was read and after possible sign there has to be integer otherwise its LEXICAL_ERR
-             */
-        case EXP_START:
+        lookahead++;
+    }
+    if (lookahead < lx->len && lx->data[lookahead] == '(')
+    {
+        lx->pos = lookahead;
+        lx->line_num += skipped_lines;
+        return set_token(lx, NEW_TOKEN, name, TOKEN_FUNC_ID, token);
+    }
+    // spaces other than ' ' and newline carry no meaning for the next token, so they are dropped
+    if (!had_space && !had_newline)
+    {
+        lx->pos = lookahead;
+    }
+    return set_token(lx, NEW_TOKEN, name, TOKEN_IDENTIFICATOR, token);
+}
+
+/*
+ * Reads the rest of the string after its opening '"', the escape sequences are decoded and block strings
+ * are checked for consistent indentation
+ */
+static int lexer_string(Lexer *lx, Token *token)
+{
+    Lexeme *code = &lx->lexeme;
+    lexeme_clear(code);
+    int previous_indent_cnt = 0;
+    bool indent_set = false;
+    bool string_newline = false;
+    bool first_line = true;
+
+    while (1)
+    {
+        switch (lx->state)
         {
-            char c = (char)getchar();
-            if (c == '+' || c == '-')
-            {
-                check_length(&code_len, 0, &code);
-                strncat(code, &c, 1);
-                c = (char)getchar();
-            }
-            if (c >= '0' && c <= '9')
-            {
-                while (c >= '0' && c <= '9')
-                {
-                    if (c != '0' ||
-                        (code[strlen(code) - 1] != '-' && code[strlen(code) - 1] != '+' && code[0] != '\0'))
-                    {
-                        check_length(&code_len, 0, &code);
-                        strncat(code, &c, 1);
-                    }
-                    c = (char)getchar();
-                }
-            }
-            else
-            {
-                ungetc(c, stdin);
-                return LEXICAL_ERR;
-            }
-            if (*code == '\0')
-            {
-                *code = '0';
-            }
-            ungetc(c, stdin);
-            return set_token(NEW_TOKEN, code, TOKEN_EXP, token);
-        }
-        break;
             /*
              *  """  has been read
              * Characters are read till """ is read again
@@ -502,18 +205,18 @@ int generate_token(Token *token, char *code)
         case STRING_BLOCK:
         {
             int curr_indent_cnt = 0;
-            char c = (char)getchar();
+            char c = next_char(lx);
 
             while (c != '"')
             {
                 if (c == '\\')
                 {
-                    state = STRING_BLOCK_ESCAPE;
+                    lx->state = STRING_BLOCK_ESCAPE;
                     break;
                 }
                 else if (c == EOF)
                 {
-                    ungetc(c, stdin);
+                    unget_char(lx);
                     return LEXICAL_ERR;
                 }
                 else
@@ -523,14 +226,14 @@ int generate_token(Token *token, char *code)
                         indent_set = true;
                         curr_indent_cnt = 0;
                         string_newline = true;
-                        line_num++;
-                        c = (char)getchar();
+                        lx->line_num++;
+                        c = next_char(lx);
                     }
 
                     while (c == ' ' || c == '\t')
                     {
                         curr_indent_cnt++;
-                        c = (char)getchar();
+                        c = next_char(lx);
                     }
 
                     if (indent_set && c != '\n')
@@ -551,29 +254,31 @@ int generate_token(Token *token, char *code)
 
                     if (c == '\n')
                     {
-                        ungetc(c, stdin);
+                        unget_char(lx);
                         break;
                     }
 
                     if (c == '"' && string_newline)
                     {
-                        state = STRING_1_END;
+                        lx->state = STRING_1_END;
                         break;
                     }
 
-                    check_length(&code_len, 0, &code);
-                    strncat(code, &c, 1);
-                    c = '\0';
-                    c = (char)getchar();
+                    lexeme_push(code, c);
+                    // plain characters up to the next one that needs handling are copied in bulk
+                    size_t end = scan_find_any(lx->data, lx->pos, lx->len, STRING_BLOCK_SPECIAL_CHARS, 7);
+                    lexeme_append(code, lx->data + lx->pos, end - lx->pos);
+                    lx->pos = end;
+                    c = next_char(lx);
                 }
             }
 
             if (string_newline)
             {
-                state = STRING_1_END;
+                lx->state = STRING_1_END;
                 break;
             }
-            else if (state != STRING_BLOCK)
+            else if (lx->state != STRING_BLOCK)
             {
                 break;
             }
@@ -586,38 +291,23 @@ int generate_token(Token *token, char *code)
              */
         case STRING:
         {
-            char c = (char)getchar();
-            while (c != '"')
+            // plain characters are copied in bulk up to the next one that needs handling
+            size_t end = scan_find_any(lx->data, lx->pos, lx->len, STRING_SPECIAL_CHARS, 5);
+            lexeme_append(code, lx->data + lx->pos, end - lx->pos);
+            lx->pos = end;
+            char c = next_char(lx);
+            if (c == '"')
             {
-                if (c == '\\')
-                {
-                    state = STRING_ESCAPE;
-                    break;
-                }
-                else if (c == EOF)
-                {
-                    ungetc(c, stdin);
-                    return LEXICAL_ERR;
-                }
-                else
-                {
-                    while (c == '\n' || c == '\r')
-                    {
-                        return LEXICAL_ERR;
-                    }
-                    check_length(&code_len, 0, &code);
-                    strncat(code, &c, 1);
-                    c = '\0';
-                    c = (char)getchar();
-                }
+                return set_token(lx, NEW_TOKEN, lexeme_take(code), TOKEN_STRING, token);
             }
-            if (state == STRING)
+            else if (c == '\\')
             {
-                return set_token(NEW_TOKEN, code, TOKEN_STRING, token);
+                lx->state = STRING_ESCAPE;
+                break;
             }
-            else if (state == STRING_ESCAPE)
+            else if (c == EOF)
             {
-                break;
+                unget_char(lx);
             }
             return LEXICAL_ERR;
         }
@@ -627,91 +317,84 @@ int generate_token(Token *token, char *code)
         case STRING_BLOCK_ESCAPE:
         case STRING_ESCAPE:
         {
-            char c = (char)getchar();
+            char c = next_char(lx);
             switch (c)
             {
             case '{':
-                if (state == STRING_ESCAPE)
+                if (lx->state == STRING_ESCAPE)
                 {
-                    state = HEX_START;
+                    lx->state = HEX_START;
                 }
                 else
                 {
-                    state = HEX_START_BLOCK;
+                    lx->state = HEX_START_BLOCK;
                 }
                 break;
             case '\\':
-                check_length(&code_len, 0, &code);
-                strcat(code, "\\");
-                if (state == STRING_ESCAPE)
+                lexeme_push(code, '\\');
+                if (lx->state == STRING_ESCAPE)
                 {
-                    state = STRING;
+                    lx->state = STRING;
                 }
                 else
                 {
-                    state = STRING_BLOCK;
+                    lx->state = STRING_BLOCK;
                 }
                 break;
             case 'n':
-                check_length(&code_len, 0, &code);
-                strcat(code, "\n");
-                if (state == STRING_ESCAPE)
+                lexeme_push(code, '\n');
+                if (lx->state == STRING_ESCAPE)
                 {
-                    state = STRING;
+                    lx->state = STRING;
                 }
                 else
                 {
-                    state = STRING_BLOCK;
+                    lx->state = STRING_BLOCK;
                 }
                 break;
             case 't':
-                check_length(&code_len, 0, &code);
-                strcat(code, "\t");
-                if (state == STRING_ESCAPE)
+                lexeme_push(code, '\t');
+                if (lx->state == STRING_ESCAPE)
                 {
-                    state = STRING;
+                    lx->state = STRING;
                 }
                 else
                 {
-                    state = STRING_BLOCK;
+                    lx->state = STRING_BLOCK;
                 }
                 break;
             case 'r':
-                check_length(&code_len, 0, &code);
-                strcat(code, "\r");
-                if (state == STRING_ESCAPE)
+                lexeme_push(code, '\r');
+                if (lx->state == STRING_ESCAPE)
                 {
-                    state = STRING;
+                    lx->state = STRING;
                 }
                 else
                 {
-                    state = STRING_BLOCK;
+                    lx->state = STRING_BLOCK;
                 }
                 break;
             case '"':
-                check_length(&code_len, 0, &code);
-                strcat(code, "\"");
-                if (state == STRING_ESCAPE)
+                lexeme_push(code, '"');
+                if (lx->state == STRING_ESCAPE)
                 {
-                    state = STRING;
+                    lx->state = STRING;
                 }
                 else
                 {
-                    state = STRING_BLOCK;
+                    lx->state = STRING_BLOCK;
                 }
                 break;
             default:
-                check_length(&code_len, 0, &code);
-                strcat(code, "\\");
-                check_length(&code_len, 0, &code);
-                strncat(code, &c, 1);
-                if (state == STRING_ESCAPE)
+                lexeme_push(code, '\\');
+                lexeme_push(code, c);
+                if (lx->state == STRING_ESCAPE)
                 {
-                    state = STRING;
+                    lx->state = STRING;
                 }
                 else
                 {
-                    state = STRING_BLOCK;
+                    lx->state = STRING_BLOCK;
                 }
                 break;
             }
@@ -729,17 +412,15 @@ int generate_token(Token *token, char *code)
             bool correct = 1;
             for (int i = 0; i < 2; i++)
             {
-                c = (char)getchar();
+                c = next_char(lx);
                 if (!((c <= '9' && c >= '0') || (c <= 'f' && c >= 'a') || (c <= 'F' && c >= 'A')))
                 {
                     correct = 0;
                     if (c == '"' || c == '\\')
                     {
-                        char str[3] = "{";
-                        strcat("{", hex);
-                        check_length(&code_len, strlen(str), &code);
-                        strcat(code, str);
-                        ungetc(c, stdin);
+                        lexeme_push(code, '{');
+                        lexeme_append(code, hex, strlen(hex));
+                        unget_char(lx);
                     }
                     else
                     {
@@ -752,11 +433,11 @@ int generate_token(Token *token, char *code)
                 }
             }
             c = '\0';
-            c = (char)getchar();
+            c = next_char(lx);
             if (c != '}')
             {
                 correct = 0;
-                ungetc(c, stdin);
+                unget_char(lx);
             }
             if (correct == 1)
             {
@@ -767,53 +448,50 @@ int generate_token(Token *token, char *code)
                 char dec_val[20];
                 memset(dec_val, '\0', sizeof(dec_val));
                 sprintf(dec_val, "%ld", dec_num);
-                check_length(&code_len, strlen(dec_val), &code);
-                strcat(code, dec_val);
+                lexeme_append(code, dec_val, strlen(dec_val));
             }
             else
             {
-                char str[3] = "{";
-                strcat("{", hex);
-                check_length(&code_len, strlen(str), &code);
-                strcat(code, str);
+                lexeme_push(code, '{');
+                lexeme_append(code, hex, strlen(hex));
             }
-            if (state == HEX_START)
+            if (lx->state == HEX_START)
             {
-                state = STRING;
+                lx->state = STRING;
             }
             else
             {
-                state = STRING_BLOCK;
+                lx->state = STRING_BLOCK;
             }
             break;
         }
             // First " has been read
         case STRING_1:
         {
-            char c = (char)getchar();
+            char c = next_char(lx);
             if (c == '"')
             {
-                state = STRING_2;
+                lx->state = STRING_2;
             }
             else
             {
-                ungetc(c, stdin);
-                state = STRING;
+                unget_char(lx);
+                lx->state = STRING;
             }
             break;
         }
             // Second " has been read
         case STRING_2:
         {
-            char c = (char)getchar();
+            char c = next_char(lx);
             if (c == '"')
             {
-                state = STRING_BLOCK;
+                lx->state = STRING_BLOCK;
             }
             else
             {
-                ungetc(c, stdin);
-                return set_token(NEW_TOKEN, "", TOKEN_STRING, token);
+                unget_char(lx);
+                return set_token(lx, NEW_TOKEN, "", TOKEN_STRING, token);
             }
             break;
         }
@@ -821,49 +499,46 @@ int generate_token(Token *token, char *code)
         case STRING_1_END:
         case STRING_2_END:
         {
-            char c = (char)getchar();
+            char c = next_char(lx);
             DEBUG_LEXER_CODE(printf("char:%c\n", c););
             if (c == '"')
             {
-                if (state == STRING_1_END)
+                if (lx->state == STRING_1_END)
                 {
-                    state = STRING_2_END;
+                    lx->state = STRING_2_END;
                     break;
                 }
                 else
                 {
-                    int len = strlen(code);
                     // Remove newline characters from the end of the string
-                    while (len > 0 && (code[len - 1] == '\n' || code[len - 1] == '\r'))
+                    while (code->len > 0 && (code->data[code->len - 1] == '\n' || code->data[code->len - 1] == '\r'))
                     {
-                        code[len - 1] = '\0';
-                        len--;
+                        code->len--;
                     }
                     // Remove newline characters from the beginning of the string
-                    int start = 0;
-                    while (code[start] != '\0' && (code[start] == '\n' || code[start] == '\r'))
+                    size_t start = 0;
+                    while (start < code->len && (code->data[start] == '\n' || code->data[start] == '\r'))
                     {
                         start++;
                     }
                     if (start > 0)
                     {
-                        memmove(code, code + start, len - start + 1);
+                        memmove(code->data, code->data + start, code->len - start);
+                        code->len -= start;
                     }
                     indent_set = false;
-                    return set_token(NEW_TOKEN, code, TOKEN_STRING, token);
+                    return set_token(lx, NEW_TOKEN, lexeme_take(code), TOKEN_STRING, token);
                 }
             }
             else
             {
-                check_length(&code_len, 0, &code);
-                strcat(code, "\"");
-                if (state == STRING_2_END)
+                lexeme_push(code, '"');
+                if (lx->state == STRING_2_END)
                 {
-                    check_length(&code_len, 0, &code);
-                    strcat(code, "\"");
+                    lexeme_push(code, '"');
                 }
-                ungetc(c, stdin);
-                state = STRING_BLOCK;
+                unget_char(lx);
+                lx->state = STRING_BLOCK;
             }
             break;
         }
@@ -873,52 +548,240 @@ int generate_token(Token *token, char *code)
     }
 }
 
-/*
- * Before each character is added to *code it reallocates memory if needed
- */
-void check_length(int *code_len, int add, char **code)
+int lexer_next(Lexer *lx, Token *token)
 {
-    if (strlen(*code) + add >= (long unsigned int)*code_len)
+    token->preceded_by_nl = false;
+    if (lx->state != NEW_TOKEN)
     {
-        *code_len = ((long unsigned int)*code_len) * 2;
-        char *new_code = calloc((long unsigned int)*code_len + 1, sizeof(char));
-        if (new_code == NULL)
+        // nothing can be read after EOF or a lexical error
+        return LEXICAL_ERR;
+    }
+
+    while (1)
+    {
+        // the automaton generated by utils/create_scanner_table.py reads the longest match
+        size_t start = lx->pos;
+        size_t end;
+        const Scan_accept *accept = scan_match(lx->data, start, lx->len, &end);
+        lx->lexeme_start = start;
+        lx->pos = end;
+        switch (accept->action)
+        {
+        case SCAN_WHITESPACE:
         {
-            throw_error(INTERNAL_ERR, -1, "Memory allocation for code failed.");
+            // newlines in the run are counted in bulk
+            size_t newlines = scan_count(lx->data, start, end, '\n', '\f');
+            if (newlines > 0)
+            {
+                token->preceded_by_nl = true;
+                lx->line_num += newlines;
+            }
+            break;
+        }
+        case SCAN_LINE_COMMENT:
+            // jump right before the end of line, the newline itself is handled as whitespace
+            lx->pos = scan_find_any(lx->data, lx->pos, lx->len, "\n\f", 2);
+            break;
+        case SCAN_BLOCK_COMMENT:
+        {
+            // jump from one '*' to another, counting the skipped lines
+            size_t pos = lx->pos;
+            while (1)
+            {
+                size_t star = scan_find_any(lx->data, pos, lx->len, "*", 1);
+                lx->line_num += scan_count(lx->data, pos, star, '\n', '\n');
+                if (star >= lx->len)
+                {
+                    lx->pos = lx->len;
+                    return LEXICAL_ERR;
+                }
+                if (star + 1 < lx->len && lx->data[star + 1] == '/')
+                {
+                    lx->pos = star + 2;
+                    break;
+                }
+                pos = star + 1;
+            }
+            break;
+        }
+        case SCAN_EOF:
+            return set_token(lx, END_STATE, (char *)accept->value, accept->type, token);
+        case SCAN_TOKEN:
+            return set_token(lx, NEW_TOKEN, (char *)accept->value, accept->type, token);
+        case SCAN_STRING:
+            lx->state = STRING_1;
+            return lexer_string(lx, token);
+        case SCAN_NUMBER:
+            number_lexeme(&lx->lexeme, lx->data + start, end - start);
+            return set_token(lx, NEW_TOKEN, lexeme_take(&lx->lexeme), accept->type, token);
+        case SCAN_IDENTIFIER:
+            return lexer_identifier(lx, start, token);
+        case SCAN_UNDERSCORE:
+            return set_token(lx, NEW_TOKEN, intern("_", 1), accept->type, token);
+        default:
+            return LEXICAL_ERR;
         }
-        strcpy(new_code, *code);
-        free(*code);
-        *code = new_code;
     }
 }
 
-/*
- * set_token is called when token is generated successfully
- * Checks whether valid characters is next from *char_without_space
+void lexeme_grow(Lexeme *lexeme, size_t add)
+{
+    size_t cap = lexeme->cap == 0 ? LEXEME_INITIAL_SIZE : lexeme->cap;
+    while (cap < lexeme->len + add + 1)
+    {
+        cap *= 2;
+    }
+    char *data = realloc(lexeme->data, cap);
+    if (data == NULL)
+    {
+        throw_error(INTERNAL_ERR, -1, "Memory allocation for code failed.");
+    }
+    lexeme->data = data;
+    lexeme->cap = cap;
+}
+
+void lexeme_append(Lexeme *lexeme, const char *str, size_t len)
+{
+    if (lexeme->len + len + 1 > lexeme->cap)
+    {
+        lexeme_grow(lexeme, len);
+    }
+    memcpy(lexeme->data + lexeme->len, str, len);
+    lexeme->len += len;
+}
+
+char *lexeme_take(Lexeme *lexeme)
+{
+    char *str = intern_alloc(lexeme->len + 1);
+    if (lexeme->len > 0)
+    {
+        memcpy(str, lexeme->data, lexeme->len);
+    }
+    str[lexeme->len] = '\0';
+    return str;
+}
+
+/**
+ * Allocates the literal with space for the operand of the length
  */
-int set_token(int next_state, char *val, Token_type type, Token *token)
+static Literal *literal_alloc(size_t operand_len)
 {
-    char c = (char)getchar();
-    DEBUG_LEXER_CODE(printf("c:%c\n", c););
-    int correct = 0;
-    for (int i = 0; i < (int)CHAR_WTH_SPACE_LENGTH; i++)
+    Literal *literal = intern_alloc(sizeof(Literal) + operand_len + 1);
+    literal->operand_len = operand_len;
+    return literal;
+}
+
+// escape sequences of the characters that cannot be written to the string operand directly
+static const char *const operand_escapes[256] = {
+    ['\a'] = "\\007",
+    ['\b'] = "\\008",
+    ['\t'] = "\\009",
+    ['\n'] = "\\010",
+    ['\v'] = "\\011",
+    ['\f'] = "\\012",
+    ['\r'] = "\\013",
+    [' '] = "\\032",
+    ['#'] = "\\035",
+    ['\\'] = "\\092",
+};
+
+size_t string_operand_encode(const char *str, char *out)
+{
+    size_t len = 0;
+    for (; *str != '\0'; str++)
     {
-        if (c == *char_without_space[i] || c == EOF || isspace(c) != 0 ||
-            val[strlen(val) - 1] == *char_without_space[i])
+        const char *escape = operand_escapes[(unsigned char)*str];
+        if (escape == NULL)
         {
-            correct = 1;
+            if (out != NULL)
+            {
+                out[len] = *str;
+            }
+            len++;
         }
+        else
+        {
+            if (out != NULL)
+            {
+                memcpy(out + len, escape, 4);
+            }
+            len += 4;
+        }
+    }
+    if (out != NULL)
+    {
+        out[len] = '\0';
     }
+    return len;
+}
 
-    ungetc(c, stdin);
+/**
+ * Decodes the value of int, double and string literals and encodes their IFJcode23 operand, NULL is returned for
+ * other tokens
+ */
+static Literal *literal_decode(Token_type type, const char *value)
+{
+    Literal *literal = NULL;
+    switch (type)
+    {
+    case TOKEN_INT:
+    {
+        // the digits are kept as written
+        size_t len = strlen(value);
+        literal = literal_alloc(len + 4);
+        literal->value.int_value = strtoll(value, NULL, 10);
+        memcpy(literal->operand, "int@", 4);
+        memcpy(literal->operand + 4, value, len + 1);
+        break;
+    }
+    case TOKEN_DOUBLE:
+    case TOKEN_EXP:
+    {
+        double double_value = strtod(value, NULL);
+        char operand[64];
+        int len = snprintf(operand, sizeof(operand), "float@%a", double_value);
+        literal = literal_alloc((size_t)len);
+        literal->value.double_value = double_value;
+        memcpy(literal->operand, operand, (size_t)len + 1);
+        break;
+    }
+    case TOKEN_STRING:
+    {
+        size_t len = string_operand_encode(value, NULL);
+        literal = literal_alloc(len + 7);
+        literal->value.int_value = 0;
+        memcpy(literal->operand, "string@", 7);
+        string_operand_encode(value, literal->operand + 7);
+        break;
+    }
+    default:
+        break;
+    }
+    return literal;
+}
+
+/*
+ * set_token is called when token is generated successfully
+ * Checks whether the token is followed by a separator or ends with one itself (table scan_separator)
+ */
+int set_token(Lexer *lx, int next_state, char *val, Token_type type, Token *token)
+{
+    char c = next_char(lx);
+    DEBUG_LEXER_CODE(printf("c:%c\n", c););
+    unget_char(lx);
 
-    if (correct == 1)
+    // empty tokens (EOF, empty string) need no separator
+    size_t len = strlen(val);
+    bool correct = len == 0 || (scan_separator[(unsigned char)c] & SCAN_SEPARATOR_FOLLOWS) != 0 ||
+                   (scan_separator[(unsigned char)val[len - 1]] & SCAN_SEPARATOR_ENDS) != 0;
+    if (correct)
     {
-        state = next_state;
+        lx->state = next_state;
         token->type = type;
         token->token_value = val;
-        token->line_num = line_num;
-        DEBUG_LEXER_CODE(printf("type:%d, value:%s, line_num:%d\n", token->type, token->token_value, line_num););
+        token->line_num = lx->line_num;
+        token->literal = literal_decode(type, val);
+        DEBUG_LEXER_CODE(printf("type:%d, value:%s, lx->line_num:%d\n", token->type, token->token_value, lx->line_num););
         return 0;
     }
     else
@@ -929,15 +792,796 @@ int set_token(int next_state, char *val, Token_type type, Token *token)
 
 void scanner_init()
 {
-    scanner_stack = Token_stack_init();
+    compiler->token_ring.tokens = malloc(sizeof(Token) * TOKEN_RING_INITIAL_SIZE);
+    if (compiler->token_ring.tokens == NULL)
+    {
+        throw_error(INTERNAL_ERR, -1, "Memory allocation for token ring failed.");
+    }
+    compiler->token_ring.cap = TOKEN_RING_INITIAL_SIZE;
+    compiler->token_ring.first = 0;
+    compiler->token_ring.count = 0;
+    compiler->token_ring.cursor = 0;
+    compiler->token_ring.dropped = 0;
+    compiler->token_ring.marks = 0;
+}
+
+/**
+ * Doubles the capacity of the ring, the kept tokens are unwrapped to the beginning of the new buffer
+ */
+static void token_ring_grow()
+{
+    size_t new_cap = compiler->token_ring.cap * 2;
+    Token *tokens = malloc(sizeof(Token) * new_cap);
+    if (tokens == NULL)
+    {
+        throw_error(INTERNAL_ERR, -1, "Memory allocation for token ring failed.");
+    }
+    for (size_t i = 0; i < compiler->token_ring.count; i++)
+    {
+        tokens[i] = compiler->token_ring.tokens[(compiler->token_ring.first + i) & (compiler->token_ring.cap - 1)];
+    }
+    free(compiler->token_ring.tokens);
+    compiler->token_ring.tokens = tokens;
+    compiler->token_ring.cap = new_cap;
+    compiler->token_ring.first = 0;
+}
+
+static inline Token *token_ring_at(size_t offset)
+{
+    return &compiler->token_ring.tokens[(compiler->token_ring.first + offset) & (compiler->token_ring.cap - 1)];
+}
+
+Token *token_ring_peek(size_t k)
+{
+    // scan the tokens up to the requested one
+    while (compiler->token_ring.count - compiler->token_ring.cursor <= k)
+    {
+        if (compiler->token_ring.count == compiler->token_ring.cap)
+        {
+            token_ring_grow();
+        }
+        Token *token = token_ring_at(compiler->token_ring.count);
+        if (compiler->token_buffer.is_active)
+        {
+            // the whole input is tokenized already, only the next token is copied
+            *token = token_buffer_get(compiler->token_buffer.pos++);
+        }
+        else if (generate_token(token) != 0)
+        {
+            throw_error(LEXICAL_ERR, (int)compiler->main_lexer.line_num, "Lexical error.")
+        }
+        compiler->token_ring.count++;
+    }
+    return token_ring_at(compiler->token_ring.cursor + k);
+}
+
+Token token_ring_advance()
+{
+    Token token = *token_ring_peek(0);
+    compiler->token_ring.cursor++;
+
+    // forget old tokens unless someone may rewind to them
+    if (compiler->token_ring.marks == 0 && compiler->token_ring.cursor > TOKEN_RING_HISTORY)
+    {
+        size_t drop = compiler->token_ring.cursor - TOKEN_RING_HISTORY;
+        compiler->token_ring.first = (compiler->token_ring.first + drop) & (compiler->token_ring.cap - 1);
+        compiler->token_ring.count -= drop;
+        compiler->token_ring.cursor -= drop;
+        compiler->token_ring.dropped += drop;
+    }
+    return token;
+}
+
+size_t token_ring_mark()
+{
+    compiler->token_ring.marks++;
+    return compiler->token_ring.dropped + compiler->token_ring.cursor;
+}
+
+size_t token_ring_position()
+{
+    return compiler->token_ring.dropped + compiler->token_ring.cursor;
+}
+
+void token_ring_rewind(size_t mark)
+{
+    compiler->token_ring.cursor = mark - compiler->token_ring.dropped;
+    compiler->token_ring.marks--;
+}
+
+void token_ring_release(size_t mark)
+{
+    (void)mark;
+    compiler->token_ring.marks--;
+}
+
+void token_ring_recover(size_t mark, size_t marks)
+{
+    compiler->token_ring.cursor = mark - compiler->token_ring.dropped;
+    compiler->token_ring.marks = marks;
+}
+
+static void token_buffer_free(Token_buffer *buffer)
+{
+    free(buffer->types);
+    free(buffer->offsets);
+    free(buffer->lengths);
+    free(buffer->values);
+    free(buffer->literals);
+    free(buffer->lines);
+    free(buffer->nl_bits);
+    *buffer = (Token_buffer){.types = NULL, .count = 0, .cap = 0, .pos = 0, .is_active = false};
+}
+
+void scanner_open(const char *path)
+{
+    int fd = STDIN_FILENO;
+    if (path != NULL)
+    {
+        fd = open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            throw_error(INTERNAL_ERR, -1, "Cannot open source file %s.", path);
+        }
+    }
+
+    compiler->source.data = NULL;
+    compiler->source.len = 0;
+    compiler->source.pos = 0;
+    compiler->source.is_mapped = false;
+    lexer_init(&compiler->main_lexer, NULL, 0);
+    scan_init();
+
+    // regular files are mapped directly
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void *mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED)
+        {
+            compiler->source.data = (char *)mapped;
+            compiler->source.len = (size_t)st.st_size;
+            compiler->source.is_mapped = true;
+            lexer_init(&compiler->main_lexer, compiler->source.data, compiler->source.len);
+            if (path != NULL)
+            {
+                close(fd);
+            }
+            return;
+        }
+    }
+
+    // pipes and terminals are read in blocks
+    size_t capacity = SOURCE_BLOCK_SIZE;
+    compiler->source.data = malloc(capacity);
+    if (compiler->source.data == NULL)
+    {
+        throw_error(INTERNAL_ERR, -1, "Memory allocation failed.");
+    }
+    ssize_t read_len;
+    while ((read_len = read(fd, compiler->source.data + compiler->source.len, capacity - compiler->source.len)) > 0)
+    {
+        compiler->source.len += (size_t)read_len;
+        if (compiler->source.len == capacity)
+        {
+            capacity *= 2;
+            char *new_data = realloc(compiler->source.data, capacity);
+            if (new_data == NULL)
+            {
+                throw_error(INTERNAL_ERR, -1, "Memory allocation failed.");
+            }
+            compiler->source.data = new_data;
+        }
+    }
+    if (read_len < 0)
+    {
+        throw_error(INTERNAL_ERR, -1, "Cannot read source code.");
+    }
+    lexer_init(&compiler->main_lexer, compiler->source.data, compiler->source.len);
+    if (path != NULL)
+    {
+        close(fd);
+    }
+}
+
+void scanner_open_buffer(char *data, size_t len)
+{
+    scanner_open_source((Scanner_source){.data = data, .len = len, .pos = 0, .is_mapped = false});
+}
+
+void scanner_open_source(Scanner_source source)
+{
+    scan_init();
+    compiler->source = source;
+    compiler->source.pos = 0;
+    lexer_init(&compiler->main_lexer, source.data, source.len);
+}
+
+void scanner_close()
+{
+    if (compiler->source.is_mapped)
+    {
+        munmap(compiler->source.data, compiler->source.len);
+    }
+    else
+    {
+        free(compiler->source.data);
+    }
+    compiler->source.data = NULL;
+    compiler->source.len = 0;
+    compiler->source.pos = 0;
+    compiler->source.is_mapped = false;
+    intern_free();
+    free(compiler->main_lexer.lexeme.data);
+    compiler->main_lexer.lexeme = (Lexeme){.data = NULL, .len = 0, .cap = 0};
+    token_buffer_free(&compiler->token_buffer);
 }
 
 void return_token(Token token)
 {
-    Token_stack_push(scanner_stack, token);
+    if (compiler->token_ring.cursor > 0)
+    {
+        // the returned token takes the place of the one it was read as
+        compiler->token_ring.cursor--;
+    }
+    else
+    {
+        // nothing has been read yet, the token is put in front of the ring
+        if (compiler->token_ring.count == compiler->token_ring.cap)
+        {
+            token_ring_grow();
+        }
+        compiler->token_ring.first = (compiler->token_ring.first - 1) & (compiler->token_ring.cap - 1);
+        compiler->token_ring.count++;
+    }
+    *token_ring_at(compiler->token_ring.cursor) = token;
+}
+
+/**
+ * Appends the token to the token buffer, the arrays grow geometrically
+ */
+/**
+ * Grows the arrays of the buffer so the count of tokens fits in
+ */
+static void token_buffer_reserve(Token_buffer *buffer, size_t count)
+{
+    if (count > buffer->cap)
+    {
+        size_t cap = buffer->cap == 0 ? TOKEN_BUFFER_INITIAL_SIZE : buffer->cap * 2;
+        while (cap < count)
+        {
+            cap *= 2;
+        }
+        Token_type *types = realloc(buffer->types, sizeof(Token_type) * cap);
+        uint32_t *offsets = realloc(buffer->offsets, sizeof(uint32_t) * cap);
+        uint32_t *lengths = realloc(buffer->lengths, sizeof(uint32_t) * cap);
+        char **values = realloc(buffer->values, sizeof(char *) * cap);
+        Literal **literals = realloc(buffer->literals, sizeof(Literal *) * cap);
+        int *lines = realloc(buffer->lines, sizeof(int) * cap);
+        uint64_t *nl_bits = realloc(buffer->nl_bits, sizeof(uint64_t) * (cap / 64));
+        if (types == NULL || offsets == NULL || lengths == NULL || values == NULL || literals == NULL || lines == NULL || nl_bits == NULL)
+        {
+            throw_error(INTERNAL_ERR, -1, "Memory allocation for token buffer failed.");
+        }
+        buffer->types = types;
+        buffer->offsets = offsets;
+        buffer->lengths = lengths;
+        buffer->values = values;
+        buffer->literals = literals;
+        buffer->lines = lines;
+        buffer->nl_bits = nl_bits;
+        buffer->cap = cap;
+    }
+}
+
+static void token_buffer_push(Token_buffer *buffer, Token *token, size_t offset, size_t length)
+{
+    token_buffer_reserve(buffer, buffer->count + 1);
+
+    size_t i = buffer->count++;
+    buffer->types[i] = token->type;
+    buffer->offsets[i] = (uint32_t)offset;
+    buffer->lengths[i] = (uint32_t)length;
+    buffer->values[i] = token->token_value;
+    buffer->literals[i] = token->literal;
+    buffer->lines[i] = token->line_num;
+    if (i % 64 == 0)
+    {
+        buffer->nl_bits[i / 64] = 0;
+    }
+    buffer->nl_bits[i / 64] |= (uint64_t)token->preceded_by_nl << (i % 64);
+}
+
+/**
+ * Returns the token at the position of the buffer without checking for errors
+ */
+static inline Token token_buffer_at(Token_buffer *buffer, size_t pos)
+{
+    return (Token){
+        .type = buffer->types[pos],
+        .token_value = buffer->values[pos],
+        .preceded_by_nl = (buffer->nl_bits[pos / 64] >> (pos % 64)) & 1,
+        .line_num = buffer->lines[pos],
+        .literal = buffer->literals[pos],
+    };
+}
+
+/**
+ * Reads the next token with the lexer and appends it to the buffer, line_delta is added to the line of the token
+ */
+static int lexer_push_token(Lexer *lx, Token_buffer *buffer, Token *token, int line_delta)
+{
+    if (lexer_next(lx, token) != 0)
+    {
+        return LEXICAL_ERR;
+    }
+    // function identifiers are followed by the whitespace skipped while looking for '('
+    size_t end = lx->pos;
+    if (token->type == TOKEN_FUNC_ID)
+    {
+        end = lx->lexeme_start + strlen(token->token_value);
+    }
+    token->line_num += line_delta;
+    token_buffer_push(buffer, token, lx->lexeme_start, end - lx->lexeme_start);
+    return 0;
+}
+
+/**
+ * @brief - Part of the source lexed by one thread. The lexer of every chunk but the last sees the source only up to
+ * the start of the next chunk, so it ends with an EOF token there.
+ * @param lexer - lexer reading the chunk, the lines are counted from 1 at the start of the chunk
+ * @param start - index where the chunk starts
+ * @param tokens - tokens read in the chunk
+ * @param error_pos - count of tokens read before the lexical error, SIZE_MAX if there is none
+ * @param ctx - compilation the chunk belongs to, the identifiers are interned into it
+ * @param thread - thread lexing the chunk
+ */
+typedef struct
+{
+    Lexer lexer;
+    size_t start;
+    Token_buffer tokens;
+    size_t error_pos;
+    Compiler *ctx;
+    pthread_t thread;
+} Lex_chunk;
+
+static void *lex_chunk(void *arg)
+{
+    Lex_chunk *chunk = arg;
+    compiler = chunk->ctx;
+    // the errors thrown while lexing are handed over to the thread running the compilation, the chunk just ends
+    jmp_buf on_error;
+    helper_on_error = &on_error;
+    if (setjmp(on_error) == 0)
+    {
+        Token token;
+        do
+        {
+            if (lexer_push_token(&chunk->lexer, &chunk->tokens, &token, 0) != 0)
+            {
+                chunk->error_pos = chunk->tokens.count;
+                break;
+            }
+        } while (token.type != TOKEN_EOF);
+    }
+    helper_on_error = NULL;
+    return NULL;
+}
+
+/**
+ * Drops the tokens of the buffer from the position on, the newline bits of the dropped tokens are cleared
+ */
+static void token_buffer_truncate(Token_buffer *buffer, size_t count)
+{
+    if (count % 64 != 0)
+    {
+        buffer->nl_bits[count / 64] &= ((uint64_t)1 << (count % 64)) - 1;
+    }
+    buffer->count = count;
+}
+
+/**
+ * Appends the tokens of the chunk, their lines are moved by line_delta. The arrays are copied in blocks, the tokens
+ * of a chunk starting the empty buffer are taken over without copying.
+ */
+static void lex_chunk_append(Lex_chunk *chunk, int line_delta)
+{
+    Token_buffer *buffer = &compiler->token_buffer;
+    Token_buffer *tokens = &chunk->tokens;
+    if (buffer->count == 0 && line_delta == 0)
+    {
+        // the arrays are swapped, the chunk frees the empty ones of the buffer
+        Token_buffer taken = *tokens;
+        *tokens = (Token_buffer){.types = buffer->types, .offsets = buffer->offsets, .lengths = buffer->lengths,
+                                 .values = buffer->values, .literals = buffer->literals, .lines = buffer->lines,
+                                 .nl_bits = buffer->nl_bits, .count = 0, .cap = buffer->cap};
+        buffer->types = taken.types;
+        buffer->offsets = taken.offsets;
+        buffer->lengths = taken.lengths;
+        buffer->values = taken.values;
+        buffer->literals = taken.literals;
+        buffer->lines = taken.lines;
+        buffer->nl_bits = taken.nl_bits;
+        buffer->count = taken.count;
+        buffer->cap = taken.cap;
+        return;
+    }
+    if (tokens->count == 0)
+    {
+        return;
+    }
+    size_t count = tokens->count, at = buffer->count;
+    token_buffer_reserve(buffer, at + count);
+    memcpy(buffer->types + at, tokens->types, sizeof(Token_type) * count);
+    memcpy(buffer->offsets + at, tokens->offsets, sizeof(uint32_t) * count);
+    memcpy(buffer->lengths + at, tokens->lengths, sizeof(uint32_t) * count);
+    memcpy(buffer->values + at, tokens->values, sizeof(char *) * count);
+    memcpy(buffer->literals + at, tokens->literals, sizeof(Literal *) * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        buffer->lines[at + i] = tokens->lines[i] + line_delta;
+    }
+    // the bits above the count are clear, the words of the chunk are shifted to the position they are appended at
+    unsigned int shift = at % 64;
+    for (size_t w = 0; w * 64 < count; w++)
+    {
+        uint64_t bits = tokens->nl_bits[w];
+        if (count - w * 64 < 64)
+        {
+            bits &= ((uint64_t)1 << (count - w * 64)) - 1;
+        }
+        size_t dst = at / 64 + w;
+        if (shift == 0)
+        {
+            buffer->nl_bits[dst] = bits;
+        }
+        else
+        {
+            buffer->nl_bits[dst] |= bits << shift;
+            if ((dst + 1) * 64 < at + count)
+            {
+                buffer->nl_bits[dst + 1] = bits >> (64 - shift);
+            }
+        }
+    }
+    buffer->count = at + count;
+}
+
+size_t scan_skip_literal(const char *data, size_t pos, size_t len)
+{
+    if (data[pos] == '/' && pos + 1 < len && data[pos + 1] == '/')
+    {
+        // the newline ending the comment is not a part of it
+        return scan_find_any(data, pos + 2, len, "\n", 1);
+    }
+    if (data[pos] == '/' && pos + 1 < len && data[pos + 1] == '*')
+    {
+        pos += 2;
+        do
+        {
+            pos = scan_find_any(data, pos, len, "*", 1) + 1;
+        } while (pos < len && data[pos] != '/');
+        return pos < len ? pos + 1 : len;
+    }
+    if (data[pos] == '"' && pos + 2 < len && data[pos + 1] == '"' && data[pos + 2] == '"')
+    {
+        // block string, till the next """ that is not escaped
+        pos += 3;
+        while (pos < len)
+        {
+            pos = scan_find_any(data, pos, len, "\"\\", 2);
+            if (pos < len && data[pos] == '\\')
+            {
+                pos += 2;
+            }
+            else if (pos + 2 < len && data[pos + 1] == '"' && data[pos + 2] == '"')
+            {
+                return pos + 3;
+            }
+            else
+            {
+                pos++;
+            }
+        }
+        return len;
+    }
+    if (data[pos] == '"')
+    {
+        // string, a newline ends it as it ends the string with an error in the lexer
+        pos++;
+        while (pos < len)
+        {
+            pos = scan_find_any(data, pos, len, "\"\\\n", 3);
+            if (pos < len && data[pos] == '\\')
+            {
+                pos += 2;
+                continue;
+            }
+            return pos < len && data[pos] == '"' ? pos + 1 : pos;
+        }
+        return len;
+    }
+    return pos + 1;
+}
+
+/**
+ * Finds where the chunks start, at most count - 1 positions are written to starts and their count is returned. The
+ * source is walked once and only the characters opening and closing the strings and the comments are looked at, so
+ * the newlines found are outside of them. A chunk starts at the first character after the spaces following such a
+ * newline, unless it is '(' - the identifier before the newline would be a function identifier then.
+ */
+static int lex_chunk_starts(const char *data, size_t pos, size_t len, size_t *starts, int count)
+{
+    size_t first = pos;
+    int found = 0;
+    while (found < count - 1 && pos < len)
+    {
+        size_t target = first + (len - first) / count * (found + 1);
+        if (pos < target)
+        {
+            // the newlines before the part of the source the chunk is to start in are not looked at
+            pos = scan_find_any(data, pos, target, "\"/", 2);
+            if (pos == target)
+            {
+                continue;
+            }
+        }
+        else
+        {
+            pos = scan_find_any(data, pos, len, "\"/\n", 3);
+            if (pos >= len)
+            {
+                break;
+            }
+        }
+        if (data[pos] == '\n')
+        {
+            size_t start = pos + 1;
+            while (start < len && isspace((unsigned char)data[start]))
+            {
+                start++;
+            }
+            if (start < len && data[start] != '(')
+            {
+                starts[found++] = start;
+            }
+            pos = start;
+        }
+        else
+        {
+            pos = scan_skip_literal(data, pos, len);
+        }
+    }
+    return found;
+}
+
+/**
+ * Frees the chunks with their lexemes and tokens
+ */
+static void lex_chunks_free(Lex_chunk *chunks, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        free(chunks[i].lexer.lexeme.data);
+        token_buffer_free(&chunks[i].tokens);
+    }
+    free(chunks);
+}
+
+/**
+ * Lexes the source in chunks on several threads. The chunks start where lex_chunk_starts finds the boundaries of the
+ * tokens, and the lexer of each chunk but the last sees the source only up to the start of the next one. A token
+ * crossing the end of such a lexer would be cut, and every cut token is a lexical error: only strings and comments
+ * go on over a newline, and a function identifier can only be followed by '(' which does not start a chunk. So a
+ * chunk that ends without an error has ended between two tokens and the next chunk is joined right after it, the
+ * lines are moved and the EOF of the cut is dropped. The first chunk ending with an error is read again with the
+ * whole source, the error may have been made by the cut.
+ */
+static void pretokenize_parallel(int threads)
+{
+    Lex_chunk *chunks = calloc((size_t)threads, sizeof(Lex_chunk));
+    size_t *starts = malloc(sizeof(size_t) * (size_t)threads);
+    if (chunks == NULL || starts == NULL)
+    {
+        throw_error(INTERNAL_ERR, -1, "Memory allocation for token buffer failed.");
+    }
+
+    const char *data = compiler->source.data;
+    size_t len = compiler->source.len;
+    int chunk_cnt = 1 + lex_chunk_starts(data, compiler->main_lexer.pos, len, starts, threads);
+    for (int i = 0; i < chunk_cnt; i++)
+    {
+        Lex_chunk *chunk = &chunks[i];
+        lexer_init(&chunk->lexer, data, i < chunk_cnt - 1 ? starts[i] : len);
+        chunk->start = i == 0 ? compiler->main_lexer.pos : starts[i - 1];
+        chunk->lexer.pos = chunk->start;
+        if (i == 0)
+        {
+            // the first chunk continues where the main lexer is
+            chunk->lexer.line_num = compiler->main_lexer.line_num;
+        }
+        chunk->error_pos = SIZE_MAX;
+        chunk->ctx = compiler;
+    }
+
+    intern_set_concurrent(true);
+    int started = 1;
+    while (started < chunk_cnt &&
+           pthread_create(&chunks[started].thread, NULL, lex_chunk, &chunks[started]) == 0)
+    {
+        started++;
+    }
+    // this thread lexes the first chunk and the chunks no thread has been started for
+    lex_chunk(&chunks[0]);
+    for (int i = started; i < chunk_cnt; i++)
+    {
+        lex_chunk(&chunks[i]);
+    }
+    for (int i = 1; i < started; i++)
+    {
+        pthread_join(chunks[i].thread, NULL);
+    }
+    intern_set_concurrent(false);
+    if (compiler->helper_error.code != NO_ERR)
+    {
+        lex_chunks_free(chunks, chunk_cnt);
+        free(starts);
+        throw_helper_error();
+    }
+
+    Token_buffer *buffer = &compiler->token_buffer;
+    int line_delta = 0;
+    size_t chunk_at = 0; // position of the first token of the last chunk joined
+    size_t total = 0;
+    for (int j = 0; j < chunk_cnt; j++)
+    {
+        total += chunks[j].tokens.count;
+    }
+    // the arrays taken over from the first chunk are grown once for the tokens of all the chunks
+    token_buffer_reserve(&chunks[0].tokens, total);
+    lex_chunk_append(&chunks[0], 0);
+    int i = 1;
+    for (; i < chunk_cnt && chunks[i - 1].error_pos == SIZE_MAX; i++)
+    {
+        // the EOF of the cut is replaced by the first token of the chunk, which follows the newline of the start
+        line_delta += (int)chunks[i - 1].lexer.line_num - 1;
+        token_buffer_truncate(buffer, buffer->count - 1);
+        chunk_at = buffer->count;
+        lex_chunk_append(&chunks[i], line_delta);
+        if (buffer->count > chunk_at)
+        {
+            buffer->nl_bits[chunk_at / 64] |= (uint64_t)1 << (chunk_at % 64);
+        }
+    }
+
+    Lexer *lx = &chunks[i - 1].lexer;
+    if (lx->len < len && chunks[i - 1].error_pos != SIZE_MAX)
+    {
+        // the rest is read by one lexer that sees the whole source
+        Lex_chunk *chunk = &chunks[i - 1];
+        token_buffer_truncate(buffer, chunk_at);
+        lx->len = len;
+        lx->pos = chunk->start;
+        lx->state = NEW_TOKEN;
+        lx->line_num = i == 1 ? compiler->main_lexer.line_num : 1;
+        Token token;
+        chunk->error_pos = SIZE_MAX;
+        do
+        {
+            if (lexer_push_token(lx, buffer, &token, line_delta) != 0)
+            {
+                chunk->error_pos = buffer->count;
+                break;
+            }
+            if (i > 1 && buffer->count == chunk_at + 1)
+            {
+                buffer->nl_bits[chunk_at / 64] |= (uint64_t)1 << (chunk_at % 64);
+            }
+        } while (token.type != TOKEN_EOF);
+    }
+    if (chunks[i - 1].error_pos != SIZE_MAX)
+    {
+        buffer->error_pos = buffer->count;
+        buffer->error_line = (int)lx->line_num + line_delta;
+    }
+    compiler->main_lexer.pos = lx->pos;
+    compiler->main_lexer.line_num = lx->line_num + line_delta;
+
+    lex_chunks_free(chunks, chunk_cnt);
+    free(starts);
+}
+
+void scanner_pretokenize(int threads)
+{
+    compiler->token_buffer.count = 0;
+    compiler->token_buffer.pos = 0;
+    compiler->token_buffer.error_pos = SIZE_MAX;
+    compiler->token_buffer.is_active = true;
+
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads == 0)
+    {
+        // small inputs are not worth starting the threads
+        threads = compiler->source.len >= PARALLEL_LEX_MIN_SIZE && processors > 1 ? (int)processors : 1;
+    }
+    else if (processors > 0 && threads > processors)
+    {
+        // the chunks beyond the processors do not run at once, they only add overlaps to lex again and streams to join
+        threads = (int)processors;
+    }
+    if (threads > 1 && compiler->main_lexer.pos < compiler->source.len)
+    {
+        pretokenize_parallel(threads);
+        return;
+    }
+
+    Token token;
+    do
+    {
+        if (lexer_push_token(&compiler->main_lexer, &compiler->token_buffer, &token, 0) != 0)
+        {
+            // the error is reported once the parser gets to it
+            compiler->token_buffer.error_pos = compiler->token_buffer.count;
+            compiler->token_buffer.error_line = compiler->main_lexer.line_num;
+            break;
+        }
+    } while (token.type != TOKEN_EOF);
+}
+
+void scanner_take_tokens(Token_buffer *tokens, size_t count, int line_delta)
+{
+    if (!compiler->token_buffer.is_active)
+    {
+        compiler->token_buffer.count = 0;
+        compiler->token_buffer.pos = 0;
+        compiler->token_buffer.error_pos = SIZE_MAX;
+        compiler->token_buffer.is_active = true;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        Token token = token_buffer_at(tokens, i);
+        token.line_num += line_delta;
+        token.preceded_by_nl = token.preceded_by_nl || i == 0;
+        token_buffer_push(&compiler->token_buffer, &token, tokens->offsets[i], tokens->lengths[i]);
+    }
+    token_buffer_free(tokens);
+}
+
+Token token_buffer_get(size_t pos)
+{
+    if (pos >= compiler->token_buffer.error_pos || pos >= compiler->token_buffer.count)
+    {
+        // an invalid token or reading past EOF
+        throw_error(LEXICAL_ERR, pos == compiler->token_buffer.error_pos ? compiler->token_buffer.error_line : (int)compiler->main_lexer.line_num, "Lexical error.")
+    }
+    return token_buffer_at(&compiler->token_buffer, pos);
+}
+
+bool token_stream_peek(size_t k, Token *token)
+{
+    // the tokens the ring has read ahead come first, the buffer continues after them
+    size_t unread = compiler->token_ring.count - compiler->token_ring.cursor;
+    if (k < unread)
+    {
+        *token = *token_ring_at(compiler->token_ring.cursor + k);
+        return true;
+    }
+    size_t pos = compiler->token_buffer.pos + (k - unread);
+    if (!compiler->token_buffer.is_active || pos >= compiler->token_buffer.count || pos >= compiler->token_buffer.error_pos)
+    {
+        return false;
+    }
+    *token = token_buffer_at(&compiler->token_buffer, pos);
+    return true;
 }
 
 void free_scanner_stack()
 {
-    Token_stack_free(scanner_stack);
+    free(compiler->token_ring.tokens);
+    compiler->token_ring.tokens = NULL;
+    compiler->token_ring.cap = 0;
+    compiler->token_ring.first = 0;
+    compiler->token_ring.count = 0;
+    compiler->token_ring.cursor = 0;
 }
\ No newline at end of file
@@ -11,38 +11,31 @@
 
 #include "error.h"
 #include <stdbool.h>
-#include "stack.h"
+#include <stdint.h>
+#include <stddef.h>
 #include "debug.h"
+#include "intern.h"
 
 /**
  * Enumeration to represent different states of the scanner.
+ * Tokens other than strings are recognised by the table driven automaton (scan_match) from NEW_TOKEN.
  */
 typedef enum
 {
     NEW_TOKEN,           // 0
-    COMMENTARY,          // 1
-    COMMENTARY_BL,       // 2
-    UNDERSCORE,          // 3
-    END_STATE,           // 4
-    INTEGER,             // 5
-    DEC_POINT,           // 6
-    EXP_START,           // 7
-    STRING,              // 8
-    STRING_ESCAPE,       // 9
-    STRING_1,            // 10
-    STRING_2,            // 11
-    STRING_3,            // 12
-    STRING_1_END,        // 13
-    STRING_2_END,        // 14
-    STRING_BLOCK,        // 15
-    STRING_BLOCK_ESCAPE, // 16
-    HEX_START_BLOCK,     // 17
-    HEX_START,           // 18
-    IDENTIFICATOR,       // 19
+    END_STATE,           // 1
+    STRING,              // 2
+    STRING_ESCAPE,       // 3
+    STRING_1,            // 4
+    STRING_2,            // 5
+    STRING_1_END,        // 6
+    STRING_2_END,        // 7
+    STRING_BLOCK,        // 8
+    STRING_BLOCK_ESCAPE, // 9
+    HEX_START_BLOCK,     // 10
+    HEX_START,           // 11
 } Scanner_state;
 
-extern unsigned int line_num;
-
 /**
  * Enumeration to represent different token types.
  */
@@ -102,12 +95,30 @@ typedef enum
     TOKEN_UNSHIFT,         // > 51
 } Token_type;
 
+/**
+ * @brief - Value of a literal decoded once when it is read, so it need not be parsed again
+ * @param value - decoded number, int_value for TOKEN_INT and double_value for TOKEN_DOUBLE and TOKEN_EXP
+ * @param operand_len - length of operand
+ * @param operand - IFJcode23 operand of the literal (int@1, float@0x1p+0, string@a\032b) terminated by '\0'
+ */
+typedef struct
+{
+    union
+    {
+        int64_t int_value;
+        double double_value;
+    } value;
+    size_t operand_len;
+    char operand[];
+} Literal;
+
 /**
  * @brief - Used to store token type and token value read from stdin
  * @param type - type of token
  * @param token_value - value of the token
  * @param preceded_by_nl - bool flag to indicate whether the token has been preceded by newline character
  * @param line_num - number of the line in stdin file
+ * @param literal - decoded value of int, double and string literals read from the source, NULL otherwise
  */
 typedef struct
 {
@@ -115,11 +126,9 @@ typedef struct
     char *token_value;
     bool preceded_by_nl;
     int line_num;
+    Literal *literal;
 } Token;
 
-// STACK FUNCTIONS
-DECLARE_STACK_FUNCTIONS(Token);
-
 /**
  * @brief - Used to define keywords and builtin functions with their particular tokens
  * @param code - value of the token
@@ -132,31 +141,170 @@ typedef struct
 } Token_map;
 
 /**
- * Declaration of token map of builtin functions and keywords
+ * @brief - Source code the scanner reads from, the whole input is kept in memory
+ * @param data - characters of the source code
+ * @param len - count of characters in data
+ * @param pos - index of the next character to be read
+ * @param is_mapped - true if data is mapped from a file, false if it has been allocated
+ */
+typedef struct
+{
+    char *data;
+    size_t len;
+    size_t pos;
+    bool is_mapped;
+} Scanner_source;
+
+/**
+ * @brief Looks up the keyword in the perfect hash table generated by utils/create_keyword_table.py
+ * @param code lexeme of the identifier
+ * @param len length of the lexeme
+ * @param type pointer where the token type of the keyword will be stored
+ * @return true if the lexeme is a keyword, false otherwise
+ */
+bool keyword_lookup(const char *code, size_t len, Token_type *type);
+
+/**
+ * Actions run when the token automaton stops, the automaton is generated by utils/create_scanner_table.py
+ */
+typedef enum
+{
+    SCAN_ERROR,         // no token matches
+    SCAN_EOF,           // end of input
+    SCAN_WHITESPACE,    // run of whitespace
+    SCAN_LINE_COMMENT,  // '//' starting a line commentary
+    SCAN_BLOCK_COMMENT, // '/' + '*' starting a block commentary
+    SCAN_TOKEN,         // operator or bracket, the value is constant
+    SCAN_STRING,        // '"' starting a string
+    SCAN_NUMBER,        // integer, decimal number or number with exponent
+    SCAN_IDENTIFIER,    // identifier, keyword or function identifier
+    SCAN_UNDERSCORE,    // lone '_'
+} Scan_action;
+
+/**
+ * @brief - Accepting state of the token automaton
+ * @param action - action to run
+ * @param type - token type
+ * @param value - constant value of the token, NULL if it is read from the source
+ */
+typedef struct
+{
+    Scan_action action;
+    Token_type type;
+    const char *value;
+} Scan_accept;
+
+#define SCAN_SEPARATOR_FOLLOWS 1 // flag of scan_separator, the character may follow any token
+#define SCAN_SEPARATOR_ENDS 2    // flag of scan_separator, token ending with the character may be followed by anything
+
+/**
+ * Flags of characters that separate tokens, indexed by the character
+ */
+extern const uint8_t scan_separator[256];
+
+/**
+ * @brief Runs the token automaton from the position for the longest match
+ * @param data characters of the source code
+ * @param pos index where the token starts
+ * @param len count of characters in data, reading past the end yields EOF
+ * @param end index after the match will be stored here
+ * @return accepting state the automaton stopped in, its action is SCAN_ERROR if the match is not a token
+ */
+const Scan_accept *scan_match(const char *data, size_t pos, size_t len, size_t *end);
+
+/**
+ * @brief - Characters of the token being read, the length is tracked explicitly so appending is O(1)
+ * @param data - characters of the lexeme, not terminated
+ * @param len - count of characters in data
+ * @param cap - allocated size of data
+ */
+typedef struct
+{
+    char *data;
+    size_t len;
+    size_t cap;
+} Lexeme;
+
+/**
+ * @brief - State of one lexer, several lexers may read different parts of the same source at once
+ * @param data - characters of the source code
+ * @param len - count of characters in data
+ * @param pos - index of the next character to be read
+ * @param state - current state of the finite state machine
+ * @param line_num - number of the line being read
+ * @param ret - error code of the last read token
+ * @param lexeme - characters of the token being read, the buffer is reused by all the tokens
+ * @param lexeme_start - index of the first character of the last token in data
+ */
+typedef struct
+{
+    const char *data;
+    size_t len;
+    size_t pos;
+    Scanner_state state;
+    unsigned int line_num;
+    int ret;
+    Lexeme lexeme;
+    size_t lexeme_start;
+} Lexer;
+
+/**
+ * @brief Prepares the lexer to read the characters from the beginning
+ * @param lx lexer to initialize
+ * @param data characters of the source code
+ * @param len count of characters in data
  */
-extern Token_map defined_tokens[];
+void lexer_init(Lexer *lx, const char *data, size_t len);
 
 /**
  * @brief Generates the next token from the input code.
  * This function implements a finite state machine to recognize different tokens in the input code.
+ * @param lx lexer to read the token with
+ * @param token A pointer to the Token structure where the generated token information will be stored.
+ * @return Returns an error code if any occurs during lexical analysis.
+ */
+int lexer_next(Lexer *lx, Token *token);
+
+/**
+ * @brief Generates the next token from the source code loaded by scanner_open using main_lexer.
  * @param token A pointer to the Token structure where the generated token information will be stored.
- * @param code A dynamically allocated sequence of characters read from stdin.
  * @return Returns an error code if any occurs during lexical analysis.
  */
-int generate_token(Token *token, char *code);
+int generate_token(Token *token);
 
 /**
- * @brief Function check_lenght is called always when character needs to be added to dynamically allocated
- * char *code which contains all read characters in the same token, if needed the allocated memory is regit resallocated to twice its size
- * @param code_len current count of characters in code
- * @param add count of charactes that need to be added to string code
- * @param code pointer to char * that is being reallocated
+ * @brief Function lexeme_grow reallocates the lexeme buffer to at least twice its size so that add more characters fit in
+ * @param lexeme lexeme that is being reallocated
+ * @param add count of characters that need to be added to the lexeme
  */
-void check_length(int *code_len, int add, char **code);
+void lexeme_grow(Lexeme *lexeme, size_t add);
+
+/**
+ * @brief Appends the characters to the lexeme
+ * @param lexeme lexeme to append to
+ * @param str characters to append
+ * @param len count of characters to append
+ */
+void lexeme_append(Lexeme *lexeme, const char *str, size_t len);
+
+/**
+ * @brief Copies the characters of the lexeme to a new '\0' terminated string, the lexeme buffer is reused for next tokens
+ * @param lexeme lexeme to copy
+ * @return copy of the lexeme, it lives as long as the interned identifiers (released by scanner_close)
+ */
+char *lexeme_take(Lexeme *lexeme);
+
+/**
+ * @brief Writes the string as IFJcode23 string operand, whitespace, '#' and '\\' are written as \ddd escape sequences
+ * @param str string to encode terminated by '\0'
+ * @param out buffer for the encoded string and '\0', only the length is counted if NULL
+ * @return length of the encoded string
+ */
+size_t string_operand_encode(const char *str, char *out);
 
 /**
  * @brief Main function for the scanner to obtain the next token in lexical analysis.
- * This function either generates a new token from the input code or retrieves a token from the scanner stack.
+ * This function reads the next token from the token ring, which generates new tokens from the input code on demand.
  * @param token A pointer to the Token structure where the next token information will be stored.
  * @return Returns 0 if successful, otherwise returns an error code.
  */
@@ -164,27 +312,233 @@ int main_scanner(Token *token);
 
 /**
  * @breif function set_token is called after proper token value and type has been read
+ * @param lx lexer that has read the token
  * @param next_state state in which will scanner be after reading current token
  * @param val character sequence that contains the value of current token
  * @param type one of Token_type enums that will determine the type of the token
  * @param token address to which we are inserting the values type and code
  * @return returns potential error that could occur during lexical analysis
  */
-int set_token(int next_state, char *val, Token_type type, Token *token);
+int set_token(Lexer *lx, int next_state, char *val, Token_type type, Token *token);
 
 /**
- * @brief function initializes scanner stack
+ * @brief function initializes the token ring
  */
 void scanner_init();
 
 /**
- * @brief function pushes token into scanner stack
- * @param token token which is to be pushed into the stack
+ * @brief function loads the source code into memory, regular files are mapped, other inputs are read in blocks
+ * @param path path to the source file, stdin is used if NULL
+ */
+void scanner_open(const char *path);
+
+/**
+ * @brief function uses the source code already loaded in memory
+ * @param data characters of the source code allocated by malloc, scanner_close frees them
+ * @param len count of the characters
+ */
+void scanner_open_buffer(char *data, size_t len);
+
+/**
+ * @brief function uses the source code loaded by an earlier scanner_open or scanner_open_buffer again
+ * @param source the source taken over, scanner_close releases it
+ */
+void scanner_open_source(Scanner_source source);
+
+/**
+ * @brief function releases the source code buffer and the interned identifiers
+ */
+void scanner_close();
+
+/**
+ * @brief Selects the fastest byte searching kernels supported by the CPU (AVX2, SSE2 or scalar)
+ */
+void scan_init();
+
+/**
+ * @brief Finds the first character from the set, 16 or 32 characters are compared at once
+ * @param data searched characters
+ * @param pos index to start at
+ * @param len count of characters in data
+ * @param set characters to look for
+ * @param set_len count of characters in set
+ * @return index of the first found character, len if there is none
+ */
+size_t scan_find_any(const char *data, size_t pos, size_t len, const char *set, int set_len);
+
+/**
+ * @brief Finds the first character that is not in the set
+ * @param data searched characters
+ * @param pos index to start at
+ * @param len count of characters in data
+ * @param set characters to skip
+ * @param set_len count of characters in set
+ * @return index of the first character not in the set, len if there is none
+ */
+size_t scan_skip_any(const char *data, size_t pos, size_t len, const char *set, int set_len);
+
+/**
+ * @brief Counts the occurrences of two characters in the range by popcount of the match masks
+ * @param data searched characters
+ * @param from index of the first character of the range
+ * @param to index after the last character of the range
+ * @param a first character to count
+ * @param b second character to count (pass a again to count just one)
+ * @return count of found characters
+ */
+size_t scan_count(const char *data, size_t from, size_t to, char a, char b);
+
+/**
+ * @brief Skips the commentary or the string starting at the position, the way the lexer reads it
+ * @param data searched characters
+ * @param pos index of the character
+ * @param len count of characters in data
+ * @return index after the commentary or the string, pos + 1 if none starts at pos
+ */
+size_t scan_skip_literal(const char *data, size_t pos, size_t len);
+
+/**
+ * @brief - Ring buffer of tokens used for lookahead and backtracking, tokens are read from the scanner on demand
+ * @param tokens - storage of the ring, its size is always a power of two
+ * @param cap - size of tokens
+ * @param first - index of the oldest kept token in tokens
+ * @param count - count of kept tokens (already read ones and the lookahead)
+ * @param cursor - offset of the next token to be read from first
+ * @param dropped - count of tokens forgotten since the beginning, marks are absolute positions
+ * @param marks - count of active marks, no token is forgotten while there is any
+ */
+typedef struct
+{
+    Token *tokens;
+    size_t cap;
+    size_t first;
+    size_t count;
+    size_t cursor;
+    size_t dropped;
+    size_t marks;
+} Token_ring;
+
+/**
+ * @brief Returns the k-th token after the current position without reading it
+ * @param k offset of the token, 0 is the next token
+ * @return pointer to the token, valid until the ring is modified
+ */
+Token *token_ring_peek(size_t k);
+
+/**
+ * @brief Reads the next token
+ * @return the next token
+ */
+Token token_ring_advance();
+
+/**
+ * @brief Remembers the current position so that it can be returned to, must be paired with rewind or release
+ * @return the position to pass to token_ring_rewind
+ */
+size_t token_ring_mark();
+
+/**
+ * @brief Returns the position of the next token, it can be recovered to while a mark before it is active
+ * @return the position to pass to token_ring_recover
+ */
+size_t token_ring_position();
+
+/**
+ * @brief Returns to the marked position, the tokens read since then will be read again
+ * @param mark position returned by token_ring_mark
+ */
+void token_ring_rewind(size_t mark);
+
+/**
+ * @brief Drops the mark without returning to it
+ * @param mark position returned by token_ring_mark
+ */
+void token_ring_release(size_t mark);
+
+/**
+ * @brief Returns to the marked position after an error, the marks of the abandoned code are dropped with it
+ * @param mark position returned by token_ring_mark or token_ring_position, a mark itself is kept
+ * @param marks count of the marks still active
+ */
+void token_ring_recover(size_t mark, size_t marks);
+
+/**
+ * @brief - Whole input tokenized at once, stored as structure of arrays indexed by the token position
+ * @param types - types of the tokens
+ * @param offsets - index of the first character of each token in the source
+ * @param lengths - count of source characters of each token
+ * @param values - values of the tokens (decoded literals, interned identifiers)
+ * @param literals - decoded values and operands of the literals, NULL for other tokens
+ * @param lines - line numbers of the tokens
+ * @param nl_bits - bit i is set if the token i has been preceded by newline
+ * @param count - count of tokens in the buffer
+ * @param cap - allocated size of the arrays
+ * @param pos - position of the next token to be passed to the token ring
+ * @param error_pos - position of the token that could not be read, SIZE_MAX if there is none
+ * @param error_line - line of the lexical error
+ * @param is_active - true if the tokens are read from the buffer instead of the input
+ */
+typedef struct
+{
+    Token_type *types;
+    uint32_t *offsets;
+    uint32_t *lengths;
+    char **values;
+    Literal **literals;
+    int *lines;
+    uint64_t *nl_bits;
+    size_t count;
+    size_t cap;
+    size_t pos;
+    size_t error_pos;
+    int error_line;
+    bool is_active;
+} Token_buffer;
+
+/**
+ * @brief Tokenizes the rest of the input (from where main_lexer is) into token_buffer, the token ring reads from the
+ * buffer from now on.
+ * Large inputs are split between tokens into chunks lexed by several threads, the chunk streams are put one after
+ * another.
+ * Lexical error stops the tokenization and is reported when the parser reaches the invalid token.
+ * @param threads count of threads to lex with, 0 chooses it by the input size and the count of processors
+ */
+void scanner_pretokenize(int threads);
+
+/**
+ * @brief Appends the tokens of another input to token_buffer and releases their buffer, the token ring reads from
+ * token_buffer from now on. The first token appended starts a new line.
+ * @param tokens tokens of the other input, empty once they have been appended
+ * @param count count of the tokens to be appended from the beginning of tokens
+ * @param line_delta added to the lines of the appended tokens
+ */
+void scanner_take_tokens(Token_buffer *tokens, size_t count, int line_delta);
+
+/**
+ * @brief Returns the token at the position of the token buffer
+ * @param pos position of the token
+ * @return token at the position
+ */
+Token token_buffer_get(size_t pos);
+
+/**
+ * @brief Returns the k-th token after the current position without reading it and without storing it in the ring.
+ * Unlike token_ring_peek it does not read new tokens, only the ones read ahead by the ring and the token buffer
+ * are available, and it never reports lexical errors.
+ * @param k offset of the token, 0 is the next token
+ * @param token the token will be stored here
+ * @return false if there is no such token (end of the input, lexical error or input not tokenized yet)
+ */
+bool token_stream_peek(size_t k, Token *token);
+
+/**
+ * @brief function returns the last read token back to the token ring
+ * @param token token which is to be returned
  */
 void return_token(Token token);
 
 /**
- * @brief function frees all allocated memory for scanner_stack
+ * @brief function frees all allocated memory for the token ring
  */
 void free_scanner_stack();
 
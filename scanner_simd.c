@@ -0,0 +1,233 @@
+/**
+ * @file scanner_simd.c
+ * @brief Vectorised byte searching used by the scanner to skip comments, whitespace and string bodies.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <pthread.h>
+#include "scanner.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SCAN_X86 1
+#include <immintrin.h>
+#else
+#define SCAN_X86 0
+#endif
+
+/**
+ * Kernels selected at runtime by scan_init
+ */
+static size_t (*find_any_impl)(const char *data, size_t pos, size_t len, const char *set, int set_len) = NULL;
+static size_t (*skip_any_impl)(const char *data, size_t pos, size_t len, const char *set, int set_len) = NULL;
+static size_t (*count_impl)(const char *data, size_t from, size_t to, char a, char b) = NULL;
+
+/// SCALAR KERNELS
+
+static inline bool in_set(char c, const char *set, int set_len)
+{
+    for (int i = 0; i < set_len; i++)
+    {
+        if (c == set[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t find_any_scalar(const char *data, size_t pos, size_t len, const char *set, int set_len)
+{
+    while (pos < len && !in_set(data[pos], set, set_len))
+    {
+        pos++;
+    }
+    return pos;
+}
+
+static size_t skip_any_scalar(const char *data, size_t pos, size_t len, const char *set, int set_len)
+{
+    while (pos < len && in_set(data[pos], set, set_len))
+    {
+        pos++;
+    }
+    return pos;
+}
+
+static size_t count_scalar(const char *data, size_t from, size_t to, char a, char b)
+{
+    size_t cnt = 0;
+    for (size_t i = from; i < to; i++)
+    {
+        cnt += data[i] == a || data[i] == b;
+    }
+    return cnt;
+}
+
+#if SCAN_X86
+
+/// SSE2 KERNELS - 16 bytes per iteration
+
+__attribute__((target("sse2"))) static inline unsigned int match_mask_sse2(const char *data, const char *set, int set_len)
+{
+    __m128i block = _mm_loadu_si128((const __m128i *)data);
+    __m128i match = _mm_setzero_si128();
+    for (int i = 0; i < set_len; i++)
+    {
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(block, _mm_set1_epi8(set[i])));
+    }
+    return (unsigned int)_mm_movemask_epi8(match);
+}
+
+__attribute__((target("sse2"))) static size_t find_any_sse2(const char *data, size_t pos, size_t len, const char *set, int set_len)
+{
+    for (; pos + 16 <= len; pos += 16)
+    {
+        unsigned int mask = match_mask_sse2(data + pos, set, set_len);
+        if (mask != 0)
+        {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return find_any_scalar(data, pos, len, set, set_len);
+}
+
+__attribute__((target("sse2"))) static size_t skip_any_sse2(const char *data, size_t pos, size_t len, const char *set, int set_len)
+{
+    for (; pos + 16 <= len; pos += 16)
+    {
+        unsigned int mask = ~match_mask_sse2(data + pos, set, set_len) & 0xFFFFu;
+        if (mask != 0)
+        {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return skip_any_scalar(data, pos, len, set, set_len);
+}
+
+__attribute__((target("sse2,popcnt"))) static size_t count_sse2(const char *data, size_t from, size_t to, char a, char b)
+{
+    size_t cnt = 0;
+    char set[2] = {a, b};
+    for (; from + 16 <= to; from += 16)
+    {
+        cnt += __builtin_popcount(match_mask_sse2(data + from, set, 2));
+    }
+    return cnt + count_scalar(data, from, to, a, b);
+}
+
+/// AVX2 KERNELS - 32 bytes per iteration
+
+__attribute__((target("avx2"))) static inline unsigned int match_mask_avx2(const char *data, const char *set, int set_len)
+{
+    __m256i block = _mm256_loadu_si256((const __m256i *)data);
+    __m256i match = _mm256_setzero_si256();
+    for (int i = 0; i < set_len; i++)
+    {
+        match = _mm256_or_si256(match, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(set[i])));
+    }
+    return (unsigned int)_mm256_movemask_epi8(match);
+}
+
+__attribute__((target("avx2"))) static size_t find_any_avx2(const char *data, size_t pos, size_t len, const char *set, int set_len)
+{
+    for (; pos + 32 <= len; pos += 32)
+    {
+        unsigned int mask = match_mask_avx2(data + pos, set, set_len);
+        if (mask != 0)
+        {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return find_any_sse2(data, pos, len, set, set_len);
+}
+
+__attribute__((target("avx2"))) static size_t skip_any_avx2(const char *data, size_t pos, size_t len, const char *set, int set_len)
+{
+    for (; pos + 32 <= len; pos += 32)
+    {
+        unsigned int mask = ~match_mask_avx2(data + pos, set, set_len);
+        if (mask != 0)
+        {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return skip_any_sse2(data, pos, len, set, set_len);
+}
+
+__attribute__((target("avx2,popcnt"))) static size_t count_avx2(const char *data, size_t from, size_t to, char a, char b)
+{
+    size_t cnt = 0;
+    char set[2] = {a, b};
+    for (; from + 32 <= to; from += 32)
+    {
+        cnt += __builtin_popcount(match_mask_avx2(data + from, set, 2));
+    }
+    return cnt + count_sse2(data, from, to, a, b);
+}
+
+#endif // SCAN_X86
+
+static pthread_once_t scan_init_once = PTHREAD_ONCE_INIT;
+
+static void select_kernels()
+{
+    find_any_impl = find_any_scalar;
+    skip_any_impl = skip_any_scalar;
+    count_impl = count_scalar;
+#if SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2"))
+    {
+        find_any_impl = find_any_sse2;
+        skip_any_impl = skip_any_sse2;
+        if (__builtin_cpu_supports("popcnt"))
+        {
+            count_impl = count_sse2;
+        }
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    {
+        find_any_impl = find_any_avx2;
+        skip_any_impl = skip_any_avx2;
+        count_impl = count_avx2;
+    }
+#endif
+}
+
+void scan_init()
+{
+    // compilations running on several threads select the kernels once
+    pthread_once(&scan_init_once, select_kernels);
+}
+
+size_t scan_find_any(const char *data, size_t pos, size_t len, const char *set, int set_len)
+{
+    if (find_any_impl == NULL)
+    {
+        scan_init();
+    }
+    return find_any_impl(data, pos, len, set, set_len);
+}
+
+size_t scan_skip_any(const char *data, size_t pos, size_t len, const char *set, int set_len)
+{
+    if (skip_any_impl == NULL)
+    {
+        scan_init();
+    }
+    return skip_any_impl(data, pos, len, set, set_len);
+}
+
+size_t scan_count(const char *data, size_t from, size_t to, char a, char b)
+{
+    if (count_impl == NULL)
+    {
+        scan_init();
+    }
+    return count_impl(data, from, to, a, b);
+}
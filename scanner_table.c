@@ -0,0 +1,162 @@
+/**
+ * @file scanner_table.c
+ * @brief Transition table of the token automaton, generated by utils/create_scanner_table.py - do not edit by hand.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <stdint.h>
+#include "scanner.h"
+
+#define SCAN_CLASS_COUNT 26 // count of character classes, columns of the table
+#define SCAN_STATE_COUNT 39 // count of states, rows of the table
+#define SCAN_START_ROW SCAN_CLASS_COUNT // the first row belongs to the dead state
+
+// character class of every byte
+static const uint8_t scan_char_class[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 2, 3, 0, 0, 0, 4, 0, 5, 6, 7, 8, 9, 10, 11, 12,
+    13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 14, 0, 15, 16, 17, 18,
+    0, 19, 19, 19, 19, 20, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19,
+    19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 0, 0, 0, 0, 21,
+    0, 19, 19, 19, 19, 20, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19,
+    19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 22, 23, 24, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 25,
+};
+
+// offset of the row of the next state for every state and character class, 0 if the automaton stops
+static const uint16_t scan_transitions[SCAN_STATE_COUNT * SCAN_CLASS_COUNT] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 52, 78, 104, 130, 156, 182, 208, 234, 260, 286, 0, 312, 338, 364, 390, 416, 442, 468, 494, 494, 520, 546, 572, 598, 624,
+    0, 52, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 650, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 676, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 702, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 728, 0, 0, 0, 0, 754, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 780, 0, 338, 0, 0, 0, 0, 0, 0, 806, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 832, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 858, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 884, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 910, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 494, 0, 0, 0, 0, 0, 494, 494, 494, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 494, 0, 0, 0, 0, 0, 494, 494, 494, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 936, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 780, 0, 0, 0, 0, 0, 0, 806, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 962, 0, 962, 0, 0, 988, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 988, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 988, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+// action run when the automaton stops in the state
+static const Scan_accept scan_accepts[SCAN_STATE_COUNT] = {
+    {.action = SCAN_ERROR, .type = TOKEN_EOF, .value = NULL},
+    {.action = SCAN_ERROR, .type = TOKEN_EOF, .value = NULL},
+    {.action = SCAN_WHITESPACE, .type = TOKEN_EOF, .value = NULL},
+    {.action = SCAN_TOKEN, .type = TOKEN_NOT, .value = "!"},
+    {.action = SCAN_STRING, .type = TOKEN_STRING, .value = NULL},
+    {.action = SCAN_ERROR, .type = TOKEN_EOF, .value = NULL},
+    {.action = SCAN_TOKEN, .type = TOKEN_L_BRACKET, .value = "("},
+    {.action = SCAN_TOKEN, .type = TOKEN_R_BRACKET, .value = ")"},
+    {.action = SCAN_TOKEN, .type = TOKEN_MUL, .value = "*"},
+    {.action = SCAN_TOKEN, .type = TOKEN_PLUS, .value = "+"},
+    {.action = SCAN_TOKEN, .type = TOKEN_COMMA, .value = ","},
+    {.action = SCAN_TOKEN, .type = TOKEN_MINUS, .value = "-"},
+    {.action = SCAN_TOKEN, .type = TOKEN_DIV, .value = "/"},
+    {.action = SCAN_NUMBER, .type = TOKEN_INT, .value = NULL},
+    {.action = SCAN_TOKEN, .type = TOKEN_DOUBLE_DOT, .value = ":"},
+    {.action = SCAN_TOKEN, .type = TOKEN_LESS, .value = "<"},
+    {.action = SCAN_TOKEN, .type = TOKEN_ASSIGN, .value = "="},
+    {.action = SCAN_TOKEN, .type = TOKEN_MORE, .value = ">"},
+    {.action = SCAN_ERROR, .type = TOKEN_EOF, .value = NULL},
+    {.action = SCAN_IDENTIFIER, .type = TOKEN_IDENTIFICATOR, .value = NULL},
+    {.action = SCAN_UNDERSCORE, .type = TOKEN_IDENTIFICATOR, .value = NULL},
+    {.action = SCAN_TOKEN, .type = TOKEN_L_CURLY, .value = "{"},
+    {.action = SCAN_ERROR, .type = TOKEN_EOF, .value = NULL},
+    {.action = SCAN_TOKEN, .type = TOKEN_R_CURLY, .value = "}"},
+    {.action = SCAN_EOF, .type = TOKEN_EOF, .value = ""},
+    {.action = SCAN_TOKEN, .type = TOKEN_NEQ, .value = "!="},
+    {.action = SCAN_TOKEN, .type = TOKEN_AND, .value = "&&"},
+    {.action = SCAN_TOKEN, .type = TOKEN_ARROW, .value = "->"},
+    {.action = SCAN_BLOCK_COMMENT, .type = TOKEN_EOF, .value = NULL},
+    {.action = SCAN_LINE_COMMENT, .type = TOKEN_EOF, .value = NULL},
+    {.action = SCAN_NUMBER, .type = TOKEN_DOUBLE, .value = NULL},
+    {.action = SCAN_ERROR, .type = TOKEN_EOF, .value = NULL},
+    {.action = SCAN_TOKEN, .type = TOKEN_LESS_EQ, .value = "<="},
+    {.action = SCAN_TOKEN, .type = TOKEN_EQ, .value = "=="},
+    {.action = SCAN_TOKEN, .type = TOKEN_MORE_EQ, .value = ">="},
+    {.action = SCAN_TOKEN, .type = TOKEN_BINARY_OPERATOR, .value = "??"},
+    {.action = SCAN_TOKEN, .type = TOKEN_OR, .value = "||"},
+    {.action = SCAN_ERROR, .type = TOKEN_EOF, .value = NULL},
+    {.action = SCAN_NUMBER, .type = TOKEN_EXP, .value = NULL},
+};
+
+const uint8_t scan_separator[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 3, 1, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, 3, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 3, 3, 0, 3,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 3, 3, 3, 3,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 3, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+};
+
+const Scan_accept *scan_match(const char *data, size_t pos, size_t len, size_t *end)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    unsigned int row = SCAN_START_ROW;
+    while (1)
+    {
+        // the end of the input is read as EOF
+        unsigned int c = pos < len ? bytes[pos] : 0xFF;
+        unsigned int next = scan_transitions[row + scan_char_class[c]];
+        if (next == 0)
+        {
+            break;
+        }
+        row = next;
+        pos++;
+    }
+    *end = pos;
+    return &scan_accepts[row / SCAN_CLASS_COUNT];
+}
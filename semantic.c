@@ -11,6 +11,8 @@
  */
 
 #include "semantic.h"
+#include "compiler.h"
+#include "fold.h"
 
 void sem_start(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
 {
@@ -38,7 +40,7 @@ void sem_var_id(__attribute__((unused)) Token *token, __attribute__((unused)) sy
     }
 
     // check if var is already defined
-    symtable_item *var_id_item = symtable_find(token->token_value, symtable_stack_top(sym_st), false);
+    symtable_item *var_id_item = symtable_find(token->token_value, symtable_stack_top(compiler->sym_st), false);
     if (var_id_item != NULL && var_id_item->data.var_data->is_param == false)
     {
         throw_error(FUNCTIONS_ERR, token->line_num, "Variable %s is already defined!", token->token_value)
@@ -63,7 +65,7 @@ void sem_var_exp(__attribute__((unused)) Token *token, __attribute__((unused)) s
     items->varItem->data.var_data->is_initialized = true;
 
     DEBUG_SEMANTIC_CODE(
-        (symtable_stack_top(sym_st)););
+        (symtable_stack_top(compiler->sym_st)););
 
     // parse expression
     psa_return_type return_type = parse_expression();
@@ -106,12 +108,14 @@ void sem_var_exp(__attribute__((unused)) Token *token, __attribute__((unused)) s
     }
 
     DEBUG_SEMANTIC_CODE(
-        (symtable_stack_top(sym_st)););
+        (symtable_stack_top(compiler->sym_st)););
+
+    items->expr = return_type.expr;
 
     // convert int to float
     if (!check_ret_values(return_type.type, items->varItem->data.var_data->type) && isTypeConvertable(items->varItem->data.var_data->type, return_type.type, return_type.is_literal))
     {
-        generate_instruction(INT2FLOATS);
+        items->expr = fold_expr(ast_unary(AST_INT2DOUBLE, TYPE_DOUBLE, items->expr));
     }
 }
 
@@ -130,12 +134,12 @@ void sem_var_add(__attribute__((unused)) Token *token, __attribute__((unused)) s
     if (items->varItem->data.var_data->is_param == false) // new symbol
     {
         DEBUG_SEMANTIC_CODE(printf(YELLOW "ADDING VAR: %s, type: %d, const: %d\n", items->varItem->id, items->varItem->data.var_data->type, items->varItem->data.var_data->is_const););
-        symtable_add(items->varItem, symtable_stack_top(sym_st));
-        DEBUG_SEMANTIC_CODE(symtable_print(symtable_stack_top(sym_st)););
+        symtable_add(items->varItem, symtable_stack_top(compiler->sym_st));
+        DEBUG_SEMANTIC_CODE(symtable_print(symtable_stack_top(compiler->sym_st)););
     }
     else // is param
     {
-        symtable_item *var_add_item = symtable_find_in_stack(items->varItem->id, sym_st, false);
+        symtable_item *var_add_item = symtable_find_in_stack(items->varItem->id, compiler->sym_st, false);
         var_add_item->data.var_data->type = items->varItem->data.var_data->type;
         var_add_item->data.var_data->is_const = items->varItem->data.var_data->is_const;
         var_add_item->data.var_data->is_initialized = items->varItem->data.var_data->is_initialized;
@@ -146,7 +150,8 @@ void sem_var_add(__attribute__((unused)) Token *token, __attribute__((unused)) s
 void sem_func_id(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
 {
     items->funcItem = init_symtable_item(true);
-    symtable_item *func_id_item = symtable_find_in_stack(token->token_value, sym_st, true);
+    items->funcItem->id = token->token_value;
+    symtable_item *func_id_item = symtable_find_in_stack(token->token_value, compiler->sym_st, true);
 
     // check if function is already defined
     if (func_id_item != NULL) // is in stack
@@ -156,8 +161,6 @@ void sem_func_id(__attribute__((unused)) Token *token, __attribute__((unused)) s
             throw_error(FUNCTIONS_ERR, token->line_num, "Function %s is already defined!\n", token->token_value);
         }
     }
-
-    items->funcItem->id = token->token_value;
 }
 
 void sem_p_name(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
@@ -170,15 +173,15 @@ void sem_p_name(__attribute__((unused)) Token *token, __attribute__((unused)) sy
 
 void sem_p_id(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
 {
-    if (strcmp(token->token_value, items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name) == 0)
-    {
-        throw_error(SEMANTICS_ERR, token->line_num, "Parameter name: '%s' matches parameter id", token->token_value);
-    }
-
     // parameters must be accesible as variables in function's body's scope
     items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id = token->token_value;
     items->varItem = init_symtable_item(false);
     items->varItem->id = token->token_value;
+
+    if (strcmp(token->token_value, items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name) == 0)
+    {
+        throw_error(SEMANTICS_ERR, token->line_num, "Parameter name: '%s' matches parameter id", token->token_value);
+    }
 }
 
 void sem_p_type(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
@@ -186,11 +189,6 @@ void sem_p_type(__attribute__((unused)) Token *token, __attribute__((unused)) sy
 
     items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].type = get_expression_type(token);
 
-    // check param
-    if (items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].name == items->funcItem->data.func_data->params[items->funcItem->data.func_data->params_count - 1].id)
-    {
-        throw_error(FUNCTIONS_ERR, token->line_num, "Parameter name matches parameter id");
-    }
     // check if param is already defined
     for (int i = 0; i < items->funcItem->data.func_data->params_count - 1; i++)
     {
@@ -211,13 +209,13 @@ void sem_func_header_done(__attribute__((unused)) Token *token, __attribute__((u
 {
     // adds function to symtable
     DEBUG_SEMANTIC_CODE(printf(YELLOW "ADDING FUNC: %s, return type: %d\n", items->funcItem->id, items->funcItem->data.func_data->return_type););
-    symtable_add(items->funcItem, symtable_stack_top(sym_st));
-    DEBUG_SEMANTIC_CODE(symtable_print(symtable_stack_top(sym_st)););
+    symtable_add(items->funcItem, symtable_stack_top(compiler->sym_st));
+    DEBUG_SEMANTIC_CODE(symtable_print(symtable_stack_top(compiler->sym_st)););
 
     // push scope
     DEBUG_SEMANTIC_CODE(printf(RED "PUSH_SCOPE\n" RESET););
     symtable symtable = symtable_init();
-    symtable_stack_push(sym_st, symtable);
+    symtable_stack_push(compiler->sym_st, symtable);
 
     // add params as vars to new scope
     if (items->funcItem->data.func_data->params_count <= 0) // no params
@@ -234,11 +232,11 @@ void sem_func_header_done(__attribute__((unused)) Token *token, __attribute__((u
             items->varItem->data.var_data->is_const = true;
             items->varItem->data.var_data->is_initialized = true;
             items->varItem->data.var_data->is_param = true;
-            symtable_add(items->varItem, symtable_stack_top(sym_st));
+            symtable_add(items->varItem, symtable_stack_top(compiler->sym_st));
             DEBUG_SEMANTIC_CODE(printf(YELLOW "ADDING VAR TO FUNCTIONS: %s, type: %d, const: %d\n", items->varItem->id, items->varItem->data.var_data->type, items->varItem->data.var_data->is_const););
         }
     }
-    DEBUG_SEMANTIC_CODE(symtable_print(symtable_stack_top(sym_st)););
+    DEBUG_SEMANTIC_CODE(symtable_print(symtable_stack_top(compiler->sym_st)););
 }
 
 void sem_push_scope(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
@@ -246,13 +244,13 @@ void sem_push_scope(__attribute__((unused)) Token *token, __attribute__((unused)
 
     DEBUG_SEMANTIC_CODE(printf(RED "PUSH_SCOPE\n" RESET););
     symtable symtable = symtable_init();
-    symtable_stack_push(sym_st, symtable);
+    symtable_stack_push(compiler->sym_st, symtable);
 }
 
 void sem_pop_scope(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
 {
     DEBUG_SEMANTIC_CODE(printf(RED "POP_SCOPE\n"););
-    symtable symt = symtable_stack_pop(sym_st);
+    symtable symt = symtable_stack_pop(compiler->sym_st);
 
     // return checking logic
     //
@@ -278,17 +276,17 @@ void sem_pop_scope(__attribute__((unused)) Token *token, __attribute__((unused))
     if (items->funcItem != NULL)
     {
         // process self
-        symtable_stack_top(sym_st)->found_return = (symt->all_children_return && symt->found_else) || symt->found_return;
+        symtable_stack_top(compiler->sym_st)->found_return = (symt->all_children_return && symt->found_else) || symt->found_return;
 
         // process lower scope
-        symtable_stack_top(sym_st)->found_return &= symt->found_return; // bitwise AND assing
-        symtable_stack_top(sym_st)->found_else = symt->found_else;
+        symtable_stack_top(compiler->sym_st)->found_return &= symt->found_return; // bitwise AND assing
+        symtable_stack_top(compiler->sym_st)->found_else = symt->found_else;
     }
 }
 
 void sem_func_if_start(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
 {
-    symtable_stack_top(sym_st)->found_else = false;
+    symtable_stack_top(compiler->sym_st)->found_else = false;
 }
 
 void sem_r_exp(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
@@ -309,7 +307,8 @@ void sem_r_exp(__attribute__((unused)) Token *token, __attribute__((unused)) sym
         throw_error(PARAM_TYPE_ERR, token->line_num, "Expression type: %d and return type: %d of function: %s do not match!\n", return_type2.type, items->funcItem->data.func_data->return_type, items->funcItem->id);
     }
 
-    symtable_stack_top(sym_st)->found_return = true;
+    items->expr = return_type2.expr;
+    symtable_stack_top(compiler->sym_st)->found_return = true;
     DEBUG_SEMANTIC_CODE(print_expression_type(return_type2.type););
 }
 
@@ -317,7 +316,7 @@ void sem_cond_exp(__attribute__((unused)) Token *token, __attribute__((unused))
 {
 
     DEBUG_SEMANTIC_CODE(printf(CYAN "COND EXP: %s\n", token->token_value);
-                        symtable_print(symtable_stack_top(sym_st)););
+                        symtable_print(symtable_stack_top(compiler->sym_st)););
 
     psa_return_type return_type3 = parse_expression();
 
@@ -331,20 +330,26 @@ void sem_cond_exp(__attribute__((unused)) Token *token, __attribute__((unused))
     {
         throw_error(COMPATIBILITY_ERR, token->line_num, "Expression type: %d and type: %d of variable: %s do not match!\n", return_type3.type, TYPE_BOOL, items->varItem->id);
     }
+    items->expr = return_type3.expr;
 
     DEBUG_SEMANTIC_CODE(print_expression_type(return_type3.type););
 }
 
 void sem_func_else(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
 {
-    symtable_stack_top(sym_st)->found_else = true;
+    symtable_stack_top(compiler->sym_st)->found_else = true;
 }
 
 void sem_let_in_if(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
 {
 
     items->varItem = init_symtable_item(false);
-    symtable_item *let_in_if_item = symtable_find_in_stack(token->token_value, sym_st, false);
+    symtable_item *let_in_if_item = symtable_find_in_stack(token->token_value, compiler->sym_st, false);
+
+    // push new scope, the body is parsed in it even if the check fails
+    DEBUG_SEMANTIC_CODE(printf(RED "PUSH_SCOPE\n" RESET););
+    symtable symtable = symtable_init();
+    symtable_stack_push(compiler->sym_st, symtable);
 
     if (let_in_if_item == NULL || let_in_if_item->data.var_data->is_const == false)
     {
@@ -375,30 +380,25 @@ void sem_let_in_if(__attribute__((unused)) Token *token, __attribute__((unused))
     items->varItem->data.var_data->is_initialized = true;
     items->varItem->data.var_data->is_param = false;
 
-    // push new scope
-    DEBUG_SEMANTIC_CODE(printf(RED "PUSH_SCOPE\n" RESET););
-    symtable symtable = symtable_init();
-    symtable_stack_push(sym_st, symtable);
-
     // add var to new scope
-    symtable_add(items->varItem, symtable_stack_top(sym_st));
+    symtable_add(items->varItem, symtable_stack_top(compiler->sym_st));
 
-    DEBUG_SEMANTIC_CODE(symtable_print(symtable_stack_top(sym_st)););
+    DEBUG_SEMANTIC_CODE(symtable_print(symtable_stack_top(compiler->sym_st)););
 }
 
 void sem_func_body_done(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
 {
 
-    symtable_item *func_body_item = symtable_find_in_stack(items->funcItem->id, sym_st, true);
-    if (symtable_stack_top(sym_st)->found_return == false && func_body_item->data.func_data->return_type != TYPE_EMPTY)
+    symtable_item *func_body_item = symtable_find_in_stack(items->funcItem->id, compiler->sym_st, true);
+    if (symtable_stack_top(compiler->sym_st)->found_return == false && func_body_item->data.func_data->return_type != TYPE_EMPTY)
     {
         throw_error(PARAM_TYPE_ERR, token->line_num, "Function %s of type: %d does not have a return statement!\n", items->funcItem->id, func_body_item->data.func_data->return_type);
     }
 
     // reset atributtes for checking return logic
-    symtable_stack_top(sym_st)->found_return = false;
-    symtable_stack_top(sym_st)->found_else = false;
-    symtable_stack_top(sym_st)->all_children_return = true;
+    symtable_stack_top(compiler->sym_st)->found_return = false;
+    symtable_stack_top(compiler->sym_st)->found_else = false;
+    symtable_stack_top(compiler->sym_st)->all_children_return = true;
 }
 
 void sem_load_identif(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
@@ -407,9 +407,9 @@ void sem_load_identif(__attribute__((unused)) Token *token, __attribute__((unuse
     items->varItem = init_symtable_item(false);
 
     DEBUG_SEMANTIC_CODE(printf(CYAN);
-                        symtable_print(symtable_stack_top(sym_st)););
+                        symtable_print(symtable_stack_top(compiler->sym_st)););
 
-    symtable_item *item = symtable_find_in_stack(token->token_value, sym_st, false);
+    symtable_item *item = symtable_find_in_stack(token->token_value, compiler->sym_st, false);
 
     if (item == NULL)
     {
@@ -425,7 +425,7 @@ void sem_load_identif(__attribute__((unused)) Token *token, __attribute__((unuse
 void sem_identif_exp(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
 {
     DEBUG_SEMANTIC_CODE(printf(CYAN);
-                        symtable_print(symtable_stack_top(sym_st)););
+                        symtable_print(symtable_stack_top(compiler->sym_st)););
 
     psa_return_type return_type4 = parse_expression();
 
@@ -436,7 +436,7 @@ void sem_identif_exp(__attribute__((unused)) Token *token, __attribute__((unused
         throw_error(COMPATIBILITY_ERR, token->line_num, "Unrecognizable type of variable: %s \n", items->varItem->id);
     }
 
-    symtable_item *identif_exp_item = symtable_find_in_stack(items->varItem->id, sym_st, false);
+    symtable_item *identif_exp_item = symtable_find_in_stack(items->varItem->id, compiler->sym_st, false);
 
     // check if expression type and var type match, conversion is possible
     if (!(check_ret_values(return_type4.type, identif_exp_item->data.var_data->type) || isTypeConvertable(identif_exp_item->data.var_data->type, return_type4.type, return_type4.is_literal)))
@@ -444,16 +444,18 @@ void sem_identif_exp(__attribute__((unused)) Token *token, __attribute__((unused
         throw_error(COMPATIBILITY_ERR, token->line_num, "Expression type: %d and type: %d of variable: %s do not match!\n", return_type4.type, identif_exp_item->data.var_data->type, items->varItem->id);
     }
 
-    // generate instructuions for conversion
+    items->expr = return_type4.expr;
+
+    // convert int to float
     if (!check_ret_values(return_type4.type, identif_exp_item->data.var_data->type) && isTypeConvertable(identif_exp_item->data.var_data->type, return_type4.type, return_type4.is_literal))
     {
-        generate_instruction(INT2FLOATS);
+        items->expr = fold_expr(ast_unary(AST_INT2DOUBLE, TYPE_DOUBLE, items->expr));
     }
 }
 
 void sem_func_call_psa(__attribute__((unused)) Token *token, __attribute__((unused)) sym_items *items)
 {
-    parse_expression();
+    items->expr = parse_expression().expr;
 
     DEBUG_SEMANTIC_CODE(print_expression_type(return_type5.type););
 }
\ No newline at end of file
@@ -22,8 +22,6 @@
 #include "stack.h"
 #include "symtable.h"
 
-extern symtable_stack *sym_st;
-
 #define RED "\x1B[31m"
 #define GREEN "\x1B[32m"
 #define YELLOW "\x1B[33m"
@@ -79,23 +77,32 @@ typedef enum
 void print_items(sym_items *items);
 
 /**
- * @brief Stores current tokne to the token_stack. Loads next token.
+ * @brief Loads next token, the current one stays in the token ring until the mark is rewound.
  *
  * @param token Pointer to the current token. New token will be stored here.
- * @param token_stack Pointer to the token stack.
  */
-void push_token_get_next(Token *token, Token_stack *token_stack);
+void push_token_get_next(Token *token);
 
 /**
- * @brief Finds the function definition in the program.
+ * @brief Finds the function definition in the program. The headers of all the functions defined in the rest of the
+ * program are indexed on the first call, so the lookup does not rescan the tokens.
  *
- * @param token Pointer to the current token.
  * @param name Name of the function.
  * @param psa_item Pointer to the symtable_item where the function definition will be stored.
  *
  * @return true if the function was found.
  */
-bool get_func_definition(Token *token, char *name, symtable_item *psa_item);
+bool get_func_definition(char *name, symtable_item *psa_item);
+
+/**
+ * @brief Finds the function in the index of the function headers without reading any more tokens.
+ *
+ * @param name Name of the function.
+ * @param complete Set to false if the index could not reach the end of the program (lexical error).
+ *
+ * @return symtable_item* - the function, NULL if it is not defined
+ */
+symtable_item *find_indexed_func(char *name, bool *complete);
 
 /**
  * @brief Converts token type to expression type.
@@ -0,0 +1,225 @@
+/**
+ * @file server.c
+ * @brief Compile server, one warm process compiles the sources sent to it one after another.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "server.h"
+
+/**
+ * @brief Reads the length line of the next request.
+ *
+ * @return int - 1 if the length has been read, 0 at the end of the stream, -1 if the line is malformed
+ */
+static int read_length(FILE *in, size_t *len)
+{
+    int c = fgetc(in);
+    if (c == EOF)
+    {
+        return 0;
+    }
+    size_t value = 0;
+    int digits = 0;
+    for (; c >= '0' && c <= '9'; c = fgetc(in), digits++)
+    {
+        if (value > (SIZE_MAX - 9) / 10)
+        {
+            return -1;
+        }
+        value = value * 10 + (size_t)(c - '0');
+    }
+    if (c == '\r')
+    {
+        c = fgetc(in);
+    }
+    if (digits == 0 || c != '\n')
+    {
+        return -1;
+    }
+    *len = value;
+    return 1;
+}
+
+/**
+ * @brief Compiles one source, the diagnostics and the code are collected in memory.
+ */
+static void serve_request(Compiler *ctx, char *source, size_t len, FILE *out, Compiler_options options)
+{
+    char *diagnostics = NULL;
+    size_t diagnostics_len = 0;
+    char *code = NULL;
+    size_t code_len = 0;
+    FILE *diagnostics_file = open_memstream(&diagnostics, &diagnostics_len);
+    FILE *code_file = open_memstream(&code, &code_len);
+
+    Error_code error_code = INTERNAL_ERR;
+    if (diagnostics_file != NULL && code_file != NULL)
+    {
+        ctx->diagnostics = diagnostics_file;
+        error_code = compiler_run_buffer(ctx, source, len, options, code_file);
+    }
+    else
+    {
+        free(source);
+    }
+    compiler_reset(ctx);
+
+    if (diagnostics_file != NULL)
+    {
+        fclose(diagnostics_file);
+    }
+    if (code_file != NULL)
+    {
+        fclose(code_file);
+    }
+
+    fprintf(out, "%d %zu %zu\n", error_code, diagnostics_len, code_len);
+    fwrite(diagnostics, 1, diagnostics_len, out);
+    fwrite(code, 1, code_len, out);
+    fflush(out);
+    free(diagnostics);
+    free(code);
+}
+
+int serve_stream(Compiler *ctx, FILE *in, FILE *out, Compiler_options options)
+{
+    while (1)
+    {
+        size_t len;
+        int status = read_length(in, &len);
+        if (status <= 0)
+        {
+            if (status < 0)
+            {
+                fprintf(stderr, "Malformed request, the length of the source was expected.\n");
+            }
+            return status < 0;
+        }
+
+        // the compilation takes the buffer over, one more byte keeps it non-empty
+        char *source = malloc(len + 1);
+        if (source == NULL)
+        {
+            fprintf(stderr, "Memory allocation for the source failed.\n");
+            return 1;
+        }
+        if (fread(source, 1, len, in) != len)
+        {
+            fprintf(stderr, "Incomplete request, the source has ended early.\n");
+            free(source);
+            return 1;
+        }
+        source[len] = '\0';
+        serve_request(ctx, source, len, out, options);
+    }
+}
+
+static int serve_socket(Compiler *ctx, const char *socket_path, Compiler_options options)
+{
+    struct sockaddr_un addr;
+    if (strlen(socket_path) >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, "Socket path %s is too long.\n", socket_path);
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        perror("socket");
+        return 1;
+    }
+    unlink(socket_path);
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listener, 16) != 0)
+    {
+        perror(socket_path);
+        close(listener);
+        return 1;
+    }
+
+    // wait between accepts while the process is out of descriptors or memory
+    long backoff_ms = 0;
+    while (1)
+    {
+        int connection = accept(listener, NULL, NULL);
+        if (connection < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+            {
+                backoff_ms = backoff_ms == 0 ? 10 : (backoff_ms >= 1000 ? 1000 : backoff_ms * 2);
+                struct timespec pause = {.tv_sec = backoff_ms / 1000, .tv_nsec = (backoff_ms % 1000) * 1000000L};
+                nanosleep(&pause, NULL);
+                continue;
+            }
+            perror("accept");
+            close(listener);
+            unlink(socket_path);
+            return 1;
+        }
+        backoff_ms = 0;
+        // the clients are served one at a time, a client that stops sending or reading must not block the others
+        struct timeval timeout = {.tv_sec = SERVE_TIMEOUT_SECONDS, .tv_usec = 0};
+        setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        // separate streams for reading and writing the same socket
+        int write_fd = dup(connection);
+        FILE *in = fdopen(connection, "r");
+        FILE *out = write_fd >= 0 ? fdopen(write_fd, "w") : NULL;
+        if (in != NULL && out != NULL)
+        {
+            serve_stream(ctx, in, out, options);
+        }
+        if (in != NULL)
+        {
+            fclose(in);
+        }
+        else
+        {
+            close(connection);
+        }
+        if (out != NULL)
+        {
+            fclose(out);
+        }
+        else if (write_fd >= 0)
+        {
+            close(write_fd);
+        }
+    }
+}
+
+int compile_server(const char *socket_path, Compiler_options options)
+{
+    // a client that goes away must not stop the server
+    signal(SIGPIPE, SIG_IGN);
+
+    Compiler ctx;
+    compiler_init(&ctx, stderr);
+    int exit_code = socket_path != NULL ? serve_socket(&ctx, socket_path, options)
+                                        : serve_stream(&ctx, stdin, stdout, options);
+    compiler_free(&ctx);
+    return exit_code;
+}
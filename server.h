@@ -0,0 +1,45 @@
+/**
+ * @file server.h
+ * @brief Compile server, one warm process compiles the sources sent to it one after another.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ * Protocol, the lengths are decimal numbers of bytes:
+ *   request:  "<source length>\n" followed by the source
+ *   response: "<exit code> <diagnostics length> <code length>\n" followed by the diagnostics and the IFJcode23
+ * The code is empty if the compilation has failed. The connection ends when the client closes its side, a client of
+ * the socket is also disconnected when it sends or reads nothing for SERVE_TIMEOUT_SECONDS.
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdio.h>
+#include "compiler.h"
+
+#define SERVE_TIMEOUT_SECONDS 10 // a client of the socket waited for longer than this is disconnected
+
+/**
+ * @brief Serves the requests read from the stream until its end.
+ *
+ * @param ctx compilation reused for all the requests
+ * @param in stream of the requests
+ * @param out stream of the responses
+ * @param options how the sources are read
+ * @return int - 0 if the stream has ended between the requests, 1 on a malformed or incomplete request
+ */
+int serve_stream(Compiler *ctx, FILE *in, FILE *out, Compiler_options options);
+
+/**
+ * @brief Serves the requests from stdin, or from the clients of the Unix socket one at a time.
+ *
+ * @param socket_path path of the socket to listen on, stdin and stdout are used if it is NULL
+ * @param options how the sources are read
+ * @return int - exit code of the server
+ */
+int compile_server(const char *socket_path, Compiler_options options);
+
+#endif // SERVER_H
@@ -11,37 +11,18 @@
  */
 
 #include "symtable.h"
+#include "compiler.h"
 
-unsigned long gen_id_idx_cnt = 0;
-const uint32_t FNV_PRIME = 16777619;
-const uint32_t FNV_OFFSET_BASIS = 2166136261;
 
 uint32_t hash(char *input)
 {
-    // Check for NULL input
-    if (input == NULL)
+    // Check for NULL or empty input
+    if (input == NULL || *input == '\0')
     {
-        return -1; // Return an error value for null input
+        return -1; // Return an error value
     }
 
-    // Calculate the length of the input
-    int len = strlen(input);
-
-    // Check for empty string
-    if (len <= 0)
-    {
-        return -1; // Return an error value for empty string
-    }
-
-    uint32_t hash = FNV_OFFSET_BASIS;
-
-    for (int i = 0; i < len; i++)
-    {
-        hash ^= (uint32_t)input[i];
-        hash *= FNV_PRIME;
-    }
-
-    return hash % SYMTABLE_MAX_ITEMS;
+    return intern_hash(input) % SYMTABLE_MAX_ITEMS;
 }
 
 DEFINE_STACK_FUNCTIONS(symtable);
@@ -50,7 +31,7 @@ void symtable_stack_free_all(symtable_stack *stack)
 {
     while (stack->size > 0)
     {
-        symtable_free(symtable_stack_pop(stack));
+        (void)symtable_stack_pop(stack);
     }
 
     free(stack);
@@ -58,18 +39,9 @@ void symtable_stack_free_all(symtable_stack *stack)
 
 symtable symtable_init()
 {
-    symtable st = malloc(sizeof(symtable *));
-    st->symtable = malloc(sizeof(symtable_item *) * SYMTABLE_MAX_ITEMS);
-
-    if (st == NULL)
-    {
-        return NULL;
-    }
-
-    for (int i = 0; i < SYMTABLE_MAX_ITEMS; i++)
-    {
-        st->symtable[i] = NULL;
-    }
+    // the arena memory is zeroed, the buckets are allocated by the first add, so a scope without declarations
+    // (most of the blocks) costs only the table itself
+    symtable st = ast_alloc(sizeof(symtable_t));
 
     st->all_children_return = true;
     st->found_else = false;
@@ -86,6 +58,11 @@ symtable_item *symtable_add(symtable_item *item, symtable table)
         return NULL;
     }
 
+    if (table->symtable == NULL)
+    {
+        table->symtable = ast_alloc(sizeof(symtable_item *) * SYMTABLE_MAX_ITEMS);
+    }
+
     if (table->symtable[item_hash] == NULL) // there is no item with this hash
     {
         table->symtable[item_hash] = item; // just add it
@@ -104,8 +81,8 @@ symtable_item *symtable_add(symtable_item *item, symtable table)
     // for a variable, generate a globally unique index
     if (item->type == VARIABLE)
     {
-        item->data.var_data->gen_id_idx = gen_id_idx_cnt;
-        gen_id_idx_cnt++;
+        item->data.var_data->gen_id_idx = compiler->gen_id_idx_cnt;
+        compiler->gen_id_idx_cnt++;
     }
 
     return item;
@@ -115,7 +92,7 @@ symtable_item *symtable_find(char *name, symtable table, bool is_func)
 {
     // get the search hash
     const uint32_t item_hash = hash(name);
-    if (item_hash == (uint32_t)-1)
+    if (item_hash == (uint32_t)-1 || table->symtable == NULL)
     {
         return NULL;
     }
@@ -129,11 +106,12 @@ symtable_item *symtable_find(char *name, symtable table, bool is_func)
             item = item->next;
             continue;
         }
-        if (strcmp(item->id, name) == 0 && item->type == is_func)
+        // names are interned, so equal names have equal pointers
+        if (item->id == name && item->type == is_func)
         {
             return item;
         }
-        else if (strcmp(item->id, name) == 0 && item->type == VARIABLE)
+        else if (item->id == name && item->type == VARIABLE)
         {
             return item;
         }
@@ -156,7 +134,7 @@ symtable_item *symtable_find_in_stack(char *name, symtable_stack *stack, bool is
         if (item != NULL)
         {
             DEBUG_SEMANTIC_CODE(printf("Found %s in %d. symtable\n", name, cnt););
-            item->scope = (int)sym_st->size - cnt - 1;
+            item->scope = (int)compiler->sym_st->size - cnt - 1;
             return item;
         }
 
@@ -165,20 +143,40 @@ symtable_item *symtable_find_in_stack(char *name, symtable_stack *stack, bool is
         cnt = cnt + 1;
     }
 
+    // the declaration of the name has failed, the error of its use would only repeat it
+    for (size_t i = 0; i < compiler->poisoned_count; i++)
+    {
+        if (compiler->poisoned[i] == name)
+        {
+            compiler->is_cascade = true;
+            break;
+        }
+    }
     return NULL;
 }
 
+void symtable_poison(char *name)
+{
+    if (compiler->poisoned_count == compiler->poisoned_cap)
+    {
+        size_t cap = compiler->poisoned_cap == 0 ? 16 : compiler->poisoned_cap * 2;
+        char **poisoned = ast_alloc(sizeof(char *) * cap);
+        if (compiler->poisoned_count > 0)
+        {
+            memcpy(poisoned, compiler->poisoned, sizeof(char *) * compiler->poisoned_count);
+        }
+        compiler->poisoned = poisoned;
+        compiler->poisoned_cap = cap;
+    }
+    compiler->poisoned[compiler->poisoned_count++] = name;
+}
+
 void add_param(FunctionData *func)
 {
     if (func->params == NULL)
     {
         // First param
         func->params = init_param_data(1);
-        if (func->params == NULL)
-        {
-            // Handle memory allocation error
-            return;
-        }
         func->capacity = 1;
         func->params_count = 0;
     }
@@ -186,12 +184,8 @@ void add_param(FunctionData *func)
     {
         // Need to resize
         int new_capacity = func->capacity * 2; // Or choose another resizing strategy
-        ParamData *new_params = realloc(func->params, new_capacity * sizeof(ParamData));
-        if (new_params == NULL)
-        {
-            // Handle memory allocation error
-            return;
-        }
+        ParamData *new_params = ast_alloc(new_capacity * sizeof(ParamData));
+        memcpy(new_params, func->params, func->params_count * sizeof(ParamData));
         func->params = new_params;
         func->capacity = new_capacity;
     }
@@ -201,26 +195,19 @@ void add_param(FunctionData *func)
 
 VariableData *init_var_data()
 {
-    VariableData *var_data = malloc(sizeof(VariableData));
-    if (var_data == NULL)
-    {
-        return NULL;
-    }
+    VariableData *var_data = ast_alloc(sizeof(VariableData));
 
     var_data->gen_id_idx = 0;
     var_data->is_const = false;
     var_data->is_initialized = false;
+    var_data->is_param = false;
     var_data->type = TYPE_EMPTY;
 
     return var_data;
 }
 ParamData *init_param_data(int count)
 {
-    ParamData *param_data = malloc(count * sizeof(ParamData));
-    if (param_data == NULL)
-    {
-        return NULL;
-    }
+    ParamData *param_data = ast_alloc(count * sizeof(ParamData));
 
     param_data->id = NULL;
     param_data->name = NULL;
@@ -231,12 +218,9 @@ ParamData *init_param_data(int count)
 
 FunctionData *init_func_data()
 {
-    FunctionData *func_data = malloc(sizeof(FunctionData));
-    if (func_data == NULL)
-    {
-        return NULL;
-    }
+    FunctionData *func_data = ast_alloc(sizeof(FunctionData));
 
+    func_data->params = NULL;
     func_data->params_count = 0;
     func_data->capacity = 0;
     func_data->return_type = TYPE_EMPTY;
@@ -247,11 +231,7 @@ FunctionData *init_func_data()
 symtable_item *init_symtable_item(bool is_func)
 {
 
-    symtable_item *new_sti = malloc(sizeof(symtable_item));
-    if (new_sti == NULL)
-    {
-        return NULL;
-    }
+    symtable_item *new_sti = ast_alloc(sizeof(symtable_item));
 
     if (is_func == false) // is variable
     {
@@ -281,7 +261,7 @@ void symtable_print(symtable table)
     {
         // print all the items in the one-way list
         printf("%d: ", i);
-        if (table->symtable[i] == NULL)
+        if (table->symtable == NULL || table->symtable[i] == NULL)
         {
             printf("NULL\n");
         }
@@ -308,28 +288,3 @@ void symtable_print(symtable table)
         }
     }
 }
-
-void free_synonyms(symtable_item *item)
-{
-    // free all chained items
-    if (item->next != NULL)
-    {
-        free_synonyms(item->next);
-    }
-
-    free(item);
-}
-
-void symtable_free(symtable table)
-{
-    // free all items in the table
-    for (int i = 0; i < SYMTABLE_MAX_ITEMS; i++)
-    {
-        if (table->symtable[i] != NULL)
-        {
-            free_synonyms(table->symtable[i]); // free all chained items
-        }
-    }
-
-    free(table);
-}
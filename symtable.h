@@ -23,6 +23,7 @@
 #include "stack.h"
 #include "debug.h"
 #include "error.h"
+#include "intern.h"
 
 /**
  * @brief Enum for the types of the expression.
@@ -89,7 +90,7 @@ typedef struct
     bool all_children_return;
     bool found_else;
     bool found_return;
-    symtable_item **symtable;
+    symtable_item **symtable; // buckets, NULL until the first item is added
 } symtable_t;
 
 typedef symtable_t *symtable;
@@ -98,29 +99,32 @@ typedef struct
 {
     symtable_item *varItem;
     symtable_item *funcItem;
+    struct Ast_expr *expr;        // syntax tree of the last parsed expression
+    bool body_skipped;            // the body of the function being parsed is cached, parsed by the function pool or
+                                  // has errors, its return is not checked
 } sym_items;
 
 DECLARE_STACK_FUNCTIONS(symtable);
 
-extern symtable_stack *sym_st;
-
 /**
- * @brief Struct to hold the stack of symtables.
+ * @brief Frees the stack of symtables, the tables themselves are released with the syntax tree.
  *
  * @param stack stack of symtables
  */
 void symtable_stack_free_all(symtable_stack *stack);
 
 /**
- * @brief Calculates the hashed value of a string. Source: https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+ * @brief Returns the bucket of an interned string, the FNV hash is precomputed by intern. Source: https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
  *
- * @param input value to be hashed
+ * @param input interned value to be hashed
  * @return int
  */
 uint32_t hash(char *input);
 
 /**
  * @brief Allocates a new symtable and initializes the items to NULL, then returns the address of the new symtable.
+ * The tables, their symbols and the data of the symbols are allocated from the syntax tree arena, so everything
+ * is released at once by ast_free.
  *
  * @return symtable* - pointer to the new symtable
  */
@@ -138,7 +142,7 @@ symtable_item *symtable_add(symtable_item *item, symtable table);
 /**
  * @brief Finds a symbol in the table and returns it's pointer.
  *
- * @param name name of the symbol to find
+ * @param name interned name of the symbol to find
  * @param table table to search in
  * @param is_func if the symbol is a function
  * @return symtable_item* - pointer to the symbol or NULL if not found
@@ -148,13 +152,20 @@ symtable_item *symtable_find(char *name, symtable table, bool is_func);
 /**
  * @brief Finds a symbol in the table and returns it's pointer.
  *
- * @param name name of the symbol to find
+ * @param name interned name of the symbol to find
  * @param stack stack of symtables to search in
  * @param is_func if the symbol is a function
  * @return symtable_item* - pointer to the symbol or NULL if not found
  */
 symtable_item *symtable_find_in_stack(char *name, symtable_stack *stack, bool is_func);
 
+/**
+ * @brief Marks the name declared by a statement with an error, the statements using it are not reported again.
+ *
+ * @param name interned name of the variable or the function that has not been declared
+ */
+void symtable_poison(char *name);
+
 FunctionData *init_func_data();
 VariableData *init_var_data();
 ParamData *init_param_data(int count);
@@ -181,18 +192,4 @@ symtable_item *init_symtable_item(bool is_func);
  */
 void symtable_print(symtable table);
 
-/**
- * @brief Recursively free all the chained synonyms
- *
- * @param item synonym to start the freeing with
- */
-void free_synonyms(symtable_item *item);
-
-/**
- * @brief Free the memory used by the table and all it's items
- *
- * @param table table to free
- */
-void symtable_free(symtable table);
-
 #endif // SYMTABLE_H
\ No newline at end of file
@@ -0,0 +1,96 @@
+/**
+ * @file bench.h
+ * @brief Timing and the writing of generated programs shared by the benchmarks, the including file defines
+ * _POSIX_C_SOURCE for clock_gettime.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define COMPILE_ROUNDS 3 // the best of the rounds of compiling a program is reported
+
+#define COUNT_OF(array) (sizeof(array) / sizeof((array)[0]))
+
+/**
+ * @brief Writes the part of the program that does not depend on the index of a function.
+ */
+typedef void (*Program_part)(FILE *f, int funcs);
+
+/**
+ * @brief Writes the function of the given index.
+ */
+typedef void (*Program_func)(FILE *f, int i, int funcs);
+
+/**
+ * @brief Monotonic time in seconds.
+ */
+static inline double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Runs the shell command the count of rounds.
+ *
+ * @return double - the best time in seconds, negative if the command failed
+ */
+static inline double best_time(const char *command, int rounds)
+{
+    double best = 1e9;
+    for (int round = 0; round < rounds; round++)
+    {
+        double start = now();
+        if (system(command) != 0)
+        {
+            printf("compilation failed: %s\n", command);
+            return -1;
+        }
+        double elapsed = now() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    return best;
+}
+
+/**
+ * @brief Writes the program of the given count of functions, the parts before and after the functions may be NULL.
+ *
+ * @return int - 0 on success, 1 if the file could not be opened
+ */
+static inline int write_program(const char *path, int funcs, Program_part before, Program_func func,
+                                Program_part after)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+    {
+        perror(path);
+        return 1;
+    }
+    if (before != NULL)
+    {
+        before(f, funcs);
+    }
+    for (int i = 0; i < funcs; i++)
+    {
+        func(f, i, funcs);
+    }
+    if (after != NULL)
+    {
+        after(f, funcs);
+    }
+    fclose(f);
+    return 0;
+}
+
+#endif // BENCH_H
@@ -0,0 +1,114 @@
+/**
+ * @file bench_cache.c
+ * @brief Rebuild time of a program of many functions with the function cache: the first build, a build without
+ * any change and a build after one function has been edited, the code is compared with a build without the cache.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+
+#define SOURCE "/tmp/ifj_bench_cache.swift"
+#define CACHE "/tmp/ifj_bench_cache.d"
+#define OUT_CACHED "/tmp/ifj_bench_cache.cached"
+#define OUT_PLAIN "/tmp/ifj_bench_cache.plain"
+
+static const int func_counts[] = {1000, 2000, 4000};
+
+static int edited = -1; // index of the edited function
+static int edit = 0;     // constant of the edited function
+
+static void write_limit(FILE *f, __attribute__((unused)) int funcs)
+{
+    fprintf(f, "let limit: Int = 10\n");
+}
+
+/**
+ * @brief Writes the function calling the previous one, the function edited is given a different constant.
+ */
+static void write_func(FILE *f, int i, __attribute__((unused)) int funcs)
+{
+    fprintf(f, "func f%d(_ n: Int, with s: String) -> Int {\n", i);
+    fprintf(f, "    var total: Int = n + %d\n", i == edited ? edit : 1);
+    fprintf(f, "    if n < limit {\n        total = total + n\n    } else {\n        write(s)\n    }\n");
+    if (i > 0)
+    {
+        fprintf(f, "    total = total + f%d(0, with: s)\n", i - 1);
+    }
+    fprintf(f, "    return total\n}\n");
+}
+
+static void write_call(FILE *f, int funcs)
+{
+    fprintf(f, "let v = f%d(%d, with: \"x\")\nwrite(v)\n", funcs - 1, funcs % 20);
+}
+
+/**
+ * @brief Builds with the cache and without it, the outputs must be the same.
+ *
+ * @return double - time of the build with the cache, negative on failure
+ */
+static double checked_build(const char *compiler, int rounds)
+{
+    char command[512];
+    snprintf(command, sizeof(command), "%s --cache %s %s > %s", compiler, CACHE, SOURCE, OUT_CACHED);
+    double time = best_time(command, rounds);
+    snprintf(command, sizeof(command), "%s %s > %s && cmp -s %s %s", compiler, SOURCE, OUT_PLAIN, OUT_PLAIN,
+             OUT_CACHED);
+    if (time < 0 || system(command) != 0)
+    {
+        printf("the code built with the cache differs\n");
+        return -1;
+    }
+    return time;
+}
+
+int main(int argc, char **argv)
+{
+    const char *compiler = argc > 1 ? argv[1] : "./ifjcompiler";
+    char command[512];
+
+    for (size_t i = 0; i < COUNT_OF(func_counts); i++)
+    {
+        int funcs = func_counts[i];
+        snprintf(command, sizeof(command), "rm -rf %s", CACHE);
+        edited = -1;
+        if (write_program(SOURCE, funcs, write_limit, write_func, write_call) != 0 || system(command) != 0)
+        {
+            return 1;
+        }
+        snprintf(command, sizeof(command), "%s %s > /dev/null", compiler, SOURCE);
+        double plain = best_time(command, COMPILE_ROUNDS);
+        double cold = checked_build(compiler, 1);
+        double warm = checked_build(compiler, COMPILE_ROUNDS);
+
+        // every round edits the function again, so it is never in the cache
+        double one_edited = 1e9;
+        for (int round = 0; round < COMPILE_ROUNDS && one_edited >= 0; round++)
+        {
+            edited = funcs / 2;
+            edit = 2 + round;
+            if (write_program(SOURCE, funcs, write_limit, write_func, write_call) != 0)
+            {
+                return 1;
+            }
+            double time = checked_build(compiler, 1);
+            one_edited = time < one_edited ? time : one_edited;
+        }
+        if (plain < 0 || cold < 0 || warm < 0 || one_edited < 0)
+        {
+            return 1;
+        }
+        printf("cache  %5d functions  no cache %8.3f ms  first %8.3f ms  unchanged %8.3f ms  one edited %8.3f ms\n",
+               funcs, plain * 1e3, cold * 1e3, warm * 1e3, one_edited * 1e3);
+    }
+    return 0;
+}
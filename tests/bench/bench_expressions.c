@@ -0,0 +1,285 @@
+/**
+ * @file bench_expressions.c
+ * @brief Time per token of compiling expression-dense programs, the operators of all the precedences over Int,
+ * Double, String, Bool and optional operands.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ * The benchmark is linked with the whole compiler. Two programs differing only in the count of the expression
+ * statements are compiled into /dev/null, the difference of their times is the cost of the expressions, from the
+ * reduction of the handles to the generated instructions.
+ *
+ * The typing of the binary operations is also timed on its own: the switch the operations were typed by before the
+ * table generated by utils/create_psa_table.py is kept here as the reference, and both are run on the operations of
+ * the statements.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "../../compiler.h"
+#include "../../psa.h"
+
+#define ROUNDS 7                // the best of the rounds is reported
+#define LOOKUPS (4 * 1000 * 1000) // typed operations in a round of the typing
+
+// 4 statements of 75 tokens in total
+static const char *statements =
+    "i = (i + 3) * 2 - i / 7 + (i - 1) * (i + 1) - i\n"
+    "d = d * 1.5 + 2 - d / (d + 4.0) * 0.5\n"
+    "s = s + \"x\" + (t ?? \"y\") + \"w\"\n"
+    "b = i < 100 && d >= 2.0 || !(s == \"z\") && (n ?? 0) != i\n";
+static const int statements_tokens = 75;
+
+/**
+ * @brief Operation of the statements, the operands are typed by the reference and by the table.
+ */
+typedef struct
+{
+    Token_type operation;
+    Expression_type left, right;
+    bool left_literal, right_literal;
+} Typed_operation;
+
+static Typed_operation operations[] = {
+    {TOKEN_PLUS, TYPE_INT, TYPE_INT, false, true},
+    {TOKEN_MUL, TYPE_INT, TYPE_INT, false, true},
+    {TOKEN_DIV, TYPE_INT, TYPE_INT, false, true},
+    {TOKEN_MINUS, TYPE_INT, TYPE_INT, false, false},
+    {TOKEN_MUL, TYPE_DOUBLE, TYPE_DOUBLE, false, true},
+    {TOKEN_PLUS, TYPE_DOUBLE, TYPE_INT, false, true},
+    {TOKEN_PLUS, TYPE_DOUBLE, TYPE_DOUBLE, false, true},
+    {TOKEN_DIV, TYPE_DOUBLE, TYPE_DOUBLE, false, false},
+    {TOKEN_PLUS, TYPE_STRING, TYPE_STRING, false, true},
+    {TOKEN_BINARY_OPERATOR, TYPE_STRING_NIL, TYPE_STRING, false, true},
+    {TOKEN_LESS, TYPE_INT, TYPE_INT, false, true},
+    {TOKEN_MORE_EQ, TYPE_DOUBLE, TYPE_DOUBLE, false, true},
+    {TOKEN_EQ, TYPE_STRING, TYPE_STRING, false, true},
+    {TOKEN_BINARY_OPERATOR, TYPE_INT_NIL, TYPE_INT, false, true},
+    {TOKEN_NEQ, TYPE_INT, TYPE_INT, false, false},
+    {TOKEN_AND, TYPE_BOOL, TYPE_BOOL, false, false},
+    {TOKEN_OR, TYPE_BOOL, TYPE_BOOL, false, false},
+};
+#define OPERATION_COUNT (sizeof(operations) / sizeof(operations[0]))
+
+/**
+ * @brief Whether the type can be nil, the check canTypeBeNil did before the table.
+ */
+static bool reference_can_be_nil(Expression_type type)
+{
+    switch (type)
+    {
+    case TYPE_INT_NIL:
+    case TYPE_DOUBLE_NIL:
+    case TYPE_BOOL_NIL:
+    case TYPE_STRING_NIL:
+    case TYPE_NIL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Type of the numeric operands, the combination getTypeCombination returned before the table.
+ */
+static Expression_type reference_combination(const Typed_operation *op, Ast_conversion *conversion)
+{
+    switch (((char)op->left << 8) | op->right)
+    {
+    case ((char)TYPE_INT << 8) | TYPE_INT:
+        return TYPE_INT;
+    case ((char)TYPE_INT << 8) | TYPE_DOUBLE:
+        *conversion = AST_CONVERT_LEFT;
+        return op->left_literal ? TYPE_DOUBLE : TYPE_INVALID;
+    case ((char)TYPE_DOUBLE << 8) | TYPE_INT:
+        *conversion = AST_CONVERT_RIGHT;
+        return op->right_literal ? TYPE_DOUBLE : TYPE_INVALID;
+    case ((char)TYPE_DOUBLE << 8) | TYPE_DOUBLE:
+        return TYPE_DOUBLE;
+    case ((char)TYPE_STRING << 8) | TYPE_STRING:
+        return TYPE_STRING;
+    case ((char)TYPE_INT_NIL << 8) | TYPE_INT_NIL:
+        return TYPE_INT_NIL;
+    case ((char)TYPE_DOUBLE_NIL << 8) | TYPE_DOUBLE_NIL:
+        return TYPE_DOUBLE_NIL;
+    case ((char)TYPE_STRING_NIL << 8) | TYPE_STRING_NIL:
+        return TYPE_STRING_NIL;
+    default:
+        return TYPE_INVALID;
+    }
+}
+
+/**
+ * @brief Type of the operation by the switch of getOperationType before the table, TYPE_INVALID instead of the error.
+ */
+static Expression_type reference_type(const Typed_operation *op, Ast_conversion *conversion)
+{
+    switch (op->operation)
+    {
+    case TOKEN_PLUS:
+        if (op->left == TYPE_STRING && op->right == TYPE_STRING)
+        {
+            return TYPE_STRING;
+        }
+        __attribute__((fallthrough));
+    case TOKEN_MINUS:
+    case TOKEN_MUL:
+    case TOKEN_DIV:
+        if (reference_can_be_nil(op->left) || reference_can_be_nil(op->right))
+        {
+            return TYPE_INVALID;
+        }
+        return reference_combination(op, conversion);
+    case TOKEN_EQ:
+    case TOKEN_NEQ:
+        return op->left == op->right || reference_combination(op, conversion) != TYPE_INVALID ? TYPE_BOOL : TYPE_INVALID;
+    case TOKEN_LESS:
+    case TOKEN_MORE:
+    case TOKEN_LESS_EQ:
+    case TOKEN_MORE_EQ:
+        return reference_combination(op, conversion) != TYPE_INVALID || (op->left == TYPE_STRING && op->right == TYPE_STRING)
+                   ? TYPE_BOOL
+                   : TYPE_INVALID;
+    case TOKEN_AND:
+    case TOKEN_OR:
+        return op->left == TYPE_BOOL && op->right == TYPE_BOOL ? TYPE_BOOL : TYPE_INVALID;
+    case TOKEN_BINARY_OPERATOR:
+        return reference_can_be_nil(op->left) && !reference_can_be_nil(op->right) && removeTypeNil(op->left) == op->right
+                   ? op->right
+                   : TYPE_INVALID;
+    default:
+        return TYPE_INVALID;
+    }
+}
+
+/**
+ * @brief Type of the operation by the generated table, the check getHandleType does with it.
+ */
+static Expression_type table_type(const Typed_operation *op, Ast_conversion *conversion)
+{
+    const Psa_operation *entry = psa_operation(op->operation, op->left, op->right);
+    if (entry->error != NO_ERR)
+    {
+        return TYPE_INVALID;
+    }
+    *conversion = entry->conversion;
+    if (entry->needs_literal && !(entry->conversion == AST_CONVERT_LEFT ? op->left_literal : op->right_literal))
+    {
+        return TYPE_INVALID;
+    }
+    return entry->type;
+}
+
+/**
+ * @brief Types the operations LOOKUPS times by the function.
+ *
+ * @return double - the best time in seconds of one typed operation
+ */
+static double typing_time(Expression_type (*type_of)(const Typed_operation *, Ast_conversion *))
+{
+    // read through the volatile pointer, so the operations cannot be typed at compile time
+    Typed_operation *volatile ops = operations;
+    double best = 1e9;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        unsigned sum = 0;
+        double start = now();
+        for (int i = 0; i < LOOKUPS / (int)OPERATION_COUNT; i++)
+        {
+            for (size_t j = 0; j < OPERATION_COUNT; j++)
+            {
+                Ast_conversion conversion = AST_CONVERT_NONE;
+                sum += (unsigned)type_of(&ops[j], &conversion) + conversion;
+            }
+        }
+        double elapsed = now() - start;
+        if (sum == 0)
+        {
+            printf("no operation typed\n");
+        }
+        best = elapsed < best ? elapsed : best;
+    }
+    return best / (LOOKUPS / OPERATION_COUNT * OPERATION_COUNT);
+}
+
+/**
+ * @brief Compiles the program of the statements repeated the given count of times.
+ *
+ * @return double - time of the compilation in seconds, negative if it has failed
+ */
+static double compile(int repeats)
+{
+    size_t len = strlen(statements);
+    const char *header = "var i = 1\nvar d = 1.0\nvar s = \"\"\nvar b = false\nlet t: String? = nil\nlet n: Int? = 5\n";
+    const char *footer = "write(i, d, s, b)\n";
+    char *data = malloc(strlen(header) + len * repeats + strlen(footer) + 1);
+    if (data == NULL)
+    {
+        return -1;
+    }
+    char *end = data + strlen(strcpy(data, header));
+    for (int i = 0; i < repeats; i++)
+    {
+        end = memcpy(end, statements, len) + len;
+    }
+    end += strlen(strcpy(end, footer));
+
+    FILE *out = fopen("/dev/null", "w");
+    if (out == NULL)
+    {
+        free(data);
+        return -1;
+    }
+    Compiler ctx;
+    compiler_init(&ctx, out);
+    Compiler_options options = {.pretokenize = false, .lex_threads = 1, .cache_dir = NULL, .func_threads = 0};
+    double start = now();
+    Error_code code = compiler_run_buffer(&ctx, data, (size_t)(end - data), options, out);
+    double elapsed = now() - start;
+    compiler_free(&ctx);
+    fclose(out);
+    return code == NO_ERR ? elapsed : -1;
+}
+
+int main()
+{
+    const int small = 1000, large = 5000;
+    double best = 1e9;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        double small_time = compile(small);
+        double large_time = compile(large);
+        if (small_time < 0 || large_time < 0)
+        {
+            printf("compilation failed\n");
+            return 1;
+        }
+        double per_token = (large_time - small_time) / ((double)(large - small) * statements_tokens);
+        best = per_token < best ? per_token : best;
+    }
+    printf("expr  %8d expression tokens  %8.1f ns/token\n", (large - small) * statements_tokens, best * 1e9);
+
+    for (size_t i = 0; i < OPERATION_COUNT; i++)
+    {
+        Ast_conversion reference_conversion = AST_CONVERT_NONE, table_conversion = AST_CONVERT_NONE;
+        Expression_type reference = reference_type(&operations[i], &reference_conversion);
+        Expression_type table = table_type(&operations[i], &table_conversion);
+        if (reference == TYPE_INVALID || reference != table || reference_conversion != table_conversion)
+        {
+            printf("operation %zu is typed %d by the switch and %d by the table\n", i, reference, table);
+            return 1;
+        }
+    }
+    double reference = typing_time(reference_type);
+    double table = typing_time(table_type);
+    printf("typing  switch %6.2f ns/operation  table %6.2f ns/operation  %5.2fx\n", reference * 1e9, table * 1e9,
+           reference / table);
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file bench_forward_calls.c
+ * @brief Compile time of programs calling functions that are defined after the calls, the time per function should
+ * not grow with the number of functions.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+
+static const int func_counts[] = {1250, 2500, 5000};
+
+/**
+ * @brief Writes the calls, all of them come before all the definitions.
+ */
+static void write_calls(FILE *f, int funcs)
+{
+    for (int i = 0; i < funcs; i++)
+    {
+        fprintf(f, "let v%d = f%d(%d, with: 2.5)\n", i, i, i);
+    }
+}
+
+static void write_func(FILE *f, int i, __attribute__((unused)) int funcs)
+{
+    fprintf(f, "func f%d(_ a: Int, with b: Double) -> Double {\n    return Int2Double(a) * b\n}\n", i);
+}
+
+int main(int argc, char **argv)
+{
+    const char *compiler = argc > 1 ? argv[1] : "./ifjcompiler";
+    char path[] = "/tmp/ifj_bench_forward_calls.swift";
+    char command[256];
+    snprintf(command, sizeof(command), "%s %s > /dev/null", compiler, path);
+
+    for (size_t i = 0; i < COUNT_OF(func_counts); i++)
+    {
+        if (write_program(path, func_counts[i], write_calls, write_func, NULL) != 0)
+        {
+            return 1;
+        }
+        double best = best_time(command, COMPILE_ROUNDS);
+        if (best < 0)
+        {
+            return 1;
+        }
+        printf("forward calls  %5d functions  %9.3f ms  %6.2f us/function\n", func_counts[i], best * 1e3,
+               best * 1e6 / func_counts[i]);
+    }
+    remove(path);
+    return 0;
+}
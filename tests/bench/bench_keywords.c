@@ -0,0 +1,115 @@
+/**
+ * @file bench_keywords.c
+ * @brief Microbenchmark of keyword recognition - linear strcmp table scan against the perfect hash lookup.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "../../scanner.h"
+
+#define ROUNDS 2000000
+
+// Mix of keywords, nullable types and user identifiers as they appear in the sources
+static const char *lexemes[] = {"let", "a", "Int", "Int?", "func", "foo", "return", "while", "counter", "String?",
+                                "nil", "if", "else", "x", "readString", "var", "Double", "result", "true", "Bool"};
+
+#define LEXEMES_CNT (sizeof(lexemes) / sizeof(*lexemes))
+
+/**
+ * @brief The original recognition - table rebuilt for every identifier, strcmp chain for ? and linear scan
+ */
+static Token_type linear_lookup(const char *code, bool followed_by_question)
+{
+    Token_map defined_tokens[] = {
+        {"Double", TOKEN_TYPE_DOUBLE}, {"String", TOKEN_TYPE_STRING}, {"Int", TOKEN_TYPE_INT}, {"Bool", TOKEN_TYPE_BOOL}, {"Double?", TOKEN_TYPE_DOUBLE_NIL}, {"String?", TOKEN_TYPE_STRING_NIL}, {"Int?", TOKEN_TYPE_INT_NIL}, {"Bool?", TOKEN_TYPE_BOOL_NIL}, {"func", TOKEN_FUNC}, {"nil", TOKEN_NIL}, {"if", TOKEN_IF}, {"else", TOKEN_ELSE}, {"true", TOKEN_BOOL}, {"false", TOKEN_BOOL}, {"return", TOKEN_RETURN}, {"while", TOKEN_WHILE}, {"var", TOKEN_VAR}, {"let", TOKEN_LET}, {"break", TOKEN_BREAK}, {"continue", TOKEN_CONTINUE}};
+    char buf[16];
+    strcpy(buf, code);
+    if (followed_by_question &&
+        (strcmp(buf, "Double") == 0 || strcmp(buf, "Int") == 0 || strcmp(buf, "String") == 0 || strcmp(buf, "Bool") == 0))
+    {
+        strcat(buf, "?");
+    }
+    for (size_t i = 0; i < sizeof(defined_tokens) / sizeof(defined_tokens[0]); i++)
+    {
+        if (strcmp(buf, defined_tokens[i].code) == 0)
+        {
+            return defined_tokens[i].token;
+        }
+    }
+    return TOKEN_IDENTIFICATOR;
+}
+
+/**
+ * @brief The perfect hash recognition as done by the scanner
+ */
+static Token_type hash_lookup(const char *code, size_t len, bool followed_by_question)
+{
+    Token_type type;
+    if (!keyword_lookup(code, len, &type))
+    {
+        return TOKEN_IDENTIFICATOR;
+    }
+    if (followed_by_question && type >= TOKEN_TYPE_STRING && type <= TOKEN_TYPE_BOOL)
+    {
+        type += TOKEN_TYPE_STRING_NIL - TOKEN_TYPE_STRING;
+    }
+    return type;
+}
+
+int main()
+{
+    // lexemes are split into the identifier part and the optional ? as the scanner sees them
+    char words[LEXEMES_CNT][16];
+    size_t lens[LEXEMES_CNT];
+    bool question[LEXEMES_CNT];
+    for (size_t i = 0; i < LEXEMES_CNT; i++)
+    {
+        strcpy(words[i], lexemes[i]);
+        lens[i] = strlen(words[i]);
+        question[i] = words[i][lens[i] - 1] == '?';
+        if (question[i])
+        {
+            words[i][--lens[i]] = '\0';
+        }
+        if (linear_lookup(words[i], question[i]) != hash_lookup(words[i], lens[i], question[i]))
+        {
+            fprintf(stderr, "Mismatch for %s\n", lexemes[i]);
+            return 1;
+        }
+    }
+
+    volatile unsigned long sink = 0;
+    double start = now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        for (size_t i = 0; i < LEXEMES_CNT; i++)
+        {
+            sink += linear_lookup(words[i], question[i]);
+        }
+    }
+    double linear_time = now() - start;
+
+    start = now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        for (size_t i = 0; i < LEXEMES_CNT; i++)
+        {
+            sink += hash_lookup(words[i], lens[i], question[i]);
+        }
+    }
+    double hash_time = now() - start;
+
+    double total = (double)ROUNDS * LEXEMES_CNT;
+    printf("linear table:  %8.2f M identifiers/s\n", total / linear_time / 1e6);
+    printf("perfect hash:  %8.2f M identifiers/s\n", total / hash_time / 1e6);
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file bench_lazy.c
+ * @brief Compile time and code size of a program calling a few functions of a large library, compiled as a whole and
+ * lazily, the interpreted programs must print the same.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "bench.h"
+
+#define SOURCE "/tmp/ifj_bench_lazy.swift"
+#define OUT_FULL "/tmp/ifj_bench_lazy.full"
+#define OUT_LAZY "/tmp/ifj_bench_lazy.lazy"
+#define RUN_FULL "/tmp/ifj_bench_lazy.full.out"
+#define RUN_LAZY "/tmp/ifj_bench_lazy.lazy.out"
+#define INTERPRETER "utils/ic23int"
+
+static const int func_counts[] = {500, 2000};
+static const int called = 5; // the program calls the last functions, each calls the previous one
+
+/**
+ * @brief Writes the function of the library, only the chain of the last called functions is reachable.
+ */
+static void write_func(FILE *f, int i, __attribute__((unused)) int funcs)
+{
+    fprintf(f, "func f%d(_ n: Int) -> Int {\n", i);
+    fprintf(f, "    var total: Int = n + %d\n    var i: Int = 0\n", i);
+    fprintf(f, "    while i < n {\n        total = total + i * 2\n        i = i + 1\n    }\n");
+    fprintf(f, "    if total > 100 {\n        total = total - 100\n    } else {\n        total = total + 1\n    }\n");
+    if (i % called > 0)
+    {
+        fprintf(f, "    total = total + f%d(n - 1)\n", i - 1);
+    }
+    fprintf(f, "    return total\n}\n");
+}
+
+static void write_call(FILE *f, int funcs)
+{
+    fprintf(f, "let v = f%d(%d)\nwrite(v, \"\\n\")\n", funcs - 1, called);
+}
+
+static long file_size(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : -1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *compiler = argc > 1 ? argv[1] : "./ifjcompiler";
+    char command[512];
+
+    for (size_t i = 0; i < COUNT_OF(func_counts); i++)
+    {
+        int funcs = func_counts[i];
+        if (write_program(SOURCE, funcs, NULL, write_func, write_call) != 0)
+        {
+            return 1;
+        }
+        snprintf(command, sizeof(command), "%s %s > %s", compiler, SOURCE, OUT_FULL);
+        double full = best_time(command, COMPILE_ROUNDS);
+        snprintf(command, sizeof(command), "%s --lazy %s > %s", compiler, SOURCE, OUT_LAZY);
+        double lazy = best_time(command, COMPILE_ROUNDS);
+        if (full < 0 || lazy < 0)
+        {
+            return 1;
+        }
+
+        // the interpreter is not part of every checkout
+        FILE *interpreter = fopen(INTERPRETER, "r");
+        if (interpreter != NULL)
+        {
+            fclose(interpreter);
+            snprintf(command, sizeof(command), "%s %s > %s && %s %s > %s && cmp -s %s %s", INTERPRETER, OUT_FULL,
+                     RUN_FULL, INTERPRETER, OUT_LAZY, RUN_LAZY, RUN_FULL, RUN_LAZY);
+            if (system(command) != 0)
+            {
+                printf("the lazily compiled program of %d functions prints something else\n", funcs);
+                return 1;
+            }
+        }
+
+        printf("lazy  %5d functions  whole %8.3f ms %8ld B  lazy %8.3f ms %8ld B\n", funcs, full * 1e3,
+               file_size(OUT_FULL), lazy * 1e3, file_size(OUT_LAZY));
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file bench_lexeme.c
+ * @brief Regression benchmark of lexeme accumulation - long string literals and identifiers must scan in linear time.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "../../scanner.h"
+#include "../../compiler.h"
+
+// the scanner is linked without the rest of the compiler, so the compilation it runs in is set up here
+__thread Compiler *compiler = NULL;
+static Compiler bench_ctx;
+
+#define STRING_MAX_LEN (1024 * 1024)  // longest string literal
+#define IDENTIFIER_MAX_LEN (64 * 1024) // longest identifier
+#define STEPS 4                        // sizes are halved STEPS - 1 times from the maximum
+#define MAX_SLOWDOWN 4.0               // allowed growth of time per byte between the smallest and the largest input
+
+/**
+ * @brief Writes the source with one lexeme of the given length and returns the time of scanning it
+ */
+static double scan_time(const char *path, const char *prefix, char fill, size_t len, const char *suffix)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+    fputs(prefix, f);
+    for (size_t i = 0; i < len; i++)
+    {
+        fputc(fill, f);
+    }
+    fputs(suffix, f);
+    fclose(f);
+
+    double best = 1e9;
+    for (int round = 0; round < 3; round++)
+    {
+        scanner_open(path);
+        double start = now();
+        Token token;
+        do
+        {
+            generate_token(&token);
+        } while (token.type != TOKEN_EOF);
+        double elapsed = now() - start;
+        scanner_close();
+        best = elapsed < best ? elapsed : best;
+    }
+    return best;
+}
+
+/**
+ * @brief Scans inputs of growing size and checks that the time per byte stays roughly constant
+ */
+static bool check_linear(const char *name, const char *prefix, char fill, size_t max_len, const char *suffix)
+{
+    char path[] = "/tmp/ifj_bench_lexeme.swift";
+    double first_per_byte = 0;
+    double last_per_byte = 0;
+    for (int i = STEPS - 1; i >= 0; i--)
+    {
+        size_t len = max_len >> i;
+        double t = scan_time(path, prefix, fill, len, suffix);
+        double per_byte = t / len * 1e9;
+        printf("%-10s %8zu B  %9.3f ms  %6.2f ns/B\n", name, len, t * 1e3, per_byte);
+        if (i == STEPS - 1)
+        {
+            first_per_byte = per_byte;
+        }
+        last_per_byte = per_byte;
+    }
+    remove(path);
+    if (last_per_byte > first_per_byte * MAX_SLOWDOWN)
+    {
+        printf("%s: cost does not scale linearly\n", name);
+        return false;
+    }
+    return true;
+}
+
+int main()
+{
+    bench_ctx.diagnostics = stderr;
+    compiler = &bench_ctx;
+    bool ok = check_linear("string", "let s = \"", 'a', STRING_MAX_LEN, "\"\n");
+    ok = check_linear("identifier", "let a", 'b', IDENTIFIER_MAX_LEN, " = 1\n") && ok;
+    return ok ? 0 : 1;
+}
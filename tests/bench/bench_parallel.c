@@ -0,0 +1,92 @@
+/**
+ * @file bench_parallel.c
+ * @brief Compile time of a program of many functions with the function bodies parsed and generated on the parser
+ * thread and by the function pool, the code is compared with the code of the parser thread.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "bench.h"
+
+#define SOURCE "/tmp/ifj_bench_parallel.swift"
+#define OUT_PLAIN "/tmp/ifj_bench_parallel.plain"
+#define OUT_POOL "/tmp/ifj_bench_parallel.pool"
+
+static const int func_counts[] = {500, 2000};
+static const int thread_counts[] = {1, 2, 4};
+
+static void write_limit(FILE *f, __attribute__((unused)) int funcs)
+{
+    fprintf(f, "let limit: Int = 10\n");
+}
+
+/**
+ * @brief Writes the function with loops, branches and the call of the previous function.
+ */
+static void write_func(FILE *f, int i, __attribute__((unused)) int funcs)
+{
+    fprintf(f, "func f%d(_ n: Int, with s: String) -> Int {\n", i);
+    fprintf(f, "    var total: Int = n + %d\n    var i: Int = 0\n", i);
+    fprintf(f, "    while i < n {\n        let d: Double = Int2Double(i) * 2.5\n        total = total + i\n");
+    fprintf(f, "        i = i + 1\n    }\n");
+    fprintf(f, "    if n < limit {\n        total = total + n * 2 - 1\n    } else if n == limit {\n");
+    fprintf(f, "        write(s, \"\\n\")\n    } else {\n        let t: String? = s\n        write(t ?? \"\")\n    }\n");
+    if (i > 0)
+    {
+        fprintf(f, "    total = total + f%d(0, with: s)\n", i - 1);
+    }
+    fprintf(f, "    return total\n}\n");
+}
+
+static void write_call(FILE *f, int funcs)
+{
+    fprintf(f, "let v = f%d(%d, with: \"x\")\nwrite(v)\n", funcs - 1, funcs % 20);
+}
+
+int main(int argc, char **argv)
+{
+    const char *compiler = argc > 1 ? argv[1] : "./ifjcompiler";
+    char command[512];
+    printf("parallel  %ld processors\n", sysconf(_SC_NPROCESSORS_ONLN));
+
+    for (size_t i = 0; i < COUNT_OF(func_counts); i++)
+    {
+        int funcs = func_counts[i];
+        if (write_program(SOURCE, funcs, write_limit, write_func, write_call) != 0)
+        {
+            return 1;
+        }
+        snprintf(command, sizeof(command), "%s %s > %s", compiler, SOURCE, OUT_PLAIN);
+        double plain = best_time(command, COMPILE_ROUNDS);
+        if (plain < 0)
+        {
+            return 1;
+        }
+        printf("parallel  %5d functions  parser thread %8.3f ms", funcs, plain * 1e3);
+
+        for (size_t j = 0; j < COUNT_OF(thread_counts); j++)
+        {
+            snprintf(command, sizeof(command), "%s --func-threads %d %s > %s", compiler, thread_counts[j], SOURCE,
+                     OUT_POOL);
+            double pool = best_time(command, COMPILE_ROUNDS);
+            snprintf(command, sizeof(command), "cmp -s %s %s", OUT_PLAIN, OUT_POOL);
+            if (pool < 0 || system(command) != 0)
+            {
+                printf("\nthe code of %d threads differs\n", thread_counts[j]);
+                return 1;
+            }
+            printf("  %d threads %8.3f ms", thread_counts[j], pool * 1e3);
+        }
+        printf("\n");
+    }
+    return 0;
+}
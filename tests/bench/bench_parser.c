@@ -0,0 +1,878 @@
+/**
+ * @file bench_parser.c
+ * @brief Compile time of programs made of many small statements and blocks, so most of the time goes to the parser,
+ * and of one deeply nested block that the parser has to handle without growing the call stack. The recursive descent
+ * parser the generated LL(1) table replaced is kept here as the reference, both parsers recognize the tokens of the
+ * same programs without the semantic actions and the PSA, so only the parsing is timed.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "bench.h"
+#include "../../parser.h"
+#include "../../compiler.h"
+
+// the scanner is linked without the rest of the compiler, so the compilation it runs in is set up here
+__thread Compiler *compiler = NULL;
+static Compiler bench_ctx;
+
+#define NESTING 50000    // depth of the nested block
+#define STACK_LIMIT 1024 // KiB of the call stack the nested block is compiled with
+#define PARSE_ROUNDS 10  // the best of the rounds of parsing the tokens is reported
+
+/**
+ * @brief - Tokens of the program read by the scanner beforehand, both parsers read them by the same functions
+ * @param types - types of the tokens, the last one is TOKEN_EOF
+ * @param nl - the token is preceded by a newline
+ * @param count - count of the tokens
+ * @param pos - position of the current token
+ */
+typedef struct
+{
+    Token_type *types;
+    bool *nl;
+    size_t count;
+    size_t pos;
+} Bench_tokens;
+
+/**
+ * @brief Matches the current token like cmp_type, the token is read past even if it does not match.
+ */
+static inline bool match(Bench_tokens *t, Token_type type)
+{
+    if (t->types[t->pos] == TOKEN_EOF)
+    {
+        return type == TOKEN_EOF;
+    }
+    return t->types[t->pos++] == type;
+}
+
+/**
+ * @brief Reads past the expression in place of the PSA. The programs of the benchmark do not continue an expression
+ * on the next line, so it ends before a newline, a brace or the end of the input outside of the brackets.
+ */
+static bool skip_expression(Bench_tokens *t)
+{
+    int depth = 0;
+    for (size_t start = t->pos; t->types[t->pos] != TOKEN_EOF; t->pos++)
+    {
+        Token_type type = t->types[t->pos];
+        if (depth == 0 && t->pos > start && (t->nl[t->pos] || type == TOKEN_L_CURLY || type == TOKEN_R_CURLY))
+        {
+            break;
+        }
+        if (type == TOKEN_L_BRACKET)
+        {
+            depth++;
+        }
+        else if (type == TOKEN_R_BRACKET)
+        {
+            depth--;
+        }
+    }
+    return true;
+}
+
+/// REFERENCE PARSER
+
+/*
+ * The recursive descent parser of parser.c before the generated table, one function per nonterminal. The semantic
+ * actions are left out, cmp_type is match and EXP is skip_expression.
+ */
+
+static bool reference_STMT_LIST(Bench_tokens *t);
+static bool reference_LOCAL_STMT_LIST(Bench_tokens *t);
+static bool reference_STMT(Bench_tokens *t);
+static bool reference_LOCAL_STMT(Bench_tokens *t);
+static bool reference_VAR_LET(Bench_tokens *t);
+static bool reference_VAR_SCOPE(Bench_tokens *t);
+static bool reference_TYPE_AND_ASIGN(Bench_tokens *t);
+static bool reference_R_FLEX(Bench_tokens *t);
+static bool reference_D_TYPE(Bench_tokens *t);
+static bool reference_DEF_FUNC(Bench_tokens *t);
+static bool reference_P_LIST(Bench_tokens *t);
+static bool reference_PARAM(Bench_tokens *t);
+static bool reference_P_SEP(Bench_tokens *t);
+static bool reference_RET_TYPE(Bench_tokens *t);
+static bool reference_FUNC_STMT_LIST(Bench_tokens *t);
+static bool reference_FUNC_STMT(Bench_tokens *t);
+static bool reference_RET(Bench_tokens *t);
+static bool reference_FUNC_WHILE(Bench_tokens *t);
+static bool reference_FUNC_IF(Bench_tokens *t);
+static bool reference_FUNC_ELSE_IF(Bench_tokens *t);
+static bool reference_FUNC_ELSE_CLAUSE(Bench_tokens *t);
+static bool reference_FUNC_AFTER_ELSE(Bench_tokens *t);
+static bool reference_IF_STMT(Bench_tokens *t);
+static bool reference_ELSE_IF_STMT(Bench_tokens *t);
+static bool reference_IF_COND(Bench_tokens *t);
+static bool reference_ELSE_CLAUSE(Bench_tokens *t);
+static bool reference_AFTER_ELSE(Bench_tokens *t);
+static bool reference_WHILE_STMT(Bench_tokens *t);
+static bool reference_LOAD_ID(Bench_tokens *t);
+
+static bool reference_START(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // START -> STMT_LIST eof
+    case TOKEN_EOF:
+    case TOKEN_FUNC:
+    case TOKEN_IF:
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+    case TOKEN_WHILE:
+    case TOKEN_VAR:
+    case TOKEN_LET:
+        return reference_STMT_LIST(t) && match(t, TOKEN_EOF);
+    default:
+        return false;
+    }
+}
+
+static bool reference_STMT_LIST(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // STMT_LIST -> eps
+    case TOKEN_EOF:
+    case TOKEN_R_CURLY:
+        return true;
+    // STMT_LIST -> STMT STMT_LIST
+    case TOKEN_FUNC:
+    case TOKEN_IF:
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+    case TOKEN_WHILE:
+    case TOKEN_VAR:
+    case TOKEN_LET:
+        return reference_STMT(t) && reference_STMT_LIST(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_LOCAL_STMT_LIST(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // STMT_LIST -> eps
+    case TOKEN_EOF:
+    case TOKEN_R_CURLY:
+        return true;
+    // STMT_LIST -> STMT STMT_LIST
+    case TOKEN_IF:
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+    case TOKEN_WHILE:
+    case TOKEN_VAR:
+    case TOKEN_LET:
+        return reference_LOCAL_STMT(t) && reference_LOCAL_STMT_LIST(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_STMT(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // STMT -> DEF_FUNC
+    case TOKEN_FUNC:
+        return reference_DEF_FUNC(t);
+    // STMT -> IF_STMT
+    case TOKEN_IF:
+        return reference_IF_STMT(t);
+    // STMT -> LOAD_ID
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+        return reference_LOAD_ID(t);
+    // STMT -> WHILE_STMT
+    case TOKEN_WHILE:
+        return reference_WHILE_STMT(t);
+    // STMT -> VAR_LET
+    case TOKEN_VAR:
+    case TOKEN_LET:
+        return reference_VAR_LET(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_LOCAL_STMT(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // STMT -> IF_STMT
+    case TOKEN_IF:
+        return reference_IF_STMT(t);
+    // STMT -> LOAD_ID
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+        return reference_LOAD_ID(t);
+    // STMT -> WHILE_STMT
+    case TOKEN_WHILE:
+        return reference_WHILE_STMT(t);
+    // STMT -> VAR_LET
+    case TOKEN_VAR:
+    case TOKEN_LET:
+        return reference_VAR_LET(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_VAR_LET(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // VAR_LET -> VAR_SCOPE id TYPE_AND_ASSIGN
+    case TOKEN_VAR:
+    case TOKEN_LET:
+        return reference_VAR_SCOPE(t) && match(t, TOKEN_IDENTIFICATOR) && reference_TYPE_AND_ASIGN(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_VAR_SCOPE(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    case TOKEN_VAR:
+        return match(t, TOKEN_VAR);
+    case TOKEN_LET:
+        return match(t, TOKEN_LET);
+    default:
+        return false;
+    }
+}
+
+static bool reference_TYPE_AND_ASIGN(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // TYPE_AND_ASIGN -> : D_TYPE R_FLEX
+    case TOKEN_DOUBLE_DOT:
+        return match(t, TOKEN_DOUBLE_DOT) && reference_D_TYPE(t) && reference_R_FLEX(t);
+    // TYPE_AND_ASIGN -> = EXP
+    case TOKEN_ASSIGN:
+        return match(t, TOKEN_ASSIGN) && skip_expression(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_R_FLEX(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // R_FLEX -> = EXP
+    case TOKEN_ASSIGN:
+        return match(t, TOKEN_ASSIGN) && skip_expression(t);
+    // R_FLEX -> eps
+    case TOKEN_EOF:
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+    case TOKEN_VAR:
+    case TOKEN_LET:
+    case TOKEN_FUNC:
+    case TOKEN_R_CURLY:
+    case TOKEN_RETURN:
+    case TOKEN_WHILE:
+    case TOKEN_IF:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool reference_D_TYPE(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    case TOKEN_TYPE_STRING:
+        return match(t, TOKEN_TYPE_STRING);
+    case TOKEN_TYPE_INT:
+        return match(t, TOKEN_TYPE_INT);
+    case TOKEN_TYPE_DOUBLE:
+        return match(t, TOKEN_TYPE_DOUBLE);
+    case TOKEN_TYPE_BOOL:
+        return match(t, TOKEN_TYPE_BOOL);
+    case TOKEN_TYPE_STRING_NIL:
+        return match(t, TOKEN_TYPE_STRING_NIL);
+    case TOKEN_TYPE_INT_NIL:
+        return match(t, TOKEN_TYPE_INT_NIL);
+    case TOKEN_TYPE_DOUBLE_NIL:
+        return match(t, TOKEN_TYPE_DOUBLE_NIL);
+    case TOKEN_TYPE_BOOL_NIL:
+        return match(t, TOKEN_TYPE_BOOL_NIL);
+    default:
+        return false;
+    }
+}
+
+static bool reference_DEF_FUNC(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    //  DEF_FUNC -> func func_id ( P_LIST ) RET_TYPE { FUNC_STMT_LIST }
+    case TOKEN_FUNC:
+        return match(t, TOKEN_FUNC) && match(t, TOKEN_FUNC_ID) && match(t, TOKEN_L_BRACKET) && reference_P_LIST(t) &&
+               match(t, TOKEN_R_BRACKET) && reference_RET_TYPE(t) && match(t, TOKEN_L_CURLY) &&
+               reference_FUNC_STMT_LIST(t) && match(t, TOKEN_R_CURLY);
+    default:
+        return false;
+    }
+}
+
+static bool reference_P_LIST(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // P_LIST -> PARAM
+    case TOKEN_IDENTIFICATOR:
+        return reference_PARAM(t);
+    // P_LIST -> eps
+    case TOKEN_R_BRACKET:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool reference_PARAM(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // PARAM -> id id : D_TYPE SEP
+    case TOKEN_IDENTIFICATOR:
+        return match(t, TOKEN_IDENTIFICATOR) && match(t, TOKEN_IDENTIFICATOR) && match(t, TOKEN_DOUBLE_DOT) &&
+               reference_D_TYPE(t) && reference_P_SEP(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_P_SEP(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // P_SEP -> eps
+    case TOKEN_R_BRACKET:
+        return true;
+    // P_SEP -> , PARAM
+    case TOKEN_COMMA:
+        return match(t, TOKEN_COMMA) && reference_PARAM(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_RET_TYPE(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // RET_TYPE -> eps
+    case TOKEN_L_CURLY:
+        return true;
+    // RET_TYPE -> -> D_TYPE
+    case TOKEN_ARROW:
+        return match(t, TOKEN_ARROW) && reference_D_TYPE(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_FUNC_STMT_LIST(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // FUNC_STMT_LIST -> FUNC_STMT FUNC_STMT_LIST
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+    case TOKEN_VAR:
+    case TOKEN_LET:
+    case TOKEN_RETURN:
+    case TOKEN_WHILE:
+    case TOKEN_IF:
+        return reference_FUNC_STMT(t) && reference_FUNC_STMT_LIST(t);
+    // FUNC_STMT_LIST -> eps
+    case TOKEN_R_CURLY:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool reference_FUNC_STMT(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // FUNC_STMT -> LOAD_ID
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+        return reference_LOAD_ID(t);
+    // FUNC_STMT -> VAR_LET
+    case TOKEN_VAR:
+    case TOKEN_LET:
+        return reference_VAR_LET(t);
+    // FUNC_STMT -> RET
+    case TOKEN_RETURN:
+        return reference_RET(t);
+    // FUNC_STMT -> FUNC_WHILE
+    case TOKEN_WHILE:
+        return reference_FUNC_WHILE(t);
+    // FUNC_STMT -> FUNC_IF
+    case TOKEN_IF:
+        return reference_FUNC_IF(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_RET(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // RET -> return EXP
+    case TOKEN_RETURN:
+        return match(t, TOKEN_RETURN) && skip_expression(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_FUNC_WHILE(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // FUNC_WHILE -> while EXP { FUNC_STMT_LIST }
+    case TOKEN_WHILE:
+        return match(t, TOKEN_WHILE) && skip_expression(t) && match(t, TOKEN_L_CURLY) && reference_FUNC_STMT_LIST(t) &&
+               match(t, TOKEN_R_CURLY);
+    default:
+        return false;
+    }
+}
+
+static bool reference_FUNC_IF(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // FUNC_IF -> if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE
+    case TOKEN_IF:
+        return match(t, TOKEN_IF) && reference_IF_COND(t) && match(t, TOKEN_L_CURLY) && reference_FUNC_STMT_LIST(t) &&
+               match(t, TOKEN_R_CURLY) && reference_FUNC_ELSE_CLAUSE(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_FUNC_ELSE_IF(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // FUNC_ELSE_IF -> if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE
+    case TOKEN_IF:
+        return match(t, TOKEN_IF) && reference_IF_COND(t) && match(t, TOKEN_L_CURLY) && reference_FUNC_STMT_LIST(t) &&
+               match(t, TOKEN_R_CURLY) && reference_FUNC_ELSE_CLAUSE(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_FUNC_ELSE_CLAUSE(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // FUNC_ELSE_CLAUSE -> eps
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+    case TOKEN_VAR:
+    case TOKEN_LET:
+    case TOKEN_R_CURLY:
+    case TOKEN_RETURN:
+    case TOKEN_WHILE:
+    case TOKEN_IF:
+        return true;
+    // FUNC_ELSE_CLAUSE -> else FUNC_AFTER_ELSE
+    case TOKEN_ELSE:
+        return match(t, TOKEN_ELSE) && reference_FUNC_AFTER_ELSE(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_FUNC_AFTER_ELSE(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // FUNC_AFTER_ELSE -> { FUNC_STMT_LIST }
+    case TOKEN_L_CURLY:
+        return match(t, TOKEN_L_CURLY) && reference_FUNC_STMT_LIST(t) && match(t, TOKEN_R_CURLY);
+    // FUNC_AFTER_ELSE -> FUNC_ELSE_IF
+    case TOKEN_IF:
+        return reference_FUNC_ELSE_IF(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_IF_STMT(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // IF_STMT -> if IF_COND { LOCAL_STMT_LIST } ELSE_CLAUSE
+    case TOKEN_IF:
+        return match(t, TOKEN_IF) && reference_IF_COND(t) && match(t, TOKEN_L_CURLY) && reference_LOCAL_STMT_LIST(t) &&
+               match(t, TOKEN_R_CURLY) && reference_ELSE_CLAUSE(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_ELSE_IF_STMT(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // ELSE_IF_STMT -> if IF_COND { LOCAL_STMT_LIST } ELSE_CLAUSE
+    case TOKEN_IF:
+        return match(t, TOKEN_IF) && reference_IF_COND(t) && match(t, TOKEN_L_CURLY) && reference_LOCAL_STMT_LIST(t) &&
+               match(t, TOKEN_R_CURLY) && reference_ELSE_CLAUSE(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_IF_COND(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // IF_COND -> EXP
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+    case TOKEN_L_BRACKET:
+    case TOKEN_DOUBLE:
+    case TOKEN_INT:
+    case TOKEN_STRING:
+    case TOKEN_BOOL:
+    case TOKEN_NIL:
+    case TOKEN_EXP:
+    case TOKEN_NOT:
+        return skip_expression(t);
+    // IF_COND -> let id
+    case TOKEN_LET:
+        return match(t, TOKEN_LET) && match(t, TOKEN_IDENTIFICATOR);
+    default:
+        return false;
+    }
+}
+
+static bool reference_ELSE_CLAUSE(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // ELSE_CLAUSE -> eps
+    case TOKEN_IDENTIFICATOR:
+    case TOKEN_FUNC_ID:
+    case TOKEN_VAR:
+    case TOKEN_LET:
+    case TOKEN_FUNC:
+    case TOKEN_R_CURLY:
+    case TOKEN_WHILE:
+    case TOKEN_IF:
+    case TOKEN_EOF:
+        return true;
+    // ELSE_CLAUSE -> else AFTER_ELSE
+    case TOKEN_ELSE:
+        return match(t, TOKEN_ELSE) && reference_AFTER_ELSE(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_AFTER_ELSE(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // AFTER_ELSE -> { LOCAL_STMT_LIST }
+    case TOKEN_L_CURLY:
+        return match(t, TOKEN_L_CURLY) && reference_LOCAL_STMT_LIST(t) && match(t, TOKEN_R_CURLY);
+    // AFTER_ELSE -> ELSE_IF_STMT
+    case TOKEN_IF:
+        return reference_ELSE_IF_STMT(t);
+    default:
+        return false;
+    }
+}
+
+static bool reference_WHILE_STMT(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // WHILE_STMT -> while EXP { LOCAL_STMT_LIST }
+    case TOKEN_WHILE:
+        return match(t, TOKEN_WHILE) && skip_expression(t) && match(t, TOKEN_L_CURLY) && reference_LOCAL_STMT_LIST(t) &&
+               match(t, TOKEN_R_CURLY);
+    default:
+        return false;
+    }
+}
+
+static bool reference_LOAD_ID(Bench_tokens *t)
+{
+    switch (t->types[t->pos])
+    {
+    // LOAD_ID -> id = EXP
+    case TOKEN_IDENTIFICATOR:
+        return match(t, TOKEN_IDENTIFICATOR) && match(t, TOKEN_ASSIGN) && skip_expression(t);
+    // LOAD_ID -> func_id
+    case TOKEN_FUNC_ID:
+        return skip_expression(t);
+    default:
+        return false;
+    }
+}
+
+/// TABLE PARSER
+
+/**
+ * @brief The loop of parse_symbol in parser.c over the generated table, without the semantic actions and the recovery.
+ */
+static bool table_parse(Bench_tokens *t)
+{
+    size_t capacity = 64;
+    size_t size = 0;
+    const Ll_symbol **stack = malloc(sizeof(const Ll_symbol *) * capacity);
+    if (stack == NULL)
+    {
+        return false;
+    }
+    stack[size++] = &ll_start;
+
+    bool result = true;
+    while (result && size > 0)
+    {
+        const Ll_symbol *top = stack[--size];
+        switch (top->kind)
+        {
+        case LL_TERMINAL:
+            result = match(t, (Token_type)top->value);
+            break;
+        case LL_EXPRESSION:
+            result = skip_expression(t);
+            break;
+        case LL_ACTION:
+            break;
+        case LL_NONTERMINAL:
+        {
+            const Ll_production *production = ll_predict(top->value, t->types[t->pos]);
+            if (production == NULL)
+            {
+                result = false;
+                break;
+            }
+            while (size + production->len > capacity)
+            {
+                capacity *= 2;
+                const Ll_symbol **grown = realloc(stack, sizeof(const Ll_symbol *) * capacity);
+                if (grown == NULL)
+                {
+                    free(stack);
+                    return false;
+                }
+                stack = grown;
+            }
+            // the right hand side is pushed in reverse so its first symbol is processed first
+            for (int i = production->len - 1; i >= 0; i--)
+            {
+                stack[size++] = &production->symbols[i];
+            }
+            break;
+        }
+        }
+    }
+    free(stack);
+    return result;
+}
+
+/// PARSE ONLY
+
+/**
+ * @brief Reads the tokens of the program by the scanner.
+ *
+ * @return int - 0 on success, 1 on a lexical error or if the memory could not be allocated
+ */
+static int read_tokens(const char *path, Bench_tokens *t)
+{
+    size_t capacity = 1024;
+    t->types = malloc(sizeof(Token_type) * capacity);
+    t->nl = malloc(sizeof(bool) * capacity);
+    t->count = 0;
+    t->pos = 0;
+
+    scanner_open(path);
+    Token token;
+    do
+    {
+        if (t->types == NULL || t->nl == NULL || generate_token(&token) != 0)
+        {
+            scanner_close();
+            return 1;
+        }
+        if (t->count == capacity)
+        {
+            capacity *= 2;
+            t->types = realloc(t->types, sizeof(Token_type) * capacity);
+            t->nl = realloc(t->nl, sizeof(bool) * capacity);
+            if (t->types == NULL || t->nl == NULL)
+            {
+                scanner_close();
+                return 1;
+            }
+        }
+        t->types[t->count] = token.type;
+        t->nl[t->count] = token.preceded_by_nl;
+        t->count++;
+    } while (token.type != TOKEN_EOF);
+    scanner_close();
+    return 0;
+}
+
+/**
+ * @brief Parses the tokens the count of rounds, the whole input has to be accepted.
+ *
+ * @return double - the best time in seconds, negative if the input was not accepted
+ */
+static double time_parse(Bench_tokens *t, bool (*parse)(Bench_tokens *t))
+{
+    double best = 1e9;
+    for (int round = 0; round < PARSE_ROUNDS; round++)
+    {
+        t->pos = 0;
+        double start = now();
+        bool accepted = parse(t);
+        double elapsed = now() - start;
+        if (!accepted || t->pos != t->count - 1)
+        {
+            printf("parse failed at token %zu of %zu\n", t->pos, t->count);
+            return -1;
+        }
+        best = elapsed < best ? elapsed : best;
+    }
+    return best;
+}
+
+static const int func_counts[] = {2000, 4000, 8000};
+
+/**
+ * @brief Writes a function with declarations and if/else if/else chains, there are no loops because the code of
+ * every loop goes through a temporary file.
+ */
+static void write_func(FILE *f, int i, __attribute__((unused)) int funcs)
+{
+    fprintf(f, "func f%d(_ n: Int, with s: String) -> Int {\n", i);
+    fprintf(f, "    var total: Int = n\n    let text: String? = s\n");
+    fprintf(f, "    if n < 10 {\n        total = total + n\n    } else if n == 10 {\n");
+    fprintf(f, "        write(text!)\n    } else {\n        if n > 15 {\n            total = total - 1\n        }\n    }\n");
+    fprintf(f, "    if let text {\n        write(text)\n    }\n    return total\n}\n");
+}
+
+static void write_calls(FILE *f, int funcs)
+{
+    for (int i = 0; i < funcs; i++)
+    {
+        fprintf(f, "let v%d = f%d(%d, with: \"x\")\n", i, i, i % 20);
+    }
+}
+
+/**
+ * @brief The nested block is written as a program whose every function is one more if around the statement.
+ */
+static void write_nested_open(FILE *f, __attribute__((unused)) int depth)
+{
+    fprintf(f, "var a = 0\n");
+}
+
+static void write_nested_if(FILE *f, __attribute__((unused)) int i, __attribute__((unused)) int depth)
+{
+    fprintf(f, "if true {\n");
+}
+
+static void write_nested_close(FILE *f, int depth)
+{
+    fprintf(f, "a = a + 1\n");
+    for (int i = 0; i < depth; i++)
+    {
+        fprintf(f, "}\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bench_ctx.diagnostics = stderr;
+    compiler = &bench_ctx;
+    const char *compiler = argc > 1 ? argv[1] : "./ifjcompiler";
+    char path[] = "/tmp/ifj_bench_parser.swift";
+    char command[256];
+    snprintf(command, sizeof(command), "%s %s > /dev/null", compiler, path);
+
+    for (size_t i = 0; i < COUNT_OF(func_counts); i++)
+    {
+        if (write_program(path, func_counts[i], NULL, write_func, write_calls) != 0)
+        {
+            return 1;
+        }
+        struct stat st;
+        stat(path, &st);
+        double best = best_time(command, COMPILE_ROUNDS);
+        if (best < 0)
+        {
+            return 1;
+        }
+        printf("statements  %5d functions  %8.1f KiB  %9.3f ms  %6.2f MiB/s\n", func_counts[i], st.st_size / 1024.0,
+               best * 1e3, st.st_size / best / (1024 * 1024));
+
+        // the parsers alone, the reference is the recursive descent the generated table replaced
+        Bench_tokens tokens;
+        if (read_tokens(path, &tokens) != 0)
+        {
+            printf("the tokens of %s could not be read\n", path);
+            return 1;
+        }
+        double recursive = time_parse(&tokens, reference_START);
+        double table = time_parse(&tokens, table_parse);
+        free(tokens.types);
+        free(tokens.nl);
+        if (recursive < 0 || table < 0)
+        {
+            return 1;
+        }
+        printf("parse only  %8zu tokens  recursive %8.3f ms  %6.1f Mtokens/s  table %8.3f ms  %6.1f Mtokens/s  %5.2fx\n",
+               tokens.count, recursive * 1e3, tokens.count / recursive / 1e6, table * 1e3, tokens.count / table / 1e6,
+               recursive / table);
+    }
+
+    if (write_program(path, NESTING, write_nested_open, write_nested_if, write_nested_close) != 0)
+    {
+        return 1;
+    }
+    snprintf(command, sizeof(command), "ulimit -s %d && %s %s > /dev/null", STACK_LIMIT, compiler, path);
+    double best = best_time(command, COMPILE_ROUNDS);
+    if (best < 0)
+    {
+        return 1;
+    }
+    printf("nested      %6d blocks  %4d KiB stack  %9.3f ms\n", NESTING, STACK_LIMIT, best * 1e3);
+    return 0;
+}
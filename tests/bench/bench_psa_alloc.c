@@ -0,0 +1,125 @@
+/**
+ * @file bench_psa_alloc.c
+ * @brief Heap allocations and time per expression token of the PSA, fails if the expressions allocate per token.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ * The benchmark is linked with the whole compiler and with malloc, calloc and realloc wrapped by the linker
+ * (-Wl,--wrap), so it counts every allocation the compilation makes. Two programs differing only in the count of
+ * the expression statements are compiled, the difference of their allocations is the cost of the expressions. The
+ * compilations are complete, from the parser and the semantic analysis to the lowering of the syntax tree and the
+ * generated code. The syntax tree nodes and the operands of the instructions come from the chunks of the arena, a few
+ * chunks per thousands of tokens are expected.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "../../compiler.h"
+
+#define ROUNDS 3                    // the best of the rounds is reported
+#define MAX_ALLOCS_PER_TOKEN 0.01   // more allocations than this per expression token fail the benchmark
+
+// 19 tokens, operators of several precedences and brackets
+static const char *statement = "x = a + a * (a - a) + (a + 1) * a - a\n";
+static const int statement_tokens = 19;
+
+static size_t allocs = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    allocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    allocs++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    allocs++;
+    return __real_realloc(ptr, size);
+}
+
+/**
+ * @brief Compiles the program of the statements, the allocations of the compilation are counted.
+ *
+ * @return double - time of the compilation in seconds, negative if it has failed
+ */
+static double compile(int statements, size_t *count)
+{
+    size_t len = strlen(statement);
+    const char *header = "let a = 3\nvar x = 0\n";
+    const char *footer = "write(x)\n";
+    char *data = malloc(strlen(header) + len * statements + strlen(footer) + 1);
+    if (data == NULL)
+    {
+        return -1;
+    }
+    char *end = data + strlen(strcpy(data, header));
+    for (int i = 0; i < statements; i++)
+    {
+        end = memcpy(end, statement, len) + len;
+    }
+    end += strlen(strcpy(end, footer));
+
+    FILE *out = fopen("/dev/null", "w");
+    if (out == NULL)
+    {
+        free(data);
+        return -1;
+    }
+    Compiler ctx;
+    compiler_init(&ctx, out);
+    Compiler_options options = {.pretokenize = false, .lex_threads = 1, .cache_dir = NULL, .func_threads = 0};
+    size_t before = allocs;
+    double start = now();
+    Error_code code = compiler_run_buffer(&ctx, data, (size_t)(end - data), options, out);
+    double elapsed = now() - start;
+    *count = allocs - before;
+    compiler_free(&ctx);
+    fclose(out);
+    return code == NO_ERR ? elapsed : -1;
+}
+
+int main()
+{
+    const int small = 2000, large = 4000;
+    size_t small_allocs, large_allocs;
+    double best = 1e9;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        double small_time = compile(small, &small_allocs);
+        double large_time = compile(large, &large_allocs);
+        if (small_time < 0 || large_time < 0)
+        {
+            printf("compilation failed\n");
+            return 1;
+        }
+        double per_token = (large_time - small_time) / ((double)(large - small) * statement_tokens);
+        best = per_token < best ? per_token : best;
+    }
+
+    double tokens = (double)(large - small) * statement_tokens;
+    double per_token = ((double)large_allocs - (double)small_allocs) / tokens;
+    printf("psa   %8.0f expression tokens  %9.4f allocations/token  %8.1f ns/token\n", tokens, per_token, best * 1e9);
+    if (per_token > MAX_ALLOCS_PER_TOKEN)
+    {
+        printf("the expressions allocate per token\n");
+        return 1;
+    }
+    return 0;
+}
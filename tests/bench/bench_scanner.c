@@ -0,0 +1,1042 @@
+/**
+ * @file bench_scanner.c
+ * @brief Throughput benchmark of the scanner on a typical program repeated to a few megabytes. The lexer_next of the
+ * scanner before the generated table is kept here as the reference, and both lexers are run on the same source. The
+ * input is also pretokenized on one thread and, if there are more processors, on a thread per processor, which shows
+ * the gain of the parallel lexing.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+#include "../../scanner.h"
+#include "../../compiler.h"
+
+// the scanner is linked without the rest of the compiler, so the compilation it runs in is set up here
+__thread Compiler *compiler = NULL;
+static Compiler bench_ctx;
+
+#define INPUT_SIZE (4 * 1024 * 1024) // size of the scanned input
+#define ROUNDS 5                     // the best of the rounds is reported
+
+// mix of declarations, expressions, calls, literals and comments
+static const char *snippet =
+    "func compute_value(with value: Int, _ factor: Double?) -> Double {\n"
+    "    var result_0 : Double = 0.0 // running total\n"
+    "    let scale = factor ?? 1.5e3\n"
+    "    while (value >= 10 && result_0 != 2.25) {\n"
+    "        result_0 = result_0 + Int2Double(value) * scale / 3.0\n"
+    "        if value < 100 || value == 7 { write(\"small value\\n\", value) } else { return result_0 }\n"
+    "    }\n"
+    "    /* block comment\n"
+    "       over two lines */\n"
+    "    return result_0 - 42\n"
+    "}\n"
+    "let text: String = \"\"\"\n"
+    "    multi line\n"
+    "    string\n"
+    "    \"\"\"\n"
+    "var _counter = compute_value(with: 12345, nil)\n";
+
+// characters that end a run of plain characters in a string, (char)EOF is included as it is treated as the end of input
+#define REF_STRING_SPECIAL_CHARS "\"\\\n\r\xff"
+#define REF_STRING_BLOCK_SPECIAL_CHARS "\"\\\n\r \t\xff"
+
+/**
+ * States of the reference lexer, the ones of scanner.h before the generated table.
+ */
+typedef enum
+{
+    REF_NEW_TOKEN,
+    REF_COMMENTARY,
+    REF_COMMENTARY_BL,
+    REF_UNDERSCORE,
+    REF_END_STATE,
+    REF_INTEGER,
+    REF_DEC_POINT,
+    REF_EXP_START,
+    REF_STRING,
+    REF_STRING_ESCAPE,
+    REF_STRING_1,
+    REF_STRING_2,
+    REF_STRING_3,
+    REF_STRING_1_END,
+    REF_STRING_2_END,
+    REF_STRING_BLOCK,
+    REF_STRING_BLOCK_ESCAPE,
+    REF_HEX_START_BLOCK,
+    REF_HEX_START,
+    REF_IDENTIFICATOR,
+} Reference_state;
+
+/**
+ * @brief - The lexer with the state of the reference, the state of lx is not used
+ */
+typedef struct
+{
+    Lexer lx;
+    Reference_state state;
+} Reference_lexer;
+
+/*
+ * Reads next character from the source buffer, reading past the end always yields EOF
+ */
+static inline char next_char(Lexer *lx)
+{
+    size_t pos = lx->pos++;
+    return pos < lx->len ? lx->data[pos] : (char)EOF;
+}
+
+/*
+ * Returns the last read character back to the source buffer
+ */
+static inline void unget_char(Lexer *lx)
+{
+    lx->pos--;
+}
+
+/**
+ * Appends one character to the lexeme, the buffer grows geometrically
+ */
+static inline void lexeme_push(Lexeme *lexeme, char c)
+{
+    if (lexeme->len + 2 > lexeme->cap)
+    {
+        lexeme_grow(lexeme, 1);
+    }
+    lexeme->data[lexeme->len++] = c;
+}
+
+/**
+ * Empties the lexeme while keeping its buffer
+ */
+static inline void lexeme_clear(Lexeme *lexeme)
+{
+    lexeme->len = 0;
+}
+
+/**
+ * @brief Sets the token by the scanner's set_token and moves the reference to the next state.
+ */
+static int reference_set_token(Reference_lexer *ref, Reference_state next_state, char *val, Token_type type, Token *token)
+{
+    int ret = set_token(&ref->lx, NEW_TOKEN, val, type, token);
+    if (ret == 0)
+    {
+        ref->state = next_state;
+    }
+    return ret;
+}
+
+/**
+ * @brief The lexer_next of the scanner before the generated table, a switch on the state for every character.
+ */
+static int reference_next(Reference_lexer *ref, Token *token)
+{
+    Lexer *lx = &ref->lx;
+    // Initialization of used flags
+    token->preceded_by_nl = false;
+    Lexeme *code = &lx->lexeme;
+    lexeme_clear(code);
+    int previous_indent_cnt = 0;
+    bool indent_set = false;
+    bool string_newline = false;
+    bool first_line = true;
+
+    while (1)
+    {
+        // Finite state machine to recognize different tokens.
+        switch (ref->state)
+        {
+        /*
+         * REF_NEW_TOKEN state each time before generating new token
+         */
+        case REF_NEW_TOKEN:
+        {
+            lexeme_clear(code);
+            lx->lexeme_start = lx->pos;
+            char c = next_char(lx);
+            switch (c)
+            {
+            case '\t':
+            case ' ':
+            case '\v':
+            case '\r':
+            case '\f':
+            case '\n':
+            {
+                // the whole run of whitespace is skipped at once, newlines in it are counted in bulk
+                size_t start = lx->pos - 1;
+                size_t end = scan_skip_any(lx->data, lx->pos, lx->len, " \t\v\r\f\n", 6);
+                size_t newlines = scan_count(lx->data, start, end, '\n', '\f');
+                if (newlines > 0)
+                {
+                    token->preceded_by_nl = true;
+                    lx->line_num += newlines;
+                }
+                lx->pos = end;
+                ref->state = REF_NEW_TOKEN;
+                break;
+            }
+            case EOF:
+                return reference_set_token(ref, REF_END_STATE, "", TOKEN_EOF, token);
+            case ',':
+                return reference_set_token(ref, REF_NEW_TOKEN, ",", TOKEN_COMMA, token);
+            case ':':
+                return reference_set_token(ref, REF_NEW_TOKEN, ":", TOKEN_DOUBLE_DOT, token);
+            case '+':
+                return reference_set_token(ref, REF_NEW_TOKEN, "+", TOKEN_PLUS, token);
+            case '-':
+                c = next_char(lx);
+                if (c == '>')
+                {
+                    return reference_set_token(ref, REF_NEW_TOKEN, "->", TOKEN_ARROW, token);
+                }
+                else
+                {
+                    unget_char(lx);
+                    return reference_set_token(ref, REF_NEW_TOKEN, "-", TOKEN_MINUS, token);
+                }
+            case '*':
+                return reference_set_token(ref, REF_NEW_TOKEN, "*", TOKEN_MUL, token);
+            case '/':
+                c = next_char(lx);
+                /*
+                 * REF_COMMENTARY starts after '//' is read from stdin
+                 * REF_COMMENTARY_BL starts after '/'+'*' is read from stdin
+                 * Any other pair or subsequent sequence means nothing else so '/' is generated as division
+                 */
+                if (c == '/')
+                {
+                    ref->state = REF_COMMENTARY;
+                }
+                else if (c == '*')
+                {
+                    ref->state = REF_COMMENTARY_BL;
+                }
+                else
+                {
+                    unget_char(lx);
+                    return reference_set_token(ref, REF_NEW_TOKEN, "/", TOKEN_DIV, token);
+                }
+                break;
+            case ')':
+                return reference_set_token(ref, REF_NEW_TOKEN, ")", TOKEN_R_BRACKET, token);
+            case '(':
+                return reference_set_token(ref, REF_NEW_TOKEN, "(", TOKEN_L_BRACKET, token);
+            case '}':
+                return reference_set_token(ref, REF_NEW_TOKEN, "}", TOKEN_R_CURLY, token);
+            case '{':
+                return reference_set_token(ref, REF_NEW_TOKEN, "{", TOKEN_L_CURLY, token);
+            case '?':
+                c = next_char(lx);
+                /*
+                 * Only valid combinations with ? are ?? or suffix of identificator
+                 */
+                if (c == '?')
+                {
+                    return reference_set_token(ref, REF_NEW_TOKEN, "??", TOKEN_BINARY_OPERATOR, token);
+                }
+                else
+                {
+                    unget_char(lx);
+                    lx->ret = LEXICAL_ERR;
+                    return LEXICAL_ERR;
+                }
+            case '<':
+                c = next_char(lx);
+                if (c == '=')
+                {
+                    return reference_set_token(ref, REF_NEW_TOKEN, "<=", TOKEN_LESS_EQ, token);
+                }
+                else
+                {
+                    unget_char(lx);
+                    return reference_set_token(ref, REF_NEW_TOKEN, "<", TOKEN_LESS, token);
+                }
+            case '>':
+                c = next_char(lx);
+                if (c == '=')
+                {
+                    return reference_set_token(ref, REF_NEW_TOKEN, ">=", TOKEN_MORE_EQ, token);
+                }
+                else
+                {
+                    unget_char(lx);
+                    return reference_set_token(ref, REF_NEW_TOKEN, ">", TOKEN_MORE, token);
+                }
+            case '=':
+                /*
+                 * After '=' is read and there is no other '=' sign after that we generate TOKEN_ASSIGN
+                 * Otherwise only 3 subsequent '==' means equal so any other sequence is LEXICAL_ERR
+                 */
+                c = next_char(lx);
+                if (c == '=')
+                {
+                    return reference_set_token(ref, REF_NEW_TOKEN, "==", TOKEN_EQ, token);
+                }
+                else
+                {
+                    unget_char(lx);
+                    return reference_set_token(ref, REF_NEW_TOKEN, "=", TOKEN_ASSIGN, token);
+                }
+            case '!':
+                /*
+                 * '!' at the beginning of token tas to create sequence '!=' otherwise it has no meaning and ends with LEXICAL_ERR
+                 */
+                c = next_char(lx);
+                if (c == '=')
+                {
+                    return reference_set_token(ref, REF_NEW_TOKEN, "!=", TOKEN_NEQ, token);
+                }
+                else
+                {
+                    unget_char(lx);
+                    return reference_set_token(ref, REF_NEW_TOKEN, "!", TOKEN_NOT, token);
+                }
+            case '&':
+                c = next_char(lx);
+                if (c == '&')
+                {
+                    return reference_set_token(ref, REF_NEW_TOKEN, "&&", TOKEN_AND, token);
+                }
+                else
+                {
+                    unget_char(lx);
+                    lx->ret = LEXICAL_ERR;
+                    return LEXICAL_ERR;
+                }
+            case '|':
+                c = next_char(lx);
+                if (c == '|')
+                {
+                    return reference_set_token(ref, REF_NEW_TOKEN, "||", TOKEN_OR, token);
+                }
+                else
+                {
+                    unget_char(lx);
+                    lx->ret = LEXICAL_ERR;
+                    return LEXICAL_ERR;
+                }
+            case '"':
+                ref->state = REF_STRING_1;
+                break;
+            case '0' ... '9':
+                lexeme_push(code, c);
+                ref->state = REF_INTEGER;
+                break;
+            case 'A' ... 'Z':
+            case 'a' ... 'z':
+                lexeme_push(code, c);
+                ref->state = REF_IDENTIFICATOR;
+                break;
+            case '_':
+                ref->state = REF_UNDERSCORE;
+                break;
+            default:
+                return LEXICAL_ERR;
+            }
+            break;
+        }
+        case REF_UNDERSCORE:
+        {
+            char c = next_char(lx);
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c <= '9' && c >= '0') || c == '_')
+            {
+                lexeme_push(code, '_');
+                unget_char(lx);
+                ref->state = REF_IDENTIFICATOR;
+            }
+            else
+            {
+                unget_char(lx);
+                return reference_set_token(ref, REF_NEW_TOKEN, intern("_", 1), TOKEN_IDENTIFICATOR, token);
+            }
+            break;
+        }
+        case REF_COMMENTARY:
+        {
+            // jump right before the end of line, the newline itself is handled as whitespace
+            lx->pos = scan_find_any(lx->data, lx->pos, lx->len, "\n\f", 2);
+            ref->state = REF_NEW_TOKEN;
+            break;
+        }
+            /*
+             * Block commentary has to end with sequence '*'+'/'otherwise it cannot be considered a commentary and LEXICAL_ERR is generated
+             */
+        case REF_COMMENTARY_BL:
+        {
+            // jump from one '*' to another, counting the skipped lines
+            size_t pos = lx->pos;
+            while (1)
+            {
+                size_t star = scan_find_any(lx->data, pos, lx->len, "*", 1);
+                lx->line_num += scan_count(lx->data, pos, star, '\n', '\n');
+                if (star >= lx->len)
+                {
+                    lx->pos = lx->len;
+                    return LEXICAL_ERR;
+                }
+                if (star + 1 < lx->len && lx->data[star + 1] == '/')
+                {
+                    lx->pos = star + 2;
+                    ref->state = REF_NEW_TOKEN;
+                    break;
+                }
+                pos = star + 1;
+            }
+            break;
+        }
+        break;
+            /*
+             * We expect identifier to be a particular keyword,
+             * builtin function or some user defined identifier
+             */
+        case REF_IDENTIFICATOR:
+        {
+            char c = next_char(lx);
+            while ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')
+            {
+                lexeme_push(code, c);
+                c = next_char(lx);
+            }
+            // Keywords are looked up in the perfect hash table, types followed by ? are types with nil possibility
+            Token_type keyword_type;
+            if (keyword_lookup(code->data, code->len, &keyword_type))
+            {
+                if (c == '?' && keyword_type >= TOKEN_TYPE_STRING && keyword_type <= TOKEN_TYPE_BOOL)
+                {
+                    lexeme_push(code, c);
+                    keyword_type += TOKEN_TYPE_STRING_NIL - TOKEN_TYPE_STRING;
+                }
+                else
+                {
+                    unget_char(lx);
+                }
+                return reference_set_token(ref, REF_NEW_TOKEN, intern(code->data, code->len), keyword_type, token);
+            }
+            unget_char(lx);
+            // Identifiers are interned, so equal names share one pointer with precomputed hash
+            char *name = intern(code->data, code->len);
+            // Look past the spaces after identifier to find out whether it is a function identifier
+            size_t lookahead = lx->pos;
+            bool had_newline = false;
+            bool had_space = false;
+            unsigned int skipped_lines = 0;
+            while (lookahead < lx->len && isspace(lx->data[lookahead]))
+            {
+                if (lx->data[lookahead] == ' ')
+                {
+                    had_space = true;
+                }
+                else if (lx->data[lookahead] == '\n' || lx->data[lookahead] == '\f')
+                {
+                    skipped_lines++;
+                    had_newline = true;
+                }
+                lookahead++;
+            }
+            if (lookahead < lx->len && lx->data[lookahead] == '(')
+            {
+                lx->pos = lookahead;
+                lx->line_num += skipped_lines;
+                return reference_set_token(ref, REF_NEW_TOKEN, name, TOKEN_FUNC_ID, token);
+            }
+            else
+            {
+                // spaces other than ' ' and newline carry no meaning for the next token, so they are dropped
+                if (!had_space && !had_newline)
+                {
+                    lx->pos = lookahead;
+                }
+                return reference_set_token(ref, REF_NEW_TOKEN, name, TOKEN_IDENTIFICATOR, token);
+            }
+        }
+        break;
+            /*
+             * TOKEN_INT is generated if integer is read and there is no dec.point subsequent to it
+             * TOKEN_DOUBLE is generated if dec.point and dec.part has been read
+             * state = REF_EXP_START if there is e/E read after the end of float/int
+             */
+        case REF_DEC_POINT:
+        case REF_INTEGER:
+        {
+            if (ref->state == REF_INTEGER)
+            {
+                unget_char(lx);
+                code->len--;
+            }
+            char c = next_char(lx);
+            while (c <= '9' && c >= '0')
+            {
+                if (c != '0' || code->len != 0)
+                {
+                    lexeme_push(code, c);
+                }
+                c = next_char(lx);
+            }
+            if (code->len == 0)
+            {
+                lexeme_push(code, '0');
+            }
+            if (c == 'e' || c == 'E')
+            {
+                lexeme_push(code, c);
+                ref->state = REF_EXP_START;
+            }
+            else if (c == '.' && ref->state == REF_INTEGER)
+            {
+                lexeme_push(code, c);
+                ref->state = REF_DEC_POINT;
+                break;
+            }
+            else
+            {
+                unget_char(lx);
+                if (ref->state == REF_INTEGER)
+                {
+                    return reference_set_token(ref, REF_NEW_TOKEN, lexeme_take(code), TOKEN_INT, token);
+                }
+                else
+                {
+                    return reference_set_token(ref, REF_NEW_TOKEN, lexeme_take(code), TOKEN_DOUBLE, token);
+                }
+            }
+        }
+        break;
+            /*
+             * E/e was read and after possible sign there has to be integer otherwise its LEXICAL_ERR
+             */
+        case REF_EXP_START:
+        {
+            char c = next_char(lx);
+            if (c == '+' || c == '-')
+            {
+                lexeme_push(code, c);
+                c = next_char(lx);
+            }
+            if (c >= '0' && c <= '9')
+            {
+                while (c >= '0' && c <= '9')
+                {
+                    if (c != '0' ||
+                        (code->data[code->len - 1] != '-' && code->data[code->len - 1] != '+'))
+                    {
+                        lexeme_push(code, c);
+                    }
+                    c = next_char(lx);
+                }
+            }
+            else
+            {
+                unget_char(lx);
+                return LEXICAL_ERR;
+            }
+            if (code->len == 0)
+            {
+                lexeme_push(code, '0');
+            }
+            unget_char(lx);
+            return reference_set_token(ref, REF_NEW_TOKEN, lexeme_take(code), TOKEN_EXP, token);
+        }
+        break;
+            /*
+             *  """  has been read
+             * Characters are read till """ is read again
+             */
+        case REF_STRING_BLOCK:
+        {
+            int curr_indent_cnt = 0;
+            char c = next_char(lx);
+
+            while (c != '"')
+            {
+                if (c == '\\')
+                {
+                    ref->state = REF_STRING_BLOCK_ESCAPE;
+                    break;
+                }
+                else if (c == EOF)
+                {
+                    unget_char(lx);
+                    return LEXICAL_ERR;
+                }
+                else
+                {
+                    while (c == '\n' || c == '\r')
+                    {
+                        indent_set = true;
+                        curr_indent_cnt = 0;
+                        string_newline = true;
+                        lx->line_num++;
+                        c = next_char(lx);
+                    }
+
+                    while (c == ' ' || c == '\t')
+                    {
+                        curr_indent_cnt++;
+                        c = next_char(lx);
+                    }
+
+                    if (indent_set && c != '\n')
+                    {
+                        if (first_line)
+                        {
+                            previous_indent_cnt = curr_indent_cnt;
+                            first_line = false;
+                        }
+                        else if (previous_indent_cnt != curr_indent_cnt)
+                        {
+                            return LEXICAL_ERR;
+                        }
+                    }
+
+                    indent_set = false;
+                    curr_indent_cnt = 0;
+
+                    if (c == '\n')
+                    {
+                        unget_char(lx);
+                        break;
+                    }
+
+                    if (c == '"' && string_newline)
+                    {
+                        ref->state = REF_STRING_1_END;
+                        break;
+                    }
+
+                    lexeme_push(code, c);
+                    // plain characters up to the next one that needs handling are copied in bulk
+                    size_t end = scan_find_any(lx->data, lx->pos, lx->len, REF_STRING_BLOCK_SPECIAL_CHARS, 7);
+                    lexeme_append(code, lx->data + lx->pos, end - lx->pos);
+                    lx->pos = end;
+                    c = next_char(lx);
+                }
+            }
+
+            if (string_newline)
+            {
+                ref->state = REF_STRING_1_END;
+                break;
+            }
+            else if (ref->state != REF_STRING_BLOCK)
+            {
+                break;
+            }
+
+            return LEXICAL_ERR;
+        }
+            /*
+             *  "  has been read
+             * Characters are read till " is read again
+             */
+        case REF_STRING:
+        {
+            // plain characters are copied in bulk up to the next one that needs handling
+            size_t end = scan_find_any(lx->data, lx->pos, lx->len, REF_STRING_SPECIAL_CHARS, 5);
+            lexeme_append(code, lx->data + lx->pos, end - lx->pos);
+            lx->pos = end;
+            char c = next_char(lx);
+            if (c == '"')
+            {
+                return reference_set_token(ref, REF_NEW_TOKEN, lexeme_take(code), TOKEN_STRING, token);
+            }
+            else if (c == '\\')
+            {
+                ref->state = REF_STRING_ESCAPE;
+                break;
+            }
+            else if (c == EOF)
+            {
+                unget_char(lx);
+            }
+            return LEXICAL_ERR;
+        }
+            /*
+             * '\' was read while in REF_STRING or REF_STRING_BLOCK state
+             */
+        case REF_STRING_BLOCK_ESCAPE:
+        case REF_STRING_ESCAPE:
+        {
+            char c = next_char(lx);
+            switch (c)
+            {
+            case '{':
+                if (ref->state == REF_STRING_ESCAPE)
+                {
+                    ref->state = REF_HEX_START;
+                }
+                else
+                {
+                    ref->state = REF_HEX_START_BLOCK;
+                }
+                break;
+            case '\\':
+                lexeme_push(code, '\\');
+                if (ref->state == REF_STRING_ESCAPE)
+                {
+                    ref->state = REF_STRING;
+                }
+                else
+                {
+                    ref->state = REF_STRING_BLOCK;
+                }
+                break;
+            case 'n':
+                lexeme_push(code, '\n');
+                if (ref->state == REF_STRING_ESCAPE)
+                {
+                    ref->state = REF_STRING;
+                }
+                else
+                {
+                    ref->state = REF_STRING_BLOCK;
+                }
+                break;
+            case 't':
+                lexeme_push(code, '\t');
+                if (ref->state == REF_STRING_ESCAPE)
+                {
+                    ref->state = REF_STRING;
+                }
+                else
+                {
+                    ref->state = REF_STRING_BLOCK;
+                }
+                break;
+            case 'r':
+                lexeme_push(code, '\r');
+                if (ref->state == REF_STRING_ESCAPE)
+                {
+                    ref->state = REF_STRING;
+                }
+                else
+                {
+                    ref->state = REF_STRING_BLOCK;
+                }
+                break;
+            case '"':
+                lexeme_push(code, '"');
+                if (ref->state == REF_STRING_ESCAPE)
+                {
+                    ref->state = REF_STRING;
+                }
+                else
+                {
+                    ref->state = REF_STRING_BLOCK;
+                }
+                break;
+            default:
+                lexeme_push(code, '\\');
+                lexeme_push(code, c);
+                if (ref->state == REF_STRING_ESCAPE)
+                {
+                    ref->state = REF_STRING;
+                }
+                else
+                {
+                    ref->state = REF_STRING_BLOCK;
+                }
+                break;
+            }
+            break;
+        }
+            /* '\{' has been read
+             * correct indicated whether sequence is valid hexadecimal number in range 01 - ff (case-insensitive)
+             */
+        case REF_HEX_START_BLOCK:
+        case REF_HEX_START:
+        {
+            char hex[3];
+            memset(hex, '\0', sizeof(hex));
+            char c = '\0';
+            bool correct = 1;
+            for (int i = 0; i < 2; i++)
+            {
+                c = next_char(lx);
+                if (!((c <= '9' && c >= '0') || (c <= 'f' && c >= 'a') || (c <= 'F' && c >= 'A')))
+                {
+                    correct = 0;
+                    if (c == '"' || c == '\\')
+                    {
+                        lexeme_push(code, '{');
+                        lexeme_append(code, hex, strlen(hex));
+                        unget_char(lx);
+                    }
+                    else
+                    {
+                        hex[i] = c;
+                    }
+                }
+                else
+                {
+                    hex[i] = c;
+                }
+            }
+            c = '\0';
+            c = next_char(lx);
+            if (c != '}')
+            {
+                correct = 0;
+                unget_char(lx);
+            }
+            if (correct == 1)
+            {
+                char str[5];
+                memset(str, '\0', sizeof(str));
+                sprintf(str, "0x%s", hex);
+                long dec_num = strtol(str, NULL, 16);
+                char dec_val[20];
+                memset(dec_val, '\0', sizeof(dec_val));
+                sprintf(dec_val, "%ld", dec_num);
+                lexeme_append(code, dec_val, strlen(dec_val));
+            }
+            else
+            {
+                lexeme_push(code, '{');
+                lexeme_append(code, hex, strlen(hex));
+            }
+            if (ref->state == REF_HEX_START)
+            {
+                ref->state = REF_STRING;
+            }
+            else
+            {
+                ref->state = REF_STRING_BLOCK;
+            }
+            break;
+        }
+            // First " has been read
+        case REF_STRING_1:
+        {
+            char c = next_char(lx);
+            if (c == '"')
+            {
+                ref->state = REF_STRING_2;
+            }
+            else
+            {
+                unget_char(lx);
+                ref->state = REF_STRING;
+            }
+            break;
+        }
+            // Second " has been read
+        case REF_STRING_2:
+        {
+            char c = next_char(lx);
+            if (c == '"')
+            {
+                ref->state = REF_STRING_BLOCK;
+            }
+            else
+            {
+                unget_char(lx);
+                return reference_set_token(ref, REF_NEW_TOKEN, "", TOKEN_STRING, token);
+            }
+            break;
+        }
+            // In string block state " or "" has been read
+        case REF_STRING_1_END:
+        case REF_STRING_2_END:
+        {
+            char c = next_char(lx);
+            DEBUG_LEXER_CODE(printf("char:%c\n", c););
+            if (c == '"')
+            {
+                if (ref->state == REF_STRING_1_END)
+                {
+                    ref->state = REF_STRING_2_END;
+                    break;
+                }
+                else
+                {
+                    // Remove newline characters from the end of the string
+                    while (code->len > 0 && (code->data[code->len - 1] == '\n' || code->data[code->len - 1] == '\r'))
+                    {
+                        code->len--;
+                    }
+                    // Remove newline characters from the beginning of the string
+                    size_t start = 0;
+                    while (start < code->len && (code->data[start] == '\n' || code->data[start] == '\r'))
+                    {
+                        start++;
+                    }
+                    if (start > 0)
+                    {
+                        memmove(code->data, code->data + start, code->len - start);
+                        code->len -= start;
+                    }
+                    indent_set = false;
+                    return reference_set_token(ref, REF_NEW_TOKEN, lexeme_take(code), TOKEN_STRING, token);
+                }
+            }
+            else
+            {
+                lexeme_push(code, '"');
+                if (ref->state == REF_STRING_2_END)
+                {
+                    lexeme_push(code, '"');
+                }
+                unget_char(lx);
+                ref->state = REF_STRING_BLOCK;
+            }
+            break;
+        }
+        default:
+            return LEXICAL_ERR;
+        }
+    }
+}
+
+
+/**
+ * @brief Lexes the whole source by the reference or by lexer_next of the scanner, both produce the tokens with their
+ * values and literals.
+ *
+ * @return double - the best time of the rounds in seconds, negative if the tokens differ from the ones of the scanner
+ */
+static double bench_lexer(bool reference, size_t tokens)
+{
+    double best = 1e9;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        Reference_lexer ref = {0};
+        lexer_init(&ref.lx, compiler->source.data, compiler->source.len);
+        ref.state = REF_NEW_TOKEN;
+        size_t count = 0;
+        Token token;
+        double start = now();
+        do
+        {
+            if ((reference ? reference_next(&ref, &token) : lexer_next(&ref.lx, &token)) != 0)
+            {
+                printf("%s lexer: lexical error on line %u\n", reference ? "switch" : "table", ref.lx.line_num);
+                return -1;
+            }
+            count++;
+        } while (token.type != TOKEN_EOF);
+        double elapsed = now() - start;
+        free(ref.lx.lexeme.data);
+        if (count != tokens)
+        {
+            printf("%s lexer read %zu tokens, the scanner %zu\n", reference ? "switch" : "table", count, tokens);
+            return -1;
+        }
+        best = elapsed < best ? elapsed : best;
+    }
+    return best;
+}
+
+/**
+ * @brief Pretokenizes the whole input on the count of threads, returns the best time of the rounds.
+ */
+static double bench_pretokenize(const char *path, int threads, size_t *tokens)
+{
+    double best = 1e9;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        scanner_open(path);
+        double start = now();
+        scanner_pretokenize(threads);
+        double elapsed = now() - start;
+        *tokens = compiler->token_buffer.count;
+        scanner_close();
+        best = elapsed < best ? elapsed : best;
+    }
+    return best;
+}
+
+int main()
+{
+    bench_ctx.diagnostics = stderr;
+    compiler = &bench_ctx;
+    char path[] = "/tmp/ifj_bench_scanner.swift";
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+    {
+        perror(path);
+        return 1;
+    }
+    size_t size = 0;
+    size_t snippet_len = strlen(snippet);
+    while (size < INPUT_SIZE)
+    {
+        fputs(snippet, f);
+        size += snippet_len;
+    }
+    fclose(f);
+
+    double best = 1e9;
+    size_t tokens = 0;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        scanner_open(path);
+        double start = now();
+        Token token;
+        tokens = 0;
+        do
+        {
+            if (generate_token(&token) != 0)
+            {
+                printf("lexical error on line %u\n", compiler->main_lexer.line_num);
+                return 1;
+            }
+            tokens++;
+        } while (token.type != TOKEN_EOF);
+        double elapsed = now() - start;
+        scanner_close();
+        best = elapsed < best ? elapsed : best;
+    }
+    printf("scanner    %8zu B  %9.3f ms  %7.1f MB/s  %6.1f Mtokens/s\n", size, best * 1e3, size / best / 1e6,
+           tokens / best / 1e6);
+
+    // the lexers alone on the source read once, the reference is the lexer the generated table replaced
+    scanner_open(path);
+    double reference = bench_lexer(true, tokens);
+    double table = bench_lexer(false, tokens);
+    scanner_close();
+    if (reference < 0 || table < 0)
+    {
+        return 1;
+    }
+    printf("lexer  switch  %9.3f ms  %7.1f MB/s  %6.1f Mtokens/s\n", reference * 1e3, size / reference / 1e6,
+           tokens / reference / 1e6);
+    printf("lexer  table   %9.3f ms  %7.1f MB/s  %6.1f Mtokens/s  %5.2fx\n", table * 1e3, size / table / 1e6,
+           tokens / table / 1e6, reference / table);
+
+    int processors = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    double serial = bench_pretokenize(path, 1, &tokens);
+    printf("pretokenize  1 thread   %9.3f ms  %7.1f MB/s\n", serial * 1e3, size / serial / 1e6);
+    if (processors > 1)
+    {
+        size_t parallel_tokens = 0;
+        double parallel = bench_pretokenize(path, processors, &parallel_tokens);
+        if (parallel_tokens != tokens)
+        {
+            printf("pretokenize %d threads read %zu tokens, 1 thread %zu\n", processors, parallel_tokens, tokens);
+            return 1;
+        }
+        printf("pretokenize %2d threads  %9.3f ms  %7.1f MB/s  %5.2fx\n", processors, parallel * 1e3,
+               size / parallel / 1e6, serial / parallel);
+    }
+    else
+    {
+        // the threads are capped by the count of processors, so the parallel lexing would be the serial one
+        printf("pretokenize  one processor, the parallel lexing is not run\n");
+    }
+    remove(path);
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file bench_serve.c
+ * @brief Latency of compiling the programs of tests/blaza_tests, one process per program against one compile server
+ * the programs are sent to over a pipe.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "bench.h"
+
+#define ROUNDS 3      // every program is compiled this many times by both ways
+#define MAX_FILES 512 // programs read from the directory
+
+typedef struct
+{
+    char *path;
+    char *data;
+    size_t len;
+} Program;
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, double *times, size_t count)
+{
+    double total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        total += times[i];
+    }
+    qsort(times, count, sizeof(double), compare_doubles);
+    printf("%-18s %5zu compiles  mean %8.3f ms  p50 %8.3f ms  p95 %8.3f ms  total %8.1f ms\n", name, count,
+           total / count * 1e3, times[count / 2] * 1e3, times[count * 95 / 100] * 1e3, total * 1e3);
+}
+
+static size_t load_programs(const char *dir, Program *programs)
+{
+    DIR *d = opendir(dir);
+    if (d == NULL)
+    {
+        perror(dir);
+        return 0;
+    }
+    size_t count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL && count < MAX_FILES)
+    {
+        size_t len = strlen(entry->d_name);
+        if (len <= 6 || strcmp(entry->d_name + len - 6, ".swift") != 0)
+        {
+            continue;
+        }
+        Program *p = &programs[count];
+        p->path = malloc(strlen(dir) + len + 2);
+        sprintf(p->path, "%s/%s", dir, entry->d_name);
+        FILE *f = fopen(p->path, "rb");
+        if (f == NULL)
+        {
+            free(p->path);
+            continue;
+        }
+        fseek(f, 0, SEEK_END);
+        p->len = (size_t)ftell(f);
+        rewind(f);
+        p->data = malloc(p->len + 1);
+        p->len = fread(p->data, 1, p->len, f);
+        fclose(f);
+        count++;
+    }
+    closedir(d);
+    return count;
+}
+
+/**
+ * @brief Starts the compile server with its stdin and stdout connected to the returned streams.
+ */
+static pid_t start_server(const char *compiler, FILE **requests, FILE **responses)
+{
+    int to_server[2], from_server[2];
+    if (pipe(to_server) != 0 || pipe(from_server) != 0)
+    {
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        dup2(to_server[0], STDIN_FILENO);
+        dup2(from_server[1], STDOUT_FILENO);
+        close(to_server[1]);
+        close(from_server[0]);
+        execl(compiler, compiler, "--serve", (char *)NULL);
+        _exit(127);
+    }
+    close(to_server[0]);
+    close(from_server[1]);
+    *requests = fdopen(to_server[1], "w");
+    *responses = fdopen(from_server[0], "r");
+    return pid;
+}
+
+/**
+ * @brief Sends one program and reads the whole response.
+ *
+ * @return int - exit code of the compilation, -1 if the server has not answered
+ */
+static int serve_one(FILE *requests, FILE *responses, const Program *p)
+{
+    fprintf(requests, "%zu\n", p->len);
+    fwrite(p->data, 1, p->len, requests);
+    fflush(requests);
+
+    int code;
+    size_t diagnostics_len, code_len;
+    if (fscanf(responses, "%d %zu %zu", &code, &diagnostics_len, &code_len) != 3 || fgetc(responses) != '\n')
+    {
+        return -1;
+    }
+    for (size_t i = 0; i < diagnostics_len + code_len; i++)
+    {
+        if (fgetc(responses) == EOF)
+        {
+            return -1;
+        }
+    }
+    return code;
+}
+
+int main(int argc, char **argv)
+{
+    const char *compiler = argc > 1 ? argv[1] : "./ifjcompiler";
+    const char *dir = argc > 2 ? argv[2] : "tests/blaza_tests";
+
+    static Program programs[MAX_FILES];
+    size_t count = load_programs(dir, programs);
+    if (count == 0)
+    {
+        printf("no programs in %s\n", dir);
+        return 1;
+    }
+    double *times = malloc(sizeof(double) * count * ROUNDS);
+
+    // a new process for every program, like a build system calling the compiler
+    char command[1024];
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            snprintf(command, sizeof(command), "%s %s > /dev/null 2>&1", compiler, programs[i].path);
+            double start = now();
+            (void)!system(command);
+            times[round * count + i] = now() - start;
+        }
+    }
+    report("process per file", times, count * ROUNDS);
+
+    // one warm server compiling all the programs
+    FILE *requests, *responses;
+    pid_t pid = start_server(compiler, &requests, &responses);
+    if (pid < 0 || requests == NULL || responses == NULL)
+    {
+        printf("cannot start %s --serve\n", compiler);
+        return 1;
+    }
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            double start = now();
+            if (serve_one(requests, responses, &programs[i]) < 0)
+            {
+                printf("the server has not answered %s\n", programs[i].path);
+                return 1;
+            }
+            times[round * count + i] = now() - start;
+        }
+    }
+    fclose(requests);
+    fclose(responses);
+    waitpid(pid, NULL, 0);
+    report("compile server", times, count * ROUNDS);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        free(programs[i].path);
+        free(programs[i].data);
+    }
+    free(times);
+    return 0;
+}
@@ -0,0 +1,19 @@
+/**
+ * @file link_stub.c
+ * @brief Source files of the program for the benchmarks linked with the scanner only, their programs are one input.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <stddef.h>
+#include "../../link.h"
+
+const Source_file *link_file_of_line(int line)
+{
+    (void)line;
+    return NULL;
+}
@@ -102,25 +102,60 @@ extract_expected_values() {
         echo "Error: First line of test file is not in expected format."
         exit 1
     fi
+
+    # optional second line with the command line arguments of the compiler: // ARGS: --func-threads 3
+    TEST_ARGS=""
+    local second_line
+    second_line=$(sed -n 2p "$testfile")
+    if [[ $second_line =~ ^//\ *ARGS:\ *(.*)$ ]]; then
+        TEST_ARGS=${BASH_REMATCH[1]}
+    fi
+}
+
+# Function to print the result of a test with the optional name.errors file, a line "<line> <CODE>" for each error
+# the compiler must report, in the order of the report
+print_reported_errors() {
+    local error_code=$1
+    local should_be_error_code=$2
+    local errors_file=$3
+    local diagnostics=$4
+
+    local reported
+    reported=$(sed 's/\x1b\[[0-9;]*m//g' "$diagnostics" | sed -n 's/^code:\([0-9]*\): error: \([A-Z_]*\).*/\1 \2/p')
+    if [ "$error_code" = "$should_be_error_code" ] && [ "$reported" != "$(cat "$errors_file")" ]; then
+        printf "\033[41m\033[1;37m You shall FAIL! \033[0m"
+        echo " \033[0;31m[expected errors: $(paste -sd, "$errors_file"), got: $(echo "$reported" | paste -sd,)]\033[0m"
+    else
+        print_error "$error_code" "$should_be_error_code"
+    fi
 }
 
 test_file() {
     local testinput="$(dirname "$0")/tests/$1"
+    local errors_file="${testinput%.swift}.errors"
+    local diagnostics
+    diagnostics=$(mktemp)
 
     extract_expected_values "$testinput"
 
     # if should_output is empty, set it to 0
 
     if [ -z "$2" ]; then
-        "$(dirname "$0")"/../"$BIN" >/dev/null 2>/dev/null <"$testinput"
+        "$(dirname "$0")"/../"$BIN" $TEST_ARGS >/dev/null 2>"$diagnostics" <"$testinput"
         RETURN_CODE=$?
     else
-        "$(dirname "$0")"/../"$BIN" <"$testinput"
+        "$(dirname "$0")"/../"$BIN" $TEST_ARGS <"$testinput" 2>"$diagnostics"
         RETURN_CODE=$?
+        cat "$diagnostics" >&2
     fi
 
     print_test_name "$1"
-    print_error $RETURN_CODE "$EXPECTED_RETURN_CODE"
+    if [ -f "$errors_file" ]; then
+        print_reported_errors $RETURN_CODE "$EXPECTED_RETURN_CODE" "$errors_file" "$diagnostics"
+    else
+        print_error $RETURN_CODE "$EXPECTED_RETURN_CODE"
+    fi
+    rm -f "$diagnostics"
 }
 
 ###############
@@ -0,0 +1,9 @@
+// NO_ERR
+/*****************************************
+ * License header closed by a run of stars
+ *****************************************/
+/** doc comment **/
+var a = 5 /* inline */ + 1
+// line comment with "quotes" and \ backslash
+let s = "string with // and /* inside"
+write(a, s)
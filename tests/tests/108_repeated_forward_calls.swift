@@ -0,0 +1,7 @@
+// NO_ERR
+let a = twice(1)
+let b = twice(a)
+write(a, b)
+func twice(_ x: Int) -> Int {
+    return x * 2
+}
@@ -0,0 +1,10 @@
+// SYNTACTIC_ERR
+// the parser continues after the first error, the code is the code of the first one
+let a: Int = = 1
+write(a)
+func f(_ x: Int) -> Int {
+    let y: String = x
+    return y
+}
+let b = f(1, 2)
+write(b)
@@ -0,0 +1,13 @@
+// RETURN_ERR
+// ARGS: --func-threads 3
+func f() -> Int {
+    return } 1
+}
+
+func g(_ x: Int) -> Int {
+    let a: Int = "x"
+    let b = undefined
+    return x
+}
+
+let c = f()
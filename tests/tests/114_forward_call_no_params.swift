@@ -0,0 +1,6 @@
+// NO_ERR
+let q = b1()
+write(q)
+func b1() -> Int {
+    return 1
+}
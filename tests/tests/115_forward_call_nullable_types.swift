@@ -0,0 +1,11 @@
+// NO_ERR
+let s: String? = "a"
+let r = g(2)
+let t = h(with: s)
+write(r ?? 0, t)
+func g(_ x: Int) -> Int? {
+    return x
+}
+func h(with x: String?) -> String {
+    return x ?? "none"
+}
@@ -0,0 +1,6 @@
+// NO_ERR
+// ARGS: tests/tests/116_linked_forward_calls.swift tests/tests/link/116_functions.swift
+let a = zero()
+let b = maybe(a)
+let c = describe(nil_or(b))
+write(a, " ", b ?? 0, " ", c, "\n")
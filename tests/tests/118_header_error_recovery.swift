@@ -0,0 +1,36 @@
+// COMPATIBILITY_ERR
+// a semantic error in the header of an if, a while or a function does not hide the errors of its body
+var n = 1
+if n + "a" < 2 {
+    write(q1)
+    let k: Int = "s"
+} else if n + "b" {
+    write(q2)
+} else {
+    write(q3)
+}
+while n < "x" {
+    write(q4)
+}
+func f(_ x: Int, _ x: Int) -> Int {
+    let z: String = 1
+    return qq
+}
+func g(_ x: Int) -> Int {
+    if x + "a" {
+        return 1
+    } else {
+        return 2
+    }
+}
+// the uses of the names that have failed are not reported again
+if let missing {
+    write(missing)
+}
+let u = undefined_one
+write(u)
+// a syntax error in the header skips the whole statement
+while n < 1 1 {
+    let skipped: Int = "x"
+}
+let t: String = 5
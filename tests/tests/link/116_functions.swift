@@ -0,0 +1,20 @@
+// functions of tests/tests/116_linked_forward_calls.swift, called from that file
+func zero() -> Int {
+    return 0
+}
+
+func maybe(_ x: Int) -> Int? {
+    return x + 5
+}
+
+func nil_or(_ x: Int?) -> String? {
+    if let x {
+        return "set"
+    } else {
+        return nil
+    }
+}
+
+func describe(_ s: String?) -> String {
+    return s ?? "nil"
+}
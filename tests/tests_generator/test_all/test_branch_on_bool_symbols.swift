@@ -0,0 +1,50 @@
+func isBig(_ n: Int) -> Bool {
+    return n > 10
+}
+func describe(_ flag: Bool) -> String {
+    if flag {
+        return "on"
+    }
+    return "off"
+}
+
+var t = true
+let f = false
+if t {
+    write("t\n")
+}
+if !f {
+    write("not f\n")
+}
+if isBig(20) && t {
+    write(describe(t), "\n")
+} else {
+    write(describe(f), "\n")
+}
+var i = 0
+while isBig(30 - i) || f {
+    i = i + 4
+}
+write(i, "\n")
+
+// the branches that are not taken
+if f {
+    write("wrong f\n")
+}
+if !t {
+    write("wrong not t\n")
+} else {
+    write("else not t\n")
+}
+if isBig(5) || f {
+    write("wrong or\n")
+} else if isBig(11) {
+    write("elseif big\n")
+}
+while isBig(1) {
+    write("wrong while\n")
+}
+t = false
+if t || !f {
+    write("changed ", t, "\n")
+}
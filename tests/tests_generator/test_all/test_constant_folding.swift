@@ -0,0 +1,20 @@
+let a = 1 + 2 * 3 - (0 - 7) / 2
+let b = 2.5 * 2 + 1 / 4.0
+let c = "ab" + "c d#" + "\\"
+let d = 1 < 2 && !(2.0 >= 3) || "b" < "ab"
+let e = Int2Double(3) + 1.5
+let f = Double2Int(2.9) * 2
+var g: Double = 5
+let h = 1 == 2.5
+write(a, " ", b, " ", c, " ", d, " ", e, " ", f, " ", g, " ", h, "\n")
+
+// the folded division rounds like the one evaluated at runtime
+let seven = 7
+let q = (0 - 7) / 2
+let r = (0 - seven) / 2
+write(q, " ", r, " ", 7 / 2, " ", seven / 2, "\n")
+
+// division by the zero literal is left to fail at runtime
+write("before\n")
+let z = 7 / 0
+write("after ", z, "\n")
@@ -0,0 +1,3 @@
+let a = 1.5e3
+let b: Double = 2E-2 + a
+write(a, "\n", b, "\n", 1e+1 * 2.0)
@@ -0,0 +1,34 @@
+// functions named like the labels of the main body and of the end of a function
+func cond0_skip() -> Int {
+    return 1
+}
+func while0() -> Int {
+    return 2
+}
+func endif0() -> Int {
+    return 3
+}
+func logic0() -> Int {
+    return 4
+}
+func f(_ x: Int) -> Int {
+    return x + 1
+}
+func f_end(_ x: Int) -> Int {
+    return x + 2
+}
+
+var i = 1
+if i > 0 || i < 0 {
+    write("or ", cond0_skip(), "\n")
+}
+while i < 3 {
+    i = i + while0()
+}
+if i == 3 {
+    write("if ", endif0(), "\n")
+} else {
+    write("else\n")
+}
+let b = i > 0 && i < 10
+write(b, " ", logic0(), " ", f(1), " ", f_end(1), "\n")
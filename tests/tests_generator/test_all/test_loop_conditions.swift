@@ -0,0 +1,53 @@
+func count(_ n: Int) -> Int {
+    var i = 0
+    var sum = 0
+    while i < n {
+        var j = i
+        while j >= 1 {
+            sum = sum + j
+            j = j - 1
+        }
+        i = i + 1
+    }
+    return sum
+}
+
+var d = 0.5
+while d <= 4.0 {
+    d = d * 2.0
+}
+var s = "a"
+while s != "aaaa" {
+    s = s + "a"
+}
+let opt: Int? = nil
+let none: Int? = nil
+var k = 3
+while k > 0 {
+    if opt == none {
+        k = k - 1
+    } else if k == 2 {
+        k = 0
+    }
+}
+let total = count(5)
+write(d, " ", s, " ", k, " ", total, "\n")
+
+// the else if branch and conditions on Double and nil
+let some: Int? = 1
+var m = 3
+while m > 0 {
+    if some == none {
+        m = 10
+    } else if m == 2 {
+        write("two ")
+        m = m - 2
+    } else {
+        m = m - 1
+    }
+}
+var x = 10.0
+while x > 1.5 {
+    x = x / 2.0
+}
+write(m, " ", x, "\n")
@@ -0,0 +1,35 @@
+func check(_ x: Int) -> Bool {
+    write("evaluated ", x, "\n")
+    return x > 0
+}
+
+let zero = 0
+var i = 0
+while i < 3 && !(zero != 0 && 10 / zero > 1) {
+    i = i + 1
+}
+if i == 3 || check(1) {
+    write("yes ", i, "\n")
+} else if check(0 - i) || i == 1 {
+    write("elseif ", i, "\n")
+}
+let b = zero == 0 || 10 / zero > 1
+let c = zero != 0 && check(2)
+write(b, " ", c, "\n")
+
+// the right operand is evaluated when the left one does not decide
+if i == 0 || check(i) {
+    write("or right ", i, "\n")
+}
+if i == 3 && check(0 - 1) {
+    write("wrong\n")
+} else {
+    write("and right false\n")
+}
+var n = 0
+while n < 2 || check(n - 5) {
+    n = n + 1
+}
+let e = zero == 1 || check(3)
+let g = zero == 0 && check(0)
+write(n, " ", e, " ", g, "\n")
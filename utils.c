@@ -240,6 +240,7 @@ Token convertPSATokenToToken(PSA_Token psa_tkn)
         .token_value = psa_tkn.token_value,
         .preceded_by_nl = psa_tkn.preceded_by_nl,
         .line_num = psa_tkn.line_num,
+        .literal = psa_tkn.literal,
     };
 }
 
@@ -252,5 +253,6 @@ PSA_Token convertTokenToPSAToken(Token tkn)
         .expr_type = getTypeFromToken(tkn.type),
         .is_literal = isTokenLiteral(tkn.type),
         .line_num = tkn.line_num,
+        .literal = tkn.literal,
     };
 }
\ No newline at end of file
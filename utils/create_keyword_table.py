@@ -0,0 +1,112 @@
+"""
+Generates keyword_table.c - perfect hash table of keywords recognised by the scanner.
+
+The hash of a lexeme is computed only from its length, first and last character:
+    hash = (len * LEN_MUL + first * FIRST_MUL + last) & (SIZE - 1)
+The script searches for the multipliers and the smallest table size for which
+no two keywords collide, so every lexeme needs one probe and at most one memcmp.
+
+Usage: python3 utils/create_keyword_table.py > keyword_table.c
+"""
+
+import sys
+
+# Keywords and their token types, nullable types (Int? ...) are derived from the base types in the scanner
+keywords = [
+    ("Double", "TOKEN_TYPE_DOUBLE"),
+    ("String", "TOKEN_TYPE_STRING"),
+    ("Int", "TOKEN_TYPE_INT"),
+    ("Bool", "TOKEN_TYPE_BOOL"),
+    ("func", "TOKEN_FUNC"),
+    ("nil", "TOKEN_NIL"),
+    ("if", "TOKEN_IF"),
+    ("else", "TOKEN_ELSE"),
+    ("true", "TOKEN_BOOL"),
+    ("false", "TOKEN_BOOL"),
+    ("return", "TOKEN_RETURN"),
+    ("while", "TOKEN_WHILE"),
+    ("var", "TOKEN_VAR"),
+    ("let", "TOKEN_LET"),
+    ("break", "TOKEN_BREAK"),
+    ("continue", "TOKEN_CONTINUE"),
+]
+
+
+def keyword_hash(word, len_mul, first_mul, size):
+    return (len(word) * len_mul + ord(word[0]) * first_mul + ord(word[-1])) & (size - 1)
+
+
+def find_parameters():
+    size = 16
+    while size <= 1024:
+        for len_mul in range(1, 64):
+            for first_mul in range(1, 64):
+                hashes = {keyword_hash(w, len_mul, first_mul, size) for w, _ in keywords}
+                if len(hashes) == len(keywords):
+                    return size, len_mul, first_mul
+        size *= 2
+    sys.exit("No perfect hash found")
+
+
+size, len_mul, first_mul = find_parameters()
+table = [None] * size
+for word, token in keywords:
+    table[keyword_hash(word, len_mul, first_mul, size)] = (word, token)
+
+print("""/**
+ * @file keyword_table.c
+ * @brief Perfect hash table of keywords, generated by utils/create_keyword_table.py - do not edit by hand.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <string.h>
+#include "scanner.h"
+""")
+print(f"#define KEYWORD_TABLE_SIZE {size}")
+print(f"#define KEYWORD_LEN_MUL {len_mul}")
+print(f"#define KEYWORD_FIRST_MUL {first_mul}")
+print("""
+/**
+ * @brief - Entry of the keyword table
+ * @param code - keyword, NULL for an empty slot
+ * @param len - length of the keyword
+ * @param token - token type of the keyword
+ */
+typedef struct
+{
+    const char *code;
+    size_t len;
+    Token_type token;
+} Keyword_entry;
+
+/**
+ * Keywords indexed by their hash
+ */
+static const Keyword_entry keyword_table[KEYWORD_TABLE_SIZE] = {""")
+for i, entry in enumerate(table):
+    if entry is not None:
+        print(f'    [{i}] = {{"{entry[0]}", {len(entry[0])}, {entry[1]}}},')
+print("""};
+
+bool keyword_lookup(const char *code, size_t len, Token_type *type)
+{
+    if (len == 0)
+    {
+        return false;
+    }
+    unsigned int hash = (unsigned int)(len * KEYWORD_LEN_MUL + (unsigned char)code[0] * KEYWORD_FIRST_MUL +
+                                       (unsigned char)code[len - 1]) &
+                        (KEYWORD_TABLE_SIZE - 1);
+    const Keyword_entry *entry = &keyword_table[hash];
+    if (entry->len != len || memcmp(entry->code, code, len) != 0)
+    {
+        return false;
+    }
+    *type = entry->token;
+    return true;
+}""")
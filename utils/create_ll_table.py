@@ -0,0 +1,318 @@
+"""
+Generates parser_table.c - LL(1) parse table and semantic actions of the IFJ23 grammar.
+
+The productions are read from doc/ll_grammar.xlsx (column A nonterminal, B '::=', C right hand side,
+'' stands for an empty right hand side). The script computes the FIRST and FOLLOW sets, fills the
+table with the production to expand for every nonterminal and lookahead token and fails if the
+grammar is not LL(1).
+
+The spreadsheet only describes the syntax, the semantic actions (Control_state passed to run_control)
+are attached to the symbols by the ACTIONS below:
+    sym/ACTION  - the action runs when the terminal is matched or the expression is parsed
+    NT/ACTION   - the terminals of the nonterminal run the action (see INHERITING)
+    @ACTION     - the action runs when the parser gets to this point of the production
+
+Usage: python3 utils/create_ll_table.py > parser_table.c
+"""
+
+import os
+import sys
+import zipfile
+import xml.etree.ElementTree as ET
+
+GRAMMAR_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "doc", "ll_grammar.xlsx")
+
+terminals = {
+    "eof": "TOKEN_EOF",
+    "id": "TOKEN_IDENTIFICATOR",
+    "func_id": "TOKEN_FUNC_ID",
+    "var": "TOKEN_VAR",
+    "let": "TOKEN_LET",
+    ":": "TOKEN_DOUBLE_DOT",
+    "=": "TOKEN_ASSIGN",
+    "Bool": "TOKEN_TYPE_BOOL",
+    "Double": "TOKEN_TYPE_DOUBLE",
+    "Int": "TOKEN_TYPE_INT",
+    "String": "TOKEN_TYPE_STRING",
+    "Bool_Nil": "TOKEN_TYPE_BOOL_NIL",
+    "Double_Nil": "TOKEN_TYPE_DOUBLE_NIL",
+    "Int_Nil": "TOKEN_TYPE_INT_NIL",
+    "String_Nil": "TOKEN_TYPE_STRING_NIL",
+    "func": "TOKEN_FUNC",
+    "(": "TOKEN_L_BRACKET",
+    ")": "TOKEN_R_BRACKET",
+    "{": "TOKEN_L_CURLY",
+    "}": "TOKEN_R_CURLY",
+    ",": "TOKEN_COMMA",
+    "->": "TOKEN_ARROW",
+    "return": "TOKEN_RETURN",
+    "while": "TOKEN_WHILE",
+    "if": "TOKEN_IF",
+    "else": "TOKEN_ELSE",
+}
+
+# expressions are parsed by the PSA, the parser only decides by the tokens they can start with
+expressions = {
+    "exp": ["TOKEN_IDENTIFICATOR", "TOKEN_FUNC_ID", "TOKEN_L_BRACKET", "TOKEN_DOUBLE", "TOKEN_INT", "TOKEN_STRING",
+            "TOKEN_BOOL", "TOKEN_NIL", "TOKEN_EXP", "TOKEN_NOT"],
+    "call": ["TOKEN_FUNC_ID"],  # function call statement
+}
+
+# differences between the spreadsheet and the language the compiler accepts
+renamed_symbols = {
+    "Bool_Ni": "Bool_Nil",  # typo
+    "R_RIGID": "= exp",     # has a column in the table but no production
+}
+corrected_productions = {
+    # else if accepts 'let id' like the first if
+    "ELSE_IF_STMT ::= if exp { LOCAL_STMT_LIST } ELSE_CLAUSE": "if IF_COND { LOCAL_STMT_LIST } ELSE_CLAUSE",
+    # the call statement is parsed by the PSA from the function name on
+    "LOAD_ID ::= func_id": "call",
+}
+
+ACTIONS = {
+    "START ::= STMT_LIST eof": "@STARTING STMT_LIST eof",
+    "STMT ::= IF_STMT": "IF_STMT @IF_END",
+    "VAR_LET ::= VAR_SCOPE id TYPE_AND_ASSIGN": "VAR_SCOPE id/VAR_ID TYPE_AND_ASSIGN",
+    "VAR_SCOPE ::= var": "var/VAR",
+    "VAR_SCOPE ::= let": "let/LET",
+    "TYPE_AND_ASSIGN ::= : D_TYPE R_FLEX": ": D_TYPE/VAR_TYPE R_FLEX",
+    "TYPE_AND_ASSIGN ::= = exp": "=/VAR_ASSIGN1 exp/VAR_EXP",
+    "R_FLEX ::= ''": "@VAR_ADD",
+    "R_FLEX ::= = exp": "=/VAR_ASSIGN2 exp/VAR_EXP",
+    "DEF_FUNC ::= func func_id ( P_LIST ) RET_TYPE { FUNC_STMT_LIST }":
+        "func func_id/FUNC_ID ( P_LIST ) RET_TYPE {/FUNC_HEADER_DONE FUNC_STMT_LIST }/FUNC_BODY_DONE",
+    "PARAM ::= id id : D_TYPE P_SEP": "id/P_NAME id/P_ID : D_TYPE/P_TYPE P_SEP",
+    "RET_TYPE ::= -> D_TYPE": "-> D_TYPE/R_TYPE",
+    "FUNC_STMT ::= FUNC_IF": "FUNC_IF @IF_END",
+    "RET ::= return exp": "return exp/R_EXP",
+    "FUNC_WHILE ::= while exp { FUNC_STMT_LIST }": "while/WHILE_START exp/COND_EXP {/WHILE_COND FUNC_STMT_LIST }/WHILE_END",
+    "FUNC_IF ::= if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE":
+        "if/FUNC_IF_FOUND IF_COND {/IF_START FUNC_STMT_LIST }/POP_SCOPE FUNC_ELSE_CLAUSE",
+    "FUNC_ELSE_CLAUSE ::= else FUNC_AFTER_ELSE": "else/FUNC_ELSE FUNC_AFTER_ELSE",
+    "FUNC_AFTER_ELSE ::= { FUNC_STMT_LIST }": "{/ELSE_START FUNC_STMT_LIST }/POP_SCOPE",
+    "IF_STMT ::= if IF_COND { LOCAL_STMT_LIST } ELSE_CLAUSE": "if IF_COND {/IF_START LOCAL_STMT_LIST }/POP_SCOPE ELSE_CLAUSE",
+    "AFTER_ELSE ::= { LOCAL_STMT_LIST }": "{/ELSE_START LOCAL_STMT_LIST }/POP_SCOPE",
+    "WHILE_STMT ::= while exp { LOCAL_STMT_LIST }": "while/WHILE_START exp/COND_EXP {/WHILE_COND LOCAL_STMT_LIST }/WHILE_END",
+    "LOAD_ID ::= id = exp": "id/LOAD_IDENTIF = exp/IDENTIF_EXP",
+    "LOAD_ID ::= call": "call/FUNC_CALL_PSA",
+    "IF_COND ::= exp": "exp/COND_EXP",
+    "IF_COND ::= let id": "let id/LET_IN_IF",
+    "LOCAL_STMT ::= IF_STMT": "IF_STMT @IF_END",
+    "FUNC_ELSE_IF ::= if IF_COND { FUNC_STMT_LIST } FUNC_ELSE_CLAUSE":
+        "if/ELSE_IF_START IF_COND {/ELSE_IF_AFTER_COND FUNC_STMT_LIST }/POP_SCOPE FUNC_ELSE_CLAUSE",
+    "ELSE_IF_STMT ::= if IF_COND { LOCAL_STMT_LIST } ELSE_CLAUSE":
+        "if/ELSE_IF_START IF_COND {/ELSE_IF_AFTER_COND LOCAL_STMT_LIST }/POP_SCOPE ELSE_CLAUSE",
+}
+
+# the terminals of these nonterminals run the action given to the nonterminal
+INHERITING = {"D_TYPE"}
+
+
+def read_grammar(path):
+    """Returns the list of (nonterminal, right hand side) from the first sheet of the workbook."""
+    ns = {"m": "http://schemas.openxmlformats.org/spreadsheetml/2006/main"}
+    with zipfile.ZipFile(path) as book:
+        strings = ["".join(t.text or "" for t in si.iter("{%s}t" % ns["m"]))
+                   for si in ET.fromstring(book.read("xl/sharedStrings.xml")).findall("m:si", ns)]
+        sheet = ET.fromstring(book.read("xl/worksheets/sheet1.xml"))
+    productions = []
+    for row in sheet.iter("{%s}row" % ns["m"]):
+        cells = {}
+        for cell in row.findall("m:c", ns):
+            value = cell.find("m:v", ns)
+            if value is not None:
+                column = cell.get("r").rstrip("0123456789")
+                cells[column] = strings[int(value.text)] if cell.get("t") == "s" else value.text
+        if cells.get("B") == "::=":
+            productions.append((cells["A"].strip(), cells["C"].strip()))
+    return productions
+
+
+def normalize(productions):
+    """Applies the corrections, returns the list of (nonterminal, [(symbol, action)])."""
+    result = []
+    for left, right in productions:
+        right = " ".join(renamed_symbols.get(symbol, symbol) for symbol in right.split())
+        key = "%s ::= %s" % (left, right)
+        right = corrected_productions.get(key, right)
+        key = "%s ::= %s" % (left, right)
+        annotated = ACTIONS.pop(key, right)
+        symbols = []
+        for item in annotated.split():
+            if item == "''":
+                continue
+            if item.startswith("@"):
+                symbols.append(("@", item[1:]))
+                continue
+            symbol, _, action = item.partition("/")
+            symbols.append((symbol, action or None))
+        if [s for s, _ in symbols if s != "@"] != [s for s in right.split() if s != "''"]:
+            sys.exit("actions of '%s' do not match the production" % key)
+        result.append((left, symbols))
+    if ACTIONS:
+        sys.exit("actions of unknown productions: %s" % ", ".join(ACTIONS))
+    return result
+
+
+def first_of(sequence, first, nullable):
+    """FIRST set of a sequence of symbols and whether it derives the empty string."""
+    result = set()
+    for symbol, _ in sequence:
+        if symbol == "@":
+            continue
+        if symbol in terminals:
+            result.add(terminals[symbol])
+            return result, False
+        if symbol in expressions:
+            result.update(expressions[symbol])
+            return result, False
+        result |= first[symbol]
+        if not nullable[symbol]:
+            return result, False
+    return result, True
+
+
+def build_table(productions, nonterminals):
+    first = {n: set() for n in nonterminals}
+    nullable = {n: False for n in nonterminals}
+    follow = {n: set() for n in nonterminals}
+
+    changed = True
+    while changed:
+        changed = False
+        for left, right in productions:
+            symbols, empty = first_of(right, first, nullable)
+            if not symbols <= first[left] or (empty and not nullable[left]):
+                first[left] |= symbols
+                nullable[left] = nullable[left] or empty
+                changed = True
+
+    changed = True
+    while changed:
+        changed = False
+        for left, right in productions:
+            for i, (symbol, _) in enumerate(right):
+                if symbol not in nonterminals:
+                    continue
+                symbols, empty = first_of(right[i + 1:], first, nullable)
+                if empty:
+                    symbols |= follow[left]
+                if not symbols <= follow[symbol]:
+                    follow[symbol] |= symbols
+                    changed = True
+
+    table = {n: {} for n in nonterminals}
+    for index, (left, right) in enumerate(productions):
+        symbols, empty = first_of(right, first, nullable)
+        if empty:
+            symbols |= follow[left]
+        for token in symbols:
+            if token in table[left]:
+                other = productions[table[left][token]]
+                sys.exit("grammar is not LL(1): %s and %s on %s" % (left, other[0], token))
+            table[left][token] = index
+    return table
+
+
+def production_text(left, right):
+    symbols = [s for s, _ in right if s != "@"]
+    return "%s ::= %s" % (left, " ".join(symbols) if symbols else "''")
+
+
+productions = normalize(read_grammar(GRAMMAR_PATH))
+nonterminals = []
+for left, _ in productions:
+    if left not in nonterminals:
+        nonterminals.append(left)
+for left, right in productions:
+    for symbol, _ in right:
+        if symbol != "@" and symbol not in terminals and symbol not in expressions and symbol not in nonterminals:
+            sys.exit("unknown symbol '%s' in %s" % (symbol, left))
+table = build_table(productions, nonterminals)
+
+# statements of a function body, the function pool parses the bodies from here
+FUNC_BODY = "FUNC_STMT_LIST"
+if FUNC_BODY not in nonterminals:
+    sys.exit("the grammar has no %s" % FUNC_BODY)
+
+# statement lists of the blocks, the parser continues from the next statement of the list after a syntax error
+SYNC = ["STMT_LIST", "FUNC_STMT_LIST", "LOCAL_STMT_LIST"]
+for n in SYNC:
+    if n not in nonterminals:
+        sys.exit("the grammar has no %s" % n)
+
+print("""/**
+ * @file parser_table.c
+ * @brief LL(1) parse table of the grammar in doc/ll_grammar.xlsx, generated by utils/create_ll_table.py - do not edit
+ * by hand.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <stdint.h>
+#include "parser.h"
+""")
+print("#define LL_NONTERMINAL_COUNT %d" % len(nonterminals))
+print("#define LL_TOKEN_COUNT (TOKEN_UNSHIFT + 1)")
+print()
+print("enum")
+print("{")
+for n in nonterminals:
+    print("    LL_%s," % n)
+print("};")
+print()
+print("// right hand sides of the productions")
+print("static const Ll_symbol ll_symbols[] = {")
+offsets = []
+offset = 0
+for left, right in productions:
+    offsets.append(offset)
+    print("    // %s" % production_text(left, right))
+    for symbol, action in right:
+        action_name = action or "SEM_NONE"
+        if symbol == "@":
+            print("    {.kind = LL_ACTION, .value = 0, .action = %s, .inherit = false}," % action_name)
+        elif symbol in terminals:
+            inherit = "true" if left in INHERITING else "false"
+            print("    {.kind = LL_TERMINAL, .value = %s, .action = %s, .inherit = %s}," % (terminals[symbol], action_name, inherit))
+        elif symbol in expressions:
+            print("    {.kind = LL_EXPRESSION, .value = 0, .action = %s, .inherit = false}," % action_name)
+        else:
+            print("    {.kind = LL_NONTERMINAL, .value = LL_%s, .action = %s, .inherit = false}," % (symbol, action_name))
+    offset += len(right)
+print("};")
+print()
+print("static const Ll_production ll_productions[] = {")
+for (left, right), start in zip(productions, offsets):
+    print("    {.symbols = &ll_symbols[%d], .len = %d, .name = \"%s\"}," % (start, len(right), production_text(left, right)))
+print("};")
+print()
+print("// production to expand for the nonterminal and the lookahead token, 0 is a syntax error, otherwise index + 1")
+print("static const uint8_t ll_table[LL_NONTERMINAL_COUNT][LL_TOKEN_COUNT] = {")
+for n in nonterminals:
+    entries = sorted(table[n].items(), key=lambda e: e[0])
+    print("    [LL_%s] = {%s}," % (n, ", ".join("[%s] = %d" % (token, index + 1) for token, index in entries)))
+print("};")
+print()
+print("// statement lists the parser synchronizes on after an error")
+print("static const bool ll_sync[LL_NONTERMINAL_COUNT] = {%s};" % ", ".join("[LL_%s] = true" % n for n in SYNC))
+print("""
+const Ll_symbol ll_start = {.kind = LL_NONTERMINAL, .value = LL_%s, .action = SEM_NONE, .inherit = false};
+
+const Ll_symbol ll_func_body = {.kind = LL_NONTERMINAL, .value = LL_%s, .action = SEM_NONE, .inherit = false};
+
+const Ll_production *ll_predict(int nonterminal, Token_type lookahead)
+{
+    unsigned int production = ll_table[nonterminal][lookahead];
+    return production == 0 ? NULL : &ll_productions[production - 1];
+}
+
+bool ll_is_sync(int nonterminal)
+{
+    return ll_sync[nonterminal];
+}""" % (nonterminals[0], FUNC_BODY))
@@ -0,0 +1,203 @@
+"""
+Generates ptable.c - precedence table of the PSA and the table of the binary operations of IFJ23.
+
+The precedence table and the classes of the tokens are written out as they are. The binary operations are described
+by the rules below, the script evaluates them for every operator and every pair of the operand types, so the PSA only
+looks the result up when it reduces a handle. An entry holds:
+    type        - type of the result, TYPE_INVALID if the operands do not fit the operation
+    error       - error reported for the operands, NO_ERR if they fit
+    conversion  - operand converted from Int to Double
+    literal     - the converted operand must be a literal
+    emit        - how the code of the operation is generated
+    inst        - instructions of the operation on the data stack
+
+Usage: python3 utils/create_psa_table.py > ptable.c
+"""
+
+TYPES = ["INT", "DOUBLE", "STRING", "BOOL", "NIL", "INT_NIL", "DOUBLE_NIL", "STRING_NIL", "BOOL_NIL"]
+NIL_TYPES = {"NIL", "INT_NIL", "DOUBLE_NIL", "STRING_NIL", "BOOL_NIL"}
+
+# precedence classes of the tokens, the rows and the columns of the precedence table
+SYMBOLS = [
+    ("!", ["TOKEN_NOT"]),
+    ("*/", ["TOKEN_MUL", "TOKEN_DIV"]),
+    ("+-", ["TOKEN_PLUS", "TOKEN_MINUS"]),
+    ("REL", ["TOKEN_EQ", "TOKEN_NEQ", "TOKEN_LESS", "TOKEN_MORE", "TOKEN_LESS_EQ", "TOKEN_MORE_EQ"]),
+    ("LOG", ["TOKEN_AND", "TOKEN_OR"]),
+    ("??", ["TOKEN_BINARY_OPERATOR"]),
+    ("i", ["TOKEN_IDENTIFICATOR", "TOKEN_FUNC_ID", "TOKEN_INT", "TOKEN_DOUBLE", "TOKEN_EXP", "TOKEN_BOOL",
+           "TOKEN_STRING", "TOKEN_NIL"]),
+    ("(", ["TOKEN_L_BRACKET"]),
+    (")", ["TOKEN_R_BRACKET"]),
+    ("$", ["TOKEN_EOF"]),
+]
+
+# top of the stack (row) and the input (column)
+P_TABLE = [
+    "->>>>><<>>",  # !
+    "<>>>>><<>>",  # */
+    "<<>>>><<>>",  # +-
+    "<<<>>><<>>",  # REL
+    "<<<<>><<>>",  # LOG
+    "<<<<<><<>>",  # ??
+    ">>>>>>-->>",  # i
+    "<<<<<<<<=-",  # (
+    ">>>>>>-->>",  # )
+    "<<<<<<<<--",  # $
+]
+
+
+def combination(left, right):
+    """Operands of the same type, a literal Int is converted to Double. (type, conversion, literal) or None."""
+    if left == "INT" and right == "DOUBLE":
+        return ("DOUBLE", "AST_CONVERT_LEFT", True)
+    if left == "DOUBLE" and right == "INT":
+        return ("DOUBLE", "AST_CONVERT_RIGHT", True)
+    if left == right and left in ("INT", "DOUBLE", "STRING", "INT_NIL", "DOUBLE_NIL", "STRING_NIL"):
+        return (left, "AST_CONVERT_NONE", False)
+    return None
+
+
+def remove_nil(t):
+    return t[:-4] if t.endswith("_NIL") else None
+
+
+def arithmetic(inst):
+    def rule(left, right):
+        if left in NIL_TYPES or right in NIL_TYPES:
+            return None
+        result = combination(left, right)
+        if result is None:
+            return None
+        # the division of integers is integral
+        selected = "IDIVS" if inst == "DIVS" and result[0] == "INT" else inst
+        return result + ("PSA_EMIT_STACK", [selected])
+    return rule
+
+
+def plus(left, right):
+    if left == "STRING" and right == "STRING":
+        return ("STRING", "AST_CONVERT_NONE", False, "PSA_EMIT_CONCAT", [])
+    return arithmetic("ADDS")(left, right)
+
+
+def equality(inst):
+    def rule(left, right):
+        if left == right:
+            return ("BOOL", "AST_CONVERT_NONE", False, "PSA_EMIT_STACK", inst)
+        result = combination(left, right)
+        return None if result is None else ("BOOL",) + result[1:] + ("PSA_EMIT_STACK", inst)
+    return rule
+
+
+def relational(inst):
+    def rule(left, right):
+        result = combination(left, right)
+        return None if result is None else ("BOOL",) + result[1:] + ("PSA_EMIT_STACK", inst)
+    return rule
+
+
+def logical(left, right):
+    # the right operand is evaluated only if the left one does not decide the result
+    if left == "BOOL" and right == "BOOL":
+        return ("BOOL", "AST_CONVERT_NONE", False, "PSA_EMIT_SHORT_CIRCUIT", [])
+    return None
+
+
+def nil_coalescing(left, right):
+    if left in NIL_TYPES and right not in NIL_TYPES and remove_nil(left) == right:
+        return (right, "AST_CONVERT_NONE", False, "PSA_EMIT_NIL_COALESCING", [])
+    return None
+
+
+OPERATORS = [
+    ("TOKEN_MUL", "*", arithmetic("MULS")),
+    ("TOKEN_DIV", "/", arithmetic("DIVS")),
+    ("TOKEN_PLUS", "+", plus),
+    ("TOKEN_MINUS", "-", arithmetic("SUBS")),
+    ("TOKEN_EQ", "==", equality(["EQS"])),
+    ("TOKEN_NEQ", "!=", equality(["EQS", "NOTS"])),
+    ("TOKEN_LESS", "<", relational(["LTS"])),
+    ("TOKEN_MORE", ">", relational(["GTS"])),
+    ("TOKEN_LESS_EQ", "<=", relational(["GTS", "NOTS"])),
+    ("TOKEN_MORE_EQ", ">=", relational(["LTS", "NOTS"])),
+    ("TOKEN_AND", "&&", logical),
+    ("TOKEN_OR", "||", logical),
+    ("TOKEN_BINARY_OPERATOR", "??", nil_coalescing),
+]
+
+
+def entry(result):
+    if result is None:
+        return "INVALID"
+    t, conversion, literal, emit, inst = result
+    return "{TYPE_%s, NO_ERR, %s, %s, %s, {%s}, %d}" % (t, conversion, "true" if literal else "false", emit,
+                                                        ", ".join(inst) if inst else "EMPTY", len(inst))
+
+
+print("""/**
+ * @file ptable.c
+ * @brief Precedence table of the PSA and the types and instructions of the binary operations, generated by
+ * utils/create_psa_table.py - do not edit by hand.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include "psa.h"
+
+#define PSA_TOKEN_COUNT (TOKEN_UNSHIFT + 1)
+#define INVALID {TYPE_INVALID, COMPATIBILITY_ERR, AST_CONVERT_NONE, false, PSA_EMIT_STACK, {EMPTY}, 0}
+""")
+print("char P_TABLE[%d][%d] = {" % (len(SYMBOLS), len(SYMBOLS)))
+print("    // INPUT >")
+print("    // %s" % "".join(name.ljust(5) for name, _ in SYMBOLS).rstrip())
+for (name, _), row in zip(SYMBOLS, P_TABLE):
+    print("    {%s}, // %s" % (", ".join("'%s'" % c for c in row), name))
+print("    // ^ TOP OF STACK")
+print("};")
+print()
+print("// class of the token in the precedence table, 0 is not a token of an expression, otherwise index + 1")
+print("static const uint8_t psa_symbols[PSA_TOKEN_COUNT] = {")
+for index, (name, tokens) in enumerate(SYMBOLS):
+    for token in tokens:
+        print("    [%s] = %d, // %s" % (token, index + 1, name))
+print("};")
+print()
+print("// row of the operator in psa_operations, 0 is not a binary operator, otherwise index + 1")
+print("static const uint8_t psa_operators[PSA_TOKEN_COUNT] = {")
+for index, (token, name, _) in enumerate(OPERATORS):
+    print("    [%s] = %d, // %s" % (token, index + 1, name))
+print("};")
+print()
+print("static const Psa_operation psa_invalid = INVALID;")
+print()
+print("// operation of the operator on the left and the right operand type")
+print("static const Psa_operation psa_operations[%d][PSA_TYPE_COUNT][PSA_TYPE_COUNT] = {" % len(OPERATORS))
+for token, name, rule in OPERATORS:
+    print("    // %s" % name)
+    print("    {")
+    for left in TYPES:
+        print("        // %s" % left)
+        print("        {%s}," % ", ".join(entry(rule(left, right)) for right in TYPES))
+    print("    },")
+print("};")
+print("""
+unsigned int getSymbolValue(Token_type token)
+{
+    unsigned int symbol = (unsigned int)token < PSA_TOKEN_COUNT ? psa_symbols[token] : 0;
+    return symbol == 0 ? 99 : symbol - 1;
+}
+
+const Psa_operation *psa_operation(Token_type operation, Expression_type left, Expression_type right)
+{
+    unsigned int op = (unsigned int)operation < PSA_TOKEN_COUNT ? psa_operators[operation] : 0;
+    if (op == 0 || (unsigned int)left >= PSA_TYPE_COUNT || (unsigned int)right >= PSA_TYPE_COUNT)
+    {
+        return &psa_invalid;
+    }
+    return &psa_operations[op - 1][left][right];
+}""")
@@ -0,0 +1,344 @@
+"""
+Generates scanner_table.c - transition table of the automaton recognising IFJ23 tokens.
+
+The tokens are described by the regular expressions below. The script builds an NFA from them,
+turns it into a DFA by subset construction and minimises it. Bytes that behave the same in every
+state share one character class, so each row of the table has one column per class.
+The scanner reads the longest match and runs the action of the state it stopped in - when the rules
+match the same text, the earlier one wins. Strings, comments, identifiers and numbers only have their
+beginning (or whole span) recognised here, the actions in scanner.c decode them.
+
+Supported regular expression syntax: characters, escapes (\\n \\t \\v \\f \\r \\xHH and escaped
+metacharacters), classes [a-z_], grouping, alternation |, and the operators * + ?.
+
+Usage: python3 utils/create_scanner_table.py > scanner_table.c
+"""
+
+import sys
+
+# (action, token type, token value, regular expression)
+rules = [
+    ("SCAN_EOF", "TOKEN_EOF", "", r"\xff"),
+    ("SCAN_WHITESPACE", None, None, r"[ \t\v\r\f\n]+"),
+    ("SCAN_LINE_COMMENT", None, None, r"//"),
+    ("SCAN_BLOCK_COMMENT", None, None, r"/\*"),
+    ("SCAN_TOKEN", "TOKEN_COMMA", ",", r","),
+    ("SCAN_TOKEN", "TOKEN_DOUBLE_DOT", ":", r":"),
+    ("SCAN_TOKEN", "TOKEN_PLUS", "+", r"\+"),
+    ("SCAN_TOKEN", "TOKEN_ARROW", "->", r"->"),
+    ("SCAN_TOKEN", "TOKEN_MINUS", "-", r"-"),
+    ("SCAN_TOKEN", "TOKEN_MUL", "*", r"\*"),
+    ("SCAN_TOKEN", "TOKEN_DIV", "/", r"/"),
+    ("SCAN_TOKEN", "TOKEN_R_BRACKET", ")", r"\)"),
+    ("SCAN_TOKEN", "TOKEN_L_BRACKET", "(", r"\("),
+    ("SCAN_TOKEN", "TOKEN_R_CURLY", "}", r"}"),
+    ("SCAN_TOKEN", "TOKEN_L_CURLY", "{", r"{"),
+    ("SCAN_TOKEN", "TOKEN_BINARY_OPERATOR", "??", r"\?\?"),
+    ("SCAN_TOKEN", "TOKEN_LESS_EQ", "<=", r"<="),
+    ("SCAN_TOKEN", "TOKEN_LESS", "<", r"<"),
+    ("SCAN_TOKEN", "TOKEN_MORE_EQ", ">=", r">="),
+    ("SCAN_TOKEN", "TOKEN_MORE", ">", r">"),
+    ("SCAN_TOKEN", "TOKEN_EQ", "==", r"=="),
+    ("SCAN_TOKEN", "TOKEN_ASSIGN", "=", r"="),
+    ("SCAN_TOKEN", "TOKEN_NEQ", "!=", r"!="),
+    ("SCAN_TOKEN", "TOKEN_NOT", "!", r"!"),
+    ("SCAN_TOKEN", "TOKEN_AND", "&&", r"&&"),
+    ("SCAN_TOKEN", "TOKEN_OR", "||", r"\|\|"),
+    ("SCAN_STRING", "TOKEN_STRING", None, r'"'),
+    ("SCAN_NUMBER", "TOKEN_INT", None, r"[0-9]+"),
+    ("SCAN_NUMBER", "TOKEN_DOUBLE", None, r"[0-9]+\.[0-9]*"),
+    ("SCAN_NUMBER", "TOKEN_EXP", None, r"[0-9]+(\.[0-9]*)?[eE][+\-]?[0-9]+"),
+    ("SCAN_IDENTIFIER", "TOKEN_IDENTIFICATOR", None, r"[A-Za-z][A-Za-z0-9_]*|_[A-Za-z0-9_]+"),
+    ("SCAN_UNDERSCORE", "TOKEN_IDENTIFICATOR", None, r"_"),
+]
+
+# A token has to be followed by one of these characters (or whitespace, EOF) unless it ends with one of them
+separators = ":{}(),\x20=!+-*/<>\n?"
+whitespace = " \t\n\v\f\r"
+EOF_BYTE = 0xFF
+
+ESCAPES = {"n": "\n", "t": "\t", "v": "\v", "f": "\f", "r": "\r"}
+
+
+class Nfa:
+    def __init__(self):
+        self.edges = []  # per state: list of (set of bytes or None for epsilon, target)
+        self.accept = {}  # state -> rule index
+
+    def state(self):
+        self.edges.append([])
+        return len(self.edges) - 1
+
+
+class RegexParser:
+    """Recursive descent parser of the regular expression, returns (start, end) fragment of the NFA"""
+
+    def __init__(self, nfa, text):
+        self.nfa = nfa
+        self.text = text
+        self.pos = 0
+
+    def peek(self):
+        return self.text[self.pos] if self.pos < len(self.text) else None
+
+    def take(self):
+        c = self.text[self.pos]
+        self.pos += 1
+        return c
+
+    def escape(self):
+        c = self.take()
+        if c == "x":
+            value = int(self.text[self.pos:self.pos + 2], 16)
+            self.pos += 2
+            return value
+        return ord(ESCAPES.get(c, c))
+
+    def parse(self):
+        fragment = self.alternation()
+        if self.pos != len(self.text):
+            sys.exit("Unexpected '%s' in %s" % (self.peek(), self.text))
+        return fragment
+
+    def alternation(self):
+        fragments = [self.concatenation()]
+        while self.peek() == "|":
+            self.take()
+            fragments.append(self.concatenation())
+        if len(fragments) == 1:
+            return fragments[0]
+        start, end = self.nfa.state(), self.nfa.state()
+        for f_start, f_end in fragments:
+            self.nfa.edges[start].append((None, f_start))
+            self.nfa.edges[f_end].append((None, end))
+        return start, end
+
+    def concatenation(self):
+        start = end = self.nfa.state()
+        while self.peek() is not None and self.peek() not in "|)":
+            f_start, f_end = self.repetition()
+            self.nfa.edges[end].append((None, f_start))
+            end = f_end
+        return start, end
+
+    def repetition(self):
+        f_start, f_end = self.atom()
+        while self.peek() is not None and self.peek() in "*+?":
+            op = self.take()
+            start, end = self.nfa.state(), self.nfa.state()
+            self.nfa.edges[start].append((None, f_start))
+            self.nfa.edges[f_end].append((None, end))
+            if op in "*?":
+                self.nfa.edges[start].append((None, end))
+            if op in "*+":
+                self.nfa.edges[f_end].append((None, f_start))
+            f_start, f_end = start, end
+        return f_start, f_end
+
+    def atom(self):
+        c = self.take()
+        if c == "(":
+            fragment = self.alternation()
+            if self.take() != ")":
+                sys.exit("Missing ')' in %s" % self.text)
+            return fragment
+        if c == "[":
+            chars = self.char_class()
+        elif c == "\\":
+            chars = {self.escape()}
+        else:
+            chars = {ord(c)}
+        start, end = self.nfa.state(), self.nfa.state()
+        self.nfa.edges[start].append((frozenset(chars), end))
+        return start, end
+
+    def char_class(self):
+        chars = set()
+        while self.peek() != "]":
+            c = self.take()
+            low = self.escape() if c == "\\" else ord(c)
+            if self.peek() == "-" and self.text[self.pos + 1] != "]":
+                self.take()
+                c = self.take()
+                high = self.escape() if c == "\\" else ord(c)
+                chars.update(range(low, high + 1))
+            else:
+                chars.add(low)
+        self.take()
+        return chars
+
+
+def build_nfa():
+    nfa = Nfa()
+    start = nfa.state()
+    for index, (_, _, _, regex) in enumerate(rules):
+        f_start, f_end = RegexParser(nfa, regex).parse()
+        nfa.edges[start].append((None, f_start))
+        nfa.accept[f_end] = index
+    return nfa, start
+
+
+def closure(nfa, states):
+    stack = list(states)
+    result = set(states)
+    while stack:
+        for chars, target in nfa.edges[stack.pop()]:
+            if chars is None and target not in result:
+                result.add(target)
+                stack.append(target)
+    return frozenset(result)
+
+
+def build_dfa(nfa, start):
+    """Subset construction, state 0 is the dead state"""
+    start_set = closure(nfa, {start})
+    sets = [None, start_set]
+    index = {start_set: 1}
+    moves = [[0] * 256, None]
+    i = 1
+    while i < len(sets):
+        row = [0] * 256
+        for byte in range(256):
+            targets = {t for s in sets[i] for chars, t in nfa.edges[s] if chars is not None and byte in chars}
+            if not targets:
+                continue
+            target_set = closure(nfa, targets)
+            if target_set not in index:
+                index[target_set] = len(sets)
+                sets.append(target_set)
+                moves.append(None)
+            row[byte] = index[target_set]
+        moves[i] = row
+        i += 1
+    accepts = [None] + [min((nfa.accept[s] for s in states if s in nfa.accept), default=None) for states in sets[1:]]
+    return moves, accepts
+
+
+def minimize(moves, accepts):
+    """Moore's partition refinement, the dead state stays 0 and the start state 1"""
+    block = [0 if i == 0 else 1 + (accepts[i] + 1 if accepts[i] is not None else 0) for i in range(len(moves))]
+    while True:
+        signatures = {}
+        new_block = []
+        for i in range(len(moves)):
+            signature = (block[i], tuple(block[t] for t in moves[i]))
+            new_block.append(signatures.setdefault(signature, len(signatures)))
+        if len(signatures) == len(set(block)):
+            break
+        block = new_block
+    # renumber so that dead is 0 and start is 1, the rest in order of first appearance
+    order = {block[0]: 0, block[1]: 1}
+    for b in block:
+        order.setdefault(b, len(order))
+    count = len(order)
+    new_moves = [None] * count
+    new_accepts = [None] * count
+    for i in range(len(moves)):
+        new_moves[order[block[i]]] = [order[block[t]] for t in moves[i]]
+        new_accepts[order[block[i]]] = accepts[i]
+    return new_moves, new_accepts
+
+
+def compress_classes(moves):
+    """Bytes with equal columns in all states form one character class"""
+    columns = {}
+    byte_class = []
+    for byte in range(256):
+        column = tuple(row[byte] for row in moves)
+        byte_class.append(columns.setdefault(column, len(columns)))
+    table = [[0] * len(columns) for _ in moves]
+    for byte in range(256):
+        for state, row in enumerate(moves):
+            table[state][byte_class[byte]] = row[byte]
+    return byte_class, table
+
+
+def c_string(value):
+    return '"' + value.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def print_array(values, per_line):
+    for i in range(0, len(values), per_line):
+        print("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+
+
+nfa, nfa_start = build_nfa()
+moves, accepts = build_dfa(nfa, nfa_start)
+moves, accepts = minimize(moves, accepts)
+byte_class, table = compress_classes(moves)
+class_count = len(table[0])
+state_count = len(table)
+row_type = "uint8_t" if (state_count - 1) * class_count < 256 else "uint16_t"
+
+separator_flags = []
+for byte in range(256):
+    flags = 0
+    if chr(byte) in separators or chr(byte) in whitespace or byte == EOF_BYTE:
+        flags |= 1
+    if chr(byte) in separators:
+        flags |= 2
+    separator_flags.append(flags)
+
+print("""/**
+ * @file scanner_table.c
+ * @brief Transition table of the token automaton, generated by utils/create_scanner_table.py - do not edit by hand.
+ * @version 0.1
+ * @date 2023-12-01
+ *
+ * @copyright Copyright (c) 2023
+ * Project: IFJ compiler
+ *
+ */
+
+#include <stdint.h>
+#include "scanner.h"
+""")
+print("#define SCAN_CLASS_COUNT %d // count of character classes, columns of the table" % class_count)
+print("#define SCAN_STATE_COUNT %d // count of states, rows of the table" % state_count)
+print("#define SCAN_START_ROW SCAN_CLASS_COUNT // the first row belongs to the dead state")
+print()
+print("// character class of every byte")
+print("static const uint8_t scan_char_class[256] = {")
+print_array(byte_class, 16)
+print("};")
+print()
+print("// offset of the row of the next state for every state and character class, 0 if the automaton stops")
+print("static const %s scan_transitions[SCAN_STATE_COUNT * SCAN_CLASS_COUNT] = {" % row_type)
+for row in table:
+    print("    " + ", ".join(str(t * class_count) for t in row) + ",")
+print("};")
+print()
+print("// action run when the automaton stops in the state")
+print("static const Scan_accept scan_accepts[SCAN_STATE_COUNT] = {")
+for accept in accepts:
+    if accept is None:
+        print("    {.action = SCAN_ERROR, .type = TOKEN_EOF, .value = NULL},")
+    else:
+        action, token, value, _ = rules[accept]
+        value = c_string(value) if value is not None else "NULL"
+        print("    {.action = %s, .type = %s, .value = %s}," % (action, token or "TOKEN_EOF", value))
+print("};")
+print()
+print("const uint8_t scan_separator[256] = {")
+print_array(separator_flags, 16)
+print("};")
+print("""
+const Scan_accept *scan_match(const char *data, size_t pos, size_t len, size_t *end)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    unsigned int row = SCAN_START_ROW;
+    while (1)
+    {
+        // the end of the input is read as EOF
+        unsigned int c = pos < len ? bytes[pos] : 0xFF;
+        unsigned int next = scan_transitions[row + scan_char_class[c]];
+        if (next == 0)
+        {
+            break;
+        }
+        row = next;
+        pos++;
+    }
+    *end = pos;
+    return &scan_accepts[row / SCAN_CLASS_COUNT];
+}""")